@@ -0,0 +1,49 @@
+# - Try to find the Zstandard (zstd) library
+# Once done this will define
+#
+#  Zstd_FOUND - system has zstd
+#  Zstd_INCLUDE_DIR - the zstd include directory
+#  Zstd_LIBRARY      - The zstd library
+#
+# Also creates the imported Zstd::zstd target
+
+# Try config mode first!
+find_package(zstd CONFIG QUIET) # Deliberately quiet, so we can handle the result
+if(zstd_FOUND)
+	foreach(_zstd_target zstd::libzstd zstd::libzstd_static zstd::libzstd_shared)
+		if (TARGET ${_zstd_target})
+			# CONFIG mode succeeded
+			if (NOT TARGET Zstd::zstd)
+				add_library(Zstd::zstd INTERFACE IMPORTED)
+				set_target_properties(Zstd::zstd PROPERTIES INTERFACE_LINK_LIBRARIES ${_zstd_target})
+			endif()
+			get_target_property(Zstd_INCLUDE_DIR ${_zstd_target} INTERFACE_INCLUDE_DIRECTORIES)
+			set(Zstd_LIBRARY ${_zstd_target})
+			set(Zstd_FOUND TRUE)
+			message(STATUS "Found zstd: ${_zstd_target}")
+			return()
+		endif()
+	endforeach()
+endif()
+
+find_package(PkgConfig QUIET)
+if(PkgConfig_FOUND)
+	pkg_check_modules(_ZSTD_PKGCONFIG QUIET libzstd)
+endif()
+
+find_path(Zstd_INCLUDE_DIR zstd.h HINTS ${_ZSTD_PKGCONFIG_INCLUDEDIR})
+find_library(Zstd_LIBRARY NAMES zstd zstd_static HINTS ${_ZSTD_PKGCONFIG_LIBDIR})
+
+mark_as_advanced(Zstd_INCLUDE_DIR Zstd_LIBRARY)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd REQUIRED_VARS Zstd_LIBRARY Zstd_INCLUDE_DIR)
+
+if(Zstd_FOUND AND NOT TARGET Zstd::zstd)
+	add_library(Zstd::zstd UNKNOWN IMPORTED)
+	set_target_properties(Zstd::zstd
+	  PROPERTIES
+	  IMPORTED_LOCATION "${Zstd_LIBRARY}"
+	  INTERFACE_INCLUDE_DIRECTORIES "${Zstd_INCLUDE_DIR}"
+	)
+endif()
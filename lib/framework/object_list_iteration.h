@@ -25,6 +25,8 @@
 #include <iterator>
 #include <functional>
 
+#include "object_slot_list.h"
+
 enum class IterationResult
 {
 	BREAK_ITERATION,
@@ -37,7 +39,8 @@ enum class IterationResult
 ///
 /// Currently two callable signatures are supported:
 /// * `IterationResult(ObjectType*)`
-/// * `IterationResult(std::list<ObjectType*>::iterator)`
+/// * `IterationResult(std::list<ObjectType*>::iterator)` (or the iterator
+///   type of whatever list is being iterated, e.g. `ObjectSlotList<ObjectType>::iterator`)
 ///
 /// The latter overload is convenient when one needs to erase from or
 /// insert into the list being iterated directly inside the handler's body,
@@ -58,16 +61,16 @@ struct LoopBodyHandlerCallStrategy
 	static constexpr bool handler_accepts_ptr = std::is_convertible<
 		Callable,
 		std::function<IterationResult(ObjectType*)>>::value;
-	template <typename ObjectType>
+	template <typename ObjectType, typename IteratorType = typename std::list<ObjectType*>::iterator>
 	static constexpr bool handler_accepts_iter = std::is_convertible<
 		Callable,
-		std::function<IterationResult(typename std::list<ObjectType*>::iterator)>>::value;
+		std::function<IterationResult(IteratorType)>>::value;
 
 
-	template <typename ObjectType>
-	static IterationResult Invoke(Callable handler, typename std::list<ObjectType*>::iterator iter)
+	template <typename ObjectType, typename IteratorType = typename std::list<ObjectType*>::iterator>
+	static IterationResult Invoke(Callable handler, IteratorType iter)
 	{
-		if constexpr (handler_accepts_iter<ObjectType>)
+		if constexpr (handler_accepts_iter<ObjectType, IteratorType>)
 		{
 			// `Invoke` overload for Callable taking a list iterator as the argument
 			return handler(iter);
@@ -117,3 +120,47 @@ void mutating_list_iterate(std::list<ObjectType*>& list, MaybeErasingLoopBodyHan
 	}
 }
 
+
+// Same as above, for the per-player object lists.
+//
+// The loop body handler may erase any element from the list (including the
+// current one and the next one), since `ObjectSlotList::erase()` only leaves
+// a tombstone behind, which the iteration then skips.
+//
+// Mirrors the `std::list` version in that elements inserted after the current
+// one while the last element is being handled are not visited.
+template <typename ObjectType, typename MaybeErasingLoopBodyHandler>
+void mutating_list_iterate(ObjectSlotList<ObjectType>& list, MaybeErasingLoopBodyHandler handler)
+{
+	using HandlerCallStrategy = LoopBodyHandlerCallStrategy<MaybeErasingLoopBodyHandler>;
+	using IteratorType = typename ObjectSlotList<ObjectType>::iterator;
+
+	static_assert(
+		   HandlerCallStrategy::template handler_accepts_ptr<ObjectType>
+		|| HandlerCallStrategy::template handler_accepts_iter<ObjectType, IteratorType>,
+		"Unsupported loop body handler signature: "
+		"should return IterationResult and take either an ObjectType* or an iterator");
+
+	if (list.empty())
+	{
+		return;
+	}
+
+	const IteratorType end = list.end();
+	IteratorType it = list.begin();
+	while (it != end)
+	{
+		IteratorType itNext = std::next(it);
+		const auto res = HandlerCallStrategy::template Invoke<ObjectType>(handler, it);
+		if (res == IterationResult::BREAK_ITERATION || itNext == end)
+		{
+			break;
+		}
+		// The next element might have been erased by the handler, skip to the next live one if so.
+		if (*itNext == nullptr)
+		{
+			++itNext;
+		}
+		it = itNext;
+	}
+}
@@ -0,0 +1,517 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file object_slot_list.h
+ * Contiguous, order-preserving list of object pointers with stable
+ * iterators and deferred erase, used for the per-player object lists.
+ *
+ * This header is deliberately self-contained (no game / framework includes)
+ * so it can be benchmarked standalone (tests/object_list_benchmark.cpp).
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Drop-in replacement for `std::list<ObjectType*>` for the per-player
+/// object lists (droids, structures, features, ...), which are walked
+/// every game tick.
+///
+/// Pointers are stored in a single contiguous array of "slots", so walking
+/// the list is a linear scan instead of a pointer chase across individually
+/// allocated list nodes, and insertion never allocates per element.
+///
+/// Each slot is addressed by a signed logical position, which is the
+/// "stable handle" of the element:
+/// * `push_front()` / `emplace_front()` take the position just before the
+///   first slot, `push_back()` / `emplace_back()` the one just after the last.
+///   The backing array keeps headroom on both sides and re-centres itself when
+///   it grows, which only moves the origin, never the logical positions.
+/// * `erase()` does not shift anything: it turns the slot into a tombstone
+///   (`nullptr`) and iterators skip tombstones. This is the "deferred erase".
+/// * Tombstones are squeezed out by `compact()`, which is the only operation
+///   (besides `clear()` and `reverse()`) that moves positions around.
+///
+/// Consequently, the iterator invalidation rules match those of `std::list`,
+/// which the simulation code relies on (see `mutating_list_iterate`):
+/// inserting or erasing never invalidates iterators to other elements.
+///
+/// Like `clear()`, `compact()` invalidates all iterators into the list, so it
+/// must only be called where no iteration is in progress. The game does so
+/// once per tick, in `objmemUpdate()`.
+///
+/// The element order is exactly the one `std::list` would produce for the
+/// same sequence of operations, which keeps the simulation deterministic.
+///
+/// Algorithmic complexities of common operations are as follows:
+/// * `push_front()` / `push_back()` are amortized `O(1)`.
+/// * `erase()` is `O(1)`.
+/// * `front()` / `begin()` are `O(1)` + number of leading tombstones.
+/// * `compact()` / `reverse()` are `O(N)`.
+/// </summary>
+/// <typeparam name="ObjectType">Pointee type of the stored pointers.</typeparam>
+template <typename ObjectType>
+class ObjectSlotList
+{
+public:
+
+	using value_type = ObjectType*;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+private:
+
+	// Logical position of a slot. Stays the same until `compact()`, `clear()` or `reverse()`.
+	using Position = ptrdiff_t;
+
+	static constexpr Position END_POSITION = PTRDIFF_MAX;
+	static constexpr size_t MIN_CAPACITY = 16;
+
+public:
+
+	/// <summary>
+	/// Bidirectional iterator over the live elements of the parent list.
+	///
+	/// An iterator only stores the parent list and a logical position, so it is
+	/// unaffected by insertions (even when those reallocate the backing array)
+	/// and by erasure of other elements.
+	///
+	/// An iterator to an erased element may still be advanced (this is what
+	/// `erase()` and `mutating_list_iterate` do), but not dereferenced.
+	/// </summary>
+	/// <typeparam name="IsConst">Marks whether iterator is const or not.</typeparam>
+	template <bool IsConst>
+	class IteratorImpl
+	{
+	public:
+
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = ObjectType*;
+		using difference_type = ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, value_type const*, value_type*>;
+		using reference = std::conditional_t<IsConst, value_type const&, value_type&>;
+
+		using ParentContainerType = std::conditional_t<
+			IsConst,
+			std::add_const_t<ObjectSlotList>,
+			ObjectSlotList
+		>;
+
+		IteratorImpl() = default;
+
+		IteratorImpl(ParentContainerType* c, Position pos)
+			: _c(c), _pos(pos)
+		{}
+
+		// Allow promotion of non-const iterator to const iterator.
+		template <bool DummyConst = IsConst, std::enable_if_t<DummyConst, bool> = true>
+		IteratorImpl(const IteratorImpl<false>& other)
+			: _c(other._c), _pos(other._pos)
+		{}
+
+		bool operator==(const IteratorImpl& other) const
+		{
+			return _pos == other._pos && _c == other._c;
+		}
+
+		bool operator!=(const IteratorImpl& other) const
+		{
+			return !(*this == other);
+		}
+
+		reference operator*() const
+		{
+			assert(_c != nullptr && _pos != END_POSITION);
+			return _c->slot(_pos);
+		}
+
+		pointer operator->() const
+		{
+			return &**this;
+		}
+
+		// Prefix increment
+		IteratorImpl& operator++()
+		{
+			_pos = _c->next_live_position(_pos + 1);
+			return *this;
+		}
+
+		// Postfix increment
+		IteratorImpl operator++(int)
+		{
+			IteratorImpl copy(*this);
+			++*this;
+			return copy;
+		}
+
+		// Prefix decrement
+		IteratorImpl& operator--()
+		{
+			_pos = _c->prev_live_position((_pos == END_POSITION ? _c->_last : _pos) - 1);
+			return *this;
+		}
+
+		// Postfix decrement
+		IteratorImpl operator--(int)
+		{
+			IteratorImpl copy(*this);
+			--*this;
+			return copy;
+		}
+
+	private:
+
+		// Make both possible instantiations of iterator friends
+		// to allow promotion to from non-const to const iterator.
+		template <bool IsConst2>
+		friend class IteratorImpl;
+
+		friend class ObjectSlotList;
+
+		ParentContainerType* _c = nullptr;
+		Position _pos = END_POSITION;
+	};
+
+	using iterator = IteratorImpl<false>;
+	using const_iterator = IteratorImpl<true>;
+
+	ObjectSlotList() = default;
+
+	ObjectSlotList(const ObjectSlotList& other)
+	{
+		copy_live_elements(other);
+	}
+
+	ObjectSlotList(ObjectSlotList&& other) noexcept
+	{
+		steal_storage(other);
+	}
+
+	ObjectSlotList& operator=(const ObjectSlotList& other)
+	{
+		if (this != &other)
+		{
+			clear();
+			copy_live_elements(other);
+		}
+		return *this;
+	}
+
+	// Like `std::list`, leaves `other` empty.
+	// Iterators into `other` are neither transferred nor invalidated for `other`'s bookkeeping.
+	ObjectSlotList& operator=(ObjectSlotList&& other) noexcept
+	{
+		if (this != &other)
+		{
+			clear();
+			steal_storage(other);
+		}
+		return *this;
+	}
+
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	size_type size() const
+	{
+		return _size;
+	}
+
+	iterator begin()
+	{
+		return iterator(this, next_live_position(_first));
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, next_live_position(_first));
+	}
+
+	iterator end()
+	{
+		return iterator(this, END_POSITION);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, END_POSITION);
+	}
+
+	const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	const_iterator cend() const
+	{
+		return end();
+	}
+
+	reference front()
+	{
+		assert(!empty());
+		return slot(next_live_position(_first));
+	}
+
+	const_reference front() const
+	{
+		assert(!empty());
+		return slot(next_live_position(_first));
+	}
+
+	reference back()
+	{
+		assert(!empty());
+		return slot(prev_live_position(_last - 1));
+	}
+
+	const_reference back() const
+	{
+		assert(!empty());
+		return slot(prev_live_position(_last - 1));
+	}
+
+	void push_front(value_type value)
+	{
+		assert(value != nullptr);
+		if (physical_index(_first) == 0)
+		{
+			grow();
+		}
+		--_first;
+		slot(_first) = value;
+		++_size;
+	}
+
+	void push_back(value_type value)
+	{
+		assert(value != nullptr);
+		if (physical_index(_last) == static_cast<Position>(_slots.size()))
+		{
+			grow();
+		}
+		slot(_last) = value;
+		++_last;
+		++_size;
+	}
+
+	reference emplace_front(value_type value)
+	{
+		push_front(value);
+		return slot(_first);
+	}
+
+	reference emplace_back(value_type value)
+	{
+		push_back(value);
+		return slot(_last - 1);
+	}
+
+	void pop_front()
+	{
+		erase(begin());
+	}
+
+	void pop_back()
+	{
+		erase(std::prev(end()));
+	}
+
+	/// Turns the slot into a tombstone. Only iterators to the erased element are invalidated.
+	/// Returns an iterator to the element following the erased one.
+	iterator erase(const_iterator pos)
+	{
+		assert(pos._c == this && pos._pos != END_POSITION);
+		value_type& s = slot(pos._pos);
+		assert(s != nullptr);
+		s = nullptr;
+		--_size;
+		++_tombstones;
+		return iterator(this, next_live_position(pos._pos + 1));
+	}
+
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		while (first != last)
+		{
+			first = erase(first);
+		}
+		return iterator(this, last._pos);
+	}
+
+	/// Erases all occurrences of `value`, returns the number of erased elements.
+	size_type remove(value_type value)
+	{
+		size_type count = 0;
+		for (Position pos = _first; pos < _last; ++pos)
+		{
+			value_type& s = slot(pos);
+			if (s != nullptr && s == value)
+			{
+				s = nullptr;
+				++count;
+			}
+		}
+		_size -= count;
+		_tombstones += count;
+		return count;
+	}
+
+	/// Invalidates all iterators, like `std::list::clear()`. Keeps the allocated storage.
+	void clear()
+	{
+		std::fill(_slots.begin(), _slots.end(), nullptr);
+		_origin = static_cast<Position>(_slots.size() / 2);
+		_first = _last = 0;
+		_size = 0;
+		_tombstones = 0;
+	}
+
+	/// Reverses the order of the elements. Invalidates all iterators, like `compact()`.
+	void reverse()
+	{
+		compact();
+		std::reverse(_slots.begin() + physical_index(_first), _slots.begin() + physical_index(_last));
+	}
+
+	/// Squeezes out tombstones left behind by `erase()`, preserving the order of elements.
+	/// Positions change, so this invalidates all iterators into the list.
+	void compact()
+	{
+		if (_tombstones == 0)
+		{
+			return;
+		}
+		auto rangeBegin = _slots.begin() + physical_index(_first);
+		auto rangeEnd = _slots.begin() + physical_index(_last);
+		auto newEnd = std::remove(rangeBegin, rangeEnd, nullptr);
+		std::fill(newEnd, rangeEnd, nullptr);
+		_last = _first + static_cast<Position>(_size);
+		_tombstones = 0;
+	}
+
+	/// Number of erased slots waiting for `compact()`.
+	size_type tombstones() const
+	{
+		return _tombstones;
+	}
+
+private:
+
+	Position physical_index(Position pos) const
+	{
+		return _origin + pos;
+	}
+
+	value_type& slot(Position pos)
+	{
+		return _slots[static_cast<size_t>(physical_index(pos))];
+	}
+
+	const value_type& slot(Position pos) const
+	{
+		return _slots[static_cast<size_t>(physical_index(pos))];
+	}
+
+	// First live position at or after `pos`, or `END_POSITION`.
+	Position next_live_position(Position pos) const
+	{
+		for (; pos < _last; ++pos)
+		{
+			if (slot(pos) != nullptr)
+			{
+				return pos;
+			}
+		}
+		return END_POSITION;
+	}
+
+	// Last live position at or before `pos`. Must exist.
+	Position prev_live_position(Position pos) const
+	{
+		while (slot(pos) == nullptr)
+		{
+			assert(pos > _first);
+			--pos;
+		}
+		return pos;
+	}
+
+	// Reallocate the slots with headroom on both sides.
+	// Only the origin moves, logical positions stay the same.
+	void grow()
+	{
+		const size_t used = static_cast<size_t>(_last - _first);
+		const size_t newCapacity = std::max(MIN_CAPACITY, 2 * used + MIN_CAPACITY);
+		const Position newFirstIndex = static_cast<Position>((newCapacity - used) / 2);
+
+		std::vector<value_type> newSlots(newCapacity, nullptr);
+		std::copy(_slots.begin() + physical_index(_first), _slots.begin() + physical_index(_last), newSlots.begin() + newFirstIndex);
+		_slots = std::move(newSlots);
+		_origin = newFirstIndex - _first;
+	}
+
+	void copy_live_elements(const ObjectSlotList& other)
+	{
+		for (value_type v : other)
+		{
+			push_back(v);
+		}
+	}
+
+	void steal_storage(ObjectSlotList& other)
+	{
+		_slots = std::move(other._slots);
+		_origin = other._origin;
+		_first = other._first;
+		_last = other._last;
+		_size = other._size;
+		_tombstones = other._tombstones;
+
+		other._slots.clear();
+		other._origin = other._first = other._last = 0;
+		other._size = other._tombstones = 0;
+	}
+
+	std::vector<value_type> _slots;
+	// Physical index of logical position 0 within `_slots`.
+	Position _origin = 0;
+	// Range of logical positions in use, `[_first, _last)`. May contain tombstones.
+	Position _first = 0;
+	Position _last = 0;
+	size_t _size = 0;
+	size_t _tombstones = 0;
+};
+
+template <typename ObjectType>
+constexpr typename ObjectSlotList<ObjectType>::Position ObjectSlotList<ObjectType>::END_POSITION;
@@ -58,6 +58,8 @@ static uint32_t gameQueueTime[MAX_GAMEQUEUE_SLOTS];
 static uint32_t gameQueueCheckTime[MAX_GAMEQUEUE_SLOTS];
 static uint32_t gameQueueCheckCrc[MAX_GAMEQUEUE_SLOTS];
 static bool     crcError = false;
+static unsigned syncErrorCount = 0;
+static uint32_t firstSyncErrorTime = 0;
 
 // A client that resumed mid-match from a GameState snapshot cannot reproduce the sync CRC of any tick
 // at or before its resume tick: it never simulated those ticks, and the resume tick's CRC is an
@@ -128,6 +130,8 @@ void gameTimeInit(void)
 
 	// Don't let syncDebug from previous games cause a desynch dump at gameTime 102.
 	crcError = false;
+	syncErrorCount = 0;
+	firstSyncErrorTime = 0;
 	syncCheckFloorTime = 0; // no resume floor for a normal game start (set later if a snapshot is restored)
 	resetSyncDebug();
 }
@@ -541,6 +545,10 @@ void recvPlayerGameTime(NETQUEUE queue)
 		{
 			debug(LOG_ERROR, "Found CRC error when receiving GAME_GAME_TIME for player: %" PRIu8 " (checkTime: %" PRIu32 ", checkCrc: %" PRIu16 ")", queue.index, checkTime, checkCrc);
 			crcError = true;
+			if (syncErrorCount++ == 0)
+			{
+				firstSyncErrorTime = checkTime;
+			}
 			if (NetPlay.players[queue.index].allocated)
 			{
 				NETsetPlayerConnectionStatus(CONNECTIONSTATUS_DESYNC, queue.index);
@@ -554,6 +562,16 @@ void recvPlayerGameTime(NETQUEUE queue)
 	}
 }
 
+unsigned gameTimeSyncErrorCount()
+{
+	return syncErrorCount;
+}
+
+uint32_t gameTimeFirstSyncErrorTime()
+{
+	return firstSyncErrorTime;
+}
+
 bool checkPlayerGameTime(unsigned player)
 {
 	unsigned begin = player, end = player + 1;
@@ -234,6 +234,8 @@ static inline Vector3i gameTimeAdjustedAverage(Vector3i numerator, int denominat
 
 void sendPlayerGameTime();                                ///< Sends a GAME_GAME_TIME message with gameTime plus latency to our game queues.
 void recvPlayerGameTime(NETQUEUE queue);                  ///< Processes a GAME_GAME_TIME message.
+unsigned gameTimeSyncErrorCount();                        ///< Number of GAME_GAME_TIME messages whose CRC didn't match ours, since gameTimeInit().
+uint32_t gameTimeFirstSyncErrorTime();                    ///< The checkTime of the first of those, 0 if there were none.
 bool checkPlayerGameTime(unsigned player);                ///< Checks that we are not waiting for a GAME_GAME_TIME message from this player. (player can be NET_ALL_PLAYERS.)
 void setPlayerGameTime(unsigned player, uint32_t time);   ///< Sets the player's time.
 
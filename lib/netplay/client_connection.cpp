@@ -152,6 +152,17 @@ net::result<ssize_t> IClientConnection::readNoInt(void* buf, size_t max_size, si
 }
 
 net::result<ssize_t> IClientConnection::writeAll(const void* buf, size_t size, size_t* rawByteCount)
+{
+	return writeAllImpl(buf, size, nullptr, rawByteCount);
+}
+
+net::result<ssize_t> IClientConnection::writeAll(const WriteBuffer& buf, size_t* rawByteCount)
+{
+	ASSERT_OR_RETURN(tl::make_unexpected(make_network_error_code(EINVAL)), buf != nullptr, "Null buffer passed to writeAll");
+	return writeAllImpl(buf->data(), buf->size(), &buf, rawByteCount);
+}
+
+net::result<ssize_t> IClientConnection::writeAllImpl(const void* buf, size_t size, const WriteBuffer* shared, size_t* rawByteCount)
 {
 	if (!isValid())
 	{
@@ -177,9 +188,16 @@ net::result<ssize_t> IClientConnection::writeAll(const void* buf, size_t size, s
 
 	if (!isCompressed())
 	{
-		pwm_->append(this, [buf, size](std::vector<uint8_t>& writeQueue)
+		pwm_->append(this, [buf, size, shared](PendingWritesManager::ConnectionWriteQueue& writeQueue)
 		{
-			writeQueue.insert(writeQueue.end(), static_cast<char const*>(buf), static_cast<char const*>(buf) + size);
+			if (shared)
+			{
+				writeQueue.append(*shared);
+			}
+			else
+			{
+				writeQueue.append(buf, size);
+			}
 		});
 		if (rawByteCount)
 		{
@@ -239,21 +257,22 @@ net::result<void> IClientConnection::flush(size_t* rawByteCount)
 		return {};  // No data to flush out.
 	}
 
+	const size_t compressedSize = compressionBuf.size();
 	pwm_->append(this, [&compressionBuf] (PendingWritesManager::ConnectionWriteQueue& writeQueue)
 	{
-		writeQueue.reserve(writeQueue.size() + compressionBuf.size());
-		writeQueue.insert(writeQueue.end(), compressionBuf.begin(), compressionBuf.end());
+		// Hand the compressed data over instead of copying it, the adapter starts a new buffer.
+		writeQueue.append(std::move(compressionBuf));
 	});
 	// Data sent, don't send again.
 	if (rawByteCount)
 	{
-		*rawByteCount = compressionBuf.size();
+		*rawByteCount = compressedSize;
 	}
 	compressionBuf.clear();
 	return {};
 }
 
-void IClientConnection::enableCompression()
+void IClientConnection::enableCompression(WzCompressionMethod method)
 {
 	if (isCompressed_)
 	{
@@ -262,9 +281,14 @@ void IClientConnection::enableCompression()
 
 	ASSERT_OR_RETURN(, compressionProvider_ != nullptr, "Invalid compression provider");
 
-	pwm_->executeUnderLock([this]
+	pwm_->executeUnderLock([this, method]
 	{
-		compressionAdapter_ = compressionProvider_->newCompressionAdapter();
+		compressionAdapter_ = compressionProvider_->newCompressionAdapter(method);
+		if (!compressionAdapter_)
+		{
+			debug(LOG_ERROR, "Unsupported compression method %u. Sockets won't work properly!", static_cast<unsigned>(method));
+			return;
+		}
 		const auto initRes = compressionAdapter_->initialize();
 		if (!initRes.has_value())
 		{
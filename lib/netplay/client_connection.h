@@ -32,6 +32,7 @@
 #include "lib/framework/types.h" // bring in `ssize_t` for MSVC
 #include "lib/netplay/net_result.h"
 #include "lib/netplay/compression_adapter.h"
+#include "lib/netplay/write_queue.h"
 
 #include <nonstd/optional.hpp>
 using nonstd::optional;
@@ -105,14 +106,19 @@ public:
 	/// <param name="rawByteCount">Output parameter: raw count of bytes (after compression) written.</param>
 	/// <returns>The total number of bytes written.</returns>
 	net::result<ssize_t> writeAll(const void* buf, size_t size, size_t* rawByteCount);
+	/// <summary>
+	/// Same as `writeAll(buf->data(), buf->size(), rawByteCount)`, except that on connections without compression
+	/// the buffer is queued as is, so that a message sent to several connections is only copied once.
+	/// </summary>
+	net::result<ssize_t> writeAll(const WriteBuffer& buf, size_t* rawByteCount);
 
 	/// <summary>
-	/// Low-level implementation method to send raw data (stored in `data`)
-	/// via the underlying transport.
+	/// Low-level implementation method to send raw data (queued in `data`)
+	/// via the underlying transport. May send only the beginning of the queue.
 	/// </summary>
 	/// <param name="data">The data to send over the network.</param>
 	/// <returns>Either the number of bytes sent or `std::error_code` describing the error.</returns>
-	virtual net::result<ssize_t> sendImpl(const std::vector<uint8_t>& data) = 0;
+	virtual net::result<ssize_t> sendImpl(const WriteQueue& data) = 0;
 	/// <summary>
 	/// Low-level implementation method to receive the data into `dst` (up to `maxSize` bytes)
 	/// via the underlying transport.
@@ -149,8 +155,11 @@ public:
 	///
 	/// This makes all subsequent write operations asynchronous, plus
 	/// the written data will need to be flushed explicitly at some point.
+	///
+	/// Both ends of the connection must use the same `method`, which is
+	/// negotiated during the join handshake.
 	/// </summary>
-	void enableCompression();
+	void enableCompression(WzCompressionMethod method = WzCompressionMethod::Zlib);
 
 	bool isCompressed() const
 	{
@@ -256,6 +265,9 @@ protected:
 
 private:
 
+	// `shared` is either null or holds the same data as `buf`.
+	net::result<ssize_t> writeAllImpl(const void* buf, size_t size, const WriteBuffer* shared, size_t* rawByteCount);
+
 	std::atomic<bool> writeErrorSet_{false}; // set when writeErrorCode_ is set
 	mutable std::mutex writeErrorMtx_; // protects access to writeErrorCode_
 	optional<std::error_code> writeErrorCode_;
@@ -25,6 +25,18 @@
 #include <stdint.h>
 #include <vector>
 
+/// <summary>
+/// Compression algorithms which can be used for network connections.
+///
+/// The values are exchanged during the join handshake (see `WzCompressionProvider`),
+/// so they must never be reordered or reused.
+/// </summary>
+enum class WzCompressionMethod : uint32_t
+{
+	Zlib = 0,
+	Zstd = 1,
+};
+
 /// <summary>
 /// Generic facade for integration of various compression algorithms into WZ's
 /// networking code.
@@ -30,6 +30,9 @@
 #endif
 
 #include <zlib.h>
+#if defined(WZ_ZSTD_ENABLED)
+# include <zstd_errors.h>
+#endif
 
 std::string GenericSystemErrorCategory::message(int ev) const
 {
@@ -122,6 +125,13 @@ std::string ZlibErrorCategory::message(int ev) const
 	}
 }
 
+#if defined(WZ_ZSTD_ENABLED)
+std::string ZstdErrorCategory::message(int ev) const
+{
+	return ZSTD_getErrorString(static_cast<ZSTD_ErrorCode>(ev));
+}
+#endif
+
 const std::error_category& generic_system_error_category()
 {
 	static GenericSystemErrorCategory instance;
@@ -140,6 +150,14 @@ const std::error_category& zlib_error_category()
 	return instance;
 }
 
+#if defined(WZ_ZSTD_ENABLED)
+const std::error_category& zstd_error_category()
+{
+	static ZstdErrorCategory instance;
+	return instance;
+}
+#endif
+
 std::error_code make_network_error_code(int ev)
 {
 	return { ev, generic_system_error_category() };
@@ -154,3 +172,10 @@ std::error_code make_zlib_error_code(int ev)
 {
 	return { ev, zlib_error_category() };
 }
+
+#if defined(WZ_ZSTD_ENABLED)
+std::error_code make_zstd_error_code(int ev)
+{
+	return { ev, zstd_error_category() };
+}
+#endif
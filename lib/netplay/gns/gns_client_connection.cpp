@@ -58,7 +58,7 @@ GNSClientConnection::~GNSClientConnection()
 	ASSERT(networkInterface_->CloseConnection(conn_, 0, nullptr, true) == true, "Failed to close client connection properly");
 }
 
-net::result<ssize_t> GNSClientConnection::sendImpl(const std::vector<uint8_t>& data)
+net::result<ssize_t> GNSClientConnection::sendImpl(const WriteQueue& data)
 {
 	ASSERT_OR_RETURN(tl::make_unexpected(make_gns_error_code(EINVAL)), isValid(), "Invalid GNS client connection handle");
 
@@ -67,15 +67,32 @@ net::result<ssize_t> GNSClientConnection::sendImpl(const std::vector<uint8_t>& d
 	{
 		sendFlags |= k_nSteamNetworkingSend_NoNagle;
 	}
-	// Limit the size of the message to the maximum size allowed by the GNS library.
-	// Higher-level code will automatically handle this case and split the payload into several messages if needed.
-	const auto size = std::min(data.size(), static_cast<size_t>(k_cbMaxSteamNetworkingSocketsMessageSizeSend));
-	auto res = networkInterface_->SendMessageToConnection(conn_, data.data(), static_cast<uint32_t>(size), sendFlags, nullptr);
-	if (res != k_EResultOK)
+	// Send each queued buffer as a separate message.
+	static constexpr size_t MAX_SEND_SPANS = 16;
+	WriteSpan spans[MAX_SEND_SPANS];
+	const size_t spanCount = data.spans(spans, MAX_SEND_SPANS);
+	size_t sent = 0;
+	for (size_t i = 0; i < spanCount; ++i)
 	{
-		return tl::make_unexpected(make_gns_error_code(res));
+		// Limit the size of the message to the maximum size allowed by the GNS library.
+		// Higher-level code will automatically handle this case and split the payload into several messages if needed.
+		const auto size = std::min(spans[i].size, static_cast<size_t>(k_cbMaxSteamNetworkingSocketsMessageSizeSend));
+		auto res = networkInterface_->SendMessageToConnection(conn_, spans[i].data, static_cast<uint32_t>(size), sendFlags, nullptr);
+		if (res != k_EResultOK)
+		{
+			if (sent != 0)
+			{
+				break;  // Report what was sent, the error will come up again on the next attempt.
+			}
+			return tl::make_unexpected(make_gns_error_code(res));
+		}
+		sent += size;
+		if (size != spans[i].size)
+		{
+			break;
+		}
 	}
-	return size;
+	return sent;
 }
 
 net::result<ssize_t> GNSClientConnection::recvImpl(char* dst, size_t maxSize)
@@ -53,7 +53,7 @@ public:
 		ISteamNetworkingSockets* networkInterface, HSteamNetConnection conn);
 	virtual ~GNSClientConnection() override;
 
-	virtual net::result<ssize_t> sendImpl(const std::vector<uint8_t>& data) override;
+	virtual net::result<ssize_t> sendImpl(const WriteQueue& data) override;
 	virtual net::result<ssize_t> recvImpl(char* dst, size_t maxSize) override;
 
 	virtual void setReadReady(bool /*ready*/) override { /* no-op */ }
@@ -56,6 +56,7 @@
 #include "lib/netplay/connection_provider_registry.h"
 #include "lib/netplay/pending_writes_manager.h"
 #include "lib/netplay/pending_writes_manager_map.h"
+#include "lib/netplay/wz_compression_provider.h"
 #include "netpermissions.h"
 #include "sync_debug.h"
 #include "port_mapping_manager.h"
@@ -244,7 +245,7 @@ struct TmpSocketInfo
 {
 	std::string ip;
 	std::chrono::steady_clock::time_point connectTime;
-	char buffer[10] = {'\0'};
+	char buffer[16] = {'\0'};
 	size_t usedBuffer = 0;
 	std::vector<uint8_t> connectChallenge;
 	enum class TmpConnectState
@@ -1612,6 +1613,8 @@ bool NETsend(NETQUEUE queue, NetMessage const& message)
 	{
 		int firstPlayer = player == NET_ALL_PLAYERS ? 0                         : player;
 		int lastPlayer  = player == NET_ALL_PLAYERS ? MAX_CONNECTED_PLAYERS - 1 : player;
+		// Copy of the message, queued as is for every connection without compression.
+		WriteBuffer sharedRawData;
 		for (player = firstPlayer; player <= lastPlayer; ++player)
 		{
 			// We are the host, send directly to player.
@@ -1626,7 +1629,13 @@ bool NETsend(NETQUEUE queue, NetMessage const& message)
 				uint8_t msgType = message.type();
 				ssize_t rawLen = rawData.size();
 				size_t compressedRawLen;
-				const auto writeResult = sockets[player]->writeAll(rawData.data(), rawLen, &compressedRawLen);
+				if (!sharedRawData && !sockets[player]->isCompressed())
+				{
+					sharedRawData = std::make_shared<const std::vector<uint8_t>>(rawData.begin(), rawData.end());
+				}
+				const auto writeResult = sockets[player]->isCompressed()
+					? sockets[player]->writeAll(rawData.data(), rawLen, &compressedRawLen)
+					: sockets[player]->writeAll(sharedRawData, &compressedRawLen);
 				const auto res = writeResult.value_or(SOCKET_ERROR);
 
 				if (res == rawLen)
@@ -3783,7 +3792,22 @@ static void NETallowJoining()
 			{
 				char *p_buffer = tmp_connectState[i].buffer;
 
-				const auto sizeReadResult = tmp_socket[i]->readNoInt(p_buffer + tmp_connectState[i].usedBuffer, 8 - tmp_connectState[i].usedBuffer, nullptr);
+				// Read NETCODE_VERSION_MAJOR and NETCODE_VERSION_MINOR first. Only clients of our own version
+				// follow them with their supported compression methods, and for the others (including the lobby
+				// server "alive" check), whatever comes next isn't ours to read yet.
+				size_t initialConnectSize = 8;
+				if (tmp_connectState[i].usedBuffer >= 8)
+				{
+					uint32_t sentMajor = 0, sentMinor = 0;
+					memcpy(&sentMajor, p_buffer, sizeof(uint32_t));
+					memcpy(&sentMinor, p_buffer + sizeof(uint32_t), sizeof(uint32_t));
+					if (NETisCorrectVersion(wz_ntohl(sentMajor), wz_ntohl(sentMinor)))
+					{
+						initialConnectSize = 12;
+					}
+				}
+
+				const auto sizeReadResult = tmp_socket[i]->readNoInt(p_buffer + tmp_connectState[i].usedBuffer, initialConnectSize - tmp_connectState[i].usedBuffer, nullptr);
 				if (sizeReadResult.has_value())
 				{
 					tmp_connectState[i].usedBuffer += sizeReadResult.value();
@@ -3820,14 +3844,24 @@ static void NETallowJoining()
 					}
 					else if (NETisCorrectVersion(major, minor))
 					{
-						result = wz_htonl(ERROR_NOERROR);
-						memcpy(&tmp_connectState[i].buffer, &result, sizeof(result));
-						const auto writeResult = tmp_socket[i]->writeAll(&tmp_connectState[i].buffer, sizeof(result), nullptr);
+						if (tmp_connectState[i].usedBuffer < 12)
+						{
+							// Continue to wait (until timeout) for the compression methods supported by the client
+							continue;
+						}
+						uint32_t clientCompressionMethods = 0;
+						memcpy(&clientCompressionMethods, tmp_connectState[i].buffer + 8, sizeof(uint32_t));
+						const auto compressionMethod = WzCompressionProvider::Instance().negotiateMethod(wz_ntohl(clientCompressionMethods));
+
+						// Reply with ERROR_NOERROR, followed by the compression method to use from now on.
+						uint32_t reply[2] = { wz_htonl(ERROR_NOERROR), wz_htonl(static_cast<uint32_t>(compressionMethod)) };
+						memcpy(&tmp_connectState[i].buffer, reply, sizeof(reply));
+						const auto writeResult = tmp_socket[i]->writeAll(&tmp_connectState[i].buffer, sizeof(reply), nullptr);
 						if (!writeResult.has_value())
 						{
 							debug(LOG_NET, "writeAll to tmpSocket[%u] failed with error?: %d", i, writeResult.error().value());
 						}
-						tmp_socket[i]->enableCompression();
+						tmp_socket[i]->enableCompression(compressionMethod);
 
 						// Connection is successful.
 						connectFailed = false;
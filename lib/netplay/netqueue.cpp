@@ -28,6 +28,7 @@
 #include <limits>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 
 // See comments in netqueue.h.
 
@@ -239,6 +240,11 @@ std::vector<std::vector<uint8_t>> NetQueue::snapshotUnreadMessages() const
 	return out;
 }
 
+size_t NetQueue::numUnreadMessages() const
+{
+	return std::distance(messages.begin(), List::const_iterator(messagePos));
+}
+
 void NetQueue::setWillNeverGetMessagesForNet()
 {
 	canGetMessagesForNet = false;
@@ -287,6 +287,7 @@ public:
 	/// into a disk savegame (where there is no host relay to re-feed in-flight commands on restore).
 	/// Restore by pushMessage()ing the captured messages back, in the returned order, into a fresh queue.
 	std::vector<std::vector<uint8_t>> snapshotUnreadMessages() const;
+	size_t numUnreadMessages() const;                                  ///< Number of messages not yet popped.
 
 	inline size_t numPendingGameTimeUpdateMessages() const
 	{
@@ -41,6 +41,8 @@
 #  pragma GCC diagnostic pop
 #endif
 
+#include <zlib.h>
+
 #include <ctime>
 #include <memory>
 
@@ -51,17 +53,75 @@ static PHYSFS_file *replaySaveHandle = nullptr;
 static PHYSFS_file *replayLoadHandle = nullptr;
 
 static const uint32_t magicReplayNumber = 0x575A7270;  // "WZrp"
-static const uint32_t currentReplayFormatVer = 3;
+static const uint32_t currentReplayFormatVer = 4;
 static const uint32_t minReplayFormatVerSupported = 3;
 static const size_t DefaultReplayBufferSize = 32768;
 static const size_t MaxReplayBufferSize = 2 * 1024 * 1024;
 
+// v4: GameState keyframes are embedded in the message stream. A keyframe record has this in place of
+// the player index (which is always < MAX_GAMEQUEUE_SLOTS), followed by:
+// [gameTime u32][GameState size u32][compressed size u32][zlib-compressed GameState JSON]
+static const uint8_t replayKeyframeMarker = 0xFF;
+static const uint32_t ReplayKeyframeInterval = 60 * GAME_TICKS_PER_SEC;
+static const uint32_t MaxReplayKeyframeSize = 256 * 1024 * 1024;
+
 typedef std::vector<uint8_t> SerializedNetMessagesBuffer;
-static moodycamel::BlockingReaderWriterQueue<SerializedNetMessagesBuffer> serializedBufferWriteQueue(256);
+
+struct ReplaySaveChunk
+{
+	SerializedNetMessagesBuffer messages;  ///< Serialized net messages, written as they are
+	std::string keyframeGameState;         ///< Or a GameState, compressed and written as a keyframe record
+	uint32_t keyframeGameTime = 0;
+	bool isKeyframe = false;
+};
+
+static moodycamel::BlockingReaderWriterQueue<ReplaySaveChunk> serializedBufferWriteQueue(256);
 static nlohmann::json queuedSaveSettings;
 static SerializedNetMessagesBuffer latestWriteBuffer;
 static size_t minBufferSizeToQueue = DefaultReplayBufferSize;
 static WZ_THREAD *saveThread = nullptr;
+static uint32_t nextKeyframeGameTime = 0;
+static std::vector<ReplayKeyframeInfo> savedKeyframes;  // only touched by the writing thread until it is joined
+
+// Set while a keyframed copy of the replay being played is written (see NETreplayReindexStart)
+static std::string reindexSourceFilename;
+static std::string reindexTempFilename;
+
+static uint32_t replayLoadFormatVer = 0;
+
+static void enqueueLatestWriteBuffer()
+{
+	ReplaySaveChunk chunk;
+	chunk.messages = std::move(latestWriteBuffer);
+	serializedBufferWriteQueue.enqueue(std::move(chunk));
+	latestWriteBuffer = SerializedNetMessagesBuffer();
+	latestWriteBuffer.reserve(minBufferSizeToQueue);
+}
+
+static bool writeKeyframeRecord(PHYSFS_file *pSaveHandle, uint32_t keyframeGameTime, const std::string &gameState)
+{
+	PHYSFS_sint64 offset = PHYSFS_tell(pSaveHandle);
+	if (offset < 0 || gameState.size() > MaxReplayKeyframeSize)
+	{
+		return false;
+	}
+
+	uLongf compressedSize = compressBound(static_cast<uLong>(gameState.size()));
+	std::vector<uint8_t> compressed(compressedSize);
+	if (compress2(compressed.data(), &compressedSize, reinterpret_cast<const Bytef *>(gameState.data()), static_cast<uLong>(gameState.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		return false;
+	}
+
+	PHYSFS_writeUBE8(pSaveHandle, replayKeyframeMarker);
+	PHYSFS_writeUBE32(pSaveHandle, keyframeGameTime);
+	PHYSFS_writeUBE32(pSaveHandle, static_cast<uint32_t>(gameState.size()));
+	PHYSFS_writeUBE32(pSaveHandle, static_cast<uint32_t>(compressedSize));
+	WZ_PHYSFS_writeBytes(pSaveHandle, compressed.data(), static_cast<uint32_t>(compressedSize));
+
+	savedKeyframes.push_back(ReplayKeyframeInfo{keyframeGameTime, static_cast<uint64_t>(offset)});
+	return true;
+}
 
 // This function is run in its own thread! Do not call any non-threadsafe functions!
 static int replaySaveThreadFunc(void *data)
@@ -71,38 +131,32 @@ static int replaySaveThreadFunc(void *data)
 	{
 		return 1;
 	}
-	SerializedNetMessagesBuffer item;
+	ReplaySaveChunk item;
 	while (true)
 	{
 		serializedBufferWriteQueue.wait_dequeue(item);
-		if (item.empty())
+		if (item.isKeyframe)
+		{
+			// Compressing the GameState takes a while, which is why it is done here and not on the main thread
+			writeKeyframeRecord(pSaveHandle, item.keyframeGameTime, item.keyframeGameState);
+			continue;
+		}
+		if (item.messages.empty())
 		{
 			// end chunk - we're done
 			break;
 		}
-		WZ_PHYSFS_writeBytes(pSaveHandle, item.data(), item.size());
+		WZ_PHYSFS_writeBytes(pSaveHandle, item.messages.data(), item.messages.size());
 	}
 	return 0;
 }
 
-static bool NETreplaySaveWritePreamble(const nlohmann::json& settings, ReplayOptionsHandler const &optionsHandler)
+static bool NETreplaySaveWriteSettingsAndMap(const nlohmann::json& settings, ReplayOptionsHandler::EmbeddedMapData const &embeddedMapData)
 {
-	if (!replaySaveHandle)
-	{
-		return false;
-	}
-
 	auto data = settings.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
 	PHYSFS_writeUBE32(replaySaveHandle, data.size());
 	WZ_PHYSFS_writeBytes(replaySaveHandle, data.data(), data.size());
 
-	// Save extra map data (if present)
-	ReplayOptionsHandler::EmbeddedMapData embeddedMapData;
-	if (!optionsHandler.saveMap(embeddedMapData))
-	{
-		// Failed to save map data - just empty it out for now
-		embeddedMapData.mapBinaryData.clear();
-	}
 	PHYSFS_writeUBE32(replaySaveHandle, embeddedMapData.dataVersion);
 #if SIZE_MAX > UINT32_MAX
 	ASSERT_OR_RETURN(false, embeddedMapData.mapBinaryData.size() <= static_cast<size_t>(std::numeric_limits<uint32_t>::max()), "Embedded map data is way too big");
@@ -116,6 +170,23 @@ static bool NETreplaySaveWritePreamble(const nlohmann::json& settings, ReplayOpt
 	return true;
 }
 
+static bool NETreplaySaveWritePreamble(const nlohmann::json& settings, ReplayOptionsHandler const &optionsHandler)
+{
+	if (!replaySaveHandle)
+	{
+		return false;
+	}
+
+	// Save extra map data (if present)
+	ReplayOptionsHandler::EmbeddedMapData embeddedMapData;
+	if (!optionsHandler.saveMap(embeddedMapData))
+	{
+		// Failed to save map data - just empty it out for now
+		embeddedMapData.mapBinaryData.clear();
+	}
+	return NETreplaySaveWriteSettingsAndMap(settings, embeddedMapData);
+}
+
 std::string NETreplaySaveStart(std::string const& subdir, ReplayOptionsHandler const &optionsHandler, int maxReplaysSaved, bool appendPlayerToFilename)
 {
 	if (NETisReplay())
@@ -201,6 +272,8 @@ std::string NETreplaySaveStart(std::string const& subdir, ReplayOptionsHandler c
 	// Create a background thread and hand off all responsibility for writing to the file handle to it
 	ASSERT(saveThread == nullptr, "Failed to release prior thread");
 	latestWriteBuffer.reserve(minBufferSizeToQueue);
+	savedKeyframes.clear();
+	nextKeyframeGameTime = ReplayKeyframeInterval;
 	if (desiredBufferSize != std::numeric_limits<size_t>::max())
 	{
 		// Write the preamble immediately (settings, etc)
@@ -222,13 +295,8 @@ std::string NETreplaySaveStart(std::string const& subdir, ReplayOptionsHandler c
 	return filename;
 }
 
-bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
+static bool NETreplaySaveFinish(ReplayOptionsHandler const *optionsHandler)
 {
-	if (!replaySaveHandle)
-	{
-		return false;
-	}
-
 	// v2: Append the "REPLAY_ENDED" message (from hostPlayer)
 	auto replayEndedMessage = NetMessageBuilder(REPLAY_ENDED, 0).build();
 	latestWriteBuffer.push_back(NetPlay.hostPlayer);
@@ -237,12 +305,11 @@ bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
 	// Queue the last chunk for writing
 	if (!latestWriteBuffer.empty())
 	{
-		serializedBufferWriteQueue.enqueue(std::move(latestWriteBuffer));
+		enqueueLatestWriteBuffer();
 	}
 
 	// Then push one empty chunk to signify "we're done!"
-	latestWriteBuffer.resize(0);
-	serializedBufferWriteQueue.enqueue(std::move(latestWriteBuffer));
+	serializedBufferWriteQueue.enqueue(ReplaySaveChunk());
 
 	// Wait for writing thread to finish
 	if (saveThread)
@@ -252,11 +319,13 @@ bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
 	}
 	else
 	{
+		ASSERT_OR_RETURN(false, optionsHandler != nullptr, "Replay preamble was not written");
+
 		// update the queued settings (ex. might have revealed player identities in a blind game)
-		optionsHandler.optionsUpdatePlayerInfo(queuedSaveSettings.at("gameOptions"));
+		optionsHandler->optionsUpdatePlayerInfo(queuedSaveSettings.at("gameOptions"));
 
 		// write the preamble
-		NETreplaySaveWritePreamble(queuedSaveSettings, optionsHandler);
+		NETreplaySaveWritePreamble(queuedSaveSettings, *optionsHandler);
 
 		// do the writing now on the main thread
 		replaySaveThreadFunc(replaySaveHandle);
@@ -266,6 +335,13 @@ bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
 	// (this is JSON that is preceded *and* followed by its size - so it should be possible to seek to the end of the file, read the last uint32_t, and then back up and grab the JSON without processing the whole file)
 	nlohmann::json endOfGameInfo = nlohmann::json::object();
 	endOfGameInfo["gameTimeElapsed"] = gameTime;
+	// v4: The index of the keyframes, as [gameTime, file offset] pairs
+	nlohmann::json keyframeIndex = nlohmann::json::array();
+	for (const auto &keyframe : savedKeyframes)
+	{
+		keyframeIndex.push_back({keyframe.gameTime, keyframe.fileOffset});
+	}
+	endOfGameInfo["keyframes"] = std::move(keyframeIndex);
 	// FUTURE TODO: Could save things like the game results / winners + losers
 
 	auto data = endOfGameInfo.dump();
@@ -276,6 +352,7 @@ bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
 	if (!PHYSFS_close(replaySaveHandle))
 	{
 		debug(LOG_ERROR, "Could not close replay file: %s", WZ_PHYSFS_getLastError());
+		replaySaveHandle = nullptr;
 		return false;
 	}
 	replaySaveHandle = nullptr;
@@ -283,6 +360,23 @@ bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
 	return true;
 }
 
+bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler)
+{
+	if (!replaySaveHandle)
+	{
+		return false;
+	}
+
+	if (!reindexTempFilename.empty())
+	{
+		// The replay was left before its end, so the keyframed copy is incomplete
+		NETreplayReindexCancel();
+		return false;
+	}
+
+	return NETreplaySaveFinish(&optionsHandler);
+}
+
 void NETreplaySaveNetMessage(NetMessage const *message, uint8_t player)
 {
 	if (!replaySaveHandle)
@@ -290,6 +384,12 @@ void NETreplaySaveNetMessage(NetMessage const *message, uint8_t player)
 		return;
 	}
 
+	if (!reindexTempFilename.empty() && player >= MAX_PLAYERS && player != NetPlay.hostPlayer)
+	{
+		// Not part of the replay being re-indexed (see NETloadReplay) - the viewer's own messages
+		return;
+	}
+
 	if (message->type() > GAME_MIN_TYPE && message->type() < GAME_MAX_TYPE)
 	{
 		latestWriteBuffer.push_back(player);
@@ -297,13 +397,208 @@ void NETreplaySaveNetMessage(NetMessage const *message, uint8_t player)
 
 		if (latestWriteBuffer.size() >= minBufferSizeToQueue)
 		{
-			serializedBufferWriteQueue.enqueue(std::move(latestWriteBuffer));
-			latestWriteBuffer = std::vector<uint8_t>();
-			latestWriteBuffer.reserve(minBufferSizeToQueue);
+			enqueueLatestWriteBuffer();
 		}
 	}
 }
 
+bool NETreplaySaveWantsKeyframe(uint32_t atGameTime)
+{
+	// Without the writing thread, everything is kept in memory until the end - so don't add keyframes there
+	return replaySaveHandle != nullptr && saveThread != nullptr && atGameTime >= nextKeyframeGameTime;
+}
+
+void NETreplaySaveKeyframe(uint32_t atGameTime, std::string &&gameState)
+{
+	if (!replaySaveHandle)
+	{
+		return;
+	}
+
+	// Keep the stream order: the keyframe goes after the messages processed before it
+	if (!latestWriteBuffer.empty())
+	{
+		enqueueLatestWriteBuffer();
+	}
+
+	ReplaySaveChunk chunk;
+	chunk.keyframeGameState = std::move(gameState);
+	chunk.keyframeGameTime = atGameTime;
+	chunk.isKeyframe = true;
+	serializedBufferWriteQueue.enqueue(std::move(chunk));
+
+	nextKeyframeGameTime = atGameTime + ReplayKeyframeInterval;
+}
+
+static bool copyReplayFile(std::string const &fromFilename, std::string const &toFilename)
+{
+	PHYSFS_file *fromHandle = PHYSFS_openRead(fromFilename.c_str());
+	if (fromHandle == nullptr)
+	{
+		return false;
+	}
+	PHYSFS_file *toHandle = PHYSFS_openWrite(toFilename.c_str());
+	if (toHandle == nullptr)
+	{
+		PHYSFS_close(fromHandle);
+		return false;
+	}
+
+	bool result = true;
+	std::vector<uint8_t> buffer(64 * 1024);
+	PHYSFS_sint64 bytesRead = 0;
+	while ((bytesRead = WZ_PHYSFS_readBytes(fromHandle, buffer.data(), static_cast<PHYSFS_uint32>(buffer.size()))) > 0)
+	{
+		if (WZ_PHYSFS_writeBytes(toHandle, buffer.data(), static_cast<PHYSFS_uint32>(bytesRead)) != bytesRead)
+		{
+			result = false;
+			break;
+		}
+	}
+	result = result && bytesRead == 0;
+
+	PHYSFS_close(fromHandle);
+	return PHYSFS_close(toHandle) != 0 && result;
+}
+
+bool NETreplayReindexStart(std::string const &filename)
+{
+	ASSERT_OR_RETURN(false, replaySaveHandle == nullptr, "Already writing a replay");
+
+	PHYSFS_file *sourceHandle = PHYSFS_openRead(filename.c_str());
+	if (sourceHandle == nullptr)
+	{
+		debug(LOG_ERROR, "Could not open replay file %s: %s", filename.c_str(), WZ_PHYSFS_getLastError());
+		return false;
+	}
+
+	// Copy the preamble, only bumping the format version
+	int32_t replayNumber = 0;
+	uint32_t dataSize = 0;
+	std::string data;
+	ReplayOptionsHandler::EmbeddedMapData embeddedMapData;
+	uint32_t binaryDataSize = 0;
+	bool readHeader = PHYSFS_readSBE32(sourceHandle, &replayNumber) && (uint32_t)replayNumber == magicReplayNumber
+		&& PHYSFS_readUBE32(sourceHandle, &dataSize);
+	if (readHeader)
+	{
+		data.resize(dataSize);
+		readHeader = WZ_PHYSFS_readBytes(sourceHandle, &data[0], dataSize) == dataSize
+			&& PHYSFS_readUBE32(sourceHandle, &embeddedMapData.dataVersion)
+			&& PHYSFS_readUBE32(sourceHandle, &binaryDataSize);
+	}
+	if (readHeader)
+	{
+		embeddedMapData.mapBinaryData.resize(binaryDataSize);
+		readHeader = WZ_PHYSFS_readBytes(sourceHandle, embeddedMapData.mapBinaryData.data(), binaryDataSize) == binaryDataSize;
+	}
+	PHYSFS_close(sourceHandle);
+
+	nlohmann::json settings;
+	try
+	{
+		settings = readHeader ? nlohmann::json::parse(data) : nlohmann::json();
+		readHeader = readHeader && settings.at("replayFormatVer").get<uint32_t>() >= 2;
+	}
+	catch (const std::exception&)
+	{
+		readHeader = false;
+	}
+	if (!readHeader)
+	{
+		debug(LOG_ERROR, "Could not re-index replay file %s: bad header", filename.c_str());
+		return false;
+	}
+	settings["replayFormatVer"] = currentReplayFormatVer;
+
+	std::string tempFilename = filename + ".reindex";
+	replaySaveHandle = PHYSFS_openWrite(tempFilename.c_str());
+	if (replaySaveHandle == nullptr)
+	{
+		debug(LOG_ERROR, "Could not create replay file %s: %s", tempFilename.c_str(), WZ_PHYSFS_getLastError());
+		return false;
+	}
+	WZ_PHYSFS_SETBUFFER(replaySaveHandle, 1024 * 32)//;
+
+	PHYSFS_writeSBE32(replaySaveHandle, magicReplayNumber);
+	NETreplaySaveWriteSettingsAndMap(settings, embeddedMapData);
+
+	reindexSourceFilename = filename;
+	reindexTempFilename = std::move(tempFilename);
+	minBufferSizeToQueue = DefaultReplayBufferSize;
+	latestWriteBuffer.reserve(minBufferSizeToQueue);
+	savedKeyframes.clear();
+	nextKeyframeGameTime = ReplayKeyframeInterval;
+
+	ASSERT(saveThread == nullptr, "Failed to release prior thread");
+	saveThread = wzThreadCreate(replaySaveThreadFunc, replaySaveHandle, "replaySaveThread");
+	wzThreadStart(saveThread);
+
+	debug(LOG_INFO, "Started adding keyframes to replay file \"%s\".", filename.c_str());
+	return true;
+}
+
+bool NETreplayReindexActive()
+{
+	return !reindexTempFilename.empty();
+}
+
+bool NETreplayReindexFinish()
+{
+	if (reindexTempFilename.empty() || !replaySaveHandle)
+	{
+		return false;
+	}
+
+	std::string sourceFilename = std::move(reindexSourceFilename);
+	std::string tempFilename = std::move(reindexTempFilename);
+	reindexSourceFilename.clear();
+	reindexTempFilename.clear();
+
+	bool result = NETreplaySaveFinish(nullptr);
+	// PhysFS can't rename files, so the keyframed copy is copied over the original
+	result = result && copyReplayFile(tempFilename, sourceFilename);
+	if (PHYSFS_delete(tempFilename.c_str()) == 0)
+	{
+		debug(LOG_ERROR, "Failed to delete temporary replay file: %s", tempFilename.c_str());
+	}
+
+	if (!result)
+	{
+		debug(LOG_ERROR, "Could not add keyframes to replay file %s: %s", sourceFilename.c_str(), WZ_PHYSFS_getLastError());
+		return false;
+	}
+	debug(LOG_INFO, "Added %zu keyframes to replay file \"%s\".", savedKeyframes.size(), sourceFilename.c_str());
+	return true;
+}
+
+void NETreplayReindexCancel()
+{
+	if (reindexTempFilename.empty())
+	{
+		return;
+	}
+
+	// Let the writing thread finish, then throw away what it wrote
+	latestWriteBuffer.clear();
+	serializedBufferWriteQueue.enqueue(ReplaySaveChunk());
+	if (saveThread)
+	{
+		wzThreadJoin(saveThread);
+		saveThread = nullptr;
+	}
+	PHYSFS_close(replaySaveHandle);
+	replaySaveHandle = nullptr;
+	if (PHYSFS_delete(reindexTempFilename.c_str()) == 0)
+	{
+		debug(LOG_ERROR, "Failed to delete temporary replay file: %s", reindexTempFilename.c_str());
+	}
+
+	debug(LOG_INFO, "Stopped adding keyframes to replay file \"%s\".", reindexSourceFilename.c_str());
+	reindexSourceFilename.clear();
+	reindexTempFilename.clear();
+}
+
 bool NETreplayLoadStart(std::string const &filename, ReplayOptionsHandler& optionsHandler, uint32_t& output_replayFormatVer)
 {
 	auto onFail = [&](char const *reason) {
@@ -346,6 +641,7 @@ bool NETreplayLoadStart(std::string const &filename, ReplayOptionsHandler& optio
 
 		uint32_t replayFormatVer = settings.at("replayFormatVer").get<uint32_t>();
 		output_replayFormatVer = replayFormatVer;
+		replayLoadFormatVer = replayFormatVer;
 		if (replayFormatVer > currentReplayFormatVer)
 		{
 			std::string mismatchVersionDescription = _("The replay file format is newer than this version of Warzone 2100 can support.");
@@ -428,7 +724,16 @@ bool NETreplayLoadStart(std::string const &filename, ReplayOptionsHandler& optio
 	return true;
 }
 
-bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &player)
+static bool readKeyframeRecordHeader(PHYSFS_file *handle, uint32_t &keyframeGameTime, uint32_t &gameStateSize, uint32_t &compressedSize)
+{
+	return PHYSFS_readUBE32(handle, &keyframeGameTime)
+		&& PHYSFS_readUBE32(handle, &gameStateSize)
+		&& PHYSFS_readUBE32(handle, &compressedSize)
+		&& gameStateSize <= MaxReplayKeyframeSize
+		&& compressedSize <= compressBound(gameStateSize);
+}
+
+bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &player, std::vector<ReplayKeyframeInfo> *keyframesPassed)
 {
 	if (!replayLoadHandle)
 	{
@@ -437,6 +742,23 @@ bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &play
 
 	WZ_PHYSFS_readBytes(replayLoadHandle, &player, 1);
 
+	while (player == replayKeyframeMarker && replayLoadFormatVer >= 4)
+	{
+		// v4: Skip over the keyframe, only noting where it is
+		PHYSFS_sint64 offset = PHYSFS_tell(replayLoadHandle) - 1;
+		uint32_t keyframeGameTime = 0, gameStateSize = 0, compressedSize = 0;
+		if (offset < 0 || !readKeyframeRecordHeader(replayLoadHandle, keyframeGameTime, gameStateSize, compressedSize)
+			|| PHYSFS_seek(replayLoadHandle, PHYSFS_tell(replayLoadHandle) + compressedSize) == 0)
+		{
+			return false;
+		}
+		if (keyframesPassed)
+		{
+			keyframesPassed->push_back(ReplayKeyframeInfo{keyframeGameTime, static_cast<uint64_t>(offset)});
+		}
+		WZ_PHYSFS_readBytes(replayLoadHandle, &player, 1);
+	}
+
 	uint8_t type;
 	WZ_PHYSFS_readBytes(replayLoadHandle, &type, 1);
 
@@ -466,6 +788,94 @@ bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &play
 	return (message->type() > GAME_MIN_TYPE && message->type() < GAME_MAX_TYPE) || message->type() == REPLAY_ENDED;
 }
 
+bool NETreplayLoadKeyframe(std::string const &filename, ReplayKeyframeInfo const &keyframe, std::string &output_gameState)
+{
+	PHYSFS_file *handle = PHYSFS_openRead(filename.c_str());
+	if (handle == nullptr)
+	{
+		debug(LOG_ERROR, "Could not open replay file %s: %s", filename.c_str(), WZ_PHYSFS_getLastError());
+		return false;
+	}
+
+	uint8_t marker = 0;
+	uint32_t keyframeGameTime = 0, gameStateSize = 0, compressedSize = 0;
+	std::vector<uint8_t> compressed;
+	bool result = PHYSFS_seek(handle, keyframe.fileOffset) != 0
+		&& PHYSFS_readUBE8(handle, &marker) && marker == replayKeyframeMarker
+		&& readKeyframeRecordHeader(handle, keyframeGameTime, gameStateSize, compressedSize)
+		&& keyframeGameTime == keyframe.gameTime;
+	if (result)
+	{
+		compressed.resize(compressedSize);
+		result = WZ_PHYSFS_readBytes(handle, compressed.data(), compressedSize) == compressedSize;
+	}
+	PHYSFS_close(handle);
+
+	if (result)
+	{
+		output_gameState.resize(gameStateSize);
+		uLongf uncompressedSize = gameStateSize;
+		result = uncompress(reinterpret_cast<Bytef *>(&output_gameState[0]), &uncompressedSize, compressed.data(), compressedSize) == Z_OK
+			&& uncompressedSize == gameStateSize;
+	}
+	if (!result)
+	{
+		debug(LOG_ERROR, "Could not load the keyframe at %" PRIu32 " from replay file %s", keyframe.gameTime, filename.c_str());
+		output_gameState.clear();
+	}
+	return result;
+}
+
+bool NETreplayReadKeyframeIndex(std::string const &filename, std::vector<ReplayKeyframeInfo> &output_keyframes)
+{
+	output_keyframes.clear();
+
+	PHYSFS_file *handle = PHYSFS_openRead(filename.c_str());
+	if (handle == nullptr)
+	{
+		return false;
+	}
+
+	// The "end of game info" chunk is followed by its size, so it can be read from the end of the file
+	std::string data;
+	uint32_t dataSize = 0;
+	PHYSFS_sint64 fileLength = PHYSFS_fileLength(handle);
+	bool result = fileLength >= 8
+		&& PHYSFS_seek(handle, fileLength - 4) != 0
+		&& PHYSFS_readUBE32(handle, &dataSize)
+		&& static_cast<PHYSFS_sint64>(dataSize) + 8 <= fileLength
+		&& PHYSFS_seek(handle, fileLength - 4 - dataSize) != 0;
+	if (result)
+	{
+		data.resize(dataSize);
+		result = WZ_PHYSFS_readBytes(handle, &data[0], dataSize) == dataSize;
+	}
+	PHYSFS_close(handle);
+	if (!result)
+	{
+		return false;
+	}
+
+	try
+	{
+		nlohmann::json endOfGameInfo = nlohmann::json::parse(data);
+		if (!endOfGameInfo.contains("keyframes"))
+		{
+			return false;
+		}
+		for (const auto &entry : endOfGameInfo.at("keyframes"))
+		{
+			output_keyframes.push_back(ReplayKeyframeInfo{entry.at(0).get<uint32_t>(), entry.at(1).get<uint64_t>()});
+		}
+	}
+	catch (const std::exception&)
+	{
+		output_keyframes.clear();
+		return false;
+	}
+	return true;
+}
+
 bool NETreplayLoadStop()
 {
 	if (!replayLoadHandle)
@@ -25,12 +25,33 @@
 #include "netplay.h"
 
 
+#include <string>
+#include <vector>
+
+/// A GameState snapshot embedded in a replay (v4+), taken at the end of the game tick at `gameTime`.
+struct ReplayKeyframeInfo
+{
+	uint32_t gameTime = 0;
+	uint64_t fileOffset = 0;  ///< Where the keyframe record starts in the replay file
+};
+
 std::string NETreplaySaveStart(std::string const& subdir, ReplayOptionsHandler const &optionsHandler, int maxReplaysSaved, bool appendPlayerToFilename = false);
 bool NETreplaySaveStop(ReplayOptionsHandler const &optionsHandler);
 void NETreplaySaveNetMessage(NetMessage const *message, uint8_t player);
+bool NETreplaySaveWantsKeyframe(uint32_t atGameTime);                       ///< True if a keyframe should be added to the replay being written, at the end of this tick.
+void NETreplaySaveKeyframe(uint32_t atGameTime, std::string &&gameState);  ///< Adds a keyframe after the messages saved so far. It is compressed and written on the replay writing thread.
 
 bool NETreplayLoadStart(std::string const &filename, ReplayOptionsHandler& optionsHandler, uint32_t& output_replayFormatVer);
-bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &player);
+bool NETreplayLoadNetMessage(std::unique_ptr<NetMessage> &message, uint8_t &player, std::vector<ReplayKeyframeInfo> *keyframesPassed = nullptr);  ///< Keyframes in front of the message are skipped, and appended to keyframesPassed.
 bool NETreplayLoadStop();
+bool NETreplayLoadKeyframe(std::string const &filename, ReplayKeyframeInfo const &keyframe, std::string &output_gameState);
+bool NETreplayReadKeyframeIndex(std::string const &filename, std::vector<ReplayKeyframeInfo> &output_keyframes);  ///< Reads the index at the end of the file. False for replays from before keyframes were added.
+
+// Re-indexing: while a replay without keyframes is played, a copy of it with keyframes is written.
+// Once the replay reaches its end, the copy replaces the original.
+bool NETreplayReindexStart(std::string const &filename);
+bool NETreplayReindexActive();
+bool NETreplayReindexFinish();
+void NETreplayReindexCancel();
 
 #endif // _NETREPLAY_H
@@ -45,6 +45,7 @@
 #include <cstring>
 #include <limits>
 #include <array>
+#include <algorithm>
 
 /// There is a game queue representing each player. The game queues are synchronised among all players, so that all players process the same game queue
 /// messages at the same game time. The game queues should be used, even in single-player. Players should write to their own queue, not to other player's
@@ -66,6 +67,16 @@ static std::array<std::unique_ptr<SessionKeys>, MAX_CONNECTED_PLAYERS> netSessio
 
 static bool bIsReplay = false;
 
+/// Where a keyframe of the loaded replay sits in the game queues: how many messages were queued before it, per queue.
+struct ReplaySeekPoint
+{
+	ReplayKeyframeInfo keyframe;
+	std::array<uint32_t, MAX_GAMEQUEUE_SLOTS> messagesBefore;
+};
+static std::string replayFilename;
+static std::vector<ReplaySeekPoint> replaySeekPoints;
+static std::array<uint32_t, MAX_GAMEQUEUE_SLOTS> replayMessagesQueued;
+
 static size_t numInvalidMessageReads = 0;
 
 // Queue selection functions
@@ -637,8 +648,16 @@ bool NETloadReplay(std::string const &filename, ReplayOptionsHandler& optionsHan
 	std::unique_ptr<NetMessage> newMessage;
 	uint8_t player;
 	bool gotReplayEnded = false;
-	while (NETreplayLoadNetMessage(newMessage, player))
+	std::vector<ReplayKeyframeInfo> keyframesPassed;
+	replaySeekPoints.clear();
+	replayMessagesQueued.fill(0);
+	while (NETreplayLoadNetMessage(newMessage, player, &keyframesPassed))
 	{
+		for (const auto &keyframe : keyframesPassed)
+		{
+			replaySeekPoints.push_back(ReplaySeekPoint{keyframe, replayMessagesQueued});
+		}
+		keyframesPassed.clear();
 		if ((player >= MAX_PLAYERS && player != NetPlay.hostPlayer) || gameQueues[player] == nullptr)
 		{
 			debug((newMessage->type() != GAME_GAME_TIME) ? LOG_ERROR : LOG_INFO, "Skipping message to player %d in replay.", player);
@@ -650,6 +669,7 @@ bool NETloadReplay(std::string const &filename, ReplayOptionsHandler& optionsHan
 			break;
 		}
 		gameQueues[player]->pushMessage(std::move(*newMessage));
+		++replayMessagesQueued[player];
 	}
 	if (!gotReplayEnded && replayFormatVer >= 2)
 	{
@@ -660,11 +680,66 @@ bool NETloadReplay(std::string const &filename, ReplayOptionsHandler& optionsHan
 	}
 	// Add special REPLAY_ENDED message to the end of the host's gameQueue
 	gameQueues[NetPlay.hostPlayer]->pushMessage(NetMessageBuilder(REPLAY_ENDED, 0).build());
+	++replayMessagesQueued[NetPlay.hostPlayer];
 	NETreplayLoadStop();
+	replayFilename = filename;
 	bIsReplay = true;
 	return true;
 }
 
+const std::string &NETreplayFilename()
+{
+	return replayFilename;
+}
+
+size_t NETreplayNumKeyframes()
+{
+	return replaySeekPoints.size();
+}
+
+bool NETreplayLoadKeyframeBefore(uint32_t targetGameTime, uint32_t currentGameTime, uint32_t &keyframeGameTime, std::string &gameState)
+{
+	ASSERT_OR_RETURN(false, bIsReplay, "Not playing a replay");
+
+	// The messages before the current game time are gone, so only keyframes ahead of it can be used
+	auto it = std::find_if(replaySeekPoints.rbegin(), replaySeekPoints.rend(), [targetGameTime](const ReplaySeekPoint &point) {
+		return point.keyframe.gameTime <= targetGameTime;
+	});
+	if (it == replaySeekPoints.rend() || it->keyframe.gameTime <= currentGameTime)
+	{
+		return false;
+	}
+	keyframeGameTime = it->keyframe.gameTime;
+	return NETreplayLoadKeyframe(replayFilename, it->keyframe, gameState);
+}
+
+bool NETreplaySkipToKeyframe(uint32_t keyframeGameTime)
+{
+	ASSERT_OR_RETURN(false, bIsReplay, "Not playing a replay");
+
+	auto it = std::find_if(replaySeekPoints.begin(), replaySeekPoints.end(), [keyframeGameTime](const ReplaySeekPoint &point) {
+		return point.keyframe.gameTime == keyframeGameTime;
+	});
+	ASSERT_OR_RETURN(false, it != replaySeekPoints.end(), "No keyframe at %" PRIu32, keyframeGameTime);
+
+	// Drop the messages which were processed before the keyframe was taken
+	for (unsigned player = 0; player < MAX_GAMEQUEUE_SLOTS; ++player)
+	{
+		NetQueue *queue = gameQueues[player];
+		if (queue == nullptr)
+		{
+			continue;
+		}
+		size_t processed = replayMessagesQueued[player] - queue->numUnreadMessages();
+		ASSERT_OR_RETURN(false, processed <= it->messagesBefore[player], "Keyframe is behind the replay for player %u", player);
+		for (; processed < it->messagesBefore[player]; ++processed)
+		{
+			queue->popMessage();
+		}
+	}
+	return true;
+}
+
 bool NETisReplay()
 {
 	return bIsReplay;
@@ -680,6 +755,8 @@ void NETshutdownReplay()
 	}
 
 	bIsReplay = false;
+	replayFilename.clear();
+	replaySeekPoints.clear();
 }
 
 // New overloads implementation
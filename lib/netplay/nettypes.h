@@ -219,6 +219,12 @@ public:
 bool NETloadReplay(std::string const &filename, ReplayOptionsHandler& optionsHandler);
 bool NETisReplay();
 void NETshutdownReplay();
+const std::string &NETreplayFilename();
+size_t NETreplayNumKeyframes();
+/// Loads the GameState of the last keyframe at or before targetGameTime, if it is ahead of currentGameTime.
+bool NETreplayLoadKeyframeBefore(uint32_t targetGameTime, uint32_t currentGameTime, uint32_t &keyframeGameTime, std::string &gameState);
+/// Drops the replay messages that had been processed when the keyframe was taken. Call after restoring its GameState.
+bool NETreplaySkipToKeyframe(uint32_t keyframeGameTime);
 
 bool NETgameIsBehindPlayersByAtLeast(size_t numGameTimeUpdates = 2);
 
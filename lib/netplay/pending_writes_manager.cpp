@@ -182,8 +182,8 @@ void PendingWritesManager::threadImplFunction()
 				const auto retSent = conn->sendImpl(writeQueue);
 				if (retSent.has_value())
 				{
-					// Erase as much data as written.
-					writeQueue.erase(writeQueue.begin(), writeQueue.begin() + retSent.value());
+					// Drop as much data as written.
+					writeQueue.consume(retSent.value());
 					if (writeQueue.empty())
 					{
 						pendingWrites_.erase(currentIt);  // Nothing left to write, delete from pending list.
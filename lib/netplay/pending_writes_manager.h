@@ -29,6 +29,7 @@
 
 #include "lib/framework/wzapp.h"
 #include "lib/netplay/net_result.h"
+#include "lib/netplay/write_queue.h"
 
 struct WZ_THREAD;
 struct WZ_MUTEX;
@@ -67,7 +68,7 @@ class PendingWritesManager
 {
 public:
 
-	using ConnectionWriteQueue = std::vector<uint8_t>;
+	using ConnectionWriteQueue = WriteQueue;
 
 	~PendingWritesManager();
 
@@ -40,7 +40,7 @@ void resetDescriptorSet(const std::vector<IClientConnection*>& conns, IDescripto
 } // anonymous namespace
 
 net::result<int> checkConnectionsReadable(const std::vector<IClientConnection*>& conns,
-	IDescriptorSet& readableSet, std::chrono::milliseconds timeout)
+	IDescriptorSet& readableSet, std::chrono::milliseconds timeout, bool resetSet)
 {
 	if (conns.empty())
 	{
@@ -69,7 +69,10 @@ net::result<int> checkConnectionsReadable(const std::vector<IClientConnection*>&
 		return conns.size();
 	}
 
-	resetDescriptorSet(conns, readableSet);
+	if (resetSet)
+	{
+		resetDescriptorSet(conns, readableSet);
+	}
 	const auto pollRes = readableSet.poll(timeout);
 	if (!pollRes.has_value())
 	{
@@ -38,7 +38,9 @@ class IDescriptorSet;
 /// <param name="readableSet">`IDescriptorSet` instance, which may have some of
 /// the descriptors being "set" for read-readiness after internal polling call completes.</param>
 /// <param name="timeout">Timeout in milliseconds.</param>
+/// <param name="resetSet">Whether to fill `readableSet` with `conns` before polling. Pass `false`
+/// if the caller keeps `readableSet` holding exactly `conns` itself.</param>
 /// <returns>On success, returns the number of connections being "set" to "ready to read" state.
 /// On failure, an `std::error_code` describing the error will be returned.</returns>
 net::result<int> checkConnectionsReadable(const std::vector<IClientConnection*>& conns,
-	IDescriptorSet& readableSet, std::chrono::milliseconds timeout);
+	IDescriptorSet& readableSet, std::chrono::milliseconds timeout, bool resetSet = true);
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include "lib/framework/frame.h" // for ASSERT
+
+#if defined(WZ_OS_LINUX)
+
+#include "lib/netplay/descriptor_set.h"
+#include "lib/netplay/tcp/epoll_fd_set.h"
+#include "lib/netplay/tcp/netsocket.h"
+#include "lib/netplay/tcp/tcp_client_connection.h"
+
+#include "lib/netplay/error_categories.h"
+#include "lib/netplay/tcp/sock_error.h"
+
+namespace tcp
+{
+
+/// <summary>
+/// Descriptor set interface specialization using the Linux `epoll` API for actual polling.
+///
+/// Unlike `PollDescriptorSet`, the descriptors stay registered with the kernel between polls, so this
+/// only pays off when the set is kept up to date with `add()` / `remove()` instead of being rebuilt
+/// before every poll, as `TCPConnectionPollGroup` does.
+/// </summary>
+/// <typeparam name="EventType">Type of updates (readable/writable sockets) to poll for.</typeparam>
+template <PollEventType EventType>
+class EpollDescriptorSet : public IDescriptorSet
+{
+public:
+
+	explicit EpollDescriptorSet()
+		: fds_(EventType == PollEventType::READABLE ? EPOLLIN : EPOLLOUT)
+	{}
+
+	/// False if the `epoll` instance could not be created, see `TCPConnectionPollGroup`.
+	bool valid() const
+	{
+		return fds_.valid();
+	}
+
+	virtual bool add(IClientConnection* conn) override
+	{
+		TCPClientConnection* tcpConn = dynamic_cast<TCPClientConnection*>(conn);
+		ASSERT_OR_RETURN(false, tcpConn, "Invalid connection type: expected TCPClientConnection");
+		ASSERT_OR_RETURN(false, tcpConn->isValid(), "Connection object is not valid: socket is not opened");
+
+		const auto fd = tcpConn->getRawSocketFd();
+		ASSERT_OR_RETURN(false, fds_.add(conn, fd), "Failed to add connection to the descriptor set: fd=%d", fd);
+		return true;
+	}
+
+	virtual bool remove(IClientConnection* conn) override
+	{
+		TCPClientConnection* tcpConn = dynamic_cast<TCPClientConnection*>(conn);
+		ASSERT_OR_RETURN(false, tcpConn, "Invalid connection type: expected TCPClientConnection");
+
+		fds_.remove(conn, tcpConn->getRawSocketFd());
+		return true;
+	}
+
+	virtual void clear() override
+	{
+		fds_.clear();
+	}
+
+	virtual net::result<int> poll(std::chrono::milliseconds timeout) override
+	{
+		int ret;
+		int sockErr = 0;
+		do
+		{
+			ret = fds_.poll(static_cast<int>(timeout.count()));
+			if (ret == SOCKET_ERROR)
+			{
+				sockErr = getSockErr();
+			}
+		} while (ret == SOCKET_ERROR && (sockErr == EINTR || sockErr == EAGAIN));
+
+		if (ret == SOCKET_ERROR)
+		{
+			return tl::make_unexpected(make_network_error_code(sockErr));
+		}
+
+		return ret;
+	}
+
+	virtual ::tl::expected<bool, ErroredState> isSet(const IClientConnection* conn) const override
+	{
+		const TCPClientConnection* tcpConn = dynamic_cast<const TCPClientConnection*>(conn);
+		ASSERT_OR_RETURN(tl::make_unexpected(ErroredState::InvalidConn), tcpConn, "Invalid connection type: expected TCPClientConnection");
+
+		constexpr uint32_t evt = EventType == PollEventType::READABLE ? EPOLLIN : EPOLLOUT;
+
+		const uint32_t revents = fds_.readyEvents(conn);
+		if (revents & evt)
+		{
+			return true;
+		}
+
+		if (revents & EPOLLERR)
+		{
+			return tl::make_unexpected(ErroredState::Error);
+		}
+
+		if (revents & EPOLLHUP)
+		{
+			return tl::make_unexpected(ErroredState::HangUp);
+		}
+
+		return false;
+	}
+
+	virtual bool empty() const override
+	{
+		return fds_.size() == 0;
+	}
+
+private:
+
+	EpollFdSet fds_;
+};
+
+} // namespace tcp
+
+#endif // defined(WZ_OS_LINUX)
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "lib/netplay/tcp/epoll_fd_set.h"
+
+#if defined(__linux__)
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace tcp
+{
+
+EpollFdSet::EpollFdSet(uint32_t events)
+	: epollFd_(::epoll_create1(EPOLL_CLOEXEC)),
+	events_(events)
+{}
+
+EpollFdSet::~EpollFdSet()
+{
+	if (epollFd_ >= 0)
+	{
+		::close(epollFd_);
+	}
+}
+
+bool EpollFdSet::add(const void* tag, int fd)
+{
+	if (epollFd_ < 0 || fd < 0)
+	{
+		return false;
+	}
+	auto it = entries_.find(tag);
+	if (it != entries_.end() && it->second.fd == fd)
+	{
+		return false;
+	}
+	auto& entry = it != entries_.end() ? it->second : entries_[tag];
+
+	epoll_event evt = {};
+	evt.events = events_;
+	evt.data.ptr = &entry;
+	if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &evt) != 0)
+	{
+		if (it == entries_.end())
+		{
+			entries_.erase(tag);
+		}
+		return false;
+	}
+	entry.fd = fd;
+	entry.polled = 0;
+	return true;
+}
+
+void EpollFdSet::remove(const void* tag, int currentFd)
+{
+	auto it = entries_.find(tag);
+	if (it == entries_.end())
+	{
+		return;
+	}
+	if (it->second.fd == currentFd)
+	{
+		::epoll_ctl(epollFd_, EPOLL_CTL_DEL, currentFd, nullptr);
+	}
+	entries_.erase(it);
+}
+
+void EpollFdSet::clear()
+{
+	for (const auto& entry : entries_)
+	{
+		// Fails harmlessly for descriptors which were closed meanwhile.
+		::epoll_ctl(epollFd_, EPOLL_CTL_DEL, entry.second.fd, nullptr);
+	}
+	entries_.clear();
+}
+
+int EpollFdSet::poll(int timeoutMs)
+{
+	if (epollFd_ < 0)
+	{
+		errno = EBADF;
+		return -1;
+	}
+	ready_.resize(std::max<size_t>(entries_.size(), 1));
+	const int ret = ::epoll_wait(epollFd_, ready_.data(), static_cast<int>(ready_.size()), timeoutMs);
+	++pollCount_;
+	for (int i = 0; i < ret; ++i)
+	{
+		auto* entry = static_cast<Entry*>(ready_[i].data.ptr);
+		entry->events = ready_[i].events;
+		entry->polled = pollCount_;
+	}
+	return ret;
+}
+
+uint32_t EpollFdSet::readyEvents(const void* tag) const
+{
+	const auto it = entries_.find(tag);
+	if (it == entries_.end() || it->second.polled != pollCount_)
+	{
+		return 0;
+	}
+	return it->second.events;
+}
+
+} // namespace tcp
+
+#endif // defined(__linux__)
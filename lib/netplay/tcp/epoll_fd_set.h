@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace tcp
+{
+
+/// <summary>
+/// Set of socket descriptors polled with a single `epoll` instance, which keeps the registrations
+/// between polls, so that adding, removing and polling don't depend on how many descriptors
+/// there are, only on how many of them are ready.
+///
+/// Each descriptor is registered under a caller-provided tag (the connection object), which is
+/// also used to ask for its readiness after polling. Readiness is level-triggered,
+/// same as with `poll()`: a socket which still has unread data is reported again on the next poll.
+///
+/// Depends on nothing but the standard library and the Linux system headers, see
+/// `EpollDescriptorSet` for the `IDescriptorSet` built on top of it.
+/// </summary>
+class EpollFdSet
+{
+public:
+
+	/// <param name="events">`EPOLLIN` or `EPOLLOUT`.</param>
+	explicit EpollFdSet(uint32_t events);
+	~EpollFdSet();
+
+	EpollFdSet(const EpollFdSet&) = delete;
+	EpollFdSet& operator=(const EpollFdSet&) = delete;
+
+	/// False if the `epoll` instance could not be created, in which case nothing can be added.
+	bool valid() const { return epollFd_ >= 0; }
+
+	/// <summary>
+	/// Registers `fd` under `tag`. Fails if `tag` is already registered with the same descriptor.
+	/// A tag registered with a different descriptor (the old one having been closed meanwhile)
+	/// is moved to the new one.
+	/// </summary>
+	bool add(const void* tag, int fd);
+
+	/// <summary>
+	/// Unregisters `tag`. `currentFd` is the descriptor the tag's socket has now, the registration
+	/// is only removed from the kernel if it is still the registered one: a closed descriptor is
+	/// dropped by the kernel by itself, and its number may already belong to somebody else.
+	/// </summary>
+	void remove(const void* tag, int currentFd);
+
+	void clear();
+	size_t size() const { return entries_.size(); }
+
+	/// Same as `poll()`: the number of ready descriptors, 0 on timeout, -1 with `errno` set on failure.
+	int poll(int timeoutMs);
+
+	/// The `epoll` events reported for `tag` by the last `poll()`, 0 if it wasn't ready or isn't registered.
+	uint32_t readyEvents(const void* tag) const;
+
+private:
+
+	struct Entry
+	{
+		int fd = -1;
+		uint32_t events = 0;
+		// Value of `pollCount_` when `events` were reported.
+		uint64_t polled = 0;
+	};
+
+	int epollFd_ = -1;
+	uint32_t events_;
+	uint64_t pollCount_ = 0;
+	// `epoll_event::data.ptr` points at the entry, which `std::unordered_map` never moves.
+	std::unordered_map<const void*, Entry> entries_;
+	std::vector<epoll_event> ready_;
+};
+
+} // namespace tcp
+
+#endif // defined(__linux__)
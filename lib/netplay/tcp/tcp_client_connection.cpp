@@ -27,6 +27,10 @@
 #include "lib/netplay/tcp/netsocket.h"
 #include "lib/netplay/tcp/sock_error.h"
 
+#if defined(WZ_OS_UNIX)
+# include <sys/uio.h> // for iovec
+#endif
+
 namespace tcp
 {
 
@@ -48,7 +52,7 @@ TCPClientConnection::~TCPClientConnection()
 	socket_ = nullptr;
 }
 
-net::result<ssize_t> TCPClientConnection::sendImpl(const std::vector<uint8_t>& data)
+net::result<ssize_t> TCPClientConnection::sendImpl(const WriteQueue& data)
 {
 	if (!isValid())
 	{
@@ -56,11 +60,39 @@ net::result<ssize_t> TCPClientConnection::sendImpl(const std::vector<uint8_t>& d
 		return tl::make_unexpected(make_network_error_code(EBADF));
 	}
 
-	ssize_t retSent = ::send(getRawSocketFd(), reinterpret_cast<const char*>(data.data()), data.size(), MSG_NOSIGNAL);
+	// Send the queued buffers with a single call, without joining them first.
+	// 16 is the smallest `IOV_MAX` allowed by POSIX, and plenty for a connection's pending flushes.
+	static constexpr size_t MAX_SEND_SPANS = 16;
+	WriteSpan spans[MAX_SEND_SPANS];
+	const size_t spanCount = data.spans(spans, MAX_SEND_SPANS);
+#ifdef WZ_OS_WIN
+	WSABUF buffers[MAX_SEND_SPANS];
+	for (size_t i = 0; i < spanCount; ++i)
+	{
+		buffers[i].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(spans[i].data));
+		buffers[i].len = static_cast<ULONG>(spans[i].size);
+	}
+	DWORD sent = 0;
+	if (WSASend(getRawSocketFd(), buffers, static_cast<DWORD>(spanCount), &sent, 0, nullptr, nullptr) == 0)
+	{
+		return static_cast<ssize_t>(sent);
+	}
+#else
+	struct iovec buffers[MAX_SEND_SPANS];
+	for (size_t i = 0; i < spanCount; ++i)
+	{
+		buffers[i].iov_base = const_cast<uint8_t*>(spans[i].data);
+		buffers[i].iov_len = spans[i].size;
+	}
+	struct msghdr msg = {};
+	msg.msg_iov = buffers;
+	msg.msg_iovlen = spanCount;
+	ssize_t retSent = ::sendmsg(getRawSocketFd(), &msg, MSG_NOSIGNAL);
 	if (retSent != SOCKET_ERROR)
 	{
 		return retSent;
 	}
+#endif
 	return tl::make_unexpected(make_network_error_code(tcp::getSockErr()));
 }
 
@@ -45,7 +45,7 @@ public:
 	explicit TCPClientConnection(WzConnectionProvider& connProvider, WzCompressionProvider& compressionProvider, PendingWritesManager& pwm, Socket* rawSocket);
 	virtual ~TCPClientConnection() override;
 
-	virtual net::result<ssize_t> sendImpl(const std::vector<uint8_t>& data) override;
+	virtual net::result<ssize_t> sendImpl(const WriteQueue& data) override;
 	virtual net::result<ssize_t> recvImpl(char* dst, size_t maxSize) override;
 
 	virtual void setReadReady(bool ready) override;
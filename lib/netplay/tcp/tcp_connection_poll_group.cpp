@@ -20,31 +20,48 @@
 #include "lib/netplay/tcp/tcp_connection_poll_group.h"
 #include "lib/netplay/tcp/tcp_client_connection.h"
 #include "lib/netplay/tcp/netsocket.h"
+#include "lib/netplay/tcp/epoll_descriptor_set.h"
 #include "lib/netplay/polling_util.h"
 #include "lib/netplay/wz_connection_provider.h"
 #include "lib/framework/wzapp.h"
 #include "lib/framework/debug.h"
 
-#include <algorithm>
+#include <cerrno>
+#include <cstring>
 
 namespace tcp
 {
 
 TCPConnectionPollGroup::TCPConnectionPollGroup(WzConnectionProvider& connProvider)
-	: connProvider_(&connProvider),
-	readableSet_(connProvider_->newDescriptorSet(PollEventType::READABLE))
-{}
+	: connProvider_(&connProvider)
+{
+#if defined(WZ_OS_LINUX)
+	// Lobby and autohost servers keep lots of idle connections in their poll groups: use `epoll`,
+	// which only reports the ready ones, instead of handing all of them to `poll()` every time.
+	auto epollSet = std::make_unique<EpollDescriptorSet<PollEventType::READABLE>>();
+	if (epollSet->valid())
+	{
+		readableSet_ = std::move(epollSet);
+		persistentReadableSet_ = true;
+		return;
+	}
+	debug(LOG_WARNING, "Failed to create epoll instance, falling back to poll(): %s", strerror(errno));
+#endif
+	readableSet_ = connProvider_->newDescriptorSet(PollEventType::READABLE);
+}
 
 net::result<int> TCPConnectionPollGroup::checkConnectionsReadable(std::chrono::milliseconds timeout)
 {
-	return ::checkConnectionsReadable(conns_, *readableSet_, timeout);
+	return ::checkConnectionsReadable(conns_, *readableSet_, timeout, !persistentReadableSet_);
 }
 
 void TCPConnectionPollGroup::add(IClientConnection* conn)
 {
 	auto* tcpConn = dynamic_cast<TCPClientConnection*>(conn);
 	ASSERT_OR_RETURN(, tcpConn != nullptr, "Expected to have TCPClientConnection instance");
+	ASSERT_OR_RETURN(, connIndices_.count(conn) == 0, "Connection already present in the poll group");
 
+	connIndices_.emplace(conn, conns_.size());
 	conns_.emplace_back(conn);
 	ASSERT(readableSet_->add(conn), "Failed to add connection to internal descriptor set");
 }
@@ -53,10 +70,18 @@ void TCPConnectionPollGroup::remove(IClientConnection* conn)
 {
 	auto tcpConn = dynamic_cast<TCPClientConnection*>(conn);
 	ASSERT_OR_RETURN(, tcpConn != nullptr, "Expected to have TCPClientConnection instance");
-	auto it = std::find(conns_.begin(), conns_.end(), conn);
-	if (it != conns_.end())
+	auto it = connIndices_.find(conn);
+	if (it != connIndices_.end())
 	{
-		conns_.erase(it);
+		// Move the last connection into the hole, the order of `conns_` doesn't matter.
+		const size_t index = it->second;
+		connIndices_.erase(it);
+		if (index + 1 != conns_.size())
+		{
+			conns_[index] = conns_.back();
+			connIndices_[conns_[index]] = index;
+		}
+		conns_.pop_back();
 	}
 	ASSERT(readableSet_->remove(conn), "Failed to remove connection from internal descriptor set");
 }
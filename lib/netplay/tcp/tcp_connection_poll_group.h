@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 class IClientConnection;
 class IDescriptorSet;
@@ -45,10 +46,15 @@ public:
 private:
 
 	std::vector<IClientConnection*> conns_;
+	// Position of each connection in `conns_`, so that removing one doesn't need a search.
+	std::unordered_map<IClientConnection*, size_t> connIndices_;
 	WzConnectionProvider* connProvider_;
 	// Pre-allocated descriptor set for `checkConnectionsReadable` operation
 	// to avoid extra memory allocations.
 	std::unique_ptr<IDescriptorSet> readableSet_;
+	// Whether `readableSet_` is kept holding `conns_` by `add()` / `remove()` (an `epoll` set),
+	// instead of being rebuilt before every poll.
+	bool persistentReadableSet_ = false;
 };
 
 } // namespace tcp
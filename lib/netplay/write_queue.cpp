@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "write_queue.h"
+
+#include <algorithm>
+
+void WriteQueue::append(const void* data, size_t size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	if (chunks_.empty() || chunks_.back().shared)
+	{
+		chunks_.emplace_back();
+	}
+	auto& owned = chunks_.back().owned;
+	owned.insert(owned.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+	size_ += size;
+}
+
+void WriteQueue::append(std::vector<uint8_t>&& data)
+{
+	if (data.empty())
+	{
+		return;
+	}
+	size_ += data.size();
+	chunks_.emplace_back();
+	chunks_.back().owned = std::move(data);
+}
+
+void WriteQueue::append(WriteBuffer buffer)
+{
+	if (!buffer || buffer->empty())
+	{
+		return;
+	}
+	size_ += buffer->size();
+	chunks_.emplace_back();
+	chunks_.back().shared = std::move(buffer);
+}
+
+size_t WriteQueue::spans(WriteSpan* out, size_t maxSpans) const
+{
+	size_t count = 0;
+	size_t offset = frontOffset_;
+	for (auto it = chunks_.begin(); it != chunks_.end() && count < maxSpans; ++it)
+	{
+		const auto& bytes = it->bytes();
+		out[count++] = WriteSpan{ bytes.data() + offset, bytes.size() - offset };
+		offset = 0;
+	}
+	return count;
+}
+
+void WriteQueue::consume(size_t bytes)
+{
+	bytes = std::min(bytes, size_);
+	size_ -= bytes;
+	while (bytes != 0)
+	{
+		const size_t left = chunks_.front().bytes().size() - frontOffset_;
+		if (bytes < left)
+		{
+			frontOffset_ += bytes;
+			return;
+		}
+		bytes -= left;
+		chunks_.pop_front();
+		frontOffset_ = 0;
+	}
+}
+
+void WriteQueue::clear()
+{
+	chunks_.clear();
+	frontOffset_ = 0;
+	size_ = 0;
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Immutable, reference-counted byte buffer, which can be queued for several connections
+/// at once without copying it for each of them.
+/// </summary>
+using WriteBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+/// <summary>
+/// Contiguous piece of a `WriteQueue`, to be handed to a scatter-gather send (`sendmsg()` / `WSASend()`).
+/// </summary>
+struct WriteSpan
+{
+	const uint8_t* data;
+	size_t size;
+};
+
+/// <summary>
+/// Outgoing bytes of a single connection, kept as a list of buffers instead of a single
+/// contiguous vector: queued buffers are moved or shared in instead of being copied,
+/// and sent bytes are dropped from the front without moving the rest of the data.
+///
+/// Not thread-safe by itself, `PendingWritesManager` guards it with its own lock.
+/// Depends on nothing but the standard library.
+/// </summary>
+class WriteQueue
+{
+public:
+
+	/// Copies `size` bytes, appending them to the last buffer if that one isn't shared.
+	void append(const void* data, size_t size);
+	/// Takes over `data` without copying it.
+	void append(std::vector<uint8_t>&& data);
+	/// Shares `buffer` with whoever else has queued it.
+	void append(WriteBuffer buffer);
+
+	bool empty() const { return size_ == 0; }
+	/// Number of bytes left to send.
+	size_t size() const { return size_; }
+
+	/// <summary>
+	/// Fills `out` with (at most `maxSpans`) pieces of the queued data, in order.
+	/// </summary>
+	/// <returns>The number of pieces written to `out`.</returns>
+	size_t spans(WriteSpan* out, size_t maxSpans) const;
+	/// Drops `bytes` (at most `size()`) bytes from the front, after they have been sent.
+	void consume(size_t bytes);
+	void clear();
+
+private:
+
+	struct Chunk
+	{
+		WriteBuffer shared;
+		std::vector<uint8_t> owned;
+
+		const std::vector<uint8_t>& bytes() const { return shared ? *shared : owned; }
+	};
+
+	std::deque<Chunk> chunks_;
+	// Bytes of `chunks_.front()` which were already sent.
+	size_t frontOffset_ = 0;
+	size_t size_ = 0;
+};
@@ -21,14 +21,19 @@
 
 #pragma once
 
-#include <memory>
+#include "compression_adapter.h"
 
-class ICompressionAdapter;
+#include <memory>
+#include <stdint.h>
 
 /// <summary>
 /// This class provides is responsible for creating `ICompressionAdapter:s`,
 /// which are thin wrappers over some compression algorithm, intended for
 /// use in `IClientConnection` to provide compression over raw net messages.
+///
+/// Which algorithm a connection uses is negotiated during the join handshake:
+/// the client sends `supportedMethods()`, and the host picks one of them
+/// with `negotiateMethod()`, falling back to zlib, which every build supports.
 /// </summary>
 class WzCompressionProvider
 {
@@ -36,7 +41,21 @@ public:
 
 	static WzCompressionProvider& Instance();
 
-	std::unique_ptr<ICompressionAdapter> newCompressionAdapter();
+	/// <summary>
+	/// Bitmask (`1 << method`) of the `WzCompressionMethod:s` this build can use.
+	/// </summary>
+	uint32_t supportedMethods() const;
+	bool isSupported(WzCompressionMethod method) const;
+	/// <summary>
+	/// Picks the cheapest method which both this build and the peer (supporting
+	/// the `peerMethods` bitmask) can use, or zlib if there is none.
+	/// </summary>
+	WzCompressionMethod negotiateMethod(uint32_t peerMethods) const;
+
+	/// <returns>
+	/// An adapter for `method`, or `nullptr` if this build doesn't support it.
+	/// </returns>
+	std::unique_ptr<ICompressionAdapter> newCompressionAdapter(WzCompressionMethod method = WzCompressionMethod::Zlib);
 
 private:
 
@@ -33,7 +33,7 @@ ZlibCompressionAdapter::ZlibCompressionAdapter()
 ZlibCompressionAdapter::~ZlibCompressionAdapter()
 {
 	deflateEnd(&deflateStream_);
-	deflateEnd(&inflateStream_);
+	inflateEnd(&inflateStream_);
 }
 
 net::result<void> ZlibCompressionAdapter::initialize()
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "zstd_compression_adapter.h"
+#include "error_categories.h"
+
+#include "lib/framework/frame.h" // for `ASSERT`
+
+#include <zstd_errors.h>
+
+#include <algorithm>
+
+// Connections flush every tick, often less than a hundred bytes at a time. The fastest levels
+// only look for long matches, which are too rare in such small blocks to compress much.
+static constexpr int ZstdCompressionLevel = 3;
+// 128 KiB window. The decompressor refuses frames asking for more, so that a peer
+// can't make us allocate much memory, and smaller match tables keep the compression
+// state of a connection at about a megabyte.
+static constexpr int ZstdWindowLog = 17;
+static constexpr int ZstdTableLog = ZstdWindowLog - 2;
+
+ZstdCompressionAdapter::ZstdCompressionAdapter() = default;
+
+ZstdCompressionAdapter::~ZstdCompressionAdapter()
+{
+	ZSTD_freeCCtx(cctx_);
+	ZSTD_freeDCtx(dctx_);
+}
+
+net::result<void> ZstdCompressionAdapter::initialize()
+{
+	cctx_ = ZSTD_createCCtx();
+	dctx_ = ZSTD_createDCtx();
+	ASSERT(cctx_ != nullptr && dctx_ != nullptr, "ZSTD_createCCtx/ZSTD_createDCtx failed! Sockets won't work.");
+	if (cctx_ == nullptr || dctx_ == nullptr)
+	{
+		return tl::make_unexpected(make_zstd_error_code(ZSTD_error_memory_allocation));
+	}
+
+	for (size_t ret : {
+		ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel, ZstdCompressionLevel),
+		ZSTD_CCtx_setParameter(cctx_, ZSTD_c_windowLog, ZstdWindowLog),
+		ZSTD_CCtx_setParameter(cctx_, ZSTD_c_hashLog, ZstdTableLog),
+		ZSTD_CCtx_setParameter(cctx_, ZSTD_c_chainLog, ZstdTableLog),
+		ZSTD_DCtx_setParameter(dctx_, ZSTD_d_windowLogMax, ZstdWindowLog) })
+	{
+		ASSERT(!ZSTD_isError(ret), "zstd parameter rejected: %s", ZSTD_getErrorName(ret));
+		if (ZSTD_isError(ret))
+		{
+			return tl::make_unexpected(make_zstd_error_code(ZSTD_getErrorCode(ret)));
+		}
+	}
+
+	decompressNeedInput_ = true;
+
+	return {};
+}
+
+net::result<void> ZstdCompressionAdapter::compress(const void* src, size_t size)
+{
+	ZSTD_inBuffer in = { src, size, 0 };
+	do
+	{
+		// Most of the time, the input is only buffered in the stream, and the output comes on flush.
+		const size_t alreadyHave = compressOutBuf_.size();
+		compressOutBuf_.resize(alreadyHave + ZSTD_compressBound(in.size - in.pos));
+		ZSTD_outBuffer out = { compressOutBuf_.data() + alreadyHave, compressOutBuf_.size() - alreadyHave, 0 };
+
+		const size_t ret = ZSTD_compressStream2(cctx_, &out, &in, ZSTD_e_continue);
+		ASSERT(!ZSTD_isError(ret), "zstd compression failed: %s", ZSTD_getErrorName(ret));
+
+		// Remove unused part of buffer.
+		compressOutBuf_.resize(alreadyHave + out.pos);
+		if (ZSTD_isError(ret))
+		{
+			return tl::make_unexpected(make_zstd_error_code(ZSTD_getErrorCode(ret)));
+		}
+	} while (in.pos < in.size);
+
+	return {};
+}
+
+net::result<void> ZstdCompressionAdapter::flushCompressionStream()
+{
+	ZSTD_inBuffer in = { nullptr, 0, 0 };
+	size_t remaining = 1000;
+	do
+	{
+		// `remaining` is how much is still left to flush, at least.
+		const size_t alreadyHave = compressOutBuf_.size();
+		compressOutBuf_.resize(alreadyHave + std::max<size_t>(remaining, 1000));
+		ZSTD_outBuffer out = { compressOutBuf_.data() + alreadyHave, compressOutBuf_.size() - alreadyHave, 0 };
+
+		remaining = ZSTD_compressStream2(cctx_, &out, &in, ZSTD_e_flush);
+		ASSERT(!ZSTD_isError(remaining), "zstd compression failed: %s", ZSTD_getErrorName(remaining));
+
+		// Remove unused part of buffer.
+		compressOutBuf_.resize(alreadyHave + out.pos);
+		if (ZSTD_isError(remaining))
+		{
+			return tl::make_unexpected(make_zstd_error_code(ZSTD_getErrorCode(remaining)));
+		}
+	} while (remaining != 0);
+
+	return {};
+}
+
+net::result<void> ZstdCompressionAdapter::decompress(void* dst, size_t size)
+{
+	ZSTD_outBuffer out = { dst, size, 0 };
+	// Called even without new input, to drain what the stream still holds from the last input.
+	do
+	{
+		const size_t inPos = decompressIn_.pos;
+		const size_t outPos = out.pos;
+		const size_t ret = ZSTD_decompressStream(dctx_, &out, &decompressIn_);
+		if (ZSTD_isError(ret))
+		{
+			debug(LOG_ERROR, "Couldn't decompress data from socket. zstd error %s", ZSTD_getErrorName(ret));
+			decompressAvailOut_ = size - out.pos;
+			return tl::make_unexpected(make_zstd_error_code(ZSTD_getErrorCode(ret)));
+		}
+		if (decompressIn_.pos == inPos && out.pos == outPos)
+		{
+			break;
+		}
+	} while (out.pos < out.size && decompressIn_.pos < decompressIn_.size);
+
+	decompressAvailOut_ = size - out.pos;
+	return {};
+}
+
+void ZstdCompressionAdapter::resetDecompressionStreamInputSize(size_t size)
+{
+	decompressIn_ = { decompressInBuf_.data(), size, 0 };
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include "compression_adapter.h"
+
+#include <zstd.h>
+
+/// <summary>
+/// Implementation of `ICompressionAdapter` interface, which uses the
+/// Zstandard library to compress/decompress the data.
+///
+/// Compared to zlib, its output for game traffic is a bit larger, but it needs
+/// a fraction of the CPU time to compress and decompress it. Both directions use
+/// a small window, which bounds the memory a peer can make us allocate per connection.
+/// </summary>
+class ZstdCompressionAdapter : public ICompressionAdapter
+{
+public:
+
+	explicit ZstdCompressionAdapter();
+	virtual ~ZstdCompressionAdapter() override;
+
+	virtual net::result<void> initialize() override;
+
+	virtual net::result<void> compress(const void* src, size_t size) override;
+	virtual net::result<void> flushCompressionStream() override;
+
+	virtual std::vector<uint8_t>& compressionOutBuffer() override
+	{
+		return compressOutBuf_;
+	}
+
+	virtual const std::vector<uint8_t>& compressionOutBuffer() const override
+	{
+		return compressOutBuf_;
+	}
+
+	virtual net::result<void> decompress(void* dst, size_t size) override;
+
+	virtual std::vector<uint8_t>& decompressionInBuffer() override
+	{
+		return decompressInBuf_;
+	}
+
+	virtual const std::vector<uint8_t>& decompressionInBuffer() const override
+	{
+		return decompressInBuf_;
+	}
+
+	virtual size_t availableSpaceToDecompress() const override
+	{
+		return decompressAvailOut_;
+	}
+	virtual bool decompressionStreamConsumedAllInput() const override
+	{
+		return decompressIn_.pos == decompressIn_.size;
+	}
+	virtual bool decompressionNeedInput() const override
+	{
+		return decompressNeedInput_;
+	}
+	virtual void setDecompressionNeedInput(bool needInput) override
+	{
+		decompressNeedInput_ = needInput;
+	}
+
+	virtual void resetDecompressionStreamInputSize(size_t size) override;
+
+private:
+
+	std::vector<uint8_t> compressOutBuf_;
+	std::vector<uint8_t> decompressInBuf_;
+	ZSTD_CCtx* cctx_ = nullptr;
+	ZSTD_DCtx* dctx_ = nullptr;
+	ZSTD_inBuffer decompressIn_ = {};
+	size_t decompressAvailOut_ = 0;
+	bool decompressNeedInput_ = false;
+};
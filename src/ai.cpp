@@ -616,7 +616,7 @@ int aiBestNearestTarget(DROID *psDroid, BASE_OBJECT **ppsObj, int weapon_slot, i
 	int droidRange = std::min(aiDroidRange(psDroid, weapon_slot) + extraRange, objSensorRange(psDroid) + 6 * TILE_UNITS);
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, droidRange);
+	gridList = gridStartIterateVisible(psDroid->pos.x, psDroid->pos.y, droidRange, psDroid->player);  // Friendly or not, only objects we can see are of use.
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		BASE_OBJECT *friendlyObj = nullptr;
@@ -974,7 +974,7 @@ bool aiChooseTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget, int weapon_slot
 			}
 
 			static GridList gridList;  // static to avoid allocations.
-			gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, srange);
+			gridList = gridStartIterateVisible(psObj->pos.x, psObj->pos.y, srange, psObj->player);
 			for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 			{
 				BASE_OBJECT *psCurr = *gi;
@@ -1057,7 +1057,7 @@ bool aiChooseSensorTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget)
 		unsigned tarDist = UINT32_MAX;
 
 		static GridList gridList;  // static to avoid allocations.
-		gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, objSensorRange(psObj));
+		gridList = gridStartIterateVisible(psObj->pos.x, psObj->pos.y, objSensorRange(psObj), psObj->player);
 		for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 		{
 			BASE_OBJECT *psCurr = *gi;
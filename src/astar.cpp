@@ -47,6 +47,7 @@
 #include "map.h"
 #endif
 
+#include <array>
 #include <list>
 #include <vector>
 #include <algorithm>
@@ -56,6 +57,9 @@
 
 #include "lib/netplay/sync_debug.h"
 #include "game_world.h"
+#include "hpastar.h"
+#include "flowfield.h"
+#include "pathbitmap.h"
 
 /// A coordinate.
 struct PathCoord
@@ -130,8 +134,9 @@ struct PathBlockingMap
 	}
 
 	PathBlockingType type;
-	std::vector<bool> map;
-	std::vector<bool> dangerMap;	// using threatBits
+	std::shared_ptr<const PathBitmap> map;        ///< Shared with the maps of earlier ticks, while unchanged.
+	std::shared_ptr<const PathBitmap> dangerMap;  ///< Using threatBits. Null if no tile is threatened.
+	std::shared_ptr<const HpaGraph> hpaGraph;     ///< Only built for hierarchical path finding.
 };
 
 struct PathNonblockingArea
@@ -150,6 +155,11 @@ struct PathNonblockingArea
 	{
 		return x >= x1 && x < x2 && y >= y1 && y < y2;
 	}
+	/// Whether any tile within the 3×3 tiles around (x, y) is in the area.
+	bool isNear(int x, int y) const
+	{
+		return x + 1 >= x1 && x - 1 < x2 && y + 1 >= y1 && y - 1 < y2 && x1 < x2 && y1 < y2;
+	}
 
 	int16_t x1 = 0;
 	int16_t x2 = 0;
@@ -167,12 +177,12 @@ struct PathfindContext
 		{
 			return false;  // The path is actually blocked here by a structure, but ignore it since it's where we want to go (or where we came from).
 		}
-		// Not sure whether the out-of-bounds check is needed, can only happen if pathfinding is started on a blocking tile (or off the map).
-		return x < 0 || y < 0 || x >= gameWorld.map.width || y >= gameWorld.map.height || blockingMap->map[x + y * gameWorld.map.width];
+		// Tiles off the map are blocking. Not sure whether that is needed, can only happen if pathfinding is started on a blocking tile (or off the map).
+		return blockingMap->map->test(x, y);
 	}
 	bool isDangerous(int x, int y) const
 	{
-		return !blockingMap->dangerMap.empty() && blockingMap->dangerMap[x + y * gameWorld.map.width];
+		return blockingMap->dangerMap != nullptr && blockingMap->dangerMap->test(x, y);
 	}
 	bool matches(const std::shared_ptr<const PathBlockingMap> &blockingMap_, PathCoord tileS_, PathNonblockingArea dstIgnore_) const
 	{
@@ -217,6 +227,27 @@ struct PathfindContext
 static std::vector<std::shared_ptr<PathBlockingMap>> fpathBlockingMaps;
 /// Game time for all blocking maps in fpathBlockingMaps.
 static uint32_t fpathCurrentGameTime;
+/// Latest blocking map for each type of blocking map (ignoring the game time), to be updated rather than rebuilt in the next tick.
+struct PathBlockingCache
+{
+	PathBlockingType type;
+	uint32_t epoch = 0;     ///< WorldMapState::epoch of map.
+	uint64_t changes = 0;   ///< WorldMapState::blockingChanges when map was last updated.
+	WorldScrollLimits scroll;
+	std::shared_ptr<const PathBitmap> map;
+};
+static std::vector<PathBlockingCache> fpathBlockingCaches;
+/// Latest danger map of each player, shared by the blocking maps of all propulsion types while it does not change.
+static std::vector<std::pair<int, std::shared_ptr<const PathBitmap>>> fpathDangerMaps;
+/// Latest cluster graph for each type of blocking map (ignoring the game time), to be repaired rather than rebuilt in the next tick.
+struct PathHpaCache
+{
+	PathBlockingType type;
+	std::shared_ptr<const PathBitmap> map;        ///< The maps graph was built from.
+	std::shared_ptr<const PathBitmap> dangerMap;
+	std::shared_ptr<const HpaGraph> graph;
+};
+static std::vector<PathHpaCache> fpathHpaGraphs;
 
 // Convert a direction into an offset
 // dir 0 => x = 0, y = -1
@@ -232,9 +263,33 @@ static const Vector2i aDirOffset[] =
 	Vector2i(1, 1),
 };
 
+/// The moves allowed from a tile, by the blocking tiles around it (see PathBitmap::neighbourhood()), bit dir being set
+/// if moving by aDirOffset[dir] is allowed. Same rules as in fpathAStarExplore(): no blocking tiles, and no cutting corners.
+static const std::array<uint8_t, 512> aPassableMoves = [] {
+	std::array<uint8_t, 512> moves {};
+	for (unsigned neighbourhood = 0; neighbourhood < moves.size(); ++neighbourhood)
+	{
+		auto isBlocked = [&](Vector2i offset) {
+			return ((neighbourhood >> ((offset.x + 1) + 3 * (offset.y + 1))) & 1) != 0;
+		};
+		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
+		{
+			if (isBlocked(aDirOffset[dir]) || (dir % 2 != 0 && (isBlocked(aDirOffset[(dir + 1) % 8]) || isBlocked(aDirOffset[(dir + 7) % 8]))))
+			{
+				continue;
+			}
+			moves[neighbourhood] |= 1 << dir;
+		}
+	}
+	return moves;
+}();
+
 void fpathHardTableReset()
 {
 	fpathBlockingMaps.clear();
+	fpathBlockingCaches.clear();
+	fpathDangerMaps.clear();
+	fpathHpaGraphs.clear();
 }
 
 /** Get the nearest entry in the open list
@@ -382,49 +437,65 @@ static PathCoord fpathAStarExplore(PathfindContext &context, PathCoord tileF)
 			foundIt = true;  // Break out of loop, but not before inserting neighbour nodes, since the neighbours may be important if the context gets reused.
 		}
 
-		// loop through possible moves in 8 directions to find a valid move
-		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
+		// Find the valid moves in 8 directions. Away from the destination area, the blocking tiles around the node decide them at once.
+		unsigned moves = 0;
+		if (!context.dstIgnore.isNear(node.p.x, node.p.y))
 		{
-			// Try a new location
-			int x = node.p.x + aDirOffset[dir].x;
-			int y = node.p.y + aDirOffset[dir].y;
-
-			/*
-			   5  6  7
-			     \|/
-			   4 -I- 0
-			     /|\
-			   3  2  1
-			   odd:orthogonal-adjacent tiles even:non-orthogonal-adjacent tiles
-			*/
-			if (dir % 2 != 0 && !context.dstIgnore.isNonblocking(node.p.x, node.p.y) && !context.dstIgnore.isNonblocking(x, y))
+			moves = aPassableMoves[context.blockingMap->map->neighbourhood(node.p.x, node.p.y)];
+		}
+		else
+		{
+			for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
 			{
-				int x2, y2;
-
-				// We cannot cut corners
-				x2 = node.p.x + aDirOffset[(dir + 1) % 8].x;
-				y2 = node.p.y + aDirOffset[(dir + 1) % 8].y;
-				if (context.isBlocked(x2, y2))
+				// Try a new location
+				int x = node.p.x + aDirOffset[dir].x;
+				int y = node.p.y + aDirOffset[dir].y;
+
+				/*
+				   5  6  7
+				     \|/
+				   4 -I- 0
+				     /|\
+				   3  2  1
+				   odd:orthogonal-adjacent tiles even:non-orthogonal-adjacent tiles
+				*/
+				if (dir % 2 != 0 && !context.dstIgnore.isNonblocking(node.p.x, node.p.y) && !context.dstIgnore.isNonblocking(x, y))
 				{
-					continue;
+					int x2, y2;
+
+					// We cannot cut corners
+					x2 = node.p.x + aDirOffset[(dir + 1) % 8].x;
+					y2 = node.p.y + aDirOffset[(dir + 1) % 8].y;
+					if (context.isBlocked(x2, y2))
+					{
+						continue;
+					}
+					x2 = node.p.x + aDirOffset[(dir + 7) % 8].x;
+					y2 = node.p.y + aDirOffset[(dir + 7) % 8].y;
+					if (context.isBlocked(x2, y2))
+					{
+						continue;
+					}
 				}
-				x2 = node.p.x + aDirOffset[(dir + 7) % 8].x;
-				y2 = node.p.y + aDirOffset[(dir + 7) % 8].y;
-				if (context.isBlocked(x2, y2))
+
+				// See if the node is a blocking tile
+				if (context.isBlocked(x, y))
 				{
+					// tile is blocked, skip it
 					continue;
 				}
+
+				moves |= 1 << dir;
 			}
+		}
 
-			// See if the node is a blocking tile
-			if (context.isBlocked(x, y))
+		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
+		{
+			if ((moves & (1 << dir)) != 0)
 			{
-				// tile is blocked, skip it
-				continue;
+				// Now insert the point into the appropriate list, if not already visited.
+				fpathNewNode(context, tileF, PathCoord(node.p.x + aDirOffset[dir].x, node.p.y + aDirOffset[dir].y), node.dist, node.p);
 			}
-
-			// Now insert the point into the appropriate list, if not already visited.
-			fpathNewNode(context, tileF, PathCoord(x, y), node.dist, node.p);
 		}
 	}
 
@@ -545,6 +616,17 @@ void PathfindContextList::clear()
 	orderedIndexes.clear();
 }
 
+/// A flow field towards one destination tile, for one blocking map.
+struct PathFlowField
+{
+	std::shared_ptr<const PathBlockingMap> blockingMap;
+	uint32_t myGameTime;  ///< See PathfindContext::matches().
+	std::unique_ptr<FlowField> field;
+};
+
+/// Number of flow fields kept by each FPathExecuteContext.
+static constexpr size_t MAX_FLOW_FIELDS = 4;
+
 class FPathExecuteContextImpl : public FPathExecuteContext
 {
 public:
@@ -556,6 +638,11 @@ public:
 	PathfindContextList fpathContexts;
 	/// Used to avoid extra allocations in fpathAStarRoute
 	std::vector<Vector2i> pathBuffer;
+	/// Scratch memory for fpathHierarchicalRoute
+	HpaSearch hpaSearch;
+	std::vector<HpaCoord> hpaPath;
+	/// Last recently used flow fields, for fpathFlowFieldRoute
+	std::vector<PathFlowField> flowFields;
 };
 
 FPathExecuteContext::~FPathExecuteContext()
@@ -570,6 +657,10 @@ void FPathExecuteContextImpl::resetForNewGameTimeIfNeeded(const PATHJOB& job)
 	{
 		fpathContexts.clear();
 	}
+	if (!flowFields.empty() && job.blockingMap->type.gameTime != flowFields.front().myGameTime)
+	{
+		flowFields.clear();
+	}
 }
 
 std::shared_ptr<FPathExecuteContext> makeFPathExecuteContext()
@@ -733,6 +824,265 @@ ASR_RETVAL fpathAStarRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE
 	return retval;
 }
 
+ASR_RETVAL fpathHierarchicalRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE_CONTROL *psMove, PATHJOB *psJob)
+{
+	HpaGraph const *graph = psJob->blockingMap->hpaGraph.get();
+	ASSERT_OR_RETURN(ASR_FAILED, graph != nullptr, "No cluster graph for hierarchical path finding");
+
+	auto ctxImpl = std::static_pointer_cast<FPathExecuteContextImpl>(ctx);
+	std::vector<HpaCoord> &path = ctxImpl->hpaPath;
+	const HpaCoord tileOrig(map_coord(psJob->origX), map_coord(psJob->origY));
+	const HpaCoord tileDest(map_coord(psJob->destX), map_coord(psJob->destY));
+	if (!graph->findPath(ctxImpl->hpaSearch, tileOrig, tileDest, path))
+	{
+		return ASR_FAILED;
+	}
+
+	psMove->asPath.resize(path.size());
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		psMove->asPath[i] = Vector2i(world_coord(path[i].x) + TILE_UNITS / 2, world_coord(path[i].y) + TILE_UNITS / 2);
+	}
+	// Found exact path, so use exact coordinates for last point, no reason to lose precision
+	psMove->asPath.back() = Vector2i(psJob->destX, psJob->destY);
+	psMove->destination = psMove->asPath.back();
+
+	return ASR_OK;
+}
+
+/// Writes the cost factor of each tile of row y, in the format of HpaGraph::build(), without the gateway flags, to row.
+static void fpathTileCostRow(PathBlockingMap const &blockMap, int y, uint8_t *row)
+{
+	// Same cost factors as in fpathNewNode().
+	std::fill_n(row, blockMap.map->width(), 1);
+	if (blockMap.dangerMap != nullptr)
+	{
+		blockMap.dangerMap->unpackRow(y, row, 5);
+	}
+	blockMap.map->unpackRow(y, row, 0);
+}
+
+ASR_RETVAL fpathFlowFieldRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE_CONTROL *psMove, PATHJOB *psJob)
+{
+	auto ctxImpl = std::static_pointer_cast<FPathExecuteContextImpl>(ctx);
+	ctxImpl->resetForNewGameTimeIfNeeded(*psJob);
+
+	auto &flowFields = ctxImpl->flowFields;
+	const HpaCoord tileOrig(map_coord(psJob->origX), map_coord(psJob->origY));
+	const HpaCoord tileDest(map_coord(psJob->destX), map_coord(psJob->destY));
+
+	auto it = std::find_if(flowFields.begin(), flowFields.end(), [&](PathFlowField const &flowField) {
+		// Must check myGameTime, as for PathfindContext::matches().
+		return flowField.myGameTime == psJob->blockingMap->type.gameTime && flowField.blockingMap == psJob->blockingMap && flowField.field->goal() == tileDest;
+	});
+	if (it == flowFields.end())
+	{
+		if (flowFields.size() >= MAX_FLOW_FIELDS)
+		{
+			flowFields.pop_back();
+		}
+		PathFlowField flowField;
+		flowField.blockingMap = psJob->blockingMap;
+		flowField.myGameTime = psJob->blockingMap->type.gameTime;
+		flowField.field = std::make_unique<FlowField>(psJob->blockingMap->map, psJob->blockingMap->dangerMap, tileDest);
+		it = flowFields.insert(flowFields.end(), std::move(flowField));
+	}
+	// Move the field to the beginning of the last recently used list.
+	std::rotate(flowFields.begin(), it, it + 1);
+
+	std::vector<HpaCoord> &path = ctxImpl->hpaPath;
+	if (!flowFields.front().field->findPath(tileOrig, path))
+	{
+		return ASR_FAILED;
+	}
+
+	psMove->asPath.resize(path.size());
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		psMove->asPath[i] = Vector2i(world_coord(path[i].x) + TILE_UNITS / 2, world_coord(path[i].y) + TILE_UNITS / 2);
+	}
+	// Found exact path, so use exact coordinates for last point, no reason to lose precision
+	psMove->asPath.back() = Vector2i(psJob->destX, psJob->destY);
+	psMove->destination = psMove->asPath.back();
+
+	return ASR_OK;
+}
+
+/// Gives blockMap a cluster graph, repaired from the last one built for the same type of blocking map.
+static void fpathSetHpaGraph(PathBlockingMap &blockMap)
+{
+	auto previous = std::find_if(fpathHpaGraphs.begin(), fpathHpaGraphs.end(), [&](PathHpaCache const &graph) {
+		return fpathIsEquivalentBlocking(graph.type.propulsion, graph.type.owner, graph.type.moveType,
+		                                 blockMap.type.propulsion, blockMap.type.owner, blockMap.type.moveType);
+	});
+	if (previous == fpathHpaGraphs.end())
+	{
+		previous = fpathHpaGraphs.emplace(fpathHpaGraphs.end(), PathHpaCache{blockMap.type, nullptr, nullptr, nullptr});
+	}
+	if (previous->graph != nullptr && previous->map == blockMap.map && previous->dangerMap == blockMap.dangerMap)
+	{
+		// Built from the same maps, so nothing to repair.
+		blockMap.hpaGraph = previous->graph;
+		syncDebug("hpaGraph(%d,%d,%d,%d) = %zu nodes, unchanged", blockMap.type.gameTime, blockMap.type.propulsion, blockMap.type.owner, blockMap.type.moveType,
+		          blockMap.hpaGraph->numNodes());
+		return;
+	}
+
+	const int width = gameWorld.map.width, height = gameWorld.map.height;
+	auto readRow = [&blockMap, width](int y, uint8_t *row) {
+		fpathTileCostRow(blockMap, y, row);
+		for (int x = 0; x < width; ++x)
+		{
+			if ((mapTile(gameWorld.map, x, y)->tileInfoBits & BITS_GATEWAY) != 0)
+			{
+				row[x] |= HpaGraph::TILE_GATEWAY;
+			}
+		}
+	};
+
+	const bool repairable = previous->graph != nullptr && previous->graph->width() == width && previous->graph->height() == height
+	                        && previous->map->width() == width && previous->map->height() == height
+	                        && (previous->dangerMap == nullptr || (previous->dangerMap->width() == width && previous->dangerMap->height() == height))
+	                        && (blockMap.dangerMap == nullptr || (blockMap.dangerMap->width() == width && blockMap.dangerMap->height() == height));
+	if (repairable)
+	{
+		// Only read the rows in which the blocking or danger map changed since the last graph. Unchanged maps are shared
+		// (see fpathGetBlockingBitmap()), so usually only a few rows of one of them need comparing.
+		std::vector<bool> changedRows(height, false);
+		for (int y = 0; y < height; ++y)
+		{
+			bool changed = previous->map != blockMap.map && !previous->map->rowEquals(*blockMap.map, y);
+			if (!changed && previous->dangerMap != blockMap.dangerMap)
+			{
+				changed = previous->dangerMap == nullptr || blockMap.dangerMap == nullptr || !previous->dangerMap->rowEquals(*blockMap.dangerMap, y);
+			}
+			changedRows[y] = changed;
+		}
+		blockMap.hpaGraph = HpaGraph::repair(*previous->graph, changedRows, readRow);
+	}
+	else
+	{
+		std::vector<uint8_t> tiles(static_cast<size_t>(width) * static_cast<size_t>(height));
+		for (int y = 0; y < height; ++y)
+		{
+			readRow(y, &tiles[static_cast<size_t>(y) * width]);
+		}
+		blockMap.hpaGraph = HpaGraph::build(width, height, std::move(tiles), nullptr);
+	}
+	previous->map = blockMap.map;
+	previous->dangerMap = blockMap.dangerMap;
+	previous->graph = blockMap.hpaGraph;
+	syncDebug("hpaGraph(%d,%d,%d,%d) = %zu nodes, %zu of %zu clusters rebuilt", blockMap.type.gameTime, blockMap.type.propulsion, blockMap.type.owner, blockMap.type.moveType,
+	          blockMap.hpaGraph->numNodes(), blockMap.hpaGraph->numRebuiltClusters(), blockMap.hpaGraph->numClusters());
+}
+
+/// Returns the blocking map of the given type, updating only the rows changed since the last one built for the same
+/// type of blocking map, and sharing that map if no row changed.
+static std::shared_ptr<const PathBitmap> fpathGetBlockingBitmap(PathBlockingType const &type)
+{
+	const WorldMapState &mapState = gameWorld.map;
+	auto cache = std::find_if(fpathBlockingCaches.begin(), fpathBlockingCaches.end(), [&](PathBlockingCache const &entry) {
+		return fpathIsEquivalentBlocking(entry.type.propulsion, entry.type.owner, entry.type.moveType, type.propulsion, type.owner, type.moveType);
+	});
+	if (cache == fpathBlockingCaches.end())
+	{
+		cache = fpathBlockingCaches.emplace(fpathBlockingCaches.end(), PathBlockingCache{type});
+	}
+
+	// Changes are only tracked for the maps of real players, and only while the aux maps have not been reallocated.
+	const bool tracked = type.owner >= 0 && type.owner < MAX_PLAYERS && mapState.epoch != 0
+	                     && mapState.blockingRowChanges.size() == static_cast<size_t>(mapState.height);
+	const bool reusable = tracked && cache->map != nullptr && cache->epoch == mapState.epoch
+	                      && cache->map->width() == mapState.width && cache->map->height() == mapState.height
+	                      && cache->scroll.minX == mapState.scroll.minX && cache->scroll.minY == mapState.scroll.minY
+	                      && cache->scroll.maxX == mapState.scroll.maxX && cache->scroll.maxY == mapState.scroll.maxY;
+
+	std::shared_ptr<const PathBitmap> map;
+	if (!reusable)
+	{
+		auto newMap = std::make_shared<PathBitmap>(mapState.width, mapState.height);
+		for (int y = 0; y < mapState.height; ++y)
+		{
+			fpathBaseBlockingRow(mapState, y, type.propulsion, type.owner, type.moveType, *newMap);
+		}
+		map = std::move(newMap);
+	}
+	else if (cache->changes == mapState.blockingChanges)
+	{
+		map = cache->map;  // Nothing changed.
+	}
+	else
+	{
+		// Copy on write, since earlier blocking maps may still be in use by the path finding threads.
+		std::shared_ptr<PathBitmap> newMap;
+		for (int y = 0; y < mapState.height; ++y)
+		{
+			if (mapState.blockingRowChanges[y] <= cache->changes)
+			{
+				continue;
+			}
+			if (newMap == nullptr)
+			{
+				newMap = std::make_shared<PathBitmap>(*cache->map);
+			}
+			fpathBaseBlockingRow(mapState, y, type.propulsion, type.owner, type.moveType, *newMap);
+		}
+		if (newMap != nullptr && *newMap != *cache->map)
+		{
+			map = std::move(newMap);
+		}
+		else
+		{
+			map = cache->map;  // Only bits which do not affect this type of blocking map changed.
+		}
+	}
+
+#ifdef DEBUG
+	for (int y = 0; y < mapState.height; ++y)
+		for (int x = 0; x < mapState.width; ++x)
+		{
+			ASSERT(map->test(x, y) == fpathBaseBlockingTile(mapState, x, y, type.propulsion, type.owner, type.moveType), "Blocking map out of date at (%d, %d)", x, y);
+		}
+#endif
+
+	cache->type = type;
+	cache->epoch = tracked ? mapState.epoch : 0;
+	cache->changes = mapState.blockingChanges;
+	cache->scroll = mapState.scroll;
+	cache->map = map;
+	return map;
+}
+
+/// Returns the danger map of the player, or null if no tile is threatened. Shared with the last danger map of the player, while it does not change.
+static std::shared_ptr<const PathBitmap> fpathGetDangerBitmap(int owner)
+{
+	const WorldMapState &mapState = gameWorld.map;
+	auto newMap = std::make_shared<PathBitmap>(mapState.width, mapState.height);
+	for (int y = 0; y < mapState.height; ++y)
+	{
+		newMap->packRow(y, &mapState.auxMap[owner][static_cast<size_t>(y) * mapState.width], AUXBITS_THREAT, nullptr, 0);
+	}
+	std::shared_ptr<const PathBitmap> map;
+	if (newMap->any())
+	{
+		map = std::move(newMap);
+	}
+
+	auto previous = std::find_if(fpathDangerMaps.begin(), fpathDangerMaps.end(), [&](std::pair<int, std::shared_ptr<const PathBitmap>> const &entry) {
+		return entry.first == owner;
+	});
+	if (previous == fpathDangerMaps.end())
+	{
+		previous = fpathDangerMaps.emplace(fpathDangerMaps.end(), owner, nullptr);
+	}
+	if (map != nullptr && previous->second != nullptr && *map == *previous->second)
+	{
+		map = previous->second;
+	}
+	previous->second = map;
+	return map;
+}
+
 void fpathSetBlockingMap(PATHJOB *psJob)
 {
 	if (fpathCurrentGameTime != gameTime)
@@ -761,34 +1111,29 @@ void fpathSetBlockingMap(PATHJOB *psJob)
 
 		// blockMap now points to an empty map with no data. Fill the map.
 		blockMap->type = type;
-		std::vector<bool> &map = blockMap->map;
-		map.resize(static_cast<size_t>(gameWorld.map.width) * static_cast<size_t>(gameWorld.map.height));
-		uint32_t checksumMap = 0, checksumDangerMap = 0, factor = 0;
-		for (int y = 0; y < gameWorld.map.height; ++y)
-			for (int x = 0; x < gameWorld.map.width; ++x)
-			{
-				map[x + y * gameWorld.map.width] = fpathBaseBlockingTile(gameWorld.map, x, y, type.propulsion, type.owner, type.moveType);
-				checksumMap ^= map[x + y * gameWorld.map.width] * (factor = 3 * factor + 1);
-			}
+		blockMap->map = fpathGetBlockingBitmap(type);
 		if (!isHumanPlayer(type.owner) && type.moveType == FMT_MOVE)
 		{
-			std::vector<bool> &dangerMap = blockMap->dangerMap;
-			dangerMap.resize(static_cast<size_t>(gameWorld.map.width) * static_cast<size_t>(gameWorld.map.height));
-			for (int y = 0; y < gameWorld.map.height; ++y)
-				for (int x = 0; x < gameWorld.map.width; ++x)
-				{
-					dangerMap[x + y * gameWorld.map.width] = auxTile(gameWorld.map, x, y, type.owner) & AUXBITS_THREAT;
-					checksumDangerMap ^= dangerMap[x + y * gameWorld.map.width] * (factor = 3 * factor + 1);
-				}
+			blockMap->dangerMap = fpathGetDangerBitmap(type.owner);
 		}
-		syncDebug("blockingMap(%d,%d,%d,%d) = %08X %08X", gameTime, psJob->propulsion, psJob->owner, psJob->moveType, checksumMap, checksumDangerMap);
+		syncDebug("blockingMap(%d,%d,%d,%d) = %08X %08X", gameTime, psJob->propulsion, psJob->owner, psJob->moveType,
+		          blockMap->map->checksum(), blockMap->dangerMap != nullptr ? blockMap->dangerMap->checksum() : 0);
 
+		if (psJob->hierarchical)
+		{
+			fpathSetHpaGraph(*blockMap);
+		}
 		psJob->blockingMap = blockMap;
 	}
 	else
 	{
 		syncDebug("blockingMap(%d,%d,%d,%d) = cached", gameTime, psJob->propulsion, psJob->owner, psJob->moveType);
 
+		if (psJob->hierarchical && (*i)->hpaGraph == nullptr)
+		{
+			// Path finding threads only look at hpaGraph for hierarchical jobs, so none of them can be reading it yet.
+			fpathSetHpaGraph(**i);
+		}
 		psJob->blockingMap = *i;
 	}
 }
@@ -50,8 +50,21 @@ std::shared_ptr<FPathExecuteContext> makeFPathExecuteContext();
  */
 ASR_RETVAL fpathAStarRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE_CONTROL *psMove, PATHJOB *psJob);
 
+/** Use the hierarchical (HPA*) cluster graph of psJob->blockingMap to find a path, see hpastar.h
+ *
+ *  Only finds exact routes, returns ASR_FAILED if the destination could not be reached, in which case
+ *  fpathAStarRoute() should be used to find the nearest route.
+ *
+ *  @ingroup pathfinding
+ */
+ASR_RETVAL fpathHierarchicalRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE_CONTROL *psMove, PATHJOB *psJob);
+
+/// Follows a flow field towards the destination, shared by all jobs to the same destination with the same blocking map.
+ASR_RETVAL fpathFlowFieldRoute(const std::shared_ptr<FPathExecuteContext>& ctx, MOVE_CONTROL *psMove, PATHJOB *psJob);
+
 /// Call from main thread.
 /// Sets psJob->blockingMap for later use by pathfinding thread, generating the required map if not already generated.
+/// If psJob->hierarchical, also makes sure the blocking map has a cluster graph, repairing the one from the last tick.
 void fpathSetBlockingMap(PATHJOB *psJob);
 
 /** Clean up the path finding node table.
@@ -99,6 +99,8 @@ struct BASE_OBJECT : public SIMPLE_OBJECT
 	UBYTE               selected;                   ///< Whether the object is selected (might want this elsewhere)
 	UBYTE               visible[MAX_PLAYERS];       ///< Whether object is visible to specific player
 	UBYTE               seenThisTick[MAX_PLAYERS];  ///< Whether object has been seen this tick by the specific player.
+	uint32_t            gridIndex = 0;              ///< Index in the map grid as of the gridReset() given by gridGeneration. Not part of the game state.
+	uint32_t            gridGeneration = 0;         ///< See gridIndex, 0 if never in the map grid.
 	WEAPON_SUBCLASS     lastHitWeapon;              ///< The weapon that last hit it
 	UDWORD              timeLastHit;                ///< The time the structure was last attacked
 	UDWORD              body;                       ///< Hit points with lame name
@@ -26,6 +26,7 @@
 #include "lib/framework/frame.h"
 #include "lib/exceptionhandler/dumpinfo.h"
 #include "lib/netplay/netplay.h"
+#include "lib/gamelib/gtime.h"
 #include "lib/framework/string_ext.h"
 
 #include "input/debugmappings.h"
@@ -40,6 +41,7 @@
 #include "multiint.h"
 #include "multiplay.h"
 #include "gamestate_serialize.h"
+#include "replaykeyframes.h"
 
 struct CHEAT_ENTRY
 {
@@ -98,6 +100,7 @@ static CHEAT_ENTRY cheatCodes[] =
 	{"autogame off", kf_AutoGame},
 	{"shakey", kf_ToggleShakeStatus}, //shakey
 	{"list droids", kf_ListDroids},
+	{"grid check", kf_ToggleGridCrossCheck}, // compare the map grid with a full rebuild every tick
 
 };
 
@@ -128,6 +131,16 @@ bool _attemptCheatCode(const char *cheat_name)
 		intShowWidgetHelp();
 		return true;
 	}
+	if (NETisReplay() && !strncasecmp("seek ", cheat_name, 5))
+	{
+		// "seek <minutes>[:<seconds>]" jumps ahead in the replay
+		unsigned minutes = 0, seconds = 0;
+		if (sscanf(cheat_name + 5, "%u:%u", &minutes, &seconds) >= 1)
+		{
+			replayRequestSeek((minutes * 60 + seconds) * GAME_TICKS_PER_SEC);
+			return true;
+		}
+	}
 
 	const DebugInputManager& dbgInputManager = gInputManager.debugManager();
 	if (strcmp(cheat_name, "cheat on") == 0 || strcmp(cheat_name, "debug") == 0)
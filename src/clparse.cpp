@@ -29,6 +29,7 @@
 #include "lib/ivis_opengl/screen.h"
 #include "lib/netplay/netplay.h"
 #include "lib/netplay/sync_debug.h"
+#include "lib/gamelib/gtime.h"
 #include "lib/ivis_opengl/pieclip.h"
 #include "lib/ivis_opengl/png_util.h"
 
@@ -44,6 +45,8 @@
 #include "main.h"
 #include "modding.h"
 #include "multiplay.h"
+#include "replaykeyframes.h"
+#include "replayverify.h"
 #include "version.h"
 #include "warzoneconfig.h"
 #include "wrappers.h"
@@ -321,6 +324,12 @@ typedef enum
 	CLI_LOADSKIRMISH,
 	CLI_LOADCAMPAIGN,
 	CLI_LOADREPLAY,
+	CLI_REPLAY_SEEK,
+	CLI_REPLAY_REINDEX,
+	CLI_REPLAY_VERIFY,
+	CLI_REPLAY_VERIFY_JOBS,
+	CLI_REPLAY_VERIFY_WORKER,
+	CLI_REPLAY_VERIFY_REPORT,
 	CLI_WINDOW,
 	CLI_VERSION,
 	CLI_GAMESTATE_SELFTEST,
@@ -415,6 +424,12 @@ static const struct poptOption *getOptionsTable()
 		{ "loadskirmish", POPT_ARG_STRING, CLI_LOADSKIRMISH, N_("Load a saved skirmish game"),     N_("savegame") },
 		{ "loadcampaign", POPT_ARG_STRING, CLI_LOADCAMPAIGN, N_("Load a saved campaign game"),     N_("savegame") },
 		{ "loadreplay", POPT_ARG_STRING, CLI_LOADREPLAY, N_("Load a replay"),     N_("replay file") },
+		{ "replay-seek", POPT_ARG_STRING, CLI_REPLAY_SEEK, N_("Jump to the keyframe at or before the given game time once the replay has started"), N_("seconds") },
+		{ "replay-reindex", POPT_ARG_NONE, CLI_REPLAY_REINDEX, N_("Add keyframes to the loaded replay if it has none, then exit (use with --loadreplay and --headless)"), nullptr },
+		{ "replay-verify", POPT_ARG_STRING, CLI_REPLAY_VERIFY, N_("Play all the replays in a directory headless, in parallel, and write a sync report next to each of them"), N_("directory") },
+		{ "replay-verify-jobs", POPT_ARG_STRING, CLI_REPLAY_VERIFY_JOBS, N_("Number of replays --replay-verify plays at once (default: one per CPU core)"), N_("jobs") },
+		{ "replay-verify-worker", POPT_ARG_STRING, CLI_REPLAY_VERIFY_WORKER, N_("Play a replay for --replay-verify (internal)"), N_("replay file") },
+		{ "replay-verify-report", POPT_ARG_STRING, CLI_REPLAY_VERIFY_REPORT, N_("Where --replay-verify-worker writes its report (internal)"), N_("file") },
 		{ "window", POPT_ARG_NONE, CLI_WINDOW,     N_("Play in windowed mode"),             nullptr },
 		{ "version", POPT_ARG_NONE, CLI_VERSION,    N_("Show version information and exit"), nullptr },
 		{ "gamestate-selftest", POPT_ARG_NONE, CLI_GAMESTATE_SELFTEST, N_("Run the GameState serialization determinism self-test and exit"), nullptr },
@@ -621,6 +636,8 @@ ParseCLIEarlyResult ParseCommandLineEarly(int argc, const char * const *argv)
 {
 	poptContext poptCon = poptGetContext(nullptr, argc, argv, getOptionsTable(), 0);
 	int iOption;
+	std::string replayVerifyDirectory;
+	unsigned replayVerifyJobs = 0;
 
 	/* loop through command line */
 	while ((iOption = poptGetNextOpt(poptCon)) > 0 || iOption == POPT_ERROR_BADOPT)
@@ -673,6 +690,24 @@ ParseCLIEarlyResult ParseCommandLineEarly(int argc, const char * const *argv)
 			}
 			return ParseCLIEarlyResult::HANDLED_QUIT_EARLY_COMMAND;
 
+		case CLI_REPLAY_VERIFY:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Missing directory for --replay-verify");
+			}
+			replayVerifyDirectory = token;
+			break;
+
+		case CLI_REPLAY_VERIFY_JOBS:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr || atoi(token) <= 0)
+			{
+				qFatal("Bad number of jobs for --replay-verify-jobs");
+			}
+			replayVerifyJobs = static_cast<unsigned>(atoi(token));
+			break;
+
 #if defined(WZ_OS_WIN)
 		case CLI_WIN_ENABLE_CONSOLE:
 			SetStdOutToConsole_Win();
@@ -745,6 +780,16 @@ ParseCLIEarlyResult ParseCommandLineEarly(int argc, const char * const *argv)
 		};
 	}
 
+	if (!replayVerifyDirectory.empty())
+	{
+		// The workers are started with the same arguments, so there is nothing else to do here
+		if (!runReplayVerification(replayVerifyDirectory, replayVerifyJobs, argc, argv))
+		{
+			exit(EXIT_FAILURE);
+		}
+		return ParseCLIEarlyResult::HANDLED_QUIT_EARLY_COMMAND;
+	}
+
 	return ParseCLIEarlyResult::OK_CONTINUE;
 }
 
@@ -766,6 +811,17 @@ optional<bool> cliOptValueToBool(const char *token)
 	return nullopt;
 }
 
+// Once saveGameName is set to a replay
+static void startReplayFromCommandLine()
+{
+	setHostLaunch(HostLaunch::LoadReplay);
+	sstrcpy(sRequestResult, saveGameName); // hack to avoid crashes
+	SPinit(LEVEL_TYPE::SKIRMISH);
+	bMultiPlayer = true;
+	game.maxPlayers = 4; //DEFAULTSKIRMISHMAPMAXPLAYERS;
+	SetGameMode(GS_SAVEGAMELOAD);
+}
+
 //! second half of parsing the commandline
 /**
  * Second half of command line parsing. See ParseCommandLineEarly() for
@@ -793,6 +849,8 @@ bool ParseCommandLine(int argc, const char * const *argv)
 		case CLI_HELP:
 		case CLI_VERSION:
 		case CLI_GAMESTATE_SELFTEST:
+		case CLI_REPLAY_VERIFY:
+		case CLI_REPLAY_VERIFY_JOBS:
 #if defined(WZ_OS_WIN)
 		case CLI_WIN_ENABLE_CONSOLE:
 #endif
@@ -855,6 +913,25 @@ bool ParseCommandLine(int argc, const char * const *argv)
 			// go directly to host screen, bypass all others.
 			setHostLaunch(HostLaunch::Host);
 			break;
+		case CLI_REPLAY_SEEK:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Missing game time value for --replay-seek");
+			}
+			replaySetStartSeekTime(static_cast<uint32_t>(atoi(token)) * GAME_TICKS_PER_SEC);
+			break;
+		case CLI_REPLAY_REINDEX:
+			replaySetQuitAfterReindex(true);
+			break;
+		case CLI_REPLAY_VERIFY_REPORT:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Missing file path for --replay-verify-report");
+			}
+			replayVerifySetWorker(token);
+			break;
 		case CLI_GAMESTATE_ROUNDTRIP:
 			token = poptGetOptArg(poptCon);
 			if (token == nullptr)
@@ -1054,12 +1131,24 @@ bool ParseCommandLine(int argc, const char * const *argv)
 			{
 				qFatal("Unable to find specified replay");
 			}
-			setHostLaunch(HostLaunch::LoadReplay);
-			sstrcpy(sRequestResult, saveGameName); // hack to avoid crashes
-			SPinit(LEVEL_TYPE::SKIRMISH);
-			bMultiPlayer = true;
-			game.maxPlayers = 4; //DEFAULTSKIRMISHMAPMAXPLAYERS;
-			SetGameMode(GS_SAVEGAMELOAD);
+			startReplayFromCommandLine();
+			break;
+		}
+		case CLI_REPLAY_VERIFY_WORKER:
+		{
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Missing replay file for --replay-verify-worker");
+			}
+			// The replay may be anywhere, not just in the replay directory
+			const std::string replayPath = replayVerifyMountReplay(token);
+			if (replayPath.empty() || !PHYSFS_exists(replayPath.c_str()))
+			{
+				qFatal("Unable to find specified replay");
+			}
+			sstrcpy(saveGameName, replayPath.c_str());
+			startReplayFromCommandLine();
 			break;
 		}
 		case CLI_CONTINUE:
@@ -77,6 +77,7 @@
 #include "template.h"
 #include "qtscript.h"
 #include "campaigninfo.h"
+#include "profiling.h"
 
 #define DEFAULT_RECOIL_TIME	(GAME_TICKS_PER_SEC/4)
 #define	DROID_DAMAGE_SPREAD	(16 - rand()%32)
@@ -709,8 +710,9 @@ bool destroyDroid(DROID *psDel, unsigned impactTime, GameWorld& world)
 				psTile = mapTile(world.map, width, breadth);
 				if (TEST_TILE_VISIBLE_TO_SELECTEDPLAYER(psTile))
 				{
-					psTile->illumination /= 2;
-					psTile->ambientOcclusion /= 2;
+					TileDisplay *psDisplay = mapTileDisplay(world.map, width, breadth);
+					psDisplay->illumination /= 2;
+					psDisplay->ambientOcclusion /= 2;
 				}
 			}
 		}
@@ -874,6 +876,7 @@ void _syncDebugDroid(const char *function, DROID const *psDroid, char ch)
 /* The main update routine for all droids */
 void droidUpdate(DROID *psDroid)
 {
+	WZ_PROFILE_SCOPE(droidUpdate);
 	Vector3i        dv;
 	UDWORD          percentDamage, emissionInterval;
 	BASE_OBJECT     *psBeingTargetted = nullptr;
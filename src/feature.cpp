@@ -52,6 +52,7 @@
 #include "display3d.h"
 #include "random.h"
 #include "game_world.h"
+#include "statids.h"
 
 /* The statistics for the features */
 std::vector<FEATURE_STATS> asFeatureStats;
@@ -59,9 +60,13 @@ std::vector<FEATURE_STATS> asFeatureStats;
 //Value is stored for easy access to this feature in destroyDroid()/destroyStruct()
 FEATURE_STATS *oilResFeature = nullptr;
 
+/// Text ids of asFeatureStats, interned in the same order, so that a StatId is an index into asFeatureStats
+static StatIdTable featureIds;
+
 void featureInitVars()
 {
 	asFeatureStats.clear();
+	featureIds.clear();
 	oilResFeature = nullptr;
 }
 
@@ -78,6 +83,8 @@ bool loadFeatureStats(WzConfig &ini)
 		FEATURE_STATS& p = asFeatureStats[i];
 		p.name = ini.string(WzString::fromUtf8("name"));
 		p.id = list[i];
+		const StatId featureId = featureIds.intern(p.id.toUtf8());
+		ASSERT(featureId == i, "Feature ID '%s' interned out of order", getID(&p));
 		WzString subType = ini.value("type").toWzString();
 		if (subType == "TANK WRECK")
 		{
@@ -144,6 +151,7 @@ bool loadFeatureStats(WzConfig &ini)
 void featureStatsShutDown()
 {
 	asFeatureStats.clear();
+	featureIds.clear();
 }
 
 /** Deals with damage to a feature
@@ -341,6 +349,7 @@ FEATURE *buildFeature(GameWorld& world, FEATURE_STATS *psStats, UDWORD x, UDWORD
 			if ((!psStats->tileDraw) && (FromSave == false))
 			{
 				psTile->height = height;
+				mapHeightChanged(world.map, tileY);
 			}
 		}
 	}
@@ -586,17 +595,13 @@ bool destroyFeature(FEATURE *psDel, unsigned impactTime, GameWorld& world)
 
 SDWORD getFeatureStatFromName(const WzString &name)
 {
-	FEATURE_STATS *psStat;
+	return getFeatureStatFromName(name.toUtf8());
+}
 
-	for (unsigned inc = 0, size = asFeatureStats.size(); inc < size; inc++)
-	{
-		psStat = &asFeatureStats[inc];
-		if (psStat->id.compare(name) == 0)
-		{
-			return inc;
-		}
-	}
-	return -1;
+SDWORD getFeatureStatFromName(std::string_view name)
+{
+	const StatId featureId = featureIds.find(name);
+	return featureId < asFeatureStats.size() ? static_cast<SDWORD>(featureId) : -1;
 }
 
 StructureBounds getStructureBounds(FEATURE const *object)
@@ -28,6 +28,8 @@
 #include "lib/framework/wzconfig.h"
 #include "lib/framework/paged_entity_container.h"
 
+#include <string_view>
+
 struct GameWorld;
 
 /* The statistics for the features */
@@ -57,6 +59,7 @@ bool destroyFeature(FEATURE *psDel, unsigned impactTime, GameWorld& world);
 
 /* get a feature stat id from its name */
 SDWORD getFeatureStatFromName(const WzString &name);
+SDWORD getFeatureStatFromName(std::string_view name);
 
 int32_t featureDamage(GameWorld& world, FEATURE *psFeature, unsigned damage, WEAPON_CLASS weaponClass, WEAPON_SUBCLASS weaponSubClass, unsigned impactTime, bool isDamagePerSecond, int minDamage, bool empRadiusHit);
 
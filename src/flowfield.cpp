@@ -0,0 +1,150 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Flow field path finding, see flowfield.h.
+ */
+
+#include "flowfield.h"
+
+#include <algorithm>
+#include <functional>
+
+/// Neighbours, in the order in which ties are broken when walking down the field.
+static const HpaCoord neighbourOffset[8] = {HpaCoord(1, 0), HpaCoord(0, 1), HpaCoord(-1, 0), HpaCoord(0, -1), HpaCoord(1, 1), HpaCoord(-1, 1), HpaCoord(-1, -1), HpaCoord(1, -1)};
+
+/// Whether the step by offset is blocked, or would cut a corner, given the blocking tiles around (see PathBitmap::neighbourhood()).
+static inline bool stepBlocked(uint32_t neighbourhood, HpaCoord offset)
+{
+	auto blocked = [neighbourhood](int dx, int dy) {
+		return ((neighbourhood >> ((dx + 1) + 3 * (dy + 1))) & 1) != 0;
+	};
+	return blocked(offset.x, offset.y) || (offset.x && offset.y && (blocked(offset.x, 0) || blocked(0, offset.y)));
+}
+
+FlowField::FlowField(std::shared_ptr<const PathBitmap> blocking, std::shared_ptr<const PathBitmap> danger, HpaCoord goal)
+	: width(blocking->width())
+	, height(blocking->height())
+	, blockingMap(std::move(blocking))
+	, dangerMap(std::move(danger))
+	, goalTile(goal)
+{
+	dist.assign(static_cast<size_t>(width) * height, NO_PATH);
+	closed.assign(static_cast<size_t>(width) * height, false);
+	if (tileCost(goal.x, goal.y) != 0)
+	{
+		uint32_t index = goal.x + goal.y * width;
+		dist[index] = 0;
+		open.push_back(index);
+	}
+}
+
+unsigned FlowField::tileCost(int x, int y) const
+{
+	// Tiles off the map test as blocking.
+	if (blockingMap->test(x, y))
+	{
+		return 0;
+	}
+	return dangerMap != nullptr && dangerMap->test(x, y) ? 5 : 1;
+}
+
+uint32_t FlowField::distance(HpaCoord tile)
+{
+	if (tileCost(tile.x, tile.y) == 0)
+	{
+		return NO_PATH;
+	}
+	const uint32_t target = tile.x + tile.y * width;
+	while (!closed[target] && !open.empty())
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+		const uint32_t index = open.back() & 0xFFFFFFFF;
+		open.pop_back();
+		if (closed[index])
+		{
+			continue;
+		}
+		closed[index] = true;
+		++explored;
+
+		// Relax the tiles from which this one can be reached in one step.
+		const int x = index % width, y = index / width;
+		const unsigned cost = tileCost(x, y);
+		const uint32_t neighbourhood = blockingMap->neighbourhood(x, y);
+		for (HpaCoord offset : neighbourOffset)
+		{
+			if (stepBlocked(neighbourhood, offset))
+			{
+				continue;  // Blocking, or would cut a corner.
+			}
+			const int nx = x + offset.x, ny = y + offset.y;
+			const uint32_t neighbour = nx + ny * width;
+			const uint32_t d = dist[index] + (offset.x && offset.y ? 198 : 140) * cost;
+			if (d < dist[neighbour])
+			{
+				dist[neighbour] = d;
+				open.push_back(uint64_t(d) << 32 | neighbour);
+				std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+			}
+		}
+	}
+	return closed[target] ? dist[target] : NO_PATH;
+}
+
+bool FlowField::findPath(HpaCoord start, std::vector<HpaCoord> &path)
+{
+	path.clear();
+	if (distance(start) == NO_PATH)
+	{
+		return false;
+	}
+
+	// Every tile nearer to the goal than a closed tile is closed too, so the distances walked through are exact.
+	HpaCoord tile = start;
+	path.push_back(tile);
+	while (tile != goalTile)
+	{
+		const uint32_t d = dist[tile.x + tile.y * width];
+		const uint32_t neighbourhood = blockingMap->neighbourhood(tile.x, tile.y);
+		bool moved = false;
+		for (HpaCoord offset : neighbourOffset)
+		{
+			if (stepBlocked(neighbourhood, offset))
+			{
+				continue;
+			}
+			const int nx = tile.x + offset.x, ny = tile.y + offset.y;
+			const unsigned cost = tileCost(nx, ny);
+			const uint32_t neighbour = nx + ny * width;
+			if (closed[neighbour] && dist[neighbour] + (offset.x && offset.y ? 198 : 140) * cost == d)
+			{
+				tile = HpaCoord(nx, ny);
+				moved = true;
+				break;
+			}
+		}
+		if (!moved)
+		{
+			path.clear();  // Can't happen, the tile which gave this one its distance is always downhill.
+			return false;
+		}
+		path.push_back(tile);
+	}
+	return true;
+}
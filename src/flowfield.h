@@ -0,0 +1,75 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Flow field (distance field) path finding, for many droids going to the same destination.
+ *
+ *  The field holds the distance from each tile to one goal tile. It is explored lazily, by a Dijkstra
+ *  search outwards from the goal which is continued each time a tile not yet reached is queried. A path
+ *  is then found by walking downhill from the start, which costs only the length of the path.
+ *
+ *  Distances are exact, so the path from a tile does not depend on how much of the field was explored
+ *  before, nor on which other tiles were queried. Costs are those of HpaGraph (see hpastar.h), read
+ *  straight from the path finding blocking and danger bitmaps.
+ */
+
+#ifndef __INCLUDED_SRC_FLOWFIELD_H__
+#define __INCLUDED_SRC_FLOWFIELD_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "hpastar.h"
+#include "pathbitmap.h"
+
+class FlowField
+{
+public:
+	static constexpr uint32_t NO_PATH = UINT32_MAX;
+
+	/// Makes the field towards goal, over the tiles which are not set in blocking. Tiles set in danger (which may be null)
+	/// cost 5 times as much, as in fpathNewNode().
+	FlowField(std::shared_ptr<const PathBitmap> blocking, std::shared_ptr<const PathBitmap> danger, HpaCoord goal);
+
+	/// Returns the distance from tile to the goal, or NO_PATH if the goal can't be reached. Explores the field as needed.
+	uint32_t distance(HpaCoord tile);
+
+	/// Finds a path from start to the goal, and stores the tiles along it, including start and goal, in path.
+	/// Returns false if there is no path.
+	bool findPath(HpaCoord start, std::vector<HpaCoord> &path);
+
+	HpaCoord goal() const { return goalTile; }
+	size_t numExplored() const { return explored; }  ///< Number of tiles whose distance is known.
+
+private:
+	unsigned tileCost(int x, int y) const;
+
+	int width = 0;
+	int height = 0;
+	std::shared_ptr<const PathBitmap> blockingMap;
+	std::shared_ptr<const PathBitmap> dangerMap;
+	HpaCoord goalTile;
+	std::vector<uint32_t> dist;   ///< Exact once closed, otherwise the best distance found so far.
+	std::vector<bool> closed;
+	std::vector<uint64_t> open;   ///< Heap of dist << 32 | tile index.
+	size_t explored = 0;
+};
+
+#endif // __INCLUDED_SRC_FLOWFIELD_H__
@@ -24,6 +24,8 @@
  *
  */
 
+#include <chrono>
+#include <deque>
 #include <future>
 #include <unordered_map>
 
@@ -38,6 +40,7 @@
 #include "map.h"
 #include "multiplay.h"
 #include "astar.h"
+#include "pathbitmap.h"
 
 #include "fpath.h"
 #include "profiling.h"
@@ -61,19 +64,37 @@ struct PATHRESULT
 // threading stuff
 using packagedPathJob = wz::packaged_task<PATHRESULT(const std::shared_ptr<FPathExecuteContext>& ctx)>;
 
+struct QueuedPathJob
+{
+	packagedPathJob task;
+	std::chrono::steady_clock::time_point queueTime;  ///< For the latency statistics.
+};
+
+/** A queue of jobs which must be run in order, with the same PathfindContexts, see fpathJobDispatchLane().
+ *
+ *  The contexts belong to the lane rather than to a thread, so any thread may run the jobs of a lane (one
+ *  thread at a time), without changing the results. Each lane has a home thread, which runs its jobs unless
+ *  that thread is busy while another thread is idle, in which case the idle thread steals the lane.
+ */
+struct FpathLane
+{
+	std::deque<QueuedPathJob> pathJobs;
+	std::shared_ptr<FPathExecuteContext> ctx;  ///< Created on first use.
+	uint32_t lastGameTime = 0;                 ///< gameTime when the last job was queued.
+	size_t homeThread = 0;
+	bool running = false;                      ///< A thread is running the jobs of this lane.
+};
+
 struct FpathThreadInfo
 {
 public:
 	FpathThreadInfo()
 	{
-		mutex = wzMutexCreate();
 		semaphore = wzSemaphoreCreate(0);
 	}
 
 	~FpathThreadInfo()
 	{
-		wzMutexDestroy(mutex);
-		mutex = nullptr;
 		wzSemaphoreDestroy(semaphore);
 		semaphore = nullptr;
 	}
@@ -84,10 +105,16 @@ public:
 	FpathThreadInfo& operator=(const FpathThreadInfo&) = delete;
 public:
 	WZ_SEMAPHORE *semaphore;
-	WZ_MUTEX *mutex;
-	std::list<packagedPathJob> pathJobs;
+	size_t index = 0;
+	bool idle = false;          ///< Waiting for semaphore, and not posted yet.
+	FPathThreadStats stats;
 };
 
+/// Number of lanes, independent of the number of threads, so that the results are too.
+constexpr size_t FPATH_LANES = 64;
+
+static WZ_MUTEX *fpathMutex = nullptr;  ///< Protects fpathLanes, and the idle flags and statistics in fpathThreadsInfo.
+static std::vector<FpathLane> fpathLanes;
 static std::vector<WZ_THREAD *> fpathThreads;
 static std::vector<std::unique_ptr<FpathThreadInfo>> fpathThreadsInfo;
 static std::unordered_map<uint32_t, wz::future<PATHRESULT>> pathResults;
@@ -99,49 +126,122 @@ static uint32_t currentFpathTick = 0;
 
 constexpr size_t MAX_FPATH_THREADS = 2;
 
+/// Whether to use hierarchical path finding for long routes.
+static bool fpathHierarchical = false;
+/// Routes shorter than this (in tiles, along either axis) are found faster by plain A*.
+constexpr int HIERARCHICAL_MIN_DISTANCE = 32;
+
+/// Whether to use flow fields for groups of droids going to the same destination.
+static bool fpathFlowField = false;
+/// Groups of droids given the same order need at least this many droids to use a flow field.
+constexpr unsigned FLOWFIELD_MIN_GROUP = 8;
+/// Number of droids given the order being carried out, see fpathBeginGroupOrder(). 0 if not in a group order.
+static unsigned fpathGroupOrderSize = 0;
+
 static PATHRESULT fpathExecute(const std::shared_ptr<FPathExecuteContext>& ctx, PATHJOB psJob);
 
 
+/// Picks the lane with the oldest waiting job, preferring the lanes homed on threadInfo. Call with fpathMutex locked.
+static FpathLane *fpathTakeLane(FpathThreadInfo &threadInfo)
+{
+	FpathLane *best = nullptr;
+	for (auto &lane : fpathLanes)
+	{
+		if (lane.running || lane.pathJobs.empty())
+		{
+			continue;
+		}
+		if (best == nullptr)
+		{
+			best = &lane;
+			continue;
+		}
+		bool isHome = lane.homeThread == threadInfo.index;
+		bool bestIsHome = best->homeThread == threadInfo.index;
+		if (isHome != bestIsHome ? isHome : lane.pathJobs.front().queueTime < best->pathJobs.front().queueTime)
+		{
+			best = &lane;
+		}
+	}
+	if (best != nullptr)
+	{
+		best->running = true;
+	}
+	return best;
+}
+
+/// Wakes up the home thread of a lane if idle, otherwise any idle thread, to steal it. Call with fpathMutex locked.
+static void fpathWakeThread(size_t homeThread)
+{
+	FpathThreadInfo *wake = fpathThreadsInfo[homeThread]->idle ? fpathThreadsInfo[homeThread].get() : nullptr;
+	for (size_t i = 0; i < fpathThreadsInfo.size() && wake == nullptr; ++i)
+	{
+		wake = fpathThreadsInfo[i]->idle ? fpathThreadsInfo[i].get() : nullptr;
+	}
+	if (wake != nullptr)
+	{
+		wake->idle = false;
+		wzSemaphorePost(wake->semaphore);
+	}
+	// Otherwise all threads are busy, and will look for more work when done.
+}
+
+static size_t fpathLatencyBucket(std::chrono::steady_clock::duration latency)
+{
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+	size_t bucket = 0;
+	while (bucket + 1 < FPathThreadStats::LATENCY_BUCKETS && us >= (FPathThreadStats::LATENCY_BUCKET_MIN_US << bucket))
+	{
+		++bucket;
+	}
+	return bucket;
+}
+
 /** This runs in a separate thread */
 static int fpathThreadFunc(void *data)
 {
 	FpathThreadInfo* threadInfo = static_cast<FpathThreadInfo*>(data);
-	WZ_SEMAPHORE *fpathSemaphore = threadInfo->semaphore;
-	WZ_MUTEX *fpathMutex = threadInfo->mutex;
-	std::list<packagedPathJob>& pathJobs = threadInfo->pathJobs;
 
-	// create an fpath astar job context
-	auto ctx = makeFPathExecuteContext();
-
-	while (true)
+	wzMutexLock(fpathMutex);
+	while (!fpathQuit)
 	{
-		wzSemaphoreWait(fpathSemaphore);  // Wait until needed.
-		wzMutexLock(fpathMutex);
-
-		if (fpathQuit)
+		FpathLane *lane = fpathTakeLane(*threadInfo);
+		if (lane == nullptr)
 		{
+			threadInfo->idle = true;
 			wzMutexUnlock(fpathMutex);
-			break;
+			wzSemaphoreWait(threadInfo->semaphore);  // Wait until needed.
+			wzMutexLock(fpathMutex);
+			continue;
 		}
 
-		if (pathJobs.empty())
+		if (!lane->ctx)
 		{
-			// should not happen - semaphore was signaled!
-			ASSERT(!pathJobs.empty(), "Received a signal but no job to consume!");
-			wzMutexUnlock(fpathMutex);
-			continue;
-
+			// create an fpath astar job context
+			lane->ctx = makeFPathExecuteContext();
 		}
+		std::shared_ptr<FPathExecuteContext> ctx = lane->ctx;
+		while (!lane->pathJobs.empty() && !fpathQuit)
+		{
+			// Copy the first job from the queue.
+			QueuedPathJob job = std::move(lane->pathJobs.front());
+			lane->pathJobs.pop_front();
 
-		WZ_PROFILE_SCOPE(fpathJob);
-		// Copy the first job from the queue.
-		packagedPathJob job = std::move(pathJobs.front());
-		pathJobs.pop_front();
-
-		wzMutexUnlock(fpathMutex);
+			wzMutexUnlock(fpathMutex);
+			{
+				WZ_PROFILE_SCOPE(fpathJob);
+				job.task(ctx);
+			}
+			auto latency = std::chrono::steady_clock::now() - job.queueTime;
+			wzMutexLock(fpathMutex);
 
-		job(ctx);
+			++threadInfo->stats.jobsRun;
+			threadInfo->stats.jobsStolen += lane->homeThread != threadInfo->index;
+			++threadInfo->stats.latency[fpathLatencyBucket(latency)];
+		}
+		lane->running = false;
 	}
+	wzMutexUnlock(fpathMutex);
 	return 0;
 }
 
@@ -166,6 +266,12 @@ bool fpathInitialise()
 	{
 		auto numThreads = fpathDetermineNumberOfThreads();
 		debug(LOG_INFO, "Using threads: %zu", numThreads);
+		fpathMutex = wzMutexCreate();
+		fpathLanes.resize(FPATH_LANES);
+		for (size_t i = 0; i < fpathLanes.size(); ++i)
+		{
+			fpathLanes[i].homeThread = i % numThreads;
+		}
 		fpathThreads.resize(numThreads, nullptr);
 		fpathThreadsInfo.resize(numThreads);
 #ifdef DEBUG
@@ -174,6 +280,7 @@ bool fpathInitialise()
 		for (size_t i = 0; i < fpathThreads.size(); ++i)
 		{
 			fpathThreadsInfo[i] = std::make_unique<FpathThreadInfo>();
+			fpathThreadsInfo[i]->index = i;
 			fpathThreads[i] = wzThreadCreate(fpathThreadFunc, fpathThreadsInfo[i].get(), "wzPath");
 			wzThreadStart(fpathThreads[i]);
 		}
@@ -188,7 +295,9 @@ void fpathShutdown()
 	if (!fpathThreads.empty())
 	{
 		// Signal the path finding thread(s) to quit
+		wzMutexLock(fpathMutex);
 		fpathQuit = true;
+		wzMutexUnlock(fpathMutex);
 		for (size_t i = 0; i < fpathThreadsInfo.size(); ++i)
 		{
 			wzSemaphorePost(fpathThreadsInfo[i]->semaphore);  // Wake up a thread
@@ -199,6 +308,9 @@ void fpathShutdown()
 		}
 		fpathThreads.clear();
 		fpathThreadsInfo.clear();
+		fpathLanes.clear();
+		wzMutexDestroy(fpathMutex);
+		fpathMutex = nullptr;
 
 #ifdef DEBUG
 		numJobsPerThreadThisTick.clear();
@@ -206,6 +318,9 @@ void fpathShutdown()
 #endif
 	}
 	fpathHardTableReset();
+	fpathHierarchical = false;  // Game setting, set again by the rules scripts of the next game.
+	fpathFlowField = false;
+	fpathGroupOrderSize = 0;
 }
 
 
@@ -215,7 +330,95 @@ void fpathShutdown()
  */
 void fpathUpdate()
 {
-	// Nothing now
+	WZ_PROFILE_SCOPE(fpathUpdate);
+	// Free the PathfindContexts of lanes which got no jobs since the last tick. Contexts only match jobs from
+	// the same tick, so this can't change any results.
+	if (fpathMutex == nullptr)
+	{
+		return;
+	}
+	wzMutexLock(fpathMutex);
+	for (auto &lane : fpathLanes)
+	{
+		if (lane.ctx && !lane.running && lane.pathJobs.empty() && lane.lastGameTime != gameTime)
+		{
+			lane.ctx.reset();
+		}
+	}
+	wzMutexUnlock(fpathMutex);
+}
+
+void fpathSetHierarchical(bool enable)
+{
+	fpathHierarchical = enable;
+}
+
+bool fpathGetHierarchical()
+{
+	return fpathHierarchical;
+}
+
+void fpathSetFlowField(bool enable)
+{
+	fpathFlowField = enable;
+}
+
+bool fpathGetFlowField()
+{
+	return fpathFlowField;
+}
+
+void fpathBeginGroupOrder(unsigned numDroids)
+{
+	fpathGroupOrderSize = numDroids;
+}
+
+void fpathEndGroupOrder()
+{
+	fpathGroupOrderSize = 0;
+}
+
+/// Whether start and destination are on the same continent, for ground and water propulsion. Coordinates are in world units.
+static bool fpathSameContinent(const WorldMapState& mapState, int startX, int startY, int tX, int tY, PROPULSION_TYPE propulsion)
+{
+	MAPTILE const *startTile = worldTile(mapState, startX, startY);
+	MAPTILE const *destTile = worldTile(mapState, tX, tY);
+	if (propulsion == PROPULSION_TYPE_HOVER)
+	{
+		return startTile->hoverContinent == destTile->hoverContinent;
+	}
+	return startTile->limitedContinent == destTile->limitedContinent;
+}
+
+/// Whether a route is worth finding with fpathHierarchicalRoute(). Coordinates are in world units.
+static bool fpathUseHierarchical(const WorldMapState& mapState, int startX, int startY, int tX, int tY, PROPULSION_TYPE propulsion, StructureBounds const &dstStructure)
+{
+	if (!fpathHierarchical || propulsion == PROPULSION_TYPE_LIFT || dstStructure.valid())
+	{
+		return false;  // Not worth it for VTOLs, and the cluster graph can't ignore the destination structure.
+	}
+	if (std::max(abs(map_coord(startX) - map_coord(tX)), abs(map_coord(startY) - map_coord(tY))) < HIERARCHICAL_MIN_DISTANCE)
+	{
+		return false;
+	}
+	// Routes to another continent can't be found, only the nearest route, which needs fpathAStarRoute() anyway.
+	return fpathSameContinent(mapState, startX, startY, tX, tY, propulsion);
+}
+
+/// Whether job is part of a group order big enough to be worth a flow field. The same for every droid of the group, whatever
+/// the order they are given it in.
+static bool fpathUseFlowField(const WorldMapState& mapState, PATHJOB const &job)
+{
+	if (!fpathFlowField || job.propulsion == PROPULSION_TYPE_LIFT || job.dstStructure.valid())
+	{
+		return false;  // Not worth it for VTOLs, and the flow field can't ignore the destination structure.
+	}
+	if (fpathGroupOrderSize < FLOWFIELD_MIN_GROUP)
+	{
+		return false;
+	}
+	// Droids on another continent would flood the whole field, only to fall back to fpathAStarRoute().
+	return fpathSameContinent(mapState, job.origX, job.origY, job.destX, job.destY, job.propulsion);
 }
 
 static constexpr size_t fpathPropulsionDomain(PROPULSION_TYPE propulsion)
@@ -230,12 +433,10 @@ static constexpr size_t fpathPropulsionDomain(PROPULSION_TYPE propulsion)
 	return 0; // silence compiler warning
 }
 
-static inline size_t fpathJobDispatchThreadId(const PATHJOB& job, size_t numThreads)
+static inline size_t fpathJobDispatchLane(const PATHJOB& job)
 {
-	if (numThreads == 1) { return 0; }
-
-	// Every job that matches a PathfindContext must be processed by the same thread, as the result of fpathAStarRoute is dependent upon jobs
-	// within each matching "cohort" having access to the same PathfindContext (and PathfindContexts are not shared between threads).
+	// Every job that matches a PathfindContext must be processed in the same lane, as the result of fpathAStarRoute is dependent upon jobs
+	// within each matching "cohort" having access to the same PathfindContext (and PathfindContexts are not shared between lanes).
 	//
 	// (In other words, the results may slightly differ depending on whether an existing PathfindContext is reused versus starting from scratch.)
 
@@ -257,7 +458,7 @@ static inline size_t fpathJobDispatchThreadId(const PATHJOB& job, size_t numThre
 		// So use those + tileDest
 		hash_combine(h, domain, job.owner, job.moveType, tileDest.x, tileDest.y);
 	}
-	return h % numThreads;
+	return h % FPATH_LANES;
 }
 
 bool fpathIsEquivalentBlocking(PROPULSION_TYPE propulsion1, int player1, FPATH_MOVETYPE moveType1,
@@ -341,6 +542,40 @@ bool fpathBaseBlockingTile(const WorldMapState& mapState, SDWORD x, SDWORD y, PR
 	return (blockTile(mapState, x, y, MAX(0, mapIndex - MAX_PLAYERS)) & unitbits) != 0;  // finally check if move is blocked by propulsion related factors
 }
 
+void fpathBaseBlockingRow(const WorldMapState& mapState, int y, PROPULSION_TYPE propulsion, int mapIndex, FPATH_MOVETYPE moveType, PathBitmap &map)
+{
+	// Same rules as fpathBaseBlockingTile(), a row at a time.
+	int x0 = 1, x1 = mapState.width - 1, y0 = 1, y1 = mapState.height - 1;
+	if (propulsion != PROPULSION_TYPE_LIFT)
+	{
+		x0 = std::max(x0, mapState.scroll.minX + 1);
+		x1 = std::min(x1, mapState.scroll.maxX - 2);
+		y0 = std::max(y0, mapState.scroll.minY + 1);
+		y1 = std::min(y1, mapState.scroll.maxY - 2);
+	}
+	if (y < y0 || y > y1)
+	{
+		map.setRow(y);
+		return;
+	}
+	ASSERT_OR_RETURN(, mapIndex >= 0 && mapIndex < MAX_PLAYERS + AUX_MAX, "invalid player: %d", mapIndex);
+
+	int auxMask = 0;
+	switch (moveType)
+	{
+	case FMT_MOVE:   auxMask = AUXBITS_NONPASSABLE; break;
+	case FMT_ATTACK: auxMask = AUXBITS_OUR_BUILDING; break;
+	case FMT_BLOCK:  auxMask = AUXBITS_BLOCKING; break;
+	}
+
+	uint8_t unitbits = prop2bits(propulsion);
+	const size_t offset = static_cast<size_t>(y) * mapState.width;
+	uint8_t const *aux = (unitbits & FEATURE_BLOCKED) != 0 ? &mapState.auxMap[mapIndex][offset] : nullptr;
+	uint8_t const *block = &mapState.blockMap[MAX(0, mapIndex - MAX_PLAYERS)][offset];
+	map.packRow(y, aux, aux != nullptr ? auxMask : 0, block, unitbits);
+	map.setOutside(y, x0, x1);
+}
+
 bool fpathDroidBlockingTile(DROID *psDroid, const WorldMapState& mapState, int x, int y, FPATH_MOVETYPE moveType)
 {
 	return fpathBaseBlockingTile(mapState, x, y, psDroid->getPropulsionStats()->propulsionType, psDroid->player, moveType);
@@ -539,8 +774,10 @@ queuePathfinding:
 	job.moveType = moveType;
 	job.owner = owner;
 	job.acceptNearest = acceptNearest;
+	job.hierarchical = fpathUseHierarchical(mapState, startX, startY, tX, tY, propulsionType, dstStructure);
 	job.deleted = false;
 	fpathSetBlockingMap(&job);
+	job.flowField = fpathUseFlowField(mapState, job);
 
 	debug(LOG_NEVER, "starting new job for droid %d 0x%x", id, id);
 	// Clear any results or jobs waiting already. It is a vital assumption that there is only one
@@ -550,20 +787,22 @@ queuePathfinding:
 	packagedPathJob task([job](const std::shared_ptr<FPathExecuteContext>& ctx) { return fpathExecute(ctx, job); });
 	pathResults[id] = task.get_future();
 
-	// Get target thread for job
-	auto targetThreadId = fpathJobDispatchThreadId(job, fpathThreads.size());
-	auto& threadInfo = *fpathThreadsInfo[targetThreadId];
+	// Get target lane for job
+	auto& lane = fpathLanes[fpathJobDispatchLane(job)];
 
 	// Add to end of appropriate list
-	wzMutexLock(threadInfo.mutex);
-	bool isFirstJob = threadInfo.pathJobs.empty();
-	threadInfo.pathJobs.push_back(std::move(task));
-	wzMutexUnlock(threadInfo.mutex);
-
-	wzSemaphorePost(threadInfo.semaphore);  // Increment semaphore
+	wzMutexLock(fpathMutex);
+	bool isFirstJob = lane.pathJobs.empty();
+	lane.pathJobs.push_back(QueuedPathJob{std::move(task), std::chrono::steady_clock::now()});
+	lane.lastGameTime = gameTime;
+	if (!lane.running)
+	{
+		fpathWakeThread(lane.homeThread);
+	}
+	wzMutexUnlock(fpathMutex);
 
 #ifdef DEBUG
-	numJobsPerThreadThisTick[targetThreadId]++;
+	numJobsPerThreadThisTick[lane.homeThread]++;
 #endif
 
 	objTrace(id, "Queued up a path-finding request to (%d, %d), at least %d items earlier in queue", tX, tY, isFirstJob);
@@ -625,7 +864,19 @@ PATHRESULT fpathExecute(const std::shared_ptr<FPathExecuteContext>& ctx, PATHJOB
 	result.retval = FPR_FAILED;
 	result.originalDest = Vector2i(job.destX, job.destY);
 
-	ASR_RETVAL retval = fpathAStarRoute(ctx, &result.sMove, &job);
+	ASR_RETVAL retval = ASR_FAILED;
+	if (job.flowField)
+	{
+		retval = fpathFlowFieldRoute(ctx, &result.sMove, &job);
+	}
+	if (retval == ASR_FAILED && job.hierarchical)
+	{
+		retval = fpathHierarchicalRoute(ctx, &result.sMove, &job);
+	}
+	if (retval == ASR_FAILED)
+	{
+		retval = fpathAStarRoute(ctx, &result.sMove, &job);
+	}
 
 	ASSERT(retval != ASR_OK || result.sMove.asPath.size() > 0, "Ok result but no path in result");
 	switch (retval)
@@ -669,15 +920,66 @@ static size_t fpathJobQueueLength()
 {
 	size_t count = 0;
 
-	for (const auto& threadInfo : fpathThreadsInfo)
+	wzMutexLock(fpathMutex);
+	for (const auto& lane : fpathLanes)
 	{
-		wzMutexLock(threadInfo->mutex);
-		count += threadInfo->pathJobs.size(); // O(N) function call for std::list. .empty() is faster, but this function isn't used except in tests.
-		wzMutexUnlock(threadInfo->mutex);
+		count += lane.pathJobs.size();
 	}
+	wzMutexUnlock(fpathMutex);
 	return count;
 }
 
+size_t fpathNumThreads()
+{
+	return fpathThreadsInfo.size();
+}
+
+size_t fpathThreadJobQueueLength(size_t thread)
+{
+	size_t count = 0;
+	if (fpathMutex == nullptr)
+	{
+		return count;
+	}
+
+	wzMutexLock(fpathMutex);
+	for (const auto& lane : fpathLanes)
+	{
+		count += lane.homeThread == thread ? lane.pathJobs.size() : 0;
+	}
+	wzMutexUnlock(fpathMutex);
+	return count;
+}
+
+FPathThreadStats fpathGetThreadStats(size_t thread)
+{
+	ASSERT_OR_RETURN({}, thread < fpathThreadsInfo.size(), "Invalid path finding thread %zu", thread);
+	FPathThreadStats stats;
+
+	wzMutexLock(fpathMutex);
+	stats = fpathThreadsInfo[thread]->stats;
+	for (const auto& lane : fpathLanes)
+	{
+		stats.queueLength += lane.homeThread == thread ? lane.pathJobs.size() : 0;
+	}
+	wzMutexUnlock(fpathMutex);
+	return stats;
+}
+
+void fpathResetThreadStats()
+{
+	if (fpathMutex == nullptr)
+	{
+		return;
+	}
+	wzMutexLock(fpathMutex);
+	for (auto& threadInfo : fpathThreadsInfo)
+	{
+		threadInfo->stats = FPathThreadStats();
+	}
+	wzMutexUnlock(fpathMutex);
+}
+
 
 /** Find the length of the result queue, excepting future results. Function must be called from the main thread.. */
 static size_t fpathResultQueueLength()
@@ -706,9 +1008,9 @@ void fpathTest(int x, int y, int x2, int y2)
 
 	/* Check initial state */
 	assert(!fpathThreads.empty());
+	ASSERT(fpathMutex != nullptr, "Failed to initialize mutex?");
 	for (const auto& threadInfo : fpathThreadsInfo)
 	{
-		ASSERT(threadInfo->mutex != nullptr, "Failed to initialize mutex?");
 		ASSERT(threadInfo->semaphore != nullptr, "Failed to initialize semaphore?");
 	}
 	assert(fpathJobQueueLength() == 0);
@@ -26,6 +26,8 @@
 
 #include "droiddef.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -45,6 +47,7 @@ enum FPATH_MOVETYPE
 };
 
 struct PathBlockingMap;
+class PathBitmap;
 
 struct PATHJOB
 {
@@ -58,6 +61,8 @@ struct PATHJOB
 	int		owner;		///< Player owner
 	std::shared_ptr<const PathBlockingMap> blockingMap;   ///< Map of blocking tiles.
 	bool		acceptNearest;
+	bool            hierarchical;   ///< Try fpathHierarchicalRoute() before fpathAStarRoute().
+	bool            flowField;      ///< Try fpathFlowFieldRoute() before the others.
 	bool            deleted;        ///< Droid was deleted, so throw away result when complete. Must still process this PATHJOB, since processing order can affect resulting paths (but can't affect the path length).
 };
 
@@ -98,6 +103,22 @@ void fpathSetPendingResult(uint32_t droidID, const FPathPendingResult &result);
 
 void fpathUpdate();
 
+/** Enable or disable hierarchical (HPA*) path finding for long routes, see hpastar.h. Off by default.
+ *  Changes the paths found, so must be set identically on all clients (it is set by the rules scripts,
+ *  and saved with the game state). */
+void fpathSetHierarchical(bool enable);
+bool fpathGetHierarchical();
+
+/** Enable or disable flow field path finding for groups of droids going to the same destination, see flowfield.h.
+ *  Off by default. Changes the paths found, so must be set identically on all clients, as fpathSetHierarchical(). */
+void fpathSetFlowField(bool enable);
+bool fpathGetFlowField();
+
+/** Called by the order code around giving the same order to each of a selection of numDroids droids. The routes found
+ *  meanwhile use a flow field if the selection is big enough, and flow fields are enabled. */
+void fpathBeginGroupOrder(unsigned numDroids);
+void fpathEndGroupOrder();
+
 /** Find a route for a droid to a location.
  */
 FPATH_RETVAL fpathDroidRoute(DROID *psDroid, const WorldMapState& mapState, SDWORD targetX, SDWORD targetY, FPATH_MOVETYPE moveType);
@@ -122,6 +143,9 @@ bool fpathBlockingTile(const WorldMapState& mapState, SDWORD x, SDWORD y, PROPUL
 bool fpathDroidBlockingTile(DROID *psDroid, const WorldMapState& mapState, int x, int y, FPATH_MOVETYPE moveType);
 bool fpathBaseBlockingTile(const WorldMapState& mapState, SDWORD x, SDWORD y, PROPULSION_TYPE propulsion, int player, FPATH_MOVETYPE moveType);
 
+/// Sets row y of map to fpathBaseBlockingTile() of each tile in the row, a word at a time.
+void fpathBaseBlockingRow(const WorldMapState& mapState, int y, PROPULSION_TYPE propulsion, int player, FPATH_MOVETYPE moveType, PathBitmap &map);
+
 static inline bool fpathBlockingTile(const WorldMapState& mapState, Vector2i tile, PROPULSION_TYPE propulsion)
 {
 	return fpathBlockingTile(mapState, tile.x, tile.y, propulsion);
@@ -143,6 +167,30 @@ void fpathRemoveDroidData(int id);
  *  using the given propulsion type. orig and dest are in world coordinates. */
 bool fpathCheck(WorldMapState& mapState, Position orig, Position dest, PROPULSION_TYPE propulsion);
 
+/** Statistics of a path finding thread, since fpathInitialise() or fpathResetThreadStats(). */
+struct FPathThreadStats
+{
+	static constexpr size_t LATENCY_BUCKETS = 16;
+	static constexpr int64_t LATENCY_BUCKET_MIN_US = 32;
+
+	size_t queueLength = 0;   ///< Jobs waiting in the queues homed on this thread, see fpathThreadJobQueueLength().
+	uint64_t jobsRun = 0;     ///< Jobs run by this thread.
+	uint64_t jobsStolen = 0;  ///< Jobs run by this thread, which were queued for another (busy) thread.
+	/// Number of jobs by time from being queued to being done. Bucket 0 is less than LATENCY_BUCKET_MIN_US µs,
+	/// bucket n is less than LATENCY_BUCKET_MIN_US << n µs, and the last bucket has all the rest.
+	std::array<uint64_t, LATENCY_BUCKETS> latency = {};
+};
+
+/** Number of path finding threads. */
+size_t fpathNumThreads();
+
+/** Number of jobs waiting for the given path finding thread. Jobs may still be stolen by another thread. Function is thread-safe. */
+size_t fpathThreadJobQueueLength(size_t thread);
+
+/** Statistics of the given path finding thread. Function is thread-safe. */
+FPathThreadStats fpathGetThreadStats(size_t thread);
+void fpathResetThreadStats();
+
 /** Unit testing. */
 void fpathTest(int x, int y, int x2, int y2);
 
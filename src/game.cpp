@@ -7753,6 +7753,7 @@ void loadFixupResearchPendingStates()
 			}
 		}
 	}
+	rebuildResearchAvailability();
 }
 
 // -----------------------------------------------------------------------------------------
@@ -7823,6 +7824,7 @@ bool loadSaveResearch(const char *pFileName)
 		}
 		ini.endGroup();
 	}
+	rebuildResearchAvailability();
 	return true;
 }
 
@@ -626,6 +626,14 @@ nlohmann::ordered_json GameStoryLogger::genEndOfGameReport(OutputKey key, Output
 	return report;
 }
 
+nlohmann::ordered_json GameStoryLogger::genCurrentGameReport() const
+{
+	nlohmann::ordered_json report = genEndOfGameReport(outputKey, outputNaming, false);
+	report["playerData"] = convertToOutputJSON(genCurrentFrame(), startingPlayerAttributes, outputKey, outputNaming);
+	report.erase("endDate");
+	return report;
+}
+
 inline void to_json(nlohmann::json& j, const GameStoryLogger::FixedPlayerAttributes& p) {
 	j = nlohmann::json::object();
 	j["name"] = p.name;
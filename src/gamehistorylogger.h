@@ -143,6 +143,7 @@ public:
 	const std::vector<FixedPlayerAttributes>& getFixedPlayerAttributes();
 	const std::vector<GameFrame>& getGameFrames();
 	const std::vector<ResearchEvent>& getResearchLog();
+	nlohmann::ordered_json genCurrentGameReport() const; // same format as the end of game report, with the current stats
 
 	// configuring output
 	void setFrameLoggingInterval(uint32_t seconds);
@@ -554,6 +554,7 @@ static void readResearch(const nlohmann::ordered_json &j, uint32_t version)
 			}
 		}
 	}
+	rebuildResearchAvailability();
 
 	const nlohmann::ordered_json &jdef = j.at("defaults");
 	const auto readDefaults = [&jdef](const char *key, UDWORD (&dst)[MAX_PLAYERS], size_t statCount)
@@ -1115,6 +1116,7 @@ static void clearWorldObjects(GameWorld &world)
 		for (size_t i = 0; i < n; ++i)
 		{
 			MAPTILE &t = world.map.tiles[i];
+			TileVision &v = world.map.vision[i];
 			t.psObject = nullptr;
 			// Defense-in-depth: force the per-tile, object-derived visibility counts to a clean 0 baseline
 			// before objects are rebuilt (visTilesUpdate adds onto these). freeAllDroids/freeAllStructs
@@ -1127,9 +1129,9 @@ static void clearWorldObjects(GameWorld &world)
 			t.jammerBits = 0;
 			for (unsigned p = 0; p < MAX_PLAYERS; ++p)
 			{
-				t.sensors[p] = 0;
-				t.watchers[p] = 0;
-				t.jammers[p] = 0;
+				v.sensors[p] = 0;
+				v.watchers[p] = 0;
+				v.jammers[p] = 0;
 			}
 		}
 	}
@@ -3168,9 +3170,7 @@ static void readMapTerrain(WorldMapState &map, const nlohmann::ordered_json &j,
 	// readMapDynamic and is untouched here.
 	if (!map.tiles || map.width != w || map.height != h)
 	{
-		map.tiles = std::make_unique<MAPTILE[]>(n);
-		map.width = w;
-		map.height = h;
+		mapAllocateTiles(map, w, h);
 	}
 	for (size_t i = 0; i < n; ++i)
 	{
@@ -3237,7 +3237,8 @@ static void readMapTerrain(WorldMapState &map, const nlohmann::ordered_json &j,
 // its own pos.z explicitly, so the build path's re-flatten is pure noise, thus: undo it by re-applying
 // saved heights once all objects are placed. Heights only - texture/water are untouched by building,
 // and the aux/blocking maps + continents were already computed (in readMapTerrain) from these exact
-// heights, so no reinit is needed.
+// heights, so no reinit is needed. Rows that change are reported through mapHeightChanged(), so that
+// the structure line of sight cached while the objects were placed (see getStructureLos()) is dropped.
 static void restampTerrainHeights(WorldMapState &map, const nlohmann::ordered_json &j)
 {
 	if (!map.tiles || !j.contains("tileHeight"))
@@ -3250,9 +3251,20 @@ static void restampTerrainHeights(WorldMapState &map, const nlohmann::ordered_js
 	{
 		return;
 	}
-	for (size_t i = 0; i < n; ++i)
+	for (int y = 0; y < map.height; ++y)
 	{
-		map.tiles[i].height = hgt[i].get<int32_t>();
+		bool rowChanged = false;
+		for (int x = 0; x < map.width; ++x)
+		{
+			const size_t i = static_cast<size_t>(x) + static_cast<size_t>(y) * static_cast<size_t>(map.width);
+			const int32_t height = hgt[i].get<int32_t>();
+			rowChanged |= map.tiles[i].height != height;
+			map.tiles[i].height = height;
+		}
+		if (rowChanged)
+		{
+			mapHeightChanged(map, y);
+		}
 	}
 }
 
@@ -3921,6 +3933,8 @@ static void readCombatModifiers(const nlohmann::ordered_json &j, uint32_t versio
 //  - transporterOnMission: transporter UI-context flag read by the synchronised embark/disembark/launch
 //    paths (which droid world-list they touch). Off-world (reinforcement) mode is single-player campaign
 //    only, so it is always false in multiplayer.
+//  - hierarchicalPathfinding: rules-script toggle (setHierarchicalPathfinding) choosing how long routes are found
+//  - flowFieldPathfinding: rules-script toggle (setFlowFieldPathfinding) choosing how group orders are routed
 
 constexpr uint32_t SIM_MISC_SECTION_VERSION = 1;
 
@@ -3936,6 +3950,8 @@ static nlohmann::ordered_json writeSimMisc()
 	j["formationSpeedLimiting"] = std::move(fsl);
 	j["transporterLaunchTime"] = transporterGetLaunchTime();
 	j["transporterOnMission"] = transporterGetOnMission();
+	j["hierarchicalPathfinding"] = fpathGetHierarchical();
+	j["flowFieldPathfinding"] = fpathGetFlowField();
 	return j;
 }
 
@@ -3963,6 +3979,8 @@ static void readSimMisc(const nlohmann::ordered_json &j, uint32_t version)
 		onMission = false;
 	}
 	transporterRestoreOnMission(onMission);
+	fpathSetHierarchical(j.value("hierarchicalPathfinding", false));
+	fpathSetFlowField(j.value("flowFieldPathfinding", false));
 }
 
 // MARK: - Section: scriptPlayerData
@@ -4916,9 +4934,7 @@ bool runGameStateSelfTest()
 	// "height" geometry vs per-tile-array key separation) are otherwise never exercised headlessly.
 	{
 		WorldMapState tm;
-		tm.tiles = std::make_unique<MAPTILE[]>(16);
-		tm.width = 4;
-		tm.height = 4;
+		mapAllocateTiles(tm, 4, 4);
 		tm.scroll.minX = 0; tm.scroll.minY = 0; tm.scroll.maxX = 4; tm.scroll.maxY = 4;
 		for (size_t i = 0; i < 16; ++i)
 		{
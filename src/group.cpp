@@ -56,6 +56,15 @@ void grpShutDown()
 	grpInitialized = false;
 }
 
+// squeeze out the slots left behind by droids that left their group
+void grpCompactLists()
+{
+	for (auto &group : grpGlobalManager)
+	{
+		group.second->psList.compact();
+	}
+}
+
 // Constructor
 DROID_GROUP::DROID_GROUP()
 {
@@ -67,6 +67,9 @@ void grpShutDown();
 
 DROID_GROUP *grpCreate();
 
+// Compact the droid lists of all groups, see ObjectSlotList::compact()
+void grpCompactLists();
+
 /// Reassign an existing group's id, keeping the global group manager consistent. Used by the
 /// GameState reconstruction to restore a command/transporter group's saved id (grpCreate assigns
 /// lowest-free ids, which differ from the original's historical ids). The caller must ensure newId
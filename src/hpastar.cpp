@@ -0,0 +1,567 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Hierarchical (HPA*) path finding, see hpastar.h.
+ */
+
+#include "hpastar.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+/// Runs of passable tiles along a border at least this long get an entrance at each end, instead of one in the middle.
+static constexpr int ENTRANCE_SPLIT_LENGTH = 6;
+
+/// Directions to the neighbouring cluster, of the entrances at a node.
+enum HpaLink : uint8_t
+{
+	LINK_EAST  = 1,
+	LINK_WEST  = 2,
+	LINK_SOUTH = 4,
+	LINK_NORTH = 8,
+};
+
+static const HpaCoord linkOffset[4] = {HpaCoord(1, 0), HpaCoord(-1, 0), HpaCoord(0, 1), HpaCoord(0, -1)};
+
+struct HpaGraph::Cluster
+{
+	std::vector<HpaCoord> nodes;  ///< Entrance tiles of the cluster, sorted by y, then x.
+	std::vector<uint8_t> links;   ///< HpaLink bits of each node.
+	std::vector<uint32_t> dist;   ///< dist[i * nodes.size() + j] is the distance from node i to node j within the cluster.
+};
+
+static bool nodeLess(HpaCoord const &a, HpaCoord const &b)
+{
+	return a.y != b.y ? a.y < b.y : a.x < b.x;
+}
+
+/// Same as fpathEstimate().
+static inline uint32_t hpaEstimate(HpaCoord s, HpaCoord f)
+{
+	uint32_t xDelta = abs(s.x - f.x), yDelta = abs(s.y - f.y);
+	return std::min(xDelta, yDelta) * (198 - 140) + std::max(xDelta, yDelta) * 140;
+}
+
+void HpaSearch::localSearch(HpaGraph const &graph, int cluster, HpaCoord source, bool reverse, HpaCoord const *target)
+{
+	constexpr int S = HpaGraph::CLUSTER_SIZE;
+	x0 = cluster % graph.clustersX * S;
+	y0 = cluster / graph.clustersX * S;
+	x1 = std::min(x0 + S, graph.mapWidth);
+	y1 = std::min(y0 + S, graph.mapHeight);
+	local.assign(S * S, LocalTile{HpaGraph::NO_PATH, UINT16_MAX, false});
+	localOpen.clear();
+	if (graph.tileCost(source.x, source.y) == 0)
+	{
+		return;
+	}
+
+	// Keys are distance, then tile, so that the heap order is fully defined.
+	unsigned sourceIndex = (source.x - x0) + (source.y - y0) * S;
+	local[sourceIndex].dist = 0;
+	localOpen.push_back(sourceIndex);
+	while (!localOpen.empty())
+	{
+		std::pop_heap(localOpen.begin(), localOpen.end(), std::greater<uint64_t>());
+		uint64_t key = localOpen.back();
+		localOpen.pop_back();
+		unsigned index = key & 0xFFFF;
+		uint32_t dist = key >> 16;
+		if (local[index].closed)
+		{
+			continue;
+		}
+		local[index].closed = true;
+
+		int x = x0 + index % S;
+		int y = y0 + index / S;
+		if (target != nullptr && x == target->x && y == target->y)
+		{
+			break;
+		}
+		unsigned here = graph.tileCost(x, y);
+		for (int dy = -1; dy <= 1; ++dy)
+		{
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				int nx = x + dx, ny = y + dy;
+				if ((dx == 0 && dy == 0) || nx < x0 || nx >= x1 || ny < y0 || ny >= y1)
+				{
+					continue;
+				}
+				unsigned there = graph.tileCost(nx, ny);
+				if (there == 0)
+				{
+					continue;
+				}
+				if (dx != 0 && dy != 0 && (graph.tileCost(nx, y) == 0 || graph.tileCost(x, ny) == 0))
+				{
+					continue;  // We cannot cut corners.
+				}
+				uint32_t newDist = dist + (dx != 0 && dy != 0 ? 198 : 140) * (reverse ? here : there);
+				unsigned newIndex = (nx - x0) + (ny - y0) * S;
+				LocalTile &tile = local[newIndex];
+				if (tile.closed || newDist >= tile.dist)
+				{
+					continue;
+				}
+				tile.dist = newDist;
+				tile.parent = index;
+				localOpen.push_back(uint64_t(newDist) << 16 | newIndex);
+				std::push_heap(localOpen.begin(), localOpen.end(), std::greater<uint64_t>());
+			}
+		}
+	}
+}
+
+uint32_t HpaSearch::localDist(HpaCoord tile) const
+{
+	if (tile.x < x0 || tile.x >= x1 || tile.y < y0 || tile.y >= y1)
+	{
+		return HpaGraph::NO_PATH;
+	}
+	return local[(tile.x - x0) + (tile.y - y0) * HpaGraph::CLUSTER_SIZE].dist;
+}
+
+std::shared_ptr<HpaGraph> HpaGraph::create(int width, int height)
+{
+	auto graph = std::make_shared<HpaGraph>();
+	graph->mapWidth = width;
+	graph->mapHeight = height;
+	graph->clustersX = (width + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	graph->clustersY = (height + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	return graph;
+}
+
+std::shared_ptr<const HpaGraph> HpaGraph::build(int width, int height, std::vector<uint8_t> tiles, HpaGraph const *previous)
+{
+	auto graph = create(width, height);
+	graph->tiles = std::move(tiles);
+	if (previous != nullptr && (previous->mapWidth != width || previous->mapHeight != height))
+	{
+		previous = nullptr;
+	}
+
+	// Find the clusters containing any changed tile.
+	std::vector<bool> dirty(static_cast<size_t>(graph->clustersX) * graph->clustersY, previous == nullptr);
+	if (previous != nullptr)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; x += CLUSTER_SIZE)
+			{
+				size_t offset = x + y * width;
+				size_t length = std::min(CLUSTER_SIZE, width - x);
+				if (memcmp(&graph->tiles[offset], &previous->tiles[offset], length) != 0)
+				{
+					dirty[graph->clusterIndex(x, y)] = true;
+				}
+			}
+		}
+	}
+
+	graph->finishBuild(previous, dirty);
+	return graph;
+}
+
+std::shared_ptr<const HpaGraph> HpaGraph::repair(HpaGraph const &previous, std::vector<bool> const &changedRows, RowReader const &readRow)
+{
+	const int width = previous.mapWidth;
+	auto graph = create(width, previous.mapHeight);
+	graph->tiles = previous.tiles;
+
+	// Reread the changed rows, and find the clusters containing any changed tile.
+	std::vector<bool> dirty(static_cast<size_t>(graph->clustersX) * graph->clustersY, false);
+	for (int y = 0; y < graph->mapHeight && static_cast<size_t>(y) < changedRows.size(); ++y)
+	{
+		if (!changedRows[y])
+		{
+			continue;
+		}
+		uint8_t *row = &graph->tiles[static_cast<size_t>(y) * width];
+		readRow(y, row);
+		for (int x = 0; x < width; x += CLUSTER_SIZE)
+		{
+			size_t length = std::min(CLUSTER_SIZE, width - x);
+			if (memcmp(row + x, &previous.tiles[x + static_cast<size_t>(y) * width], length) != 0)
+			{
+				dirty[graph->clusterIndex(x, y)] = true;
+			}
+		}
+	}
+
+	graph->finishBuild(&previous, dirty);
+	return graph;
+}
+
+void HpaGraph::finishBuild(HpaGraph const *previous, std::vector<bool> const &dirty)
+{
+	HpaSearch search;
+	buildBorders(previous, dirty);
+	buildClusters(previous, dirty, search);
+
+	// Number the nodes.
+	const size_t numClusters = dirty.size();
+	firstNode.resize(numClusters + 1);
+	for (size_t c = 0; c < numClusters; ++c)
+	{
+		firstNode[c] = nodes.size();
+		for (HpaCoord node : clusters[c]->nodes)
+		{
+			nodes.push_back(node);
+			nodeCluster.push_back(c);
+		}
+	}
+	firstNode[numClusters] = nodes.size();
+}
+
+void HpaGraph::buildBorders(HpaGraph const *previous, std::vector<bool> const &dirty)
+{
+	eastBorders.resize(dirty.size());
+	southBorders.resize(dirty.size());
+	for (int cy = 0; cy < clustersY; ++cy)
+	{
+		for (int cx = 0; cx < clustersX; ++cx)
+		{
+			int c = cx + cy * clustersX;
+			// A border depends only on the tiles on both sides of it.
+			bool eastDirty = dirty[c] || (cx + 1 < clustersX && dirty[c + 1]);
+			bool southDirty = dirty[c] || (cy + 1 < clustersY && dirty[c + clustersX]);
+			eastBorders[c] = previous != nullptr && !eastDirty ? previous->eastBorders[c] : buildBorder(cx, cy, true);
+			southBorders[c] = previous != nullptr && !southDirty ? previous->southBorders[c] : buildBorder(cx, cy, false);
+		}
+	}
+}
+
+std::shared_ptr<const HpaGraph::Border> HpaGraph::buildBorder(int cx, int cy, bool east) const
+{
+	auto border = std::make_shared<Border>();
+	if (east ? cx + 1 >= clustersX : cy + 1 >= clustersY)
+	{
+		return border;  // Edge of the map.
+	}
+
+	// Tile on this side of the border, and the offset to the tile on the other side.
+	int begin = east ? cy * CLUSTER_SIZE : cx * CLUSTER_SIZE;
+	int end = std::min(begin + CLUSTER_SIZE, east ? mapHeight : mapWidth);
+	auto tileIndex = [&](int pos) {
+		return east ? (cx + 1) * CLUSTER_SIZE - 1 + pos * mapWidth : pos + ((cy + 1) * CLUSTER_SIZE - 1) * mapWidth;
+	};
+	int across = east ? 1 : mapWidth;
+
+	int runBegin = -1;
+	for (int pos = begin; pos <= end; ++pos)
+	{
+		if (pos < end && (tiles[tileIndex(pos)] & TILE_COST_MASK) != 0 && (tiles[tileIndex(pos) + across] & TILE_COST_MASK) != 0)
+		{
+			if (runBegin < 0)
+			{
+				runBegin = pos;
+			}
+			continue;
+		}
+		if (runBegin < 0)
+		{
+			continue;
+		}
+
+		// Found a run of passable tiles, from runBegin to pos - 1. Prefer crossing it at the gateway, if there is one.
+		int runLast = pos - 1;
+		int gatewayFirst = -1, gatewayLast = -1;
+		for (int p = runBegin; p <= runLast; ++p)
+		{
+			if (((tiles[tileIndex(p)] | tiles[tileIndex(p) + across]) & TILE_GATEWAY) != 0)
+			{
+				gatewayFirst = gatewayFirst < 0 ? p : gatewayFirst;
+				gatewayLast = p;
+			}
+		}
+		int gateway = gatewayFirst < 0 ? -1 : (gatewayFirst + gatewayLast) / 2;
+		if (runLast - runBegin + 1 >= ENTRANCE_SPLIT_LENGTH)
+		{
+			border->push_back(runBegin);
+			if (gateway > runBegin && gateway < runLast)
+			{
+				border->push_back(gateway);
+			}
+			border->push_back(runLast);
+		}
+		else
+		{
+			border->push_back(gateway >= 0 ? gateway : (runBegin + runLast) / 2);
+		}
+		runBegin = -1;
+	}
+	return border;
+}
+
+void HpaGraph::buildClusters(HpaGraph const *previous, std::vector<bool> const &dirty, HpaSearch &search)
+{
+	clusters.resize(dirty.size());
+	rebuiltClusters = 0;
+	for (int cy = 0; cy < clustersY; ++cy)
+	{
+		for (int cx = 0; cx < clustersX; ++cx)
+		{
+			int c = cx + cy * clustersX;
+			// A cluster depends on its tiles and its four borders, so on the tiles of its neighbours too.
+			bool rebuild = previous == nullptr || dirty[c]
+			               || (cx > 0 && dirty[c - 1]) || (cx + 1 < clustersX && dirty[c + 1])
+			               || (cy > 0 && dirty[c - clustersX]) || (cy + 1 < clustersY && dirty[c + clustersX]);
+			if (!rebuild)
+			{
+				clusters[c] = previous->clusters[c];
+				continue;
+			}
+			clusters[c] = buildCluster(cx, cy, search);
+			++rebuiltClusters;
+		}
+	}
+}
+
+std::shared_ptr<const HpaGraph::Cluster> HpaGraph::buildCluster(int cx, int cy, HpaSearch &search) const
+{
+	int c = cx + cy * clustersX;
+	int x0 = cx * CLUSTER_SIZE, y0 = cy * CLUSTER_SIZE;
+	int xLast = std::min(x0 + CLUSTER_SIZE, mapWidth) - 1, yLast = std::min(y0 + CLUSTER_SIZE, mapHeight) - 1;
+
+	std::vector<std::pair<HpaCoord, uint8_t>> entrances;
+	for (uint16_t pos : *eastBorders[c])
+	{
+		entrances.emplace_back(HpaCoord(xLast, pos), LINK_EAST);
+	}
+	if (cx > 0)
+	{
+		for (uint16_t pos : *eastBorders[c - 1])
+		{
+			entrances.emplace_back(HpaCoord(x0, pos), LINK_WEST);
+		}
+	}
+	for (uint16_t pos : *southBorders[c])
+	{
+		entrances.emplace_back(HpaCoord(pos, yLast), LINK_SOUTH);
+	}
+	if (cy > 0)
+	{
+		for (uint16_t pos : *southBorders[c - clustersX])
+		{
+			entrances.emplace_back(HpaCoord(pos, y0), LINK_NORTH);
+		}
+	}
+	std::sort(entrances.begin(), entrances.end(), [](std::pair<HpaCoord, uint8_t> const &a, std::pair<HpaCoord, uint8_t> const &b) {
+		return nodeLess(a.first, b.first) || (a.first == b.first && a.second < b.second);
+	});
+
+	// Tiles at a corner of the cluster may be entrances on two borders.
+	auto cluster = std::make_shared<Cluster>();
+	for (auto const &entrance : entrances)
+	{
+		if (!cluster->nodes.empty() && cluster->nodes.back() == entrance.first)
+		{
+			cluster->links.back() |= entrance.second;
+			continue;
+		}
+		cluster->nodes.push_back(entrance.first);
+		cluster->links.push_back(entrance.second);
+	}
+
+	size_t n = cluster->nodes.size();
+	cluster->dist.resize(n * n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		search.localSearch(*this, c, cluster->nodes[i], false);
+		for (size_t j = 0; j < n; ++j)
+		{
+			cluster->dist[i * n + j] = search.localDist(cluster->nodes[j]);
+		}
+	}
+	return cluster;
+}
+
+uint32_t HpaGraph::nodeIndex(HpaCoord tile) const
+{
+	int c = clusterIndex(tile.x, tile.y);
+	std::vector<HpaCoord> const &clusterNodes = clusters[c]->nodes;
+	auto i = std::lower_bound(clusterNodes.begin(), clusterNodes.end(), tile, nodeLess);
+	if (i == clusterNodes.end() || *i != tile)
+	{
+		return NO_PATH;
+	}
+	return firstNode[c] + (i - clusterNodes.begin());
+}
+
+bool HpaGraph::refine(HpaSearch &search, HpaCoord from, HpaCoord to, std::vector<HpaCoord> &path) const
+{
+	int c = clusterIndex(from.x, from.y);
+	if (c != clusterIndex(to.x, to.y))
+	{
+		path.push_back(to);  // Crossing an entrance, a single straight step.
+		return true;
+	}
+
+	search.localSearch(*this, c, from, false, &to);
+	if (search.localDist(to) == NO_PATH)
+	{
+		return false;
+	}
+	// Walk back from to, then reverse that part of the path. Leaves out from, which is already in the path.
+	size_t legBegin = path.size();
+	for (HpaCoord p = to; p != from;)
+	{
+		path.push_back(p);
+		uint16_t parent = search.local[(p.x - search.x0) + (p.y - search.y0) * CLUSTER_SIZE].parent;
+		p = HpaCoord(search.x0 + parent % CLUSTER_SIZE, search.y0 + parent / CLUSTER_SIZE);
+	}
+	std::reverse(path.begin() + legBegin, path.end());
+	return true;
+}
+
+bool HpaGraph::findPath(HpaSearch &search, HpaCoord start, HpaCoord goal, std::vector<HpaCoord> &path) const
+{
+	path.clear();
+	if (start.x < 0 || start.y < 0 || start.x >= mapWidth || start.y >= mapHeight || tileCost(start.x, start.y) == 0
+	    || goal.x < 0 || goal.y < 0 || goal.x >= mapWidth || goal.y >= mapHeight || tileCost(goal.x, goal.y) == 0)
+	{
+		return false;
+	}
+	if (start == goal)
+	{
+		path.push_back(start);
+		return true;
+	}
+
+	// Connect the start and goal to the nodes of their clusters.
+	int startCluster = clusterIndex(start.x, start.y);
+	int goalCluster = clusterIndex(goal.x, goal.y);
+	Cluster const &startNodes = *clusters[startCluster];
+	Cluster const &goalNodes = *clusters[goalCluster];
+	search.localSearch(*this, startCluster, start, false);
+	search.startDist.resize(startNodes.nodes.size());
+	for (size_t j = 0; j < startNodes.nodes.size(); ++j)
+	{
+		search.startDist[j] = search.localDist(startNodes.nodes[j]);
+	}
+	uint32_t directDist = startCluster == goalCluster ? search.localDist(goal) : NO_PATH;
+	search.localSearch(*this, goalCluster, goal, true);
+	search.goalDist.resize(goalNodes.nodes.size());
+	for (size_t j = 0; j < goalNodes.nodes.size(); ++j)
+	{
+		search.goalDist[j] = search.localDist(goalNodes.nodes[j]);
+	}
+
+	// A* over the nodes. Keys are estimate, then node index, so that the heap order is fully defined.
+	uint32_t const startNode = nodes.size(), goalNode = nodes.size() + 1;
+	search.dist.assign(nodes.size() + 2, NO_PATH);
+	search.parent.assign(nodes.size() + 2, NO_PATH);
+	search.closed.assign(nodes.size() + 2, false);
+	search.open.clear();
+	auto addNode = [&](uint32_t node, HpaCoord tile, uint32_t dist, uint32_t parent) {
+		if (search.closed[node] || dist >= search.dist[node])
+		{
+			return;
+		}
+		search.dist[node] = dist;
+		search.parent[node] = parent;
+		search.open.push_back(uint64_t(dist + hpaEstimate(tile, goal)) << 32 | node);
+		std::push_heap(search.open.begin(), search.open.end(), std::greater<uint64_t>());
+	};
+	addNode(startNode, start, 0, NO_PATH);
+	while (!search.open.empty())
+	{
+		std::pop_heap(search.open.begin(), search.open.end(), std::greater<uint64_t>());
+		uint32_t node = search.open.back() & 0xFFFFFFFF;
+		search.open.pop_back();
+		if (search.closed[node])
+		{
+			continue;
+		}
+		search.closed[node] = true;
+		if (node == goalNode)
+		{
+			break;
+		}
+
+		uint32_t dist = search.dist[node];
+		if (node == startNode)
+		{
+			for (size_t j = 0; j < startNodes.nodes.size(); ++j)
+			{
+				if (search.startDist[j] != NO_PATH)
+				{
+					addNode(firstNode[startCluster] + j, startNodes.nodes[j], search.startDist[j], startNode);
+				}
+			}
+			if (directDist != NO_PATH)
+			{
+				addNode(goalNode, goal, directDist, startNode);
+			}
+			continue;
+		}
+
+		int c = nodeCluster[node];
+		Cluster const &cluster = *clusters[c];
+		size_t n = cluster.nodes.size();
+		size_t i = node - firstNode[c];
+		for (size_t j = 0; j < n; ++j)
+		{
+			uint32_t edge = cluster.dist[i * n + j];
+			if (j != i && edge != NO_PATH)
+			{
+				addNode(firstNode[c] + j, cluster.nodes[j], dist + edge, node);
+			}
+		}
+		for (unsigned link = 0; link < 4; ++link)
+		{
+			if ((cluster.links[i] & (1 << link)) == 0)
+			{
+				continue;
+			}
+			HpaCoord tile(nodes[node].x + linkOffset[link].x, nodes[node].y + linkOffset[link].y);
+			addNode(nodeIndex(tile), tile, dist + 140 * tileCost(tile.x, tile.y), node);
+		}
+		if (c == goalCluster && search.goalDist[i] != NO_PATH)
+		{
+			addNode(goalNode, goal, dist + search.goalDist[i], node);
+		}
+	}
+	if (!search.closed[goalNode])
+	{
+		return false;
+	}
+
+	// Refine the route, one leg at a time.
+	search.route.clear();
+	for (uint32_t node = goalNode; node != NO_PATH; node = search.parent[node])
+	{
+		search.route.push_back(node);
+	}
+	path.push_back(start);
+	for (size_t i = search.route.size() - 1; i-- > 0;)
+	{
+		uint32_t node = search.route[i];
+		if (!refine(search, path.back(), node == goalNode ? goal : nodes[node], path))
+		{
+			path.clear();
+			return false;
+		}
+	}
+	return true;
+}
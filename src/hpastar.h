@@ -0,0 +1,155 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Hierarchical (HPA*) path finding.
+ *
+ *  The map is cut into square clusters. Wherever two neighbouring clusters share a run of passable
+ *  tiles along their border, one or two entrances are placed in the run (preferring gateway tiles),
+ *  and the distances between all entrances of a cluster are precomputed. A long route is then planned
+ *  over this small graph, and only the legs inside each cluster are refined to tiles.
+ *
+ *  The graph is immutable once built, so it can be shared between the path finding threads. A new
+ *  graph can be built from the previous one, reusing every cluster whose surroundings have not changed.
+ *  The result (and so every path found with it) is identical to a graph built from scratch.
+ *
+ *  Costs match fpathAStarRoute(): 140 for a straight step, 198 for a diagonal step, multiplied by the
+ *  cost factor of the tile stepped onto. Diagonal steps may not cut corners. All ties are broken by
+ *  position, so results do not depend on the standard library implementation.
+ */
+
+#ifndef __INCLUDED_SRC_HPASTAR_H__
+#define __INCLUDED_SRC_HPASTAR_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct HpaCoord
+{
+	HpaCoord() : x(0), y(0) {}
+	HpaCoord(int16_t x_, int16_t y_) : x(x_), y(y_) {}
+	bool operator ==(HpaCoord const &z) const
+	{
+		return x == z.x && y == z.y;
+	}
+	bool operator !=(HpaCoord const &z) const
+	{
+		return !(*this == z);
+	}
+
+	int16_t x, y;
+};
+
+class HpaSearch;
+
+class HpaGraph
+{
+public:
+	static constexpr int CLUSTER_SIZE = 16;
+	static constexpr uint8_t TILE_COST_MASK = 0x7F;  ///< Cost factor of a tile, 0 if the tile is blocking.
+	static constexpr uint8_t TILE_GATEWAY = 0x80;    ///< Set on gateway tiles, see gateway.h.
+	static constexpr uint32_t NO_PATH = UINT32_MAX;
+
+	/// Builds the cluster graph of a width × height map, tiles[x + y * width] being a cost factor plus TILE_GATEWAY flag.
+	/// If previous is not null and is for a map of the same size, clusters which did not change are shared with previous.
+	static std::shared_ptr<const HpaGraph> build(int width, int height, std::vector<uint8_t> tiles, HpaGraph const *previous);
+
+	/// Writes the width tiles of row y, in the format of build(), to row.
+	typedef std::function<void (int y, uint8_t *row)> RowReader;
+
+	/// Same as build(), for a map which differs from the one previous was built for only in the rows where changedRows[y] is set.
+	/// Only those rows are read, and only the clusters in which a tile actually changed are rebuilt.
+	static std::shared_ptr<const HpaGraph> repair(HpaGraph const &previous, std::vector<bool> const &changedRows, RowReader const &readRow);
+
+	/// Finds a path from start to goal, and stores the tiles along it, including start and goal, in path.
+	/// Returns false if there is no path. Thread safe.
+	bool findPath(HpaSearch &search, HpaCoord start, HpaCoord goal, std::vector<HpaCoord> &path) const;
+
+	int width() const { return mapWidth; }
+	int height() const { return mapHeight; }
+	unsigned tileCost(int x, int y) const { return tiles[x + y * mapWidth] & TILE_COST_MASK; }
+	size_t numNodes() const { return nodes.size(); }
+	size_t numClusters() const { return clusters.size(); }
+	size_t numRebuiltClusters() const { return rebuiltClusters; }  ///< Number of clusters which could not be reused from the previous graph.
+
+	struct Cluster;
+	typedef std::vector<uint16_t> Border;  ///< Positions of the entrances along a border.
+
+private:
+	friend class HpaSearch;
+
+	int clusterIndex(int x, int y) const { return x / CLUSTER_SIZE + y / CLUSTER_SIZE * clustersX; }
+	uint32_t nodeIndex(HpaCoord tile) const;
+	static std::shared_ptr<HpaGraph> create(int width, int height);
+	void finishBuild(HpaGraph const *previous, std::vector<bool> const &dirty);
+	void buildBorders(HpaGraph const *previous, std::vector<bool> const &dirty);
+	void buildClusters(HpaGraph const *previous, std::vector<bool> const &dirty, HpaSearch &search);
+	std::shared_ptr<const Border> buildBorder(int cx, int cy, bool east) const;
+	std::shared_ptr<const Cluster> buildCluster(int cx, int cy, HpaSearch &search) const;
+	bool refine(HpaSearch &search, HpaCoord from, HpaCoord to, std::vector<HpaCoord> &path) const;
+
+	int mapWidth = 0;
+	int mapHeight = 0;
+	int clustersX = 0;
+	int clustersY = 0;
+	std::vector<uint8_t> tiles;
+	std::vector<std::shared_ptr<const Border>> eastBorders;   ///< Border between cluster i and the cluster east of it.
+	std::vector<std::shared_ptr<const Border>> southBorders;  ///< Border between cluster i and the cluster south of it.
+	std::vector<std::shared_ptr<const Cluster>> clusters;
+	std::vector<uint32_t> firstNode;                          ///< Index in nodes of the first node of each cluster.
+	std::vector<HpaCoord> nodes;                              ///< All nodes, by cluster.
+	std::vector<uint32_t> nodeCluster;                        ///< Cluster of each node.
+	size_t rebuiltClusters = 0;
+};
+
+/// Scratch memory for HpaGraph::findPath(). Each thread needs its own.
+class HpaSearch
+{
+public:
+	struct LocalTile
+	{
+		uint32_t dist;
+		uint16_t parent;
+		bool     closed;
+	};
+
+	/// Dijkstra within the bounds of one cluster. If reverse, finds distances to source instead of from it.
+	/// Stops early once target (if any) is reached.
+	void localSearch(HpaGraph const &graph, int cluster, HpaCoord source, bool reverse, HpaCoord const *target = nullptr);
+	uint32_t localDist(HpaCoord tile) const;
+
+private:
+	friend class HpaGraph;
+
+	int x0 = 0, y0 = 0, x1 = 0, y1 = 0;           ///< Bounds of the cluster of the last localSearch().
+	std::vector<LocalTile> local;
+	std::vector<uint64_t> localOpen;
+
+	std::vector<uint32_t> dist;                   ///< Abstract search, indexed by node. Start and goal come last.
+	std::vector<uint32_t> parent;
+	std::vector<bool> closed;
+	std::vector<uint64_t> open;
+	std::vector<uint32_t> startDist;              ///< Distance from the start to each node of its cluster.
+	std::vector<uint32_t> goalDist;               ///< Distance from each node of the goal cluster to the goal.
+	std::vector<uint32_t> route;
+};
+
+#endif // __INCLUDED_SRC_HPASTAR_H__
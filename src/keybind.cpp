@@ -29,6 +29,7 @@
 #include "levels.h"
 #include "basedef.h"
 #include "map.h"
+#include "mapgrid.h"
 #include "warcam.h"
 #include "warzoneconfig.h"
 #include "console.h"
@@ -99,8 +100,8 @@ bool	bMovePause = false;
 bool		bAllowOtherKeyPresses = true;
 char	beaconMsg[MAX_PLAYERS][MAX_CONSOLE_STRING_LENGTH];		//beacon msg for each player
 
-using ExtractorListIter = optional<ExtractorList::const_iterator>;
-static ExtractorListIter psOldRE = {};
+// The last oil derrick jumped to (not an iterator, so that the extractor list can be compacted).
+static const STRUCTURE* psOldRE = nullptr;
 static char	sCurrentConsoleText[MAX_CONSOLE_STRING_LENGTH];			//remember what user types in console for beacon msg
 
 #define QUICKSAVE_CAM_FOLDER "savegames/campaign/QuickSave"
@@ -764,6 +765,13 @@ void kf_ListDroids()
 	}
 }
 
+// Compare the incrementally updated map grid with a full rebuild every tick. Doesn't change the game state.
+void kf_ToggleGridCrossCheck()
+{
+	gridSetCrossCheck(!gridGetCrossCheck());
+	addConsoleMessage(gridGetCrossCheck() ? "Map grid cross-check on" : "Map grid cross-check off", LEFT_JUSTIFY, SYSTEM_MESSAGE);
+}
+
 
 // --------------------------------------------------------------------------
 
@@ -861,7 +869,7 @@ void	kf_TileInfo()
 
 	debug(LOG_ERROR, "Tile position=(%d, %d) Terrain=%d Texture=%u Height=%d Illumination=%u",
 	      mouseTileX, mouseTileY, (int)terrainType(psTile), TileNumber_tile(psTile->texture), psTile->height,
-	      psTile->illumination);
+	      mapTileDisplay(gameWorld.map, mouseTileX, mouseTileY)->illumination);
 	addConsoleMessage(_("Tile info dumped into log"), DEFAULT_JUSTIFY, SYSTEM_MESSAGE);
 }
 
@@ -1707,20 +1715,27 @@ void	kf_JumpToResourceExtractor()
 		return;
 	}
 
-	if (!psOldRE.has_value() || std::next(*psOldRE) == gameWorld.objects.extractors[selectedPlayer].end())
+	const auto& extractors = gameWorld.objects.extractors[selectedPlayer];
+	auto nextIt = extractors.end();
+	if (psOldRE != nullptr)
 	{
-		// Reset the pointer if `psOldRE` is either not initialized yet or points to the last element.
-		psOldRE.emplace(gameWorld.objects.extractors[selectedPlayer].begin());
+		nextIt = std::find(extractors.begin(), extractors.end(), psOldRE);
+		if (nextIt != extractors.end())
+		{
+			++nextIt;
+		}
 	}
-	else
+	if (nextIt == extractors.end())
 	{
-		++(*psOldRE);
+		// Start over if `psOldRE` is either not initialized yet or was the last element.
+		nextIt = extractors.begin();
 	}
+	psOldRE = *nextIt;
 
-	if (**psOldRE != nullptr)
+	if (psOldRE != nullptr)
 	{
 		playerPos.r.y = 0; // face north
-		setViewPos(map_coord((**psOldRE)->pos.x), map_coord((**psOldRE)->pos.y), true);
+		setViewPos(map_coord(psOldRE->pos.x), map_coord(psOldRE->pos.y), true);
 	}
 	else
 	{
@@ -1732,7 +1747,7 @@ void keybindInformResourceExtractorRemoved(const STRUCTURE* psResourceExtractor,
 {
 	if (selectedPlayer >= MAX_PLAYERS)
 	{
-		psOldRE.reset();
+		psOldRE = nullptr;
 		return;
 	}
 
@@ -1743,9 +1758,9 @@ void keybindInformResourceExtractorRemoved(const STRUCTURE* psResourceExtractor,
 		return;
 	}
 
-	if (psOldRE.has_value() && *psOldRE != activeExtractors.end() && **psOldRE == psResourceExtractor)
+	if (psOldRE == psResourceExtractor)
 	{
-		psOldRE.reset();
+		psOldRE = nullptr;
 	}
 }
 
@@ -2725,5 +2740,5 @@ void kf_ToggleSpecOverlays()
 
 void keybindShutdown()
 {
-	psOldRE.reset();
+	psOldRE = nullptr;
 }
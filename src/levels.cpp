@@ -58,6 +58,7 @@
 #include "qtscript.h"
 #include "wrappers.h"
 #include "activity.h"
+#include "profiling.h"
 #include <wzmaplib/map_package.h>
 
 #include <unordered_set>
@@ -1374,6 +1375,12 @@ static LoadingTask<> levFinalizeLevelLoad(ResourceLoadingController& controller,
 			}
 		}
 	}
+	if (autogame_enabled() && headlessGameMode())
+	{
+		// Time the simulation, for saveTickProfile() at the end of the game
+		profiling::resetTickProfiler();
+		profiling::setTickProfilerEnabled(true);
+	}
 
 	ActivityManager::instance().loadedLevel(psCurrLevel->type, mapNameWithoutTechlevel(getLevelName()));
 	co_return load_ok();
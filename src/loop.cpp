@@ -44,6 +44,7 @@
 
 #include "loop.h"
 #include "gamestate_serialize.h"
+#include "replaykeyframes.h"
 #include "objects.h"
 #include "display.h"
 #include "map.h"
@@ -77,6 +78,7 @@
 #include "warcam.h"
 #include "lighting.h"
 #include "mapgrid.h"
+#include "move.h"
 #include "edit3d.h"
 #include "fpath.h"
 #include "cmddroid.h"
@@ -537,6 +539,9 @@ static void gameStateUpdate()
 		executeFnAndProcessScriptQueuedRemovals([]() { updateScripts(); });
 	}
 
+	// Queue the most frequent script events until the end of the tick, see flushScriptEvents()
+	beginScriptEventBatch();
+
 	// Update abandoned structures
 	handleAbandonedStructures();
 
@@ -548,6 +553,7 @@ static void gameStateUpdate()
 
 	// Check which objects are visible.
 	processVisibility();
+	gridCacheVisibility();
 
 	// Update the map.
 	mapUpdate(gameWorld);
@@ -558,6 +564,7 @@ static void gameStateUpdate()
 	// update the command droids
 	cmdDroidUpdate();
 
+	moveBuildNeighbourTable();
 	for (unsigned i = 0; i < MAX_PLAYERS; i++)
 	{
 		//update the current power available for a player
@@ -593,6 +600,7 @@ static void gameStateUpdate()
 			});
 		});
 	}
+	moveClearNeighbourTable();
 
 	missionTimerUpdate();
 
@@ -603,6 +611,8 @@ static void gameStateUpdate()
 		featureUpdate(psCFeat);
 	}
 
+	executeFnAndProcessScriptQueuedRemovals([]() { flushScriptEvents(); });
+
 	// Free dead droid memory.
 	objmemUpdate();
 
@@ -618,6 +628,9 @@ static void gameStateUpdate()
 	// Must be at the end of gameStateUpdate, since countUpdate is also called randomly (unsynchronised) between gameStateUpdate calls, but should have no effect if we already called it, and recvMessage requires consistent counts on all clients.
 	countUpdate(true);
 
+	// Replay keyframes are GameState snapshots of the end of a tick, like the round-trip test below.
+	replayKeyframesUpdate();
+
 	// Optional GameState reconstruct-fidelity test (no-op unless --gamestate-roundtrip was set).
 	gamestate::gamestateMaybeRunRoundTripTest();
 }
@@ -127,6 +127,8 @@
 #include "wzpropertyproviders.h"
 #include "3rdparty/gsl_finally.h"
 #include "wzapi.h"
+#include "replaykeyframes.h"
+#include "replayverify.h"
 
 #if defined(WZ_OS_UNIX)
 # include <signal.h>
@@ -928,6 +930,8 @@ bool startGameAfterLevelLoad()
 			setMaxFastForwardTicks(10, false);
 		}
 	}
+	replayKeyframesGameStarted();
+	replayVerifyGameStarted();
 
 	// Rebase the game clock's real-time reference: the clock started at the
 	// beginning of level loading (gameTimeInit in stageOneInitialise), and
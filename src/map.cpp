@@ -58,6 +58,7 @@
 #include "lib/framework/wzapp.h"
 #include "lib/framework/load_result.h"
 #include "lib/ivis_opengl/pielighting.h"
+#include "profiling.h"
 
 #define GAME_TICKS_FOR_DANGER (GAME_TICKS_PER_SEC * 2)
 
@@ -785,7 +786,7 @@ static bool mapSetGroundTypes(WorldMapState& mapState)
 		{
 			MAPTILE *psTile = mapTile(mapState, i, j);
 
-			psTile->ground = determineGroundType(mapState, i, j, tilesetDir);
+			mapTileDisplay(mapState, i, j)->ground = determineGroundType(mapState, i, j, tilesetDir);
 
 			if (hasDecals(mapState, i, j))
 			{
@@ -1155,11 +1156,7 @@ LoadingTask<> mapLoadFromWzMapData(ResourceLoadingController& controller, std::s
 	ASSERT(mapState.tiles == nullptr, "Map has not been cleared before calling mapLoad()!");
 
 	/* Allocate the memory for the map */
-	mapState.tiles = std::make_unique<MAPTILE[]>(static_cast<size_t>(width) * height);
-	ASSERT(mapState.tiles != nullptr, "Out of memory");
-
-	mapState.width = width;
-	mapState.height = height;
+	mapAllocateTiles(mapState, width, height);
 
 	// FIXME: the map preview code loads the map without setting the tileset
 	if (!tilesetDir)
@@ -1197,9 +1194,7 @@ LoadingTask<> mapLoadFromWzMapData(ResourceLoadingController& controller, std::s
 		mapState.tiles[i].height = loadedMap->mMapTiles[i].height;
 
 		// Visibility stuff
-		memset(mapState.tiles[i].watchers, 0, sizeof(mapState.tiles[i].watchers));
-		memset(mapState.tiles[i].sensors, 0, sizeof(mapState.tiles[i].sensors));
-		memset(mapState.tiles[i].jammers, 0, sizeof(mapState.tiles[i].jammers));
+		mapState.vision[i] = TileVision{};
 		mapState.tiles[i].sensorBits = 0;
 		mapState.tiles[i].jammerBits = 0;
 		mapState.tiles[i].tileExploredBits = 0;
@@ -1235,6 +1230,17 @@ LoadingTask<> mapLoadFromWzMapData(ResourceLoadingController& controller, std::s
 	co_return load_ok();
 }
 
+/// Starts tracking changes to the blocking bits of newly allocated aux maps and to the tile heights, see WorldMapState::epoch.
+static void mapSetEpoch(WorldMapState& mapState)
+{
+	static uint32_t lastEpoch = 0;
+	mapState.epoch = ++lastEpoch;
+	mapState.blockingChanges = 0;
+	mapState.blockingRowChanges.assign(mapState.height, 0);
+	mapState.heightChanges = 0;
+	mapState.heightRowChanges.assign(mapState.height, 0);
+}
+
 static bool afterMapLoad(WorldMapState& mapState)
 {
 	if (!mapSetGroundTypes(mapState))
@@ -1267,6 +1273,7 @@ static bool afterMapLoad(WorldMapState& mapState)
 	{
 		mapState.auxMap[x] = std::make_unique<uint8_t[]> (mapSize);
 	}
+	mapSetEpoch(mapState);
 
 	// Set our blocking bits
 	for (int y = 0; y < mapState.height; ++y)
@@ -1322,6 +1329,7 @@ bool mapReinitGameStateAfterTerrainRestore(WorldMapState& mapState)
 	{
 		mapState.auxMap[x] = std::make_unique<uint8_t[]>(mapSize);
 	}
+	mapSetEpoch(mapState);
 
 	for (int y = 0; y < mapState.height; ++y)
 	{
@@ -1400,6 +1408,16 @@ bool mapSaveToWzMapData(WzMap::MapData& output, const WorldMapState& mapState)
 	return true;
 }
 
+void mapAllocateTiles(WorldMapState& mapState, int32_t width, int32_t height)
+{
+	const size_t size = static_cast<size_t>(width) * height;
+	mapState.tiles = std::make_unique<MAPTILE[]>(size);
+	mapState.vision = std::make_unique<TileVision[]>(size);
+	mapState.display = std::make_unique<TileDisplay[]>(size);
+	mapState.width = width;
+	mapState.height = height;
+}
+
 /* Shutdown the map module */
 bool mapShutdown()
 {
@@ -2355,6 +2373,7 @@ void mapInit(GameWorld& world)
 
 void mapUpdate(GameWorld& world)
 {
+	WZ_PROFILE_SCOPE(mapUpdate);
 	const uint16_t currentTime = gameTime / GAME_TICKS_PER_UPDATE;
 	int posX, posY;
 
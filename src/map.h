@@ -120,10 +120,24 @@ static inline void auxMapRestore(WorldMapState& mapState, int player, int slot,
 	}
 }
 
+/// The aux bits which affect path finding blocking maps, see fpathBaseBlockingTile().
+#define AUXBITS_PATH_BLOCKING   (AUXBITS_NONPASSABLE | AUXBITS_OUR_BUILDING | AUXBITS_BLOCKING)
+
+/// Note a change to the path blocking bits in row y. Only aux bits in AUXBITS_PATH_BLOCKING count, so path
+/// finding threat bits (which the danger thread sets) never touch blockingRowChanges.
+WZ_DECL_ALWAYS_INLINE static inline void auxBlockingChanged(WorldMapState& mapState, int y, int state)
+{
+	if ((state & AUXBITS_PATH_BLOCKING) != 0)
+	{
+		mapState.blockingRowChanges[y] = ++mapState.blockingChanges;
+	}
+}
+
 /// Set aux bits. Always set identically for all players. States not set are retained.
 WZ_DECL_ALWAYS_INLINE static inline void auxSet(WorldMapState& mapState, int x, int y, int player, int state)
 {
 	mapState.auxMap[player][x + y * mapState.width] |= state;
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Set aux bits. Always set identically for all players. States not set are retained.
@@ -135,6 +149,7 @@ WZ_DECL_ALWAYS_INLINE static inline void auxSetAll(WorldMapState& mapState, int
 	{
 		mapState.auxMap[i][x + y * mapState.width] |= state;
 	}
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Set aux bits. Always set identically for all players. States not set are retained.
@@ -149,6 +164,7 @@ WZ_DECL_ALWAYS_INLINE static inline void auxSetAllied(WorldMapState& mapState, i
 			mapState.auxMap[i][x + y * mapState.width] |= state;
 		}
 	}
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Set aux bits. Always set identically for all players. States not set are retained.
@@ -163,12 +179,14 @@ WZ_DECL_ALWAYS_INLINE static inline void auxSetEnemy(WorldMapState& mapState, in
 			mapState.auxMap[i][x + y * mapState.width] |= state;
 		}
 	}
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Clear aux bits. Always set identically for all players. States not cleared are retained.
 WZ_DECL_ALWAYS_INLINE static inline void auxClear(WorldMapState& mapState, int x, int y, int player, int state)
 {
 	mapState.auxMap[player][x + y * mapState.width] &= ~state;
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Clear all aux bits. Always set identically for all players. States not cleared are retained.
@@ -180,18 +198,21 @@ WZ_DECL_ALWAYS_INLINE static inline void auxClearAll(WorldMapState& mapState, in
 	{
 		mapState.auxMap[i][x + y * mapState.width] &= ~state;
 	}
+	auxBlockingChanged(mapState, y, state);
 }
 
 /// Set blocking bits. Always set identically for all players. States not set are retained.
 WZ_DECL_ALWAYS_INLINE static inline void auxSetBlocking(WorldMapState& mapState, int x, int y, int state)
 {
 	mapState.blockMap[0][x + y * mapState.width] |= state;
+	auxBlockingChanged(mapState, y, AUXBITS_PATH_BLOCKING);
 }
 
 /// Clear blocking bits. Always set identically for all players. States not cleared are retained.
 WZ_DECL_ALWAYS_INLINE static inline void auxClearBlocking(WorldMapState& mapState, int x, int y, int state)
 {
 	mapState.blockMap[0][x + y * mapState.width] &= ~state;
+	auxBlockingChanged(mapState, y, AUXBITS_PATH_BLOCKING);
 }
 
 /**
@@ -359,6 +380,9 @@ static inline void clip_world_offmap(const WorldMapState& mapState, int *worldX,
 /* Shutdown the map module */
 bool mapShutdown();
 
+/// Allocates the per-tile planes of mapState for a map of width * height tiles, all zero.
+void mapAllocateTiles(WorldMapState& mapState, int32_t width, int32_t height);
+
 class ResourceLoadingController;
 
 /* Load the map data */
@@ -403,8 +427,8 @@ public:
 /* Save the map data */
 bool mapSaveToWzMapData(WzMap::MapData& output, const WorldMapState& mapState);
 
-/** Return a pointer to the tile structure at x,y in map coordinates */
-static inline WZ_DECL_PURE MAPTILE *mapTile(WorldMapState& mapState, int32_t x, int32_t y)
+/** Return the index of the tile at x,y in the per-tile planes of mapState, clamped to the map */
+static inline WZ_DECL_PURE size_t mapTileIndex(const WorldMapState& mapState, int32_t x, int32_t y)
 {
 	// Clamp x and y values to actual ones
 	// Give one tile worth of leeway before asserting, for units/transporters coming in from off-map.
@@ -417,7 +441,13 @@ static inline WZ_DECL_PURE MAPTILE *mapTile(WorldMapState& mapState, int32_t x,
 	x = MIN(x, mapState.width - 1);
 	y = MIN(y, mapState.height - 1);
 
-	return &mapState.tiles[x + (y * mapState.width)];
+	return x + (y * mapState.width);
+}
+
+/** Return a pointer to the tile structure at x,y in map coordinates */
+static inline WZ_DECL_PURE MAPTILE *mapTile(WorldMapState& mapState, int32_t x, int32_t y)
+{
+	return &mapState.tiles[mapTileIndex(mapState, x, y)];
 }
 
 static inline WZ_DECL_PURE const MAPTILE* mapTile(const WorldMapState& mapState, int32_t x, int32_t y)
@@ -435,6 +465,28 @@ static inline WZ_DECL_PURE const MAPTILE* mapTile(const WorldMapState& mapState,
 	return const_cast<const MAPTILE*>(mapTile(const_cast<WorldMapState&>(mapState), v.x, v.y));
 }
 
+/** Return the per-player vision counts of the tile at x,y in map coordinates */
+static inline WZ_DECL_PURE TileVision *mapTileVision(WorldMapState& mapState, int32_t x, int32_t y)
+{
+	return &mapState.vision[mapTileIndex(mapState, x, y)];
+}
+
+static inline WZ_DECL_PURE const TileVision *mapTileVision(const WorldMapState& mapState, int32_t x, int32_t y)
+{
+	return &mapState.vision[mapTileIndex(mapState, x, y)];
+}
+
+/** Return the display data of the tile at x,y in map coordinates. DISPLAY ONLY (NOT for use in game calculations) */
+static inline WZ_DECL_PURE TileDisplay *mapTileDisplay(WorldMapState& mapState, int32_t x, int32_t y)
+{
+	return &mapState.display[mapTileIndex(mapState, x, y)];
+}
+
+static inline WZ_DECL_PURE const TileDisplay *mapTileDisplay(const WorldMapState& mapState, int32_t x, int32_t y)
+{
+	return &mapState.display[mapTileIndex(mapState, x, y)];
+}
+
 /** Return a pointer to the tile structure at x,y in world coordinates */
 static inline WZ_DECL_PURE MAPTILE *worldTile(WorldMapState& mapState, int32_t x, int32_t y)
 {
@@ -487,6 +539,15 @@ static inline WZ_DECL_PURE int32_t map_TileHeightSurface(const WorldMapState& ma
 }
 
 
+/// Note a change to the height of a tile in row y.
+static inline void mapHeightChanged(WorldMapState& mapState, int y)
+{
+	if (static_cast<size_t>(y) < mapState.heightRowChanges.size())
+	{
+		mapState.heightRowChanges[y] = ++mapState.heightChanges;
+	}
+}
+
 /*sets the tile height */
 static inline void setTileHeight(WorldMapState& mapState, int32_t x, int32_t y, int32_t height)
 {
@@ -494,6 +555,7 @@ static inline void setTileHeight(WorldMapState& mapState, int32_t x, int32_t y,
 	ASSERT_OR_RETURN(, y < mapState.height && x >= 0, "y coordinate %d bigger than map height %u", y, mapState.height);
 
 	mapState.tiles[x + (y * mapState.width)].height = height;
+	mapHeightChanged(mapState, y);
 	markTileDirty(x, y);
 }
 
@@ -563,7 +625,7 @@ void mapFloodFillContinents(WorldMapState& mapState);
 
 /// Rebuild the game-authoritative derived map state (aux/block maps, blocking bits, continents)
 /// for a world whose tiles + static terrain (texture/height/water) have just been restored from a
-/// match-state snapshot. The caller must have allocated map.tiles, set width/height, populated the
+/// match-state snapshot. The caller must have allocated the tiles with mapAllocateTiles(), populated the
 /// static terrain, and added any gateways before calling. Display-only state (ground types,
 /// riverbed, lightmap, tileset) is NOT rebuilt here -- it is regenerated by the normal map-load
 /// path if/when this (off-world) map is actually entered and rendered.
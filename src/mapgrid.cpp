@@ -31,12 +31,58 @@
 #include "mapgrid.h"
 #include "pointtree.h"
 #include "game_world.h"
+#include "profiling.h"
+
+#include <algorithm>
+#include <unordered_map>
 
 
 static PointTree *gridPointTree = nullptr;  // A quad-tree-like object.
 static PointTree::Filter *gridFiltersUnseen;
 static PointTree::Filter *gridFiltersDroidsByPlayer;
 static PointTree::Filter *gridFiltersDroidsRepairCandidates;
+static uint32_t gridGeneration = 0;  // Number of gridReset() calls, see BASE_OBJECT::gridGeneration.
+static std::vector<Vector2i> gridPositions;  // Position of each object in the point tree, by gridIndex.
+
+// Which objects each player could fully see at the last gridCacheVisibility(), for gridStartIterateVisible().
+#define GRID_VISIBLE_CELL_SHIFT 10  // Cells of 1024×1024 world units (8×8 tiles).
+static_assert(MAX_PLAYERS <= 16, "gridVisibleMasks needs more bits");
+static uint32_t gridVisibleGeneration = 0;      // gridGeneration at the last gridCacheVisibility(), 0 if invalidated since.
+static std::vector<uint16_t> gridVisibleMasks;  // Bit p set if the object was alive and fully visible to player p, by gridIndex.
+static Vector2i gridVisibleOrigin(0, 0);        // Smallest x and y of any object, the corner of cell (0, 0).
+static int gridVisibleCellsX = 1;
+static int gridVisibleCellsY = 1;
+struct GridVisibleBuckets
+{
+	uint32_t generation = 0;         // gridVisibleGeneration the buckets were built for, 0 if never.
+	std::vector<uint32_t> cellStart; // The objects in cell c are objects[cellStart[c]] to objects[cellStart[c + 1] - 1].
+	std::vector<uint32_t> objects;   // gridIndex of the objects visible to the player, ascending within each cell.
+};
+static GridVisibleBuckets gridVisibleBuckets[MAX_PLAYERS];
+
+// Queries remembered by gridStartIterateMemoised() and gridStartIterateAreaMemoised(), since gridMemoGeneration.
+struct GridMemoKey
+{
+	int32_t x, y, x2, y2;  // x2 and y2 are the radius and 0 for circles
+
+	bool operator ==(GridMemoKey const &b) const
+	{
+		return x == b.x && y == b.y && x2 == b.x2 && y2 == b.y2;
+	}
+};
+struct GridMemoKeyHash
+{
+	size_t operator()(GridMemoKey const &k) const
+	{
+		uint64_t h = (uint64_t)(uint32_t)k.x * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uint32_t)k.y * 0xC2B2AE3D27D4EB4FULL;
+		h ^= (uint64_t)(uint32_t)k.x2 * 0x165667B19E3779F9ULL ^ (uint64_t)(uint32_t)k.y2 * 0x27D4EB2F165667C5ULL;
+		return (size_t)(h ^ (h >> 32));
+	}
+};
+#define GRID_MEMO_MAX_QUERIES 4096  // Forget all queries when there are more, in case the caller never repeats them.
+static uint32_t gridMemoGeneration = 0;
+static std::unordered_map<GridMemoKey, PointTree::ResultVector, GridMemoKeyHash> gridMemoCircles;  // Not yet filtered by radius.
+static std::unordered_map<GridMemoKey, GridList, GridMemoKeyHash> gridMemoAreas;
 
 // initialise the grid system
 bool gridInitialise()
@@ -50,34 +96,86 @@ bool gridInitialise()
 	return true;  // Yay, nothing failed!
 }
 
+static bool gridCrossCheckEnabled = false;  // Compare each incremental rebuild with a full rebuild.
+
+static void gridInsertObject(BASE_OBJECT *psObj, uint32_t previousGeneration)
+{
+	unsigned previousIndex = psObj->gridGeneration == previousGeneration ? psObj->gridIndex : PointTree::NO_PREVIOUS_INDEX;
+	gridPointTree->insertIncremental(psObj, psObj->pos.x, psObj->pos.y, previousIndex);
+	for (unsigned char& viewer : psObj->seenThisTick)
+	{
+		viewer = 0;
+	}
+}
+
+// Rebuilds the point tree from scratch, and checks that the incremental rebuild gave the same result.
+static void gridCrossCheck(GameWorld& world)
+{
+	static PointTree fullTree;
+	fullTree.clear();
+	auto insert = [](BASE_OBJECT *psObj) {
+		if (!psObj->died)
+		{
+			fullTree.insert(psObj, psObj->pos.x, psObj->pos.y);
+		}
+	};
+	for (unsigned player = 0; player < MAX_PLAYERS; player++)
+	{
+		for (BASE_OBJECT* psObj : world.objects.droids[player])
+		{
+			insert(psObj);
+		}
+		for (BASE_OBJECT* psObj : world.objects.structures[player])
+		{
+			insert(psObj);
+		}
+	}
+	for (BASE_OBJECT* psObj : world.objects.features[0])
+	{
+		insert(psObj);
+	}
+	fullTree.sort();
+
+	size_t mismatch = 0;
+	while (mismatch < fullTree.size() && mismatch < gridPointTree->size() && fullTree.pointAt(mismatch) == gridPointTree->pointAt(mismatch))
+	{
+		++mismatch;
+	}
+	if (mismatch == fullTree.size() && mismatch == gridPointTree->size())
+	{
+		return;
+	}
+	ASSERT(false, "Incremental grid rebuild differs from full rebuild at index %zu of %zu (incremental has %zu points)", mismatch, fullTree.size(), gridPointTree->size());
+	std::swap(*gridPointTree, fullTree);  // Carry on with the correct one.
+}
+
 // reset the grid system
 void gridReset(GameWorld& world)
 {
-	gridPointTree->clear();
+	WZ_PROFILE_SCOPE(gridReset);
+	uint32_t previousGeneration = gridGeneration;
+	if (++gridGeneration == 0)
+	{
+		gridGeneration = 1;  // 0 means "never computed".
+	}
 
-	// Put all existing objects into the point tree.
+	// Put all existing objects into the point tree. Objects which have not moved since the last reset keep their
+	// place, only the others need to be sorted.
+	gridPointTree->beginIncrementalBuild();
 	for (unsigned player = 0; player < MAX_PLAYERS; player++)
 	{
 		for (BASE_OBJECT* psObj : world.objects.droids[player])
 		{
 			if (!psObj->died)
 			{
-				gridPointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
-				for (unsigned char& viewer : psObj->seenThisTick)
-				{
-					viewer = 0;
-				}
+				gridInsertObject(psObj, previousGeneration);
 			}
 		}
 		for (BASE_OBJECT* psObj : world.objects.structures[player])
 		{
 			if (!psObj->died)
 			{
-				gridPointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
-				for (unsigned char& viewer : psObj->seenThisTick)
-				{
-					viewer = 0;
-				}
+				gridInsertObject(psObj, previousGeneration);
 			}
 		}
 	}
@@ -85,15 +183,25 @@ void gridReset(GameWorld& world)
 	{
 		if (!psObj->died)
 		{
-			gridPointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
-			for (unsigned char& viewer : psObj->seenThisTick)
-			{
-				viewer = 0;
-			}
+			gridInsertObject(psObj, previousGeneration);
 		}
 	}
+	gridPointTree->endIncrementalBuild();
 
-	gridPointTree->sort();
+	if (gridCrossCheckEnabled)
+	{
+		gridCrossCheck(world);
+	}
+
+	// Remember where each object ended up, for the next reset.
+	gridPositions.resize(gridPointTree->size());
+	for (unsigned i = 0; i < gridPointTree->size(); ++i)
+	{
+		BASE_OBJECT *psObj = static_cast<BASE_OBJECT *>(gridPointTree->pointAt(i));
+		psObj->gridIndex = i;
+		psObj->gridGeneration = gridGeneration;
+		gridPositions[i] = psObj->pos.xy();
+	}
 
 	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
 	{
@@ -103,6 +211,16 @@ void gridReset(GameWorld& world)
 	}
 }
 
+void gridSetCrossCheck(bool enable)
+{
+	gridCrossCheckEnabled = enable;
+}
+
+bool gridGetCrossCheck()
+{
+	return gridCrossCheckEnabled;
+}
+
 // shutdown the grid system
 void gridShutDown()
 {
@@ -112,6 +230,17 @@ void gridShutDown()
 	gridFiltersUnseen = nullptr;
 	delete[] gridFiltersDroidsByPlayer;
 	gridFiltersDroidsByPlayer = nullptr;
+	delete[] gridFiltersDroidsRepairCandidates;
+	gridFiltersDroidsRepairCandidates = nullptr;
+	gridPositions.clear();
+	gridVisibleGeneration = 0;
+	gridVisibleMasks.clear();
+	for (GridVisibleBuckets &buckets : gridVisibleBuckets)
+	{
+		buckets = GridVisibleBuckets();
+	}
+	gridMemoCircles.clear();
+	gridMemoAreas.clear();
 }
 
 static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
@@ -120,44 +249,45 @@ static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
 	return ((int64_t)x * (int64_t)x + (int64_t)y * (int64_t)y) <= ((int64_t)radius * (int64_t)radius);
 }
 
-// initialise the grid system to start iterating through units that
-// could affect a location (x,y in world coords)
+// Find the objects within radius of (x, y) which satisfy condition, into results. Objects which do not satisfy the
+// condition are erased from filter, so that future searches skip them.
 template<class Condition>
-static GridList const &gridStartIterateFiltered(int32_t x, int32_t y, uint32_t radius, PointTree::Filter *filter, Condition const &condition)
+static void gridQueryFiltered(int32_t x, int32_t y, uint32_t radius, PointTree::Filter *filter, PointTree::ResultVector &candidates, PointTree::IndexVector &indices, Condition const &condition, GridList &results)
 {
+	PointTree const &pointTree = *gridPointTree;
 	if (filter == nullptr)
 	{
-		gridPointTree->query(x, y, radius);
+		pointTree.query(x, y, radius, candidates);
 	}
 	else
 	{
-		gridPointTree->query(*filter, x, y, radius);
+		pointTree.query(*filter, x, y, radius, candidates, indices);
 	}
-	PointTree::ResultVector::iterator w = gridPointTree->lastQueryResults.begin(), i;
-	for (i = w; i != gridPointTree->lastQueryResults.end(); ++i)
+	results.clear();
+	for (size_t n = 0; n < candidates.size(); ++n)
 	{
-		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(*i);
+		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(candidates[n]);
 		if (!condition.test(obj))  // Check if we should skip this object.
 		{
-			filter->erase(gridPointTree->lastFilteredQueryIndices[i - gridPointTree->lastQueryResults.begin()]);  // Stop the object from appearing in future searches.
+			filter->erase(indices[n]);  // Stop the object from appearing in future searches.
 		}
 		else if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))  // Check that search result is less than radius (since they can be up to a factor of sqrt(2) more).
 		{
-			*w = *i;
-			++w;
+			results.push_back(obj);
 		}
 	}
-	gridPointTree->lastQueryResults.erase(w, i);  // Erase all points that were a bit too far.
 
 	// In case you are curious.
-	//debug(LOG_WARNING, "gridStartIterateFiltered(%d, %d, %u) found %u objects", x, y, radius, (unsigned)gridPointTree->lastQueryResults.size());
+	//debug(LOG_WARNING, "gridQueryFiltered(%d, %d, %u) found %u objects", x, y, radius, (unsigned)results.size());
+}
 
+// initialise the grid system to start iterating through units that
+// could affect a location (x,y in world coords)
+template<class Condition>
+static GridList const &gridStartIterateFiltered(int32_t x, int32_t y, uint32_t radius, PointTree::Filter *filter, Condition const &condition)
+{
 	static GridList gridList;
-	gridList.resize(gridPointTree->lastQueryResults.size());
-	for (unsigned n = 0; n < gridList.size(); ++n)
-	{
-		gridList[n] = (BASE_OBJECT *)gridPointTree->lastQueryResults[n];
-	}
+	gridQueryFiltered(x, y, radius, filter, gridPointTree->lastQueryResults, gridPointTree->lastFilteredQueryIndices, condition, gridList);
 	return gridList;
 }
 
@@ -183,6 +313,136 @@ struct ConditionTrue
 	}
 };
 
+void gridCacheVisibility()
+{
+	const size_t size = gridPointTree->size();
+	gridVisibleMasks.resize(size);
+	Vector2i minPos(0, 0), maxPos(0, 0);
+	for (size_t i = 0; i < size; ++i)
+	{
+		BASE_OBJECT const *psObj = static_cast<BASE_OBJECT const *>(gridPointTree->pointAt(i));
+		uint16_t mask = 0;
+		for (unsigned player = 0; player < MAX_PLAYERS && !psObj->died; ++player)
+		{
+			mask |= uint16_t(psObj->visible[player] == UBYTE_MAX) << player;
+		}
+		gridVisibleMasks[i] = mask;
+		minPos = i == 0 ? gridPositions[i] : glm::min(minPos, gridPositions[i]);
+		maxPos = i == 0 ? gridPositions[i] : glm::max(maxPos, gridPositions[i]);
+	}
+	gridVisibleOrigin = minPos;
+	gridVisibleCellsX = (int)(((int64_t)maxPos.x - minPos.x) >> GRID_VISIBLE_CELL_SHIFT) + 1;
+	gridVisibleCellsY = (int)(((int64_t)maxPos.y - minPos.y) >> GRID_VISIBLE_CELL_SHIFT) + 1;
+	gridVisibleGeneration = gridGeneration;
+}
+
+void gridInvalidateVisibility()
+{
+	gridVisibleGeneration = 0;
+}
+
+static int gridVisibleCellX(int64_t x)
+{
+	return (int)std::min<int64_t>(std::max<int64_t>((x - gridVisibleOrigin.x) >> GRID_VISIBLE_CELL_SHIFT, 0), gridVisibleCellsX - 1);
+}
+
+static int gridVisibleCellY(int64_t y)
+{
+	return (int)std::min<int64_t>(std::max<int64_t>((y - gridVisibleOrigin.y) >> GRID_VISIBLE_CELL_SHIFT, 0), gridVisibleCellsY - 1);
+}
+
+// Sorts the objects visible to player into cells, by counting sort, so that each cell stays in gridIndex order.
+static void gridBuildVisibleBuckets(GridVisibleBuckets &buckets, unsigned player)
+{
+	const uint16_t bit = 1 << player;
+	buckets.cellStart.assign(gridVisibleCellsX * gridVisibleCellsY + 1, 0);
+	for (size_t i = 0; i < gridVisibleMasks.size(); ++i)
+	{
+		if (gridVisibleMasks[i] & bit)
+		{
+			++buckets.cellStart[gridVisibleCellX(gridPositions[i].x) + gridVisibleCellY(gridPositions[i].y) * gridVisibleCellsX + 1];
+		}
+	}
+	for (size_t c = 1; c < buckets.cellStart.size(); ++c)
+	{
+		buckets.cellStart[c] += buckets.cellStart[c - 1];
+	}
+	buckets.objects.resize(buckets.cellStart.back());
+	std::vector<uint32_t> next(buckets.cellStart.begin(), buckets.cellStart.end() - 1);
+	for (size_t i = 0; i < gridVisibleMasks.size(); ++i)
+	{
+		if (gridVisibleMasks[i] & bit)
+		{
+			buckets.objects[next[gridVisibleCellX(gridPositions[i].x) + gridVisibleCellY(gridPositions[i].y) * gridVisibleCellsX]++] = i;
+		}
+	}
+	buckets.generation = gridVisibleGeneration;
+}
+
+GridList const &gridStartIterateVisible(int32_t x, int32_t y, uint32_t radius, int player)
+{
+	if (gridVisibleGeneration != gridGeneration || (unsigned)player >= MAX_PLAYERS)
+	{
+		return gridStartIterate(x, y, radius);
+	}
+	GridVisibleBuckets &buckets = gridVisibleBuckets[player];
+	if (buckets.generation != gridVisibleGeneration)
+	{
+		gridBuildVisibleBuckets(buckets, player);
+	}
+
+	// The same square as PointTree::query(), by position in the point tree, then back into gridIndex order, which is the order it returns them in.
+	const int32_t minX = x - radius, maxX = x + radius, minY = y - radius, maxY = y + radius;
+	static std::vector<uint32_t> indices;
+	indices.clear();
+	const int cx0 = gridVisibleCellX((int64_t)x - radius), cx1 = gridVisibleCellX((int64_t)x + radius);
+	const int cy0 = gridVisibleCellY((int64_t)y - radius), cy1 = gridVisibleCellY((int64_t)y + radius);
+	for (int cy = cy0; cy <= cy1; ++cy)
+	{
+		for (int cx = cx0; cx <= cx1; ++cx)
+		{
+			const int cell = cx + cy * gridVisibleCellsX;
+			for (uint32_t n = buckets.cellStart[cell]; n != buckets.cellStart[cell + 1]; ++n)
+			{
+				const uint32_t i = buckets.objects[n];
+				const Vector2i pos = gridPositions[i];
+				if (pos.x >= minX && pos.x <= maxX && pos.y >= minY && pos.y <= maxY)
+				{
+					indices.push_back(i);
+				}
+			}
+		}
+	}
+	std::sort(indices.begin(), indices.end());
+
+	static GridList gridList;
+	gridList.clear();
+	for (uint32_t i : indices)
+	{
+		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(gridPointTree->pointAt(i));
+		if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))
+		{
+			gridList.push_back(obj);
+		}
+	}
+	return gridList;
+}
+
+size_t gridSize()
+{
+	return gridPointTree->size();
+}
+
+BASE_OBJECT *gridObjectAt(size_t index)
+{
+	return static_cast<BASE_OBJECT *>(gridPointTree->pointAt(index));
+}
+
+Vector2i gridPositionAt(size_t index)
+{
+	return gridPositions[index];
+}
+
 GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius)
 {
 	return gridStartIterateFiltered(x, y, radius, nullptr, ConditionTrue());
@@ -193,6 +453,53 @@ GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t
 	return gridStartIterateFilteredArea(x, y, x2, y2, ConditionTrue());
 }
 
+static void gridMemoCheckGeneration()
+{
+	if (gridMemoGeneration != gridGeneration || gridMemoCircles.size() + gridMemoAreas.size() >= GRID_MEMO_MAX_QUERIES)
+	{
+		gridMemoCircles.clear();
+		gridMemoAreas.clear();
+		gridMemoGeneration = gridGeneration;
+	}
+}
+
+GridList const &gridStartIterateMemoised(int32_t x, int32_t y, uint32_t radius)
+{
+	gridMemoCheckGeneration();
+	auto it = gridMemoCircles.find(GridMemoKey{x, y, (int32_t)radius, 0});
+	if (it == gridMemoCircles.end())
+	{
+		it = gridMemoCircles.emplace(GridMemoKey{x, y, (int32_t)radius, 0}, PointTree::ResultVector()).first;
+		gridPointTree->query(x, y, radius, it->second);
+	}
+
+	// The point tree has not changed since the query, so the candidates are exactly what it would return now, in the same order.
+	// Only the radius check depends on the current object positions, so it is done here.
+	static GridList gridList;
+	gridList.clear();
+	for (void *candidate : it->second)
+	{
+		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(candidate);
+		if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))
+		{
+			gridList.push_back(obj);
+		}
+	}
+	return gridList;
+}
+
+GridList const &gridStartIterateAreaMemoised(int32_t x, int32_t y, uint32_t x2, uint32_t y2)
+{
+	// Unlike circles, areas are not checked against the current positions, so the results can be kept as they are.
+	gridMemoCheckGeneration();
+	auto it = gridMemoAreas.find(GridMemoKey{x, y, (int32_t)x2, (int32_t)y2});
+	if (it == gridMemoAreas.end())
+	{
+		it = gridMemoAreas.emplace(GridMemoKey{x, y, (int32_t)x2, (int32_t)y2}, gridStartIterateArea(x, y, x2, y2)).first;
+	}
+	return it->second;
+}
+
 struct ConditionDroidsByPlayer
 {
 	ConditionDroidsByPlayer(int32_t player_) : player(player_) {}
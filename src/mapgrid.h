@@ -24,6 +24,8 @@
 #ifndef __INCLUDED_SRC_MAPGRID_H__
 #define __INCLUDED_SRC_MAPGRID_H__
 
+#include "lib/framework/vector.h"
+
 typedef std::vector<BASE_OBJECT *> GridList;
 typedef GridList::const_iterator GridIterator;
 
@@ -37,14 +39,47 @@ void gridShutDown();
 
 // Reset the grid system. Called once per update.
 // Resets seenThisTick[] to false.
+// Only objects which moved, appeared or disappeared since the last reset cost more than a linear pass.
 void gridReset(GameWorld& world);
 
+/// Debugging aid: if enabled, gridReset() compares its result with a full rebuild of the grid every time.
+void gridSetCrossCheck(bool enable);
+bool gridGetCrossCheck();
+
+/// Number of objects in the grid, as of the last gridReset(). Each has a gridIndex in [0, gridSize()).
+size_t gridSize();
+
+/// The object with the given gridIndex, for index < gridSize().
+BASE_OBJECT *gridObjectAt(size_t index);
+
+/// Position of the object with the given gridIndex at the last gridReset(), which is where queries look for it.
+Vector2i gridPositionAt(size_t index);
+
 /// Find all objects within radius.
 GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius);
 
 /// Find all objects within radius.
 GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t y2);
 
+/// Same as gridStartIterate(x, y, radius), but keeps the candidates of each query until the next gridReset(), so that
+/// repeating a query costs only the radius check. For callers which repeat queries within a tick, such as scripts.
+GridList const &gridStartIterateMemoised(int32_t x, int32_t y, uint32_t radius);
+
+/// Same as gridStartIterateArea(x, y, x2, y2), but keeps the results of each query until the next gridReset().
+GridList const &gridStartIterateAreaMemoised(int32_t x, int32_t y, uint32_t x2, uint32_t y2);
+
+/// Find all objects within radius, except that objects which were dead, or not fully visible to player, at the last
+/// gridCacheVisibility() may be left out. Callers must still check visibility themselves, but for the targeting code,
+/// which only considers objects with visible[player] == UBYTE_MAX, the result is the same as with gridStartIterate().
+GridList const &gridStartIterateVisible(int32_t x, int32_t y, uint32_t radius, int player);
+
+/// Records which objects each player can fully see, for gridStartIterateVisible(). Call after each processVisibility().
+void gridCacheVisibility();
+
+/// Call when an object may have become fully visible to a player other than in processVisibility(). Until the next
+/// gridCacheVisibility(), gridStartIterateVisible() then leaves nothing out.
+void gridInvalidateVisibility();
+
 /// Find all objects within radius where object->type == OBJ_DROID && object->player == player.
 GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t radius, int player);
 
@@ -29,10 +29,13 @@
 #include "lib/framework/wzstring.h"
 #include "objmem.h"
 
+#include <array>
+#include <list>
+
 #define NO_AUDIO_MSG		-1
 
 /** The lists of messages allocated. */
-using PerPlayerMessageLists = PerPlayerObjectLists<MESSAGE, MAX_PLAYERS>;
+using PerPlayerMessageLists = std::array<std::list<MESSAGE*>, MAX_PLAYERS>;
 using MessageList = typename PerPlayerMessageLists::value_type;
 extern PerPlayerMessageLists apsMessages;
 
@@ -40,7 +43,7 @@ extern PerPlayerMessageLists apsMessages;
 extern iIMDBaseShape	*pProximityMsgIMD;
 
 /** The list of proximity displays allocated. */
-using PerPlayerProximityDisplayLists = PerPlayerObjectLists<PROXIMITY_DISPLAY, MAX_PLAYERS>;
+using PerPlayerProximityDisplayLists = std::array<std::list<PROXIMITY_DISPLAY*>, MAX_PLAYERS>;
 using ProximityDisplayList = typename PerPlayerProximityDisplayLists::value_type;
 extern PerPlayerProximityDisplayLists apsProxDisp;
 
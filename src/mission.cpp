@@ -312,6 +312,9 @@ void initMission()
 	{
 		i.reset();
 	}
+	mission.gameWorld.map.epoch = 0;
+	mission.gameWorld.map.blockingRowChanges.clear();
+	mission.gameWorld.map.heightRowChanges.clear();
 
 	//init all the landing zones
 	initNoGoAreas();
@@ -1321,6 +1321,16 @@ static void moveCalcDroidSlide(DROID *psDroid, int *pmx, int *pmy)
 	CHECK_DROID(psDroid);
 }
 
+void moveBuildNeighbourTable()
+{
+	steering::CollisionAvoidanceBehavior::buildNeighbourTable();
+}
+
+void moveClearNeighbourTable()
+{
+	steering::CollisionAvoidanceBehavior::clearNeighbourTable();
+}
+
 /*!
  * Get a direction for a droid to avoid obstacles etc.
  * \param psDroid Which droid to examine
@@ -51,6 +51,11 @@ void moveReallyStopDroid(DROID *psDroid);
 /* Get a droid to do a frame's worth of moving */
 void moveUpdateDroid(DROID *psDroid);
 
+/// Build the table of droids to steer around for this update, after gridReset(). Only speeds up moveUpdateDroid().
+void moveBuildNeighbourTable();
+/// Forget the table built by moveBuildNeighbourTable(), once the droids have moved.
+void moveClearNeighbourTable();
+
 SDWORD moveCalcDroidSpeed(DROID *psDroid);
 
 /* update body and turret to local slope */
@@ -41,6 +41,7 @@
 #include "action.h"
 #include "console.h"
 #include "mapgrid.h"
+#include "fpath.h"
 #include "multirecv.h"
 #include "transporter.h"
 #include "game_world.h"
@@ -671,6 +672,10 @@ bool recvDroidInfo(NETQUEUE queue)
 		uint32_t num = 0;
 		NETuint32_t(r, num);
 
+		if (info.subType != SecondaryOrder)
+		{
+			fpathBeginGroupOrder(num);  // The same for every client, since the droids are the ones selected when the order was given.
+		}
 		for (unsigned n = 0; n < num; ++n)
 		{
 			// Get the next droid ID which is being given this order.
@@ -737,6 +742,7 @@ bool recvDroidInfo(NETQUEUE queue)
 
 			CHECK_DROID(psDroid);
 		}
+		fpathEndGroupOrder();
 	}
 	NETend(r);
 
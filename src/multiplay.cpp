@@ -95,6 +95,8 @@
 #include "multilobbycommands.h"
 #include "hci/teamstrategy.h"
 #include "hci/quickchat.h"
+#include "replaykeyframes.h"
+#include "replayverify.h"
 
 // ////////////////////////////////////////////////////////////////////////////
 // ////////////////////////////////////////////////////////////////////////////
@@ -1532,6 +1534,8 @@ bool recvMessage()
 					// ignore
 					break;
 				}
+				replayKeyframesReplayEnded();
+				replayVerifyFinish("replayEnded");
 				addConsoleMessage(_("REPLAY HAS ENDED"), CENTRE_JUSTIFY, SYSTEM_MESSAGE, false, MAX_CONSOLE_MESSAGE_DURATION);
 				addConsoleMessage(_("(Press ESC to quit.)"), CENTRE_JUSTIFY, SYSTEM_MESSAGE, false, MAX_CONSOLE_MESSAGE_DURATION);
 				showSpectatorGameOverScreen();
@@ -1954,6 +1958,7 @@ bool recvResearchStatus(NETQUEUE queue)
 
 			// Start the research
 			MakeResearchStarted(pPlayerRes);
+			researchStatusChanged(player, index);
 			psResFacilty->timeStartHold		= 0;
 		}
 	}
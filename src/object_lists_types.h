@@ -28,6 +28,7 @@
 #include <list>
 
 #include "lib/framework/frame.h" // MAX_PLAYERS
+#include "lib/framework/object_slot_list.h"
 
 struct BASE_OBJECT;
 struct DROID;
@@ -35,8 +36,10 @@ struct STRUCTURE;
 struct FEATURE;
 struct FLAG_POSITION;
 
+/// Per-player lists of simulation objects, walked every game tick.
+/// See `ObjectSlotList` for why these aren't `std::list`.
 template <typename ObjectType, unsigned PlayerCount>
-using PerPlayerObjectLists = std::array<std::list<ObjectType*>, PlayerCount>;
+using PerPlayerObjectLists = std::array<ObjectSlotList<ObjectType>, PlayerCount>;
 
 using PerPlayerDroidLists = PerPlayerObjectLists<DROID, MAX_PLAYERS>;
 using DroidList = typename PerPlayerDroidLists::value_type;
@@ -47,7 +50,8 @@ using StructureList = typename PerPlayerStructureLists::value_type;
 using PerPlayerFeatureLists = PerPlayerObjectLists<FEATURE, 1>;
 using FeatureList = typename PerPlayerFeatureLists::value_type;
 
-using PerPlayerFlagPositionLists = PerPlayerObjectLists<FLAG_POSITION, MAX_PLAYERS>;
+// Not simulated per tick, so these stay as plain `std::list`s.
+using PerPlayerFlagPositionLists = std::array<std::list<FLAG_POSITION*>, MAX_PLAYERS>;
 using FlagPositionList = typename PerPlayerFlagPositionLists::value_type;
 
 using PerPlayerExtractorLists = PerPlayerStructureLists;
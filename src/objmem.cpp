@@ -38,6 +38,7 @@
 #include "structuredef.h"
 #include "structure.h"
 #include "droid.h"
+#include "group.h"
 #include "mapgrid.h"
 #include "combat.h"
 #include "visibility.h"
@@ -46,6 +47,7 @@
 #include "wzcrashhandlingproviders.h"
 #include "world_object_state.h"
 #include "game_world.h"
+#include "profiling.h"
 
 #include <algorithm>
 
@@ -288,6 +290,7 @@ bool objmemDestroy(BASE_OBJECT *psObj, bool checkRefs)
 	{
 		return false;
 	}
+	scriptFreeObject(psObj);
 	if (psObj->type == OBJ_DROID)
 	{
 		// Droids are managed by a separate droid container.
@@ -320,9 +323,24 @@ bool objmemDestroy(BASE_OBJECT *psObj, bool checkRefs)
 	return true;
 }
 
+/* Squeeze out the slots left behind by objects removed from the per-player lists */
+static void compactObjectLists(WorldObjectState& objState)
+{
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		objState.droids[player].compact();
+		objState.structures[player].compact();
+		objState.extractors[player].compact();
+	}
+	objState.features[0].compact();
+	objState.sensors[0].compact();
+	objState.oils[0].compact();
+}
+
 /* General housekeeping for the object system */
 void objmemUpdate()
 {
+	WZ_PROFILE_SCOPE(objmemUpdate);
 #ifdef DEBUG
 	// do a general validity check first
 	objListIntegCheck();
@@ -353,6 +371,10 @@ void objmemUpdate()
 			triggerEventDestroyed(*it++);
 		}
 	}
+
+	compactObjectLists(gameWorld.objects);
+	compactObjectLists(mission.gameWorld.objects);
+	grpCompactLists();
 }
 
 uint32_t generateNewObjectId()
@@ -629,6 +651,7 @@ static void freeAllEntitiesImpl(PerPlayerObjectLists<Entity, PlayerCount>& entit
 			// (e.g. a droid's looping dynamic track), so a queued audio callback cannot later fire on
 			// the freed object - matching objmemDestroy's single-object teardown.
 			audio_RemoveObj((BASE_OBJECT*)ent);
+			scriptFreeObject((BASE_OBJECT*)ent);
 			if (map != nullptr)
 			{
 				visRemoveVisibility((BASE_OBJECT*)ent, *map);
@@ -119,7 +119,7 @@ void freeAllFlagPositions(WorldObjectState& objState);
 
 // Find a base object from it's id
 template <typename ObjectType>
-BASE_OBJECT* getBaseObjFromId(const std::list<ObjectType*>& list, unsigned id)
+BASE_OBJECT* getBaseObjFromId(const ObjectSlotList<ObjectType>& list, unsigned id)
 {
 	auto objIt = std::find_if(list.begin(), list.end(), [id](ObjectType* obj)
 	{
@@ -0,0 +1,217 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Bit packed tile map, see pathbitmap.h.
+ */
+
+#include "pathbitmap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define WZ_PATHBITMAP_SSE2
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define WZ_PATHBITMAP_SWAR
+#endif
+
+/// Returns bit i set iff (a[i] & maskA) != 0 || (b[i] & maskB) != 0, for i in [0, 64).
+static inline uint64_t packWord(uint8_t const *a, uint8_t maskA, uint8_t const *b, uint8_t maskB)
+{
+	uint64_t result = 0;
+#if defined(WZ_PATHBITMAP_SSE2)
+	const __m128i ma = _mm_set1_epi8(static_cast<char>(maskA));
+	const __m128i mb = _mm_set1_epi8(static_cast<char>(maskB));
+	const __m128i zero = _mm_setzero_si128();
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		__m128i v = zero;
+		if (maskA != 0)
+		{
+			v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(a + 16 * i)), ma);
+		}
+		if (maskB != 0)
+		{
+			v = _mm_or_si128(v, _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(b + 16 * i)), mb));
+		}
+		uint64_t isZero = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)));
+		result |= (~isZero & 0xFFFF) << (16 * i);
+	}
+#elif defined(WZ_PATHBITMAP_SWAR)
+	const uint64_t ma = maskA * 0x0101010101010101ull;
+	const uint64_t mb = maskB * 0x0101010101010101ull;
+	for (unsigned i = 0; i < 8; ++i)
+	{
+		uint64_t wa = 0, wb = 0;
+		if (maskA != 0)
+		{
+			memcpy(&wa, a + 8 * i, 8);
+		}
+		if (maskB != 0)
+		{
+			memcpy(&wb, b + 8 * i, 8);
+		}
+		const uint64_t t = (wa & ma) | (wb & mb);
+		// High bit of each byte set iff the byte is nonzero, then gather the 8 high bits into one byte.
+		const uint64_t nonzero = (((t & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | t) & 0x8080808080808080ull;
+		result |= ((nonzero >> 7) * 0x0102040810204080ull >> 56) << (8 * i);
+	}
+#else
+	for (unsigned i = 0; i < 64; ++i)
+	{
+		const bool set = (maskA != 0 && (a[i] & maskA) != 0) || (maskB != 0 && (b[i] & maskB) != 0);
+		result |= uint64_t(set) << i;
+	}
+#endif
+	return result;
+}
+
+PathBitmap::PathBitmap(int width, int height)
+	: mapWidth(std::max(width, 0))
+	, mapHeight(std::max(height, 0))
+	, wordsPerRow((mapWidth + 2 + 63) / 64)
+{
+	words.assign((mapHeight + 2) * wordsPerRow, 0);
+	std::fill(words.begin(), words.begin() + wordsPerRow, ~uint64_t(0));
+	std::fill(words.end() - wordsPerRow, words.end(), ~uint64_t(0));
+	for (int y = 0; y < mapHeight; ++y)
+	{
+		setOutside(y, 0, mapWidth - 1);
+	}
+}
+
+void PathBitmap::set(int x, int y, bool value)
+{
+	if ((unsigned)x >= (unsigned)mapWidth || (unsigned)y >= (unsigned)mapHeight)
+	{
+		return;
+	}
+	const size_t bit = x + 1;
+	uint64_t &word = row(y)[bit / 64];
+	word = (word & ~(uint64_t(1) << (bit % 64))) | uint64_t(value) << (bit % 64);
+}
+
+void PathBitmap::packRow(int y, uint8_t const *a, uint8_t maskA, uint8_t const *b, uint8_t maskB)
+{
+	uint64_t *r = row(y);
+	std::fill(r, r + wordsPerRow, 0);
+	int x = 0;
+	for (; x + 64 <= mapWidth; x += 64)
+	{
+		// Tile x is stored at bit x + 1, so each word of tiles straddles two words of the row.
+		const uint64_t w = packWord(a + x, maskA, b + x, maskB);
+		r[x / 64] |= w << 1;
+		r[x / 64 + 1] |= w >> 63;
+	}
+	for (; x < mapWidth; ++x)
+	{
+		const bool value = (maskA != 0 && (a[x] & maskA) != 0) || (maskB != 0 && (b[x] & maskB) != 0);
+		r[(x + 1) / 64] |= uint64_t(value) << ((x + 1) % 64);
+	}
+	setOutside(y, 0, mapWidth - 1);
+}
+
+void PathBitmap::setOutside(int y, int x0, int x1)
+{
+	uint64_t *r = row(y);
+	// Stored bits [1, x0] and [x1 + 2, mapWidth + 1], including the margin.
+	const size_t end = std::min<size_t>(std::max(x0, 0), mapWidth) + 1;
+	for (size_t bit = 0; bit < end; ++bit)
+	{
+		r[bit / 64] |= uint64_t(1) << (bit % 64);
+	}
+	for (size_t bit = std::max(x1 + 2, 0); bit < size_t(mapWidth) + 2; ++bit)
+	{
+		r[bit / 64] |= uint64_t(1) << (bit % 64);
+	}
+}
+
+void PathBitmap::setRow(int y)
+{
+	uint64_t *r = row(y);
+	std::fill(r, r + wordsPerRow, 0);
+	setOutside(y, 0, -1);
+}
+
+void PathBitmap::copyRow(PathBitmap const &other, int y)
+{
+	std::copy_n(other.row(y), wordsPerRow, row(y));
+}
+
+bool PathBitmap::rowEquals(PathBitmap const &other, int y) const
+{
+	return std::equal(row(y), row(y) + wordsPerRow, other.row(y));
+}
+
+void PathBitmap::unpackRow(int y, uint8_t *out, uint8_t value) const
+{
+	uint64_t const *r = row(y);
+	for (size_t i = 0; i < wordsPerRow; ++i)
+	{
+		for (uint64_t w = r[i]; w != 0; w &= w - 1)
+		{
+			// Tile x is stored at bit x + 1, skip the margins.
+			const size_t bit = i * 64 + std::countr_zero(w);
+			if (bit >= 1 && bit <= size_t(mapWidth))
+			{
+				out[bit - 1] = value;
+			}
+		}
+	}
+}
+
+bool PathBitmap::any() const
+{
+	for (int y = 0; y < mapHeight; ++y)
+	{
+		uint64_t const *r = row(y);
+		for (size_t i = 0; i < wordsPerRow; ++i)
+		{
+			uint64_t w = r[i];
+			// Ignore the margin, and the unused bits after it.
+			const size_t first = i * 64;
+			if (first == 0)
+			{
+				w &= ~uint64_t(1);
+			}
+			const size_t last = size_t(mapWidth) + 1;  // The right margin.
+			if (last < first + 64)
+			{
+				w &= last > first ? (uint64_t(1) << (last - first)) - 1 : 0;
+			}
+			if (w != 0)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+uint32_t PathBitmap::checksum() const
+{
+	uint64_t h = 14695981039346656037ull;
+	for (uint64_t w : words)
+	{
+		h = (h ^ w) * 1099511628211ull;
+	}
+	return static_cast<uint32_t>(h ^ (h >> 32));
+}
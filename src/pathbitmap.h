@@ -0,0 +1,111 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Bit packed tile map, for the path finding blocking and danger maps.
+ *
+ *  Each row is stored in whole 64 bit words, with a one tile margin around the map, in which every
+ *  bit is set. Tiles outside the map therefore test as set (blocking), and the 3×3 neighbourhood of
+ *  any tile on the map can be read with a few word operations, without bounds checks.
+ */
+
+#ifndef __INCLUDED_SRC_PATHBITMAP_H__
+#define __INCLUDED_SRC_PATHBITMAP_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PathBitmap
+{
+public:
+	PathBitmap() = default;
+	PathBitmap(int width, int height);  ///< All tiles clear.
+
+	int width() const { return mapWidth; }
+	int height() const { return mapHeight; }
+
+	/// Whether tile (x, y) is set. Tiles outside the map are set.
+	bool test(int x, int y) const
+	{
+		if ((unsigned)x >= (unsigned)mapWidth || (unsigned)y >= (unsigned)mapHeight)
+		{
+			return true;
+		}
+		const size_t bit = x + 1;
+		return (row(y)[bit / 64] >> (bit % 64)) & 1;
+	}
+
+	void set(int x, int y, bool value);
+
+	/// Returns the 3×3 tiles around (x, y), which must be on the map, as bit (dx + 1) + 3 * (dy + 1), for dx, dy in [-1, 1].
+	uint32_t neighbourhood(int x, int y) const
+	{
+		return bits3(row(y - 1), x) | bits3(row(y), x) << 3 | bits3(row(y + 1), x) << 6;
+	}
+
+	/// Sets row y to (a[x] & maskA) != 0 || (b[x] & maskB) != 0, for each x. Either array may be null, if its mask is 0.
+	void packRow(int y, uint8_t const *a, uint8_t maskA, uint8_t const *b, uint8_t maskB);
+
+	/// Sets the tiles of row y outside [x0, x1].
+	void setOutside(int y, int x0, int x1);
+	/// Sets every tile of row y.
+	void setRow(int y);
+
+	/// Copies row y from other, which must have the same size.
+	void copyRow(PathBitmap const &other, int y);
+	/// Whether row y is the same in other, which must have the same size.
+	bool rowEquals(PathBitmap const &other, int y) const;
+
+	/// Sets out[x] to value for each set tile x of row y, leaving the other elements of out[0, width) alone.
+	void unpackRow(int y, uint8_t *out, uint8_t value) const;
+
+	bool any() const;  ///< Whether any tile on the map is set.
+	uint32_t checksum() const;
+	bool operator ==(PathBitmap const &other) const
+	{
+		return mapWidth == other.mapWidth && mapHeight == other.mapHeight && words == other.words;
+	}
+	bool operator !=(PathBitmap const &other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	uint64_t const *row(int y) const { return &words[(y + 1) * wordsPerRow]; }
+	uint64_t *row(int y) { return &words[(y + 1) * wordsPerRow]; }
+
+	/// Tiles x - 1, x and x + 1 of a row, as bits 0 to 2.
+	static uint32_t bits3(uint64_t const *r, int x)
+	{
+		const unsigned shift = x % 64;  // Bit of tile x - 1, due to the margin.
+		uint64_t w = r[x / 64] >> shift;
+		if (shift > 61)
+		{
+			w |= r[x / 64 + 1] << (64 - shift);
+		}
+		return w & 7;
+	}
+
+	int mapWidth = 0;
+	int mapHeight = 0;
+	size_t wordsPerRow = 0;
+	std::vector<uint64_t> words;  ///< (mapHeight + 2) rows, the first and last being the margin.
+};
+
+#endif // __INCLUDED_SRC_PATHBITMAP_H__
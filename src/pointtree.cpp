@@ -33,9 +33,9 @@ When looking for points in a particular area, a search square is split up into 4
 of varying sizes, and a quick binary search for point in those ranges is performed. The ranges
 may overlap, in which case they are combined.
 
-For illustrations, run "make check" and look at tests/pointtree.ppm. (Different image each time.)
-The coloured areas are the points in the ranges (note that each range also contains some points
-outside the rectangles). The orange points are the search results.
+The points are stored as a structure of arrays, so the binary searches and the checks of the
+points in each range only read the sorted keys, which are densely packed. The binary searches start from a small bucket of keys, found by looking
+up the high bits of the key in bucketStart.
 */
 
 // Expands bit pattern abcd efgh to 0a0b 0c0d 0e0f 0g0h
@@ -79,30 +79,149 @@ static uint64_t interleave(int32_t x, int32_t y)
 
 void PointTree::insert(void *pointData, int32_t x, int32_t y)
 {
-	points.push_back(Point(interleave(x, y), pointData));
+	keys.push_back(interleave(x, y));
+	values.push_back(pointData);
 }
 
 void PointTree::clear()
 {
-	points.clear();
+	keys.clear();
+	values.clear();
+	bucketStart.clear();
 }
 
-static bool pointTreeSortFunction(std::pair<uint64_t, void *> const &a, std::pair<uint64_t, void *> const &b)
+void PointTree::sort()
 {
-	return a.first < b.first;  // Sort only by position, not by pointer address, even if two units are in the same place.
+	// Sort only by position and insertion order, not by pointer address, even if two units are in the same place.
+	// (Same as a stable sort by position, to avoid unspecified behaviour when two objects are in exactly the same place.)
+	sortBuffer.resize(keys.size());
+	for (size_t i = 0; i != keys.size(); ++i)
+	{
+		sortBuffer[i] = {keys[i], (unsigned)i, values[i]};
+	}
+	std::sort(sortBuffer.begin(), sortBuffer.end());
+	for (size_t i = 0; i != keys.size(); ++i)
+	{
+		keys[i] = sortBuffer[i].key;
+		values[i] = sortBuffer[i].value;
+	}
+	buildBucketIndex();
 }
 
-void PointTree::sort()
+void PointTree::beginIncrementalBuild()
 {
-	std::stable_sort(points.begin(), points.end(), pointTreeSortFunction);  // Stable sort to avoid unspecified behaviour when two objects are in exactly the same place.
+	keptRanks.assign(keys.size(), NO_PREVIOUS_INDEX);
+	sortBuffer.clear();
+	numIncrementalInserts = 0;
 }
 
-//#define DUMP_IMAGE  // All x and y coordinates must be in range -500 to 499, if dumping an image.
-#ifdef DUMP_IMAGE
-#include <math.h>
-uint8_t ppm[1000][1000][3];
-int doDump = false;
-#endif //DUMP_IMAGE
+void PointTree::insertIncremental(void *pointData, int32_t x, int32_t y, unsigned previousIndex)
+{
+	uint64_t key = interleave(x, y);
+	unsigned rank = numIncrementalInserts++;
+	if (previousIndex < keys.size() && values[previousIndex] == pointData && keys[previousIndex] == key && keptRanks[previousIndex] == NO_PREVIOUS_INDEX)
+	{
+		keptRanks[previousIndex] = rank;  // Still in the same place.
+		return;
+	}
+	sortBuffer.push_back({key, rank, pointData});
+}
+
+void PointTree::endIncrementalBuild()
+{
+	// The points which did not move are still sorted by position, but points in exactly the same place might have
+	// been inserted in a different order this time.
+	keptBuffer.clear();
+	for (size_t i = 0; i != keys.size(); ++i)
+	{
+		if (keptRanks[i] == NO_PREVIOUS_INDEX)
+		{
+			continue;  // Moved or gone.
+		}
+		keptBuffer.push_back({keys[i], keptRanks[i], values[i]});
+		size_t n = keptBuffer.size();
+		if (n >= 2 && keptBuffer[n - 1] < keptBuffer[n - 2])
+		{
+			// Rare, so just bubble it into place.
+			for (size_t j = n - 1; j > 0 && keptBuffer[j] < keptBuffer[j - 1]; --j)
+			{
+				std::swap(keptBuffer[j], keptBuffer[j - 1]);
+			}
+		}
+	}
+
+	std::sort(sortBuffer.begin(), sortBuffer.end());
+
+	keys.resize(keptBuffer.size() + sortBuffer.size());
+	values.resize(keys.size());
+	auto kept = keptBuffer.begin(), moved = sortBuffer.begin();
+	for (size_t i = 0; i != keys.size(); ++i)
+	{
+		Entry const &next = moved == sortBuffer.end() || (kept != keptBuffer.end() && *kept < *moved) ? *kept++ : *moved++;
+		keys[i] = next.key;
+		values[i] = next.value;
+	}
+	buildBucketIndex();
+}
+
+void PointTree::buildBucketIndex()
+{
+	// Split the key range into at most NUM_BUCKETS buckets, so the binary searches start off with a small range.
+	// Since all points are on the map, most of the bits of the keys are the same, and the buckets are well spread.
+	constexpr unsigned NUM_BUCKETS = 4096;
+	bucketStart.clear();
+	if (keys.empty())
+	{
+		return;
+	}
+	minKey = keys.front();
+	maxKey = keys.back();
+	bucketShift = 0;
+	while (((maxKey - minKey) >> bucketShift) >= NUM_BUCKETS)
+	{
+		++bucketShift;
+	}
+	unsigned numBuckets = ((maxKey - minKey) >> bucketShift) + 1;
+	bucketStart.resize(numBuckets + 1);
+	unsigned i = 0;
+	for (unsigned b = 0; b != numBuckets; ++b)
+	{
+		while (i != keys.size() && ((keys[i] - minKey) >> bucketShift) < b)
+		{
+			++i;
+		}
+		bucketStart[b] = i;
+	}
+	bucketStart[numBuckets] = keys.size();
+}
+
+unsigned PointTree::lowerBound(uint64_t key) const
+{
+	if (keys.empty() || key <= minKey)
+	{
+		return 0;
+	}
+	if (key > maxKey)
+	{
+		return keys.size();
+	}
+	uint64_t b = (key - minKey) >> bucketShift;
+	return std::lower_bound(keys.begin() + bucketStart[b], keys.begin() + bucketStart[b + 1], key) - keys.begin();
+}
+
+unsigned PointTree::upperBound(uint64_t key) const
+{
+	if (keys.empty() || key < minKey)
+	{
+		return 0;
+	}
+	if (key >= maxKey)
+	{
+		return keys.size();
+	}
+	uint64_t b = (key - minKey) >> bucketShift;
+	return std::upper_bound(keys.begin() + bucketStart[b], keys.begin() + bucketStart[b + 1], key) - keys.begin();
+}
 
 struct PointTreeRange
 {
@@ -111,25 +230,24 @@ struct PointTreeRange
 
 // If !IsFiltered, function is trivially optimised to "return i;".
 template<bool IsFiltered>
-static unsigned current(std::vector<unsigned> &filterData, unsigned i)
+static unsigned current(std::vector<unsigned> *filterData, unsigned i)
 {
 	unsigned ret = i;
-	while (IsFiltered && filterData[ret])
+	while (IsFiltered && (*filterData)[ret])
 	{
-		ret += filterData[ret];
+		ret += (*filterData)[ret];
 	}
-	while (IsFiltered && filterData[i])
+	while (IsFiltered && (*filterData)[i])
 	{
-		unsigned next = i + filterData[i];
-		filterData[i] = ret - i;
+		unsigned next = i + (*filterData)[i];
+		(*filterData)[i] = ret - i;
 		i = next;
 	}
 
 	return ret;
 }
 
-template<bool IsFiltered>
-PointTree::ResultVector &PointTree::queryMaybeFilter(Filter &filter, int32_t minXo, int32_t minYo, int32_t maxXo, int32_t maxYo)
+void PointTree::findRanges(Ranges &out, int32_t minXo, int32_t minYo, int32_t maxXo, int32_t maxYo) const
 {
 	uint64_t minX = expandX(minXo);
 	uint64_t maxX = expandX(maxXo);
@@ -151,55 +269,6 @@ PointTree::ResultVector &PointTree::queryMaybeFilter(Filter &filter, int32_t min
 	};
 	int numRanges = 4;
 
-#ifdef DUMP_IMAGE
-	FILE *f;
-	if (doDump)
-	{
-		f = fopen("pointtree.ppm", "wb");
-		fprintf(f, "P6\n1000 1000\n255\n");
-		for (int py = 0; py != 1000; ++py) for (int px = 0; px != 1000; ++px)
-			{
-				int ax = px - 500, ay = py - 500;
-				double dx = ax - x, dy = ay - y;
-				double dist = sqrt(dx * dx + dy * dy);
-				ppm[py][px][0] = 255;
-				ppm[py][px][1] = 255;
-				ppm[py][px][2] = 255;
-				if (dist <= radius)
-				{
-					ppm[py][px][0] = 128;
-					ppm[py][px][1] = 128;
-					ppm[py][px][2] = 128;
-				}
-				if (ax == minXo || ax == splitXo || ax == maxXo || ay == minYo || ay == splitYo || ay == maxYo)
-				{
-					ppm[py][px][0] /= 2;
-					ppm[py][px][1] /= 2;
-					ppm[py][px][2] /= 2;
-				}
-				uint64_t nn = expandX(ax) | expandY(ay);
-				if (ranges[0].a <= nn && nn <= ranges[0].z)
-				{
-					ppm[py][px][0] /= 2;
-				}
-				if (ranges[1].a <= nn && nn <= ranges[1].z)
-				{
-					ppm[py][px][1] /= 2;
-				}
-				if (ranges[2].a <= nn && nn <= ranges[2].z)
-				{
-					ppm[py][px][2] /= 2;
-				}
-				if (ranges[3].a <= nn && nn <= ranges[3].z && ((ax ^ ay) & 2))
-				{
-					ppm[py][px][0] /= 2;
-					ppm[py][px][1] /= 2;
-					ppm[py][px][2] /= 2;
-				}
-			}
-	}
-#endif //DUMP_IMAGE
-
 	// Sort ranges ready to be merged.
 	if (ranges[1].a > ranges[2].a)
 	{
@@ -225,72 +294,94 @@ PointTree::ResultVector &PointTree::queryMaybeFilter(Filter &filter, int32_t min
 		--numRanges;
 	}
 
-	lastQueryResults.clear();
+	out.minX = minX;
+	out.maxX = maxX;
+	out.minY = minY;
+	out.maxY = maxY;
+	out.count = numRanges;
+	for (int r = 0; r != numRanges; ++r)
+	{
+		// Find range of points which may be close enough. Range is [begin ... end - 1].
+		out.begin[r] = lowerBound(ranges[r].a);
+		out.end[r]   = upperBound(ranges[r].z);
+	}
+}
+
+// Only touches filterData (if IsFiltered), results and filteredIndices (if IsFiltered), so several queries may run at once.
+template<bool IsFiltered>
+void PointTree::queryMaybeFilter(Filter::Data *filterData, ResultVector &results, IndexVector *filteredIndices, int32_t minXo, int32_t minYo, int32_t maxXo, int32_t maxYo) const
+{
+	Ranges ranges;
+	findRanges(ranges, minXo, minYo, maxXo, maxYo);
+
+	results.clear();
 	if (IsFiltered)
 	{
-		lastFilteredQueryIndices.clear();
+		filteredIndices->clear();
 	}
-	for (int r = 0; r != numRanges; ++r)
+	for (unsigned r = 0; r != ranges.count; ++r)
 	{
-		// Find range of points which may be close enough. Range is [i1 ... i2 - 1]. The pointers are ignored when searching.
-		unsigned i1 = std::lower_bound(points.begin(),      points.end(), Point(ranges[r].a, (void *)nullptr), pointTreeSortFunction) - points.begin();
-		unsigned i2 = std::upper_bound(points.begin() + i1, points.end(), Point(ranges[r].z, (void *)nullptr), pointTreeSortFunction) - points.begin();
+		if (!IsFiltered)
+		{
+			// Branch-free: store every point of the range, but only advance past the ones in the desired square.
+			size_t numResults = results.size();
+			results.resize(numResults + (ranges.end[r] - ranges.begin[r]));
+			void **out = results.data() + numResults;
+			for (unsigned i = ranges.begin[r]; i != ranges.end[r]; ++i)
+			{
+				*out = values[i];
+				out += inSquare(keys[i], ranges);
+			}
+			results.resize(out - results.data());
+			continue;
+		}
 
-		for (unsigned i = current<IsFiltered>(filter.data, i1); i < i2; i = current<IsFiltered>(filter.data, i + 1))
+		for (unsigned i = current<IsFiltered>(filterData, ranges.begin[r]); i < ranges.end[r]; i = current<IsFiltered>(filterData, i + 1))
 		{
-			uint64_t px = points[i].first & 0xAAAAAAAAAAAAAAAAULL;
-			uint64_t py = points[i].first & 0x5555555555555555ULL;
-			if (px >= minX && px <= maxX && py >= minY && py <= maxY)  // Only add point if it's at least in the desired square.
+			if (inSquare(keys[i], ranges))  // Only add point if it's at least in the desired square.
 			{
-				lastQueryResults.push_back(points[i].second);
+				results.push_back(values[i]);
 				if (IsFiltered)
 				{
-					lastFilteredQueryIndices.push_back(i);
-				}
-#ifdef DUMP_IMAGE
-				if (doDump)
-				{
-					ppm[((int32_t *)points[i].second)[1] + 500][((int32_t *)points[i].second)[0] + 500][0] = 192;
-					ppm[((int32_t *)points[i].second)[1] + 500][((int32_t *)points[i].second)[0] + 500][1] = 128;
-					ppm[((int32_t *)points[i].second)[1] + 500][((int32_t *)points[i].second)[0] + 500][2] = 0;
+					filteredIndices->push_back(i);
 				}
-#endif //DUMP_IMAGE
 			}
 		}
 	}
-
-#ifdef DUMP_IMAGE
-	if (doDump)
-	{
-		fwrite(ppm[0][0], 3000000, 1, f);
-		fclose(f);
-	}
-#endif //DUMP_IMAGE
-
-	return lastQueryResults;
 }
 
 PointTree::ResultVector &PointTree::query(int32_t x, int32_t y, uint32_t x2, uint32_t y2)
 {
-	Filter unused;
-	return queryMaybeFilter<false>(unused, x, y, x2, y2);
+	queryMaybeFilter<false>(nullptr, lastQueryResults, nullptr, x, y, x2, y2);
+	return lastQueryResults;
 }
 
 PointTree::ResultVector &PointTree::query(int32_t x, int32_t y, uint32_t radius)
 {
-	Filter unused;
+	query(x, y, radius, lastQueryResults);
+	return lastQueryResults;
+}
+
+void PointTree::query(int32_t x, int32_t y, uint32_t radius, ResultVector &results) const
+{
 	int32_t minXo = x - radius;
 	int32_t maxXo = x + radius;
 	int32_t minYo = y - radius;
 	int32_t maxYo = y + radius;
-	return queryMaybeFilter<false>(unused, minXo, minYo, maxXo, maxYo);
+	queryMaybeFilter<false>(nullptr, results, nullptr, minXo, minYo, maxXo, maxYo);
 }
 
 PointTree::ResultVector &PointTree::query(Filter &filter, int32_t x, int32_t y, uint32_t radius)
+{
+	query(filter, x, y, radius, lastQueryResults, lastFilteredQueryIndices);
+	return lastQueryResults;
+}
+
+void PointTree::query(Filter &filter, int32_t x, int32_t y, uint32_t radius, ResultVector &results, IndexVector &filteredIndices) const
 {
 	int32_t minXo = x - radius;
 	int32_t maxXo = x + radius;
 	int32_t minYo = y - radius;
 	int32_t maxYo = y + radius;
-	return queryMaybeFilter<true>(filter, minXo, minYo, maxXo, maxYo);
+	queryMaybeFilter<true>(&filter.data, results, &filteredIndices, minXo, minYo, maxXo, maxYo);
 }
@@ -30,14 +30,16 @@ class PointTree
 public:
 	typedef std::vector<void *> ResultVector;
 	typedef std::vector<unsigned> IndexVector;
-	class Filter  ///< Filters are invalidated when modifying the PointTree.
+	/// Filters are invalidated when modifying the PointTree.
+	/// Queries modify the filter they use, so threads querying concurrently need a filter each.
+	class Filter
 	{
 	public:
 		Filter() : data(1) {}  ///< Must be reset before use.
-		Filter(PointTree const &pointTree) : data(pointTree.points.size() + 1) {}
+		Filter(PointTree const &pointTree) : data(pointTree.size() + 1) {}
 		void reset(PointTree const &pointTree)
 		{
-			data.assign(pointTree.points.size() + 1, 0);
+			data.assign(pointTree.size() + 1, 0);
 		}
 		void erase(unsigned index)
 		{
@@ -55,14 +57,40 @@ public:
 	void insert(void *pointData, int32_t x, int32_t y);                       ///< Inserts a point into the point tree.
 	void clear();                                                             ///< Clears the PointTree.
 	void sort();                                                              ///< Must be done between inserting and querying, to get meaningful results.
+	size_t size() const { return keys.size(); }                               ///< Number of points in the PointTree.
+	void *pointAt(unsigned index) const { return values[index]; }             ///< The pointData of the point at index, in sorted order.
+
+	/// Incremental alternative to clear(), insert() and sort(), for when most points have not moved since the last build.
+	/// Gives exactly the same result as clearing the PointTree, inserting the same points in the same order and sorting.
+	/// Queries are not allowed between beginIncrementalBuild() and endIncrementalBuild().
+	void beginIncrementalBuild();
+	/// Inserts a point, during an incremental build. previousIndex is the index of the same point in the PointTree before
+	/// this build (so that pointAt(previousIndex) == pointData), or NO_PREVIOUS_INDEX. If the point has not moved since, it
+	/// keeps its place without needing to be sorted again.
+	void insertIncremental(void *pointData, int32_t x, int32_t y, unsigned previousIndex);
+	void endIncrementalBuild();                                               ///< Finishes an incremental build.
+	static constexpr unsigned NO_PREVIOUS_INDEX = ~0u;
+
+	/// Calls visitor(pointData) for all points less than or equal to radius from (x, y), possibly plus some extra nearby points,
+	/// in the same order as query() returns them. (More specifically, visits all points in a square with edge length 2*radius.)
+	/// Thread safe, as long as the PointTree is not modified concurrently. Does not allocate.
+	template<typename Visitor>
+	void visit(int32_t x, int32_t y, uint32_t radius, Visitor &&visitor) const;
+
 	/// Returns all points less than or equal to radius from (x, y), possibly plus some extra nearby points.
 	/// (More specifically, returns all objects in a square with edge length 2*radius.)
 	/// Note: Not thread safe, because it modifies lastQueryResults.
 	ResultVector &query(int32_t x, int32_t y, uint32_t radius);
+	/// Same as above, but writes the points into results instead of lastQueryResults.
+	/// Thread safe, as long as the PointTree is not modified concurrently. Does not allocate if results is big enough already.
+	void query(int32_t x, int32_t y, uint32_t radius, ResultVector &results) const;
 	/// Returns all points which have not been filtered away, less than or equal to radius from (x, y), possibly plus some extra nearby points.
 	/// (More specifically, returns objects in a square with edge length 2*radius.)
 	/// Note: Not thread safe, because it modifies lastQueryResults, lastFilteredQueryIndices and the internal filter representation for faster lookups.
 	ResultVector &query(Filter &filter, int32_t x, int32_t y, uint32_t radius);
+	/// Same as above, but writes the points into results and their indices (for Filter::erase()) into filteredIndices.
+	/// Thread safe, as long as the PointTree is not modified concurrently and no other thread uses the same filter.
+	void query(Filter &filter, int32_t x, int32_t y, uint32_t radius, ResultVector &results, IndexVector &filteredIndices) const;
 	/// Returns all points which have not been filtered away within given rectangle. See function above on thread safety.
 	ResultVector &query(int32_t x, int32_t y, uint32_t x2, uint32_t y2);
 
@@ -70,13 +98,74 @@ public:
 	IndexVector lastFilteredQueryIndices;
 
 private:
-	typedef std::pair<uint64_t, void *> Point;
-	typedef std::vector<Point> Vector;
+	/// Up to 4 ranges of points in Z-order, which together contain all points in the query square (and some others).
+	struct Ranges
+	{
+		uint64_t minX, maxX, minY, maxY;  ///< The query square, in interleaved coordinates.
+		unsigned begin[4];
+		unsigned end[4];
+		unsigned count;
+	};
+
+	/// A point, plus the order it was inserted in, which is used to sort points in exactly the same place.
+	struct Entry
+	{
+		uint64_t key;
+		unsigned rank;
+		void *value;
+
+		bool operator <(Entry const &other) const
+		{
+			return key < other.key || (key == other.key && rank < other.rank);
+		}
+	};
+
+	void buildBucketIndex();
+	void findRanges(Ranges &ranges, int32_t minXo, int32_t minYo, int32_t maxXo, int32_t maxYo) const;
+	unsigned lowerBound(uint64_t key) const;  ///< Index of the first point with a key >= key.
+	unsigned upperBound(uint64_t key) const;  ///< Index of the first point with a key > key.
+
+	static bool inSquare(uint64_t key, Ranges const &ranges)
+	{
+		uint64_t px = key & 0xAAAAAAAAAAAAAAAAULL;
+		uint64_t py = key & 0x5555555555555555ULL;
+		return px >= ranges.minX && px <= ranges.maxX && py >= ranges.minY && py <= ranges.maxY;
+	}
 
 	template<bool IsFiltered>
-	ResultVector &queryMaybeFilter(Filter &filter, int32_t minXo, int32_t maxXo, int32_t minYo, int32_t maxYo);
+	void queryMaybeFilter(Filter::Data *filterData, ResultVector &results, IndexVector *filteredIndices, int32_t minXo, int32_t minYo, int32_t maxXo, int32_t maxYo) const;
 
-	Vector points;
+	// The points, sorted by key, stored as a structure of arrays: queries mostly scan keys, and only look at
+	// the values of the points they return.
+	std::vector<uint64_t> keys;    ///< Interleaved x and y coordinates (Morton numbers).
+	std::vector<void *> values;    ///< The pointData of each point.
+	// Only used while building, kept to avoid allocations.
+	std::vector<Entry> sortBuffer;          ///< All points, for sort(). The points which moved, for incremental builds.
+	std::vector<Entry> keptBuffer;          ///< The points which did not move, for incremental builds.
+	std::vector<unsigned> keptRanks;        ///< Insertion order of the points which did not move, by previous index, or NO_PREVIOUS_INDEX.
+	unsigned numIncrementalInserts = 0;
+	// Index for the binary searches: points with ((key - minKey) >> bucketShift) == b are at [bucketStart[b], bucketStart[b + 1]).
+	std::vector<unsigned> bucketStart;
+	uint64_t minKey = 0;
+	uint64_t maxKey = 0;
+	unsigned bucketShift = 0;
 };
 
+template<typename Visitor>
+void PointTree::visit(int32_t x, int32_t y, uint32_t radius, Visitor &&visitor) const
+{
+	Ranges ranges;
+	findRanges(ranges, x - radius, y - radius, x + radius, y + radius);
+	for (unsigned r = 0; r != ranges.count; ++r)
+	{
+		for (unsigned i = ranges.begin[r]; i != ranges.end[r]; ++i)
+		{
+			if (inSquare(keys[i], ranges))
+			{
+				visitor(values[i]);
+			}
+		}
+	}
+}
+
 #endif //_point_tree_h
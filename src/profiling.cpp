@@ -17,8 +17,17 @@
 	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
 */
 
+#include <nlohmann/json.hpp> // Must come before WZ includes
+
 #include "profiling.h"
 
+#include "lib/framework/file.h"
+#include "lib/gamelib/gtime.h"
+#include "multiplay.h"
+#include "version.h"
+
+#include <cstdio>
+
 #if defined(WZ_PROFILING_INSTRUMENTATION)
 
 #include <cstdio>
@@ -201,3 +210,48 @@ void mark(const Domain *domain, const char *object, const char *mark)
 }
 
 #endif // defined(WZ_PROFILING_INSTRUMENTATION)
+
+void saveTickProfile()
+{
+	const auto entries = profiling::tickProfilerEntries();
+	if (entries.empty())
+	{
+		return;
+	}
+
+	nlohmann::ordered_json root = nlohmann::ordered_json::object();
+	root["version"] = version_getVersionString();
+	root["map"] = game.map;
+	root["gameTime"] = gameTime;
+	nlohmann::ordered_json scopes = nlohmann::ordered_json::object();
+	for (auto const &entry : entries)
+	{
+		const profiling::LatencyHistogram &histogram = *entry.histogram;
+		nlohmann::ordered_json scope = nlohmann::ordered_json::object();
+		scope["count"] = histogram.count();
+		scope["totalNs"] = histogram.sumNs();
+		scope["meanNs"] = histogram.sumNs() / histogram.count();
+		scope["minNs"] = histogram.minNs();
+		scope["p50Ns"] = histogram.percentileNs(0.5);
+		scope["p90Ns"] = histogram.percentileNs(0.9);
+		scope["p99Ns"] = histogram.percentileNs(0.99);
+		scope["maxNs"] = histogram.maxNs();
+		// [largest duration in the bucket, count], for the non-empty buckets
+		nlohmann::ordered_json buckets = nlohmann::ordered_json::array();
+		for (auto const &bucket : histogram.buckets())
+		{
+			buckets.push_back({bucket.first, bucket.second});
+		}
+		scope["buckets"] = std::move(buckets);
+		scopes[entry.name] = std::move(scope);
+	}
+	root["scopes"] = std::move(scopes);
+
+	const std::string fileName = "logs/tickprofile_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()) + ".json";
+	const std::string data = root.dump(1, '\t');
+	if (saveFile(fileName.c_str(), data.data(), static_cast<UDWORD>(data.size())))
+	{
+		fprintf(stdout, "Tick profile written to: %s\n", fileName.c_str());
+		fflush(stdout);
+	}
+}
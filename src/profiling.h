@@ -21,6 +21,8 @@
 
 #include "lib/framework/wzglobal.h" // required for config.h
 
+#include "tickprofiler.h"
+
 #if defined(WZ_PROFILING_INSTRUMENTATION)
 
 #include <cstdint>
@@ -73,12 +75,26 @@ void mark(const Domain *domain, const char *object, const char *mark);
 
 }
 
-#define WZ_PROFILE_SCOPE(name) profiling::Scope mark_##name(&profiling::wzRootDomain, #name);
-#define WZ_PROFILE_SCOPE2(object, name) profiling::Scope mark_##name(&profiling::wzRootDomain, #object, #name);
+#define WZ_INSTRUMENT_SCOPE(name) profiling::Scope mark_##name(&profiling::wzRootDomain, #name);
+#define WZ_INSTRUMENT_SCOPE2(object, name) profiling::Scope mark_##name(&profiling::wzRootDomain, #object, #name);
 
 #else // !defined(WZ_PROFILING_INSTRUMENTATION)
 
-#define WZ_PROFILE_SCOPE(name)
-#define WZ_PROFILE_SCOPE2(object, name)
+#define WZ_INSTRUMENT_SCOPE(name)
+#define WZ_INSTRUMENT_SCOPE2(object, name)
 
 #endif // defined(WZ_PROFILING_INSTRUMENTATION)
+
+/// Marks the rest of the enclosing block as a profiling scope, for the instrumentation backend if there is one,
+/// and for the built in latency histograms (see tickprofiler.h) when they are switched on.
+#define WZ_PROFILE_SCOPE(name) \
+	static profiling::TickProfileSite tickSite_##name(#name); \
+	profiling::TickProfileScope tickScope_##name(tickSite_##name); \
+	WZ_INSTRUMENT_SCOPE(name)
+#define WZ_PROFILE_SCOPE2(object, name) \
+	static profiling::TickProfileSite tickSite_##name(#object "::" #name); \
+	profiling::TickProfileScope tickScope_##name(tickSite_##name); \
+	WZ_INSTRUMENT_SCOPE2(object, name)
+
+/// Writes the latency histograms as JSON to logs/ in the write directory, if any scope was timed.
+void saveTickProfile();
@@ -61,6 +61,7 @@
 #include "profiling.h"
 #include "game_world.h"
 #include "wrappers.h"
+#include "projectilebroadphase.h"
 
 #include <algorithm>
 #include <functional>
@@ -110,6 +111,8 @@ struct DAMAGE
 // Watermelon:they are from droid.c
 /* The range for neighbouring objects */
 #define PROJ_NEIGHBOUR_RANGE (TILE_UNITS*4)
+/* Below this many projectiles in flight, building the broadphase costs more than it saves */
+#define PROJ_BROADPHASE_MIN_PROJECTILES 32
 // used to create a specific ID for projectile objects to facilitate tracking them.
 static const uint32_t ProjectileTrackerID = 0xdead0000;
 static uint32_t projectileTrackerIDIncrement = 0;
@@ -131,6 +134,13 @@ static ProjectileIterator psProjectileNext;
 /// </summary>
 static PagedEntityContainer<PROJECTILE> globalProjectileStorage;
 
+/* Collision data of the objects projectiles may hit, built once per proj_UpdateAll() when enough projectiles are in flight.
+ * The heights and shapes are indexed by BASE_OBJECT::gridIndex, and don't change during the update. */
+static bool projectileBroadphaseBuilt = false;
+static ProjectileBroadphase projectileBroadphase;
+static std::vector<int32_t> projectileTargetHeights;
+static std::vector<ObjectShape> projectileTargetShapes;
+
 /***************************************************************************/
 
 static void	proj_ImpactFunc(PROJECTILE *psObj);
@@ -910,8 +920,16 @@ static PROJECTILE* proj_InFlightFunc(PROJECTILE *psProj)
 	closestCollisionSpacetime.time = 0xFFFFFFFF;
 
 	/* Check nearby objects for possible collisions */
+	// A projectile above every object it could reach this tick can't hit any of them, so don't look for one.
+	const bool aboveObjects = projectileBroadphaseBuilt && std::min(psProj->prevSpacetime.pos.z, psProj->pos.z) > projectileBroadphase.ceiling(psProj->pos.x, psProj->pos.y, PROJ_NEIGHBOUR_RANGE);
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psProj->pos.x, psProj->pos.y, PROJ_NEIGHBOUR_RANGE);
+	gridList.clear();
+#ifndef DEBUG
+	if (!aboveObjects)
+#endif
+	{
+		gridList = gridStartIterate(psProj->pos.x, psProj->pos.y, PROJ_NEIGHBOUR_RANGE);
+	}
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		BASE_OBJECT *psTempObj = *gi;
@@ -952,8 +970,8 @@ static PROJECTILE* proj_InFlightFunc(PROJECTILE *psProj)
 
 		const Vector3i diff = psProj->pos - psTempObj->pos;
 		const Vector3i prevDiff = psProj->prevSpacetime.pos - psTempObjPrevPos;
-		const unsigned int targetHeight = establishTargetHeight(psTempObj);
-		const ObjectShape targetShape = establishTargetShape(psTempObj);
+		const unsigned int targetHeight = projectileBroadphaseBuilt ? projectileTargetHeights[psTempObj->gridIndex] : establishTargetHeight(psTempObj);
+		const ObjectShape targetShape = projectileBroadphaseBuilt ? projectileTargetShapes[psTempObj->gridIndex] : establishTargetShape(psTempObj);
 		const int32_t collision = collisionXYZ(prevDiff, diff, targetShape, targetHeight);
 		const uint32_t collisionTime = psProj->prevSpacetime.time + (psProj->time - psProj->prevSpacetime.time) * collision / 1024;
 
@@ -966,6 +984,7 @@ static PROJECTILE* proj_InFlightFunc(PROJECTILE *psProj)
 			// Keep testing for more collisions, in case there was a closer target.
 		}
 	}
+	ASSERT(!aboveObjects || closestCollisionObject == nullptr, "Projectile above the broadphase ceiling hit %s", objInfo(closestCollisionObject));
 
 	unsigned terrainIntersectTime = map_LineIntersect(psProj->prevSpacetime.pos, psProj->pos, psProj->time - psProj->prevSpacetime.time);
 	if (terrainIntersectTime != UINT32_MAX)
@@ -1488,11 +1507,45 @@ PROJECTILE* PROJECTILE::update()
 
 /***************************************************************************/
 
+// Collects the collision data of every object in the map grid, for the projectiles in flight to share.
+static void proj_BuildBroadphase()
+{
+	projectileBroadphaseBuilt = false;
+	size_t inFlight = std::count_if(psProjectileList.begin(), psProjectileList.end(), [](PROJECTILE const *p) { return p->state == PROJ_INFLIGHT; });
+	if (inFlight < PROJ_BROADPHASE_MIN_PROJECTILES)
+	{
+		return;
+	}
+
+	const size_t numObjects = gridSize();
+	projectileBroadphase.reset(world_coord(gameWorld.map.width), world_coord(gameWorld.map.height));
+	projectileTargetHeights.assign(numObjects, 0);
+	projectileTargetShapes.assign(numObjects, ObjectShape());
+	for (size_t i = 0; i < numObjects; ++i)
+	{
+		BASE_OBJECT *psObj = gridObjectAt(i);
+		if (psObj->died || (psObj->type == OBJ_FEATURE && !castFeature(psObj)->psStats->damageable))
+		{
+			continue;  // Never hit, see proj_InFlightFunc().
+		}
+		const int32_t height = establishTargetHeight(psObj);
+		projectileTargetHeights[i] = height;
+		projectileTargetShapes[i] = establishTargetShape(psObj);
+
+		// Projectiles entirely above this can't hit the object, whatever the sign of its height, see collisionZ().
+		const Vector3i prevPos = isDroid(psObj) ? castDroid(psObj)->prevSpacetime.pos : psObj->pos;
+		projectileBroadphase.add(psObj->pos.x, psObj->pos.y, std::max(psObj->pos.z, prevPos.z) + std::abs(height));
+	}
+	projectileBroadphaseBuilt = true;
+}
+
 // iterate through all projectiles and update their status
 void proj_UpdateAll()
 {
 	WZ_PROFILE_SCOPE(proj_UpdateAll);
 
+	proj_BuildBroadphase();
+
 	static std::vector<PROJECTILE*> spawnedProjectiles;
 	spawnedProjectiles.reserve(psProjectileList.size());
 	spawnedProjectiles.clear();
@@ -1509,6 +1562,7 @@ void proj_UpdateAll()
 			spawnedProjectiles.emplace_back(spawned);
 		}
 	}
+	projectileBroadphaseBuilt = false;
 
 	// Remove and free dead projectiles.
 	psProjectileList.erase(std::remove_if(psProjectileList.begin(), psProjectileList.end(), [](PROJECTILE* p)
@@ -0,0 +1,38 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Shared broadphase for projectile collisions, see projectilebroadphase.h.
+ */
+
+#include "projectilebroadphase.h"
+
+#include <algorithm>
+
+void ProjectileBroadphase::reset(int32_t worldWidth, int32_t worldHeight)
+{
+	cellsX = std::max<int32_t>((std::max(worldWidth, 0) + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT, 1);
+	cellsY = std::max<int32_t>((std::max(worldHeight, 0) + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT, 1);
+	cellTop.assign(static_cast<size_t>(cellsX) * cellsY, NO_OBJECTS);
+}
+
+void ProjectileBroadphase::add(int32_t x, int32_t y, int32_t top)
+{
+	int32_t &cell = cellTop[cellX(x) + cellY(y) * cellsX];
+	cell = std::max(cell, top);
+}
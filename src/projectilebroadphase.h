@@ -0,0 +1,75 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Shared broadphase for projectile collisions.
+ *
+ *  Built once per projectile update from all objects which projectiles may hit, it stores the highest point of any
+ *  object in each cell of the map, as one flat array. A projectile
+ *  which stays above the ceiling of all the cells it could reach an object in cannot hit any object, so it needs no
+ *  search for candidates at all. Most artillery shells in flight are in that situation.
+ */
+
+#ifndef __INCLUDED_SRC_PROJECTILEBROADPHASE_H__
+#define __INCLUDED_SRC_PROJECTILEBROADPHASE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class ProjectileBroadphase
+{
+public:
+	static constexpr int CELL_SHIFT = 10;  ///< Cells are 1024×1024 world units (8×8 tiles).
+	static constexpr int32_t NO_OBJECTS = std::numeric_limits<int32_t>::min();  ///< Ceiling of cells without objects.
+
+	/// Clears all objects, for a map of worldWidth×worldHeight world units.
+	void reset(int32_t worldWidth, int32_t worldHeight);
+
+	/// Adds an object at (x, y), whose highest point is at top.
+	void add(int32_t x, int32_t y, int32_t top);
+
+	/// Highest top of any object within the square of edge length 2 * radius around (x, y), or NO_OBJECTS.
+	/// May include some objects outside the square, so the result is an upper bound.
+	int32_t ceiling(int32_t x, int32_t y, uint32_t radius) const
+	{
+		const int x0 = cellX(int64_t(x) - radius), x1 = cellX(int64_t(x) + radius);
+		const int y0 = cellY(int64_t(y) - radius), y1 = cellY(int64_t(y) + radius);
+		int32_t result = NO_OBJECTS;
+		for (int cy = y0; cy <= y1; ++cy)
+		{
+			for (int cx = x0; cx <= x1; ++cx)
+			{
+				result = std::max(result, cellTop[cx + cy * cellsX]);
+			}
+		}
+		return result;
+	}
+
+private:
+	int cellX(int64_t x) const { return static_cast<int>(std::min<int64_t>(std::max<int64_t>(x >> CELL_SHIFT, 0), cellsX - 1)); }
+	int cellY(int64_t y) const { return static_cast<int>(std::min<int64_t>(std::max<int64_t>(y >> CELL_SHIFT, 0), cellsY - 1)); }
+
+	int cellsX = 1;
+	int cellsY = 1;
+	std::vector<int32_t> cellTop = std::vector<int32_t>(1, NO_OBJECTS);  ///< Highest top of the objects in each cell.
+};
+
+#endif // __INCLUDED_SRC_PROJECTILEBROADPHASE_H__
@@ -64,6 +64,7 @@
 #include "gamehistorylogger.h"
 #include "campaigninfo.h"
 #include "hci/quickchat.h"
+#include "scriptevents.h"
 
 #include <set>
 #include <memory>
@@ -77,6 +78,7 @@
 
 #include "wzscriptdebug.h"
 #include "quickjs_backend.h"
+#include "profiling.h"
 
 #define ATTACK_THROTTLE 1000
 
@@ -294,6 +296,27 @@ typedef struct monitor_bin
 typedef std::unordered_map<std::string, MONITOR_BIN> MONITOR;
 static std::unordered_map<wzapi::scripting_instance *, MONITOR *> monitors;
 
+/// An eventAttacked, eventObjectSeen, eventGroupSeen or eventDroidIdle, waiting for flushScriptEvents()
+struct queuedEvent
+{
+	wzapi::scripting_instance *instance;
+	QueuedScriptEvent type;
+	BASE_OBJECT *psObj;    ///< Victim, object seen, or idle droid
+	BASE_OBJECT *psOther;  ///< Attacker or viewer
+	int groupId;           ///< Group seen
+	bool stale;            ///< An object was freed since, see scriptFreeObject()
+};
+static std::vector<queuedEvent> queuedEvents;
+static bool batchingScriptEvents = false;
+
+/// Coalescing and counters of the queued event types, per script instance
+struct instanceEvents
+{
+	std::array<ScriptEventCoalescer, NUM_QUEUED_SCRIPT_EVENTS> coalescers;
+	std::array<ScriptEventStats, NUM_QUEUED_SCRIPT_EVENTS> stats;
+};
+static std::unordered_map<wzapi::scripting_instance *, instanceEvents> eventState;
+
 static bool globalDialog = false;
 
 bool bInTutorial = false;
@@ -399,6 +422,119 @@ void scriptRemoveObject(const BASE_OBJECT *psObj)
 	scripting_engine::instance().groupRemoveObject(psObj);
 }
 
+void scriptFreeObject(const BASE_OBJECT *psObj)
+{
+	// Objects destroyed during the tick stay allocated until objmemUpdate(), after flushScriptEvents(), so the queued
+	// events about them are delivered. Only objects freed before that, which is rare, make their events stale.
+	for (auto &event : queuedEvents)
+	{
+		if (event.psObj == psObj || event.psOther == psObj)
+		{
+			event.stale = true;
+		}
+	}
+}
+
+static uint32_t coalescingKey(const queuedEvent &event)
+{
+	return event.type == QueuedScriptEvent::GroupSeen ? event.groupId : event.psObj->id;
+}
+
+static void runScriptEvent(const queuedEvent &event)
+{
+	instanceEvents &state = eventState[event.instance];
+	const size_t type = static_cast<size_t>(event.type);
+	ScriptEventStats &stats = state.stats[type];
+	if (event.stale)
+	{
+		stats.stale++;
+		return;
+	}
+	if (!state.coalescers[type].admit(coalescingKey(event), gameTime))
+	{
+		stats.coalesced++;
+		return;
+	}
+
+	using microDuration = std::chrono::duration<uint64_t, std::micro>;
+	auto time_begin = std::chrono::steady_clock::now();
+	switch (event.type)
+	{
+	case QueuedScriptEvent::Attacked: event.instance->handle_eventAttacked(event.psObj, event.psOther); break;
+	case QueuedScriptEvent::ObjectSeen: event.instance->handle_eventObjectSeen(event.psOther, event.psObj); break;
+	case QueuedScriptEvent::GroupSeen: event.instance->handle_eventGroupSeen(event.psOther, event.groupId); break;
+	case QueuedScriptEvent::DroidIdle: event.instance->handle_eventDroidIdle(static_cast<DROID *>(event.psObj)); break;
+	}
+	uint64_t duration_microsec = std::chrono::duration_cast<microDuration>(std::chrono::steady_clock::now() - time_begin).count();
+	stats.delivered++;
+	stats.time += duration_microsec;
+	stats.worst = std::max<uint32_t>(stats.worst, static_cast<uint32_t>(std::min<uint64_t>(duration_microsec, std::numeric_limits<uint32_t>::max())));
+}
+
+/// Runs the event now, or queues it until flushScriptEvents() while in a batch
+static void triggerQueuedEvent(wzapi::scripting_instance *instance, QueuedScriptEvent type, BASE_OBJECT *psObj, BASE_OBJECT *psOther, int groupId = 0)
+{
+	queuedEvent event = {instance, type, psObj, psOther, groupId, false};
+	eventState[instance].stats[static_cast<size_t>(type)].triggered++;
+	if (batchingScriptEvents)
+	{
+		queuedEvents.push_back(event);
+		return;
+	}
+	runScriptEvent(event);
+}
+
+void beginScriptEventBatch()
+{
+	ASSERT(queuedEvents.empty(), "Script events left over from the last batch");
+	batchingScriptEvents = scriptsReady;
+}
+
+void flushScriptEvents()
+{
+	WZ_PROFILE_SCOPE(flushScriptEvents);
+	// Events triggered by the handlers below run at once, as they would have outside a batch
+	batchingScriptEvents = false;
+	if (queuedEvents.empty())
+	{
+		return;
+	}
+
+	// Deliver each instance's events together, in the order the instances were loaded, and
+	// each instance's events in the order they were triggered
+	std::unordered_map<wzapi::scripting_instance *, size_t> order;
+	for (size_t i = 0; i < scripts.size(); ++i)
+	{
+		order[scripts[i]] = i;
+	}
+	std::stable_sort(queuedEvents.begin(), queuedEvents.end(), [&order](const queuedEvent &a, const queuedEvent &b)
+	{
+		return order[a.instance] < order[b.instance];
+	});
+
+	for (size_t begin = 0; begin < queuedEvents.size();)
+	{
+		wzapi::scripting_instance *instance = queuedEvents[begin].instance;
+		std::array<uint32_t, NUM_QUEUED_SCRIPT_EVENTS> batchSize = {};
+		size_t end = begin;
+		for (; end < queuedEvents.size() && queuedEvents[end].instance == instance; ++end)
+		{
+			batchSize[static_cast<size_t>(queuedEvents[end].type)]++;
+		}
+		std::array<ScriptEventStats, NUM_QUEUED_SCRIPT_EVENTS> &stats = eventState[instance].stats;
+		for (size_t type = 0; type < NUM_QUEUED_SCRIPT_EVENTS; ++type)
+		{
+			stats[type].largestBatch = std::max(stats[type].largestBatch, batchSize[type]);
+		}
+		// Indexed, since handlers freeing objects mark the events still queued as stale
+		for (; begin < end; ++begin)
+		{
+			runScriptEvent(queuedEvents[begin]);
+		}
+	}
+	queuedEvents.clear();
+}
+
 // do not want to call this 'init', since scripts are often loaded before we get here
 bool prepareScripts(bool loadGame)
 {
@@ -455,8 +591,35 @@ bool scripting_engine::shutdownScripts()
 		}
 		monitor->clear();
 		delete monitor;
+		auto eventIt = eventState.find(instance);
+		if (eventIt != eventState.end())
+		{
+			instance->dumpScriptLog("=== QUEUED EVENT DATA ===\n");
+			instance->dumpScriptLog("triggered | delivered | coalesced |   stale | avg (usec) | worst (usec) | largest batch | event\n");
+			for (size_t type = 0; type < NUM_QUEUED_SCRIPT_EVENTS; ++type)
+			{
+				const ScriptEventStats &m = eventIt->second.stats[type];
+				if (m.triggered == 0)
+				{
+					continue;
+				}
+				std::ostringstream info;
+				info << std::right << std::setw(9) << m.triggered << " | ";
+				info << std::right << std::setw(9) << m.delivered << " | ";
+				info << std::right << std::setw(9) << m.coalesced << " | ";
+				info << std::right << std::setw(7) << m.stale << " | ";
+				info << std::right << std::setw(10) << (m.delivered ? m.time / m.delivered : 0) << " | ";
+				info << std::right << std::setw(12) << m.worst << " | ";
+				info << std::right << std::setw(13) << m.largestBatch << " | ";
+				info << queuedScriptEventName(static_cast<QueuedScriptEvent>(type)) << "\n";
+				instance->dumpScriptLog(info.str());
+			}
+		}
 		unregisterFunctions(instance);
 	}
+	queuedEvents.clear();
+	batchingScriptEvents = false;
+	eventState.clear();
 	timers.clear();
 	lastTimerID = 0;
 	timerIDMap.clear();
@@ -471,6 +634,7 @@ bool scripting_engine::shutdownScripts()
 
 bool updateScripts()
 {
+	WZ_PROFILE_SCOPE(updateScripts);
 	return scripting_engine::instance().updateScripts();
 }
 
@@ -792,6 +956,35 @@ bool scripting_engine::saveScriptStates2(nlohmann::ordered_json &root, int onlyP
 		// re-seeding from wall-clock time (which would desync host-side AI decisions across a restore)
 		instanceObj["mathRandomState"] = instance->saveMathRandomState();
 
+		// Coalescing windows set by setEventCoalescing(), with the events they are holding back
+		// (Omitted entirely when the instance has none)
+		auto eventIt = eventState.find(instance);
+		if (eventIt != eventState.end())
+		{
+			nlohmann::ordered_json coalescing = nlohmann::ordered_json::object();
+			for (size_t type = 0; type < NUM_QUEUED_SCRIPT_EVENTS; ++type)
+			{
+				const ScriptEventCoalescer &coalescer = eventIt->second.coalescers[type];
+				if (coalescer.window() == 0)
+				{
+					continue;
+				}
+				nlohmann::ordered_json recent = nlohmann::ordered_json::array();
+				for (const auto &entry : coalescer.recent(gameTime))
+				{
+					recent.push_back({entry.first, entry.second});
+				}
+				nlohmann::ordered_json eventObj = nlohmann::ordered_json::object();
+				eventObj["window"] = coalescer.window();
+				eventObj["recent"] = std::move(recent);
+				coalescing[queuedScriptEventName(static_cast<QueuedScriptEvent>(type))] = std::move(eventObj);
+			}
+			if (!coalescing.empty())
+			{
+				instanceObj["eventCoalescing"] = std::move(coalescing);
+			}
+		}
+
 		// This instance's owned (script-created) labels - (Omitted entirely when the instance has none)
 		auto ownedIt = ownedLabels.find(instance);
 		if (ownedIt != ownedLabels.end() && !ownedIt->second.empty())
@@ -1212,6 +1405,35 @@ bool scripting_engine::loadScriptStates2(const nlohmann::ordered_json &root, int
 				instance->restoreMathRandomState(rngIt->get<uint64_t>());
 			}
 
+			// Event coalescing (see saveScriptStates2)
+			auto coalescingIt = instanceObj.find("eventCoalescing");
+			if (coalescingIt != instanceObj.end() && coalescingIt->is_object())
+			{
+				for (auto eventIt = coalescingIt->begin(); eventIt != coalescingIt->end(); ++eventIt)
+				{
+					QueuedScriptEvent event;
+					auto windowIt = eventIt->find("window");
+					if (!queuedScriptEventFromName(eventIt.key(), event) || windowIt == eventIt->end() || !windowIt->is_number_unsigned())
+					{
+						debug(LOG_ERROR, "Invalid coalescing of %s", eventIt.key().c_str());
+						continue;
+					}
+					std::vector<std::pair<uint32_t, uint32_t>> recent;
+					auto recentIt = eventIt->find("recent");
+					if (recentIt != eventIt->end() && recentIt->is_array())
+					{
+						for (const auto &entry : *recentIt)
+						{
+							if (entry.is_array() && entry.size() == 2)
+							{
+								recent.emplace_back(entry[0].get<uint32_t>(), entry[1].get<uint32_t>());
+							}
+						}
+					}
+					eventState[instance].coalescers[static_cast<size_t>(event)].restore(windowIt->get<uint32_t>(), recent);
+				}
+			}
+
 			// This instance's owned labels
 			auto instLabelsIt = instanceObj.find("labels");
 			if (instLabelsIt != instanceObj.end() && instLabelsIt->is_array())
@@ -1624,7 +1846,8 @@ bool triggerEventCheatMode(bool entered)
 
 //__ ## eventDroidIdle(droid)
 //__
-//__ A droid should be given new orders.
+//__ A droid should be given new orders. Run at the end of the game tick, even if the droid was
+//__ destroyed during the tick (```eventDestroyed``` follows in that case). See also ```setEventCoalescing()```.
 //__
 bool triggerEventDroidIdle(DROID *psDroid)
 {
@@ -1634,7 +1857,7 @@ bool triggerEventDroidIdle(DROID *psDroid)
 		int player = instance->player();
 		if (player == psDroid->player)
 		{
-			instance->handle_eventDroidIdle(psDroid);
+			triggerQueuedEvent(instance, QueuedScriptEvent::DroidIdle, psDroid, nullptr);
 		}
 	}
 	return true;
@@ -1782,7 +2005,9 @@ bool triggerEventDroidRankGained(const DROID *psDroid, int rankNum)
 //__ ## eventAttacked(victim, attacker)
 //__
 //__ An event that is run when an object belonging to the script's controlling player is
-//__ attacked. The attacker parameter may be either a structure or a droid.
+//__ attacked. The attacker parameter may be either a structure or a droid. Run at the end of the
+//__ game tick, even if either was destroyed during the tick (```eventDestroyed``` follows in that
+//__ case). See also ```setEventCoalescing()```.
 //__
 bool triggerEventAttacked(BASE_OBJECT *psVictim, BASE_OBJECT *psAttacker, int lastHit)
 {
@@ -1804,7 +2029,7 @@ bool triggerEventAttacked(BASE_OBJECT *psVictim, BASE_OBJECT *psAttacker, int la
 		bool receiveAll = instance->isReceivingAllEvents();
 		if (player == psVictim->player || receiveAll)
 		{
-			instance->handle_eventAttacked(psVictim, psAttacker);
+			triggerQueuedEvent(instance, QueuedScriptEvent::Attacked, psVictim, psAttacker);
 		}
 	}
 	return true;
@@ -1880,14 +2105,14 @@ bool triggerEventPickup(FEATURE *psFeat, DROID *psDroid)
 //__ which was reset through resetLabel() to subscribe for events, goes from not seen to seen.
 //__ An event that is run sometimes when an objectm  goes from not seen to seen.
 //__ First parameter is **game object** doing the seeing, the next the game
-//__ object being seen.
+//__ object being seen. Run at the end of the game tick, like ```eventAttacked```.
 //__
 //__ ## eventGroupSeen(viewer, group)
 //__
 //__ An event that is run sometimes when a member of a group, which was marked by a group label,
 //__ which was reset through resetLabel() to subscribe for events, goes from not seen to seen.
 //__ First parameter is **game object** doing the seeing, the next the id of the group
-//__ being seen.
+//__ being seen. Run at the end of the game tick, like ```eventAttacked```.
 //__
 bool triggerEventSeen(BASE_OBJECT *psViewer, BASE_OBJECT *psSeen)
 {
@@ -1902,12 +2127,12 @@ bool scripting_engine::triggerEventSeen(BASE_OBJECT *psViewer, BASE_OBJECT *psSe
 		std::pair<bool, int> callbacks = scripting_engine::instance().seenLabelCheck(instance, psSeen, psViewer);
 		if (callbacks.first)
 		{
-			instance->handle_eventObjectSeen(psViewer, psSeen);
+			triggerQueuedEvent(instance, QueuedScriptEvent::ObjectSeen, psSeen, psViewer);
 		}
 		if (callbacks.second)
 		{
 			int groupId = callbacks.second;
-			instance->handle_eventGroupSeen(psViewer, groupId);
+			triggerQueuedEvent(instance, QueuedScriptEvent::GroupSeen, nullptr, psViewer, groupId);
 		}
 	}
 	return true;
@@ -3407,8 +3632,8 @@ std::vector<const BASE_OBJECT *> scripting_engine::_enumAreaWorldCoords(WZAPI_PA
 	int playerFilter = _playerFilter.value_or(ALL_PLAYERS);
 	bool seen = _seen.value_or(true);
 
-	static GridList gridList;  // static to avoid allocations. // not thread-safe
-	gridList = gridStartIterateArea(x1, y1, x2, y2);
+	// Scripts often repeat the same queries within a tick
+	GridList const &gridList = gridStartIterateAreaMemoised(x1, y1, x2, y2);
 	std::vector<const BASE_OBJECT *> list;
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -3527,6 +3752,23 @@ int scripting_engine::groupSize(WZAPI_PARAMS(int groupId))
 	return groupMap->groupSize(groupId);
 }
 
+//-- ## setEventCoalescing(eventName, milliseconds)
+//--
+//-- Deliver the named event at most once per given number of milliseconds of game time for
+//-- the same object, dropping any repeats in between. Works for ```eventAttacked``` (per victim),
+//-- ```eventObjectSeen``` (per object seen), ```eventGroupSeen``` (per group) and ```eventDroidIdle```.
+//-- Pass zero milliseconds to deliver every event again, which is the default. Returns false if the
+//-- event cannot be coalesced.
+//--
+bool scripting_engine::setEventCoalescing(WZAPI_PARAMS(std::string eventName, int milliseconds))
+{
+	QueuedScriptEvent event;
+	SCRIPT_ASSERT(false, context, queuedScriptEventFromName(eventName, event), "Cannot coalesce %s", eventName.c_str());
+	SCRIPT_ASSERT(false, context, milliseconds >= 0, "Negative coalescing window %d", milliseconds);
+	eventState[context.currentInstance()].coalescers[static_cast<size_t>(event)].setWindow(milliseconds);
+	return true;
+}
+
 // ----------------------------------------------------------------------------------------
 // Register functions with scripting system
 
@@ -106,6 +106,11 @@ bool prepareScripts(bool loadGame);
 /// Run this each logical frame to update frame-dependent script states
 bool updateScripts();
 
+/// Queue eventAttacked, eventObjectSeen, eventGroupSeen and eventDroidIdle from now on, rather than run them at once
+void beginScriptEventBatch();
+/// Run the queued events, grouped by script instance, and stop queueing them
+void flushScriptEvents();
+
 // Load and evaluate the given script, kept in memory
 bool loadGlobalScript(WzString path);
 wzapi::scripting_instance* loadPlayerScript(const WzString& path, int player, AIDifficulty difficulty);
@@ -138,6 +143,9 @@ bool scriptsAreReady();
 /// Tell script system that an object has been removed.
 void scriptRemoveObject(const BASE_OBJECT *psObj);
 
+/// Tell script system that an object is about to be freed.
+void scriptFreeObject(const BASE_OBJECT *psObj);
+
 /// Open debug GUI
 void jsShowDebug();
 
@@ -477,6 +485,7 @@ public:
 	static wzapi::no_return_value groupAddDroid(WZAPI_PARAMS(int groupId, const DROID *psDroid));
 	static wzapi::no_return_value groupAdd(WZAPI_PARAMS(int groupId, const BASE_OBJECT *psObj));
 	static int groupSize(WZAPI_PARAMS(int groupId));
+	static bool setEventCoalescing(WZAPI_PARAMS(std::string eventName, int milliseconds));
 private:
 	wzapi::scripting_instance* findInstanceForPlayer(int match, const WzString& scriptName);
 
@@ -74,10 +74,13 @@
 #include "qtscript.h"
 #include "featuredef.h"
 #include "data.h"
+#include "modding.h"
+#include "scriptbytecodecache.h"
 
 
 #include <unordered_set>
 #include "lib/framework/file.h"
+#include "lib/framework/crc.h"
 #include <unordered_map>
 #include <limits>
 #include <cmath>
@@ -402,6 +405,37 @@ static void QJSRuntimeFree_LeakHandler_Error(const char* msg)
   #define QUICKJS_HAS_FEATURE(x) 0
 #endif
 
+/// Atoms of the property names of the objects converted for scripts, made once per context rather than once per property
+class PropertyAtoms
+{
+public:
+	/// name must be a string literal, since atoms are looked up by its address
+	template<size_t N>
+	JSAtom get(JSContext *ctx, const char (&name)[N])
+	{
+		auto it = atoms.find(name);
+		if (it == atoms.end())
+		{
+			JSAtom atom = JS_NewAtom(ctx, name);
+			ASSERT(atom != JS_ATOM_NULL, "Failed to create atom: %s", name);
+			it = atoms.emplace(name, atom).first;
+		}
+		return it->second;
+	}
+
+	void clear(JSContext *ctx)
+	{
+		for (auto &it : atoms)
+		{
+			JS_FreeAtom(ctx, it.second);
+		}
+		atoms.clear();
+	}
+
+private:
+	std::unordered_map<const char *, JSAtom> atoms;
+};
+
 class quickjs_scripting_instance : public wzapi::scripting_instance
 {
 public:
@@ -448,6 +482,7 @@ public:
 			compiledScriptObj = JS_UNINITIALIZED;
 		}
 
+		propertyAtoms.clear(ctx);
 		JS_FreeValue(ctx, global_obj);
 		ASSERT(ctx != nullptr, "context is null??");
 		if (ctx)
@@ -545,6 +580,7 @@ private:
 public: // temporary
 	std::vector<std::string> eventNamespaces;
 	JSValue Get_Global_Obj() const { return global_obj; }
+	PropertyAtoms propertyAtoms;
 
 public:
 	// MARK: General events
@@ -1327,6 +1363,7 @@ JSValue convResearch(const RESEARCH *psResearch, JSContext *ctx, int player)
 //;;
 JSValue convStructure(const STRUCTURE *psStruct, JSContext *ctx)
 {
+	PropertyAtoms &atoms = engineToInstanceMap.at(ctx)->propertyAtoms;
 	bool aa = false;
 	bool ga = false;
 	bool indirect = false;
@@ -1343,17 +1380,17 @@ JSValue convStructure(const STRUCTURE *psStruct, JSContext *ctx)
 		}
 	}
 	JSValue value = convObj(psStruct, ctx);
-	QuickJS_DefinePropertyValue(ctx, value, "isCB", JS_NewBool(ctx, structCBSensor(psStruct)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isSensor", JS_NewBool(ctx, structStandardSensor(psStruct)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "canHitAir", JS_NewBool(ctx, aa), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "canHitGround", JS_NewBool(ctx, ga), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "hasIndirect", JS_NewBool(ctx, indirect), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isRadarDetector", JS_NewBool(ctx, objRadarDetector(psStruct)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "range", JS_NewInt32(ctx, range), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "status", JS_NewInt32(ctx, (int)psStruct->status), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "health", JS_NewInt32(ctx, 100 * psStruct->body / MAX(1, psStruct->structureBody())), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "cost", JS_NewInt32(ctx, psStruct->pStructureType->powerToBuild), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "direction", JS_NewInt32(ctx, static_cast<int32_t>(UNDEG(psStruct->rot.direction))), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isCB"), JS_NewBool(ctx, structCBSensor(psStruct)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isSensor"), JS_NewBool(ctx, structStandardSensor(psStruct)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "canHitAir"), JS_NewBool(ctx, aa), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "canHitGround"), JS_NewBool(ctx, ga), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "hasIndirect"), JS_NewBool(ctx, indirect), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isRadarDetector"), JS_NewBool(ctx, objRadarDetector(psStruct)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "range"), JS_NewInt32(ctx, range), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "status"), JS_NewInt32(ctx, (int)psStruct->status), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "health"), JS_NewInt32(ctx, 100 * psStruct->body / MAX(1, psStruct->structureBody())), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cost"), JS_NewInt32(ctx, psStruct->pStructureType->powerToBuild), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "direction"), JS_NewInt32(ctx, static_cast<int32_t>(UNDEG(psStruct->rot.direction))), JS_PROP_ENUMERABLE);
 	int stattype = 0;
 	switch (psStruct->pStructureType->type) // don't bleed our source insanities into the scripting world
 	{
@@ -1370,30 +1407,30 @@ JSValue convStructure(const STRUCTURE *psStruct, JSContext *ctx)
 		stattype = (int)psStruct->pStructureType->type;
 		break;
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "stattype", JS_NewInt32(ctx, stattype), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "stattype"), JS_NewInt32(ctx, stattype), JS_PROP_ENUMERABLE);
 	if (psStruct->pStructureType->type == REF_FACTORY || psStruct->pStructureType->type == REF_CYBORG_FACTORY
 	    || psStruct->pStructureType->type == REF_VTOL_FACTORY
 	    || psStruct->pStructureType->type == REF_RESEARCH
 	    || psStruct->pStructureType->type == REF_POWER_GEN)
 	{
-		QuickJS_DefinePropertyValue(ctx, value, "modules", JS_NewUint32(ctx, psStruct->capacity), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "modules"), JS_NewUint32(ctx, psStruct->capacity), JS_PROP_ENUMERABLE);
 	}
 	else
 	{
-		QuickJS_DefinePropertyValue(ctx, value, "modules", JS_NULL, JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "modules"), JS_NULL, JS_PROP_ENUMERABLE);
 	}
 	JSValue weaponlist = JS_NewArray(ctx);
 	for (int j = 0; j < psStruct->numWeaps; j++)
 	{
 		JSValue weapon = JS_NewObject(ctx);
 		const WEAPON_STATS *psStats = psStruct->getWeaponStats(j);
-		QuickJS_DefinePropertyValue(ctx, weapon, "fullname", JS_NewString(ctx, psStats->name.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, weapon, "name", JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE); // will be changed to contain full name
-		QuickJS_DefinePropertyValue(ctx, weapon, "id", JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, weapon, "lastFired", JS_NewUint32(ctx, psStruct->asWeaps[j].lastFired), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "fullname"), JS_NewString(ctx, psStats->name.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "name"), JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE); // will be changed to contain full name
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "id"), JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "lastFired"), JS_NewUint32(ctx, psStruct->asWeaps[j].lastFired), JS_PROP_ENUMERABLE);
 		JS_DefinePropertyValueUint32(ctx, weaponlist, j, weapon, JS_PROP_ENUMERABLE);
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "weapons", weaponlist, JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "weapons"), weaponlist, JS_PROP_ENUMERABLE);
 	return value;
 }
 
@@ -1408,11 +1445,12 @@ JSValue convStructure(const STRUCTURE *psStruct, JSContext *ctx)
 //;;
 JSValue convFeature(const FEATURE *psFeature, JSContext *ctx)
 {
+	PropertyAtoms &atoms = engineToInstanceMap.at(ctx)->propertyAtoms;
 	JSValue value = convObj(psFeature, ctx);
 	const FEATURE_STATS *psStats = psFeature->psStats;
-	QuickJS_DefinePropertyValue(ctx, value, "health", JS_NewUint32(ctx, 100 * psStats->body / MAX(1, psFeature->body)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "damageable", JS_NewBool(ctx, psStats->damageable), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "stattype", JS_NewInt32(ctx, psStats->subType), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "health"), JS_NewUint32(ctx, 100 * psStats->body / MAX(1, psFeature->body)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "damageable"), JS_NewBool(ctx, psStats->damageable), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "stattype"), JS_NewInt32(ctx, psStats->subType), JS_PROP_ENUMERABLE);
 	return value;
 }
 
@@ -1481,6 +1519,7 @@ JSValue convFeature(const FEATURE *psFeature, JSContext *ctx)
 //;;
 JSValue convDroid(const DROID *psDroid, JSContext *ctx)
 {
+	PropertyAtoms &atoms = engineToInstanceMap.at(ctx)->propertyAtoms;
 	bool aa = false;
 	bool ga = false;
 	bool indirect = false;
@@ -1501,18 +1540,18 @@ JSValue convDroid(const DROID *psDroid, JSContext *ctx)
 	}
 	DROID_TYPE type = psDroid->droidType;
 	JSValue value = convObj(psDroid, ctx);
-	QuickJS_DefinePropertyValue(ctx, value, "action", JS_NewInt32(ctx, (int)psDroid->action), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "action"), JS_NewInt32(ctx, (int)psDroid->action), JS_PROP_ENUMERABLE);
 	if (range >= 0)
 	{
-		QuickJS_DefinePropertyValue(ctx, value, "range", JS_NewInt32(ctx, range), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "range"), JS_NewInt32(ctx, range), JS_PROP_ENUMERABLE);
 	}
 	else
 	{
-		QuickJS_DefinePropertyValue(ctx, value, "range", JS_NULL, JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "range"), JS_NULL, JS_PROP_ENUMERABLE);
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "order", JS_NewInt32(ctx, (int)psDroid->order.type), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "cost", JS_NewUint32(ctx, calcDroidPower(psDroid)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "hasIndirect", JS_NewBool(ctx, indirect), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "order"), JS_NewInt32(ctx, (int)psDroid->order.type), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cost"), JS_NewUint32(ctx, calcDroidPower(psDroid)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "hasIndirect"), JS_NewBool(ctx, indirect), JS_PROP_ENUMERABLE);
 	switch (psDroid->droidType) // hide some engine craziness
 	{
 	case DROID_CYBORG_CONSTRUCT:
@@ -1526,27 +1565,27 @@ JSValue convDroid(const DROID *psDroid, JSContext *ctx)
 	default:
 		break;
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "bodySize", JS_NewInt32(ctx, psBodyStats->size), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "bodySize"), JS_NewInt32(ctx, psBodyStats->size), JS_PROP_ENUMERABLE);
 	if (psDroid->isTransporter())
 	{
-		QuickJS_DefinePropertyValue(ctx, value, "cargoCapacity", JS_NewInt32(ctx, TRANSPORTER_CAPACITY), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, value, "cargoLeft", JS_NewInt32(ctx, calcRemainingCapacity(psDroid)), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, value, "cargoCount", JS_NewUint32(ctx, psDroid->psGroup != nullptr? psDroid->psGroup->getNumMembers() : 0), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cargoCapacity"), JS_NewInt32(ctx, TRANSPORTER_CAPACITY), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cargoLeft"), JS_NewInt32(ctx, calcRemainingCapacity(psDroid)), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cargoCount"), JS_NewUint32(ctx, psDroid->psGroup != nullptr? psDroid->psGroup->getNumMembers() : 0), JS_PROP_ENUMERABLE);
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "isRadarDetector", JS_NewBool(ctx, objRadarDetector(psDroid)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isCB", JS_NewBool(ctx, cbSensorDroid(psDroid)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isSensor", JS_NewBool(ctx, standardSensorDroid(psDroid)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "canHitAir", JS_NewBool(ctx, aa), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "canHitGround", JS_NewBool(ctx, ga), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isVTOL", JS_NewBool(ctx, psDroid->isVtol()), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "isFlying", JS_NewBool(ctx, psDroid->isFlying()), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "droidType", JS_NewInt32(ctx, (int)type), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "experience", JS_NewFloat64(ctx, (double)psDroid->experience / 65536.0), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "health", JS_NewFloat64(ctx, 100.0 / (double)psDroid->originalBody * (double)psDroid->body), JS_PROP_ENUMERABLE);
-
-	QuickJS_DefinePropertyValue(ctx, value, "body", JS_NewString(ctx, psDroid->getBodyStats()->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "propulsion", JS_NewString(ctx, psDroid->getPropulsionStats()->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "armed", JS_NewFloat64(ctx, 0.0), JS_PROP_ENUMERABLE); // deprecated!
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isRadarDetector"), JS_NewBool(ctx, objRadarDetector(psDroid)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isCB"), JS_NewBool(ctx, cbSensorDroid(psDroid)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isSensor"), JS_NewBool(ctx, standardSensorDroid(psDroid)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "canHitAir"), JS_NewBool(ctx, aa), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "canHitGround"), JS_NewBool(ctx, ga), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isVTOL"), JS_NewBool(ctx, psDroid->isVtol()), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "isFlying"), JS_NewBool(ctx, psDroid->isFlying()), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "droidType"), JS_NewInt32(ctx, (int)type), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "experience"), JS_NewFloat64(ctx, (double)psDroid->experience / 65536.0), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "health"), JS_NewFloat64(ctx, 100.0 / (double)psDroid->originalBody * (double)psDroid->body), JS_PROP_ENUMERABLE);
+
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "body"), JS_NewString(ctx, psDroid->getBodyStats()->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "propulsion"), JS_NewString(ctx, psDroid->getPropulsionStats()->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "armed"), JS_NewFloat64(ctx, 0.0), JS_PROP_ENUMERABLE); // deprecated!
 
 	JSValue weaponlist = JS_NewArray(ctx);
 	for (int j = 0; j < psDroid->numWeaps; j++)
@@ -1554,15 +1593,15 @@ JSValue convDroid(const DROID *psDroid, JSContext *ctx)
 		int armed = droidReloadBar(psDroid, &psDroid->asWeaps[j], j);
 		JSValue weapon = JS_NewObject(ctx);
 		const WEAPON_STATS *psStats = psDroid->getWeaponStats(j);
-		QuickJS_DefinePropertyValue(ctx, weapon, "fullname", JS_NewString(ctx, psStats->name.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, weapon, "name", JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE); // will be changed to contain full name
-		QuickJS_DefinePropertyValue(ctx, weapon, "id", JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, weapon, "lastFired", JS_NewUint32(ctx, psDroid->asWeaps[j].lastFired), JS_PROP_ENUMERABLE);
-		QuickJS_DefinePropertyValue(ctx, weapon, "armed", JS_NewInt32(ctx, armed), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "fullname"), JS_NewString(ctx, psStats->name.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "name"), JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE); // will be changed to contain full name
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "id"), JS_NewString(ctx, psStats->id.toUtf8().c_str()), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "lastFired"), JS_NewUint32(ctx, psDroid->asWeaps[j].lastFired), JS_PROP_ENUMERABLE);
+		JS_DefinePropertyValue(ctx, weapon, atoms.get(ctx, "armed"), JS_NewInt32(ctx, armed), JS_PROP_ENUMERABLE);
 		JS_DefinePropertyValueUint32(ctx, weaponlist, j, weapon, JS_PROP_ENUMERABLE);
 	}
-	QuickJS_DefinePropertyValue(ctx, value, "weapons", weaponlist, JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "cargoSize", JS_NewInt32(ctx, transporterSpaceRequired(psDroid)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "weapons"), weaponlist, JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "cargoSize"), JS_NewInt32(ctx, transporterSpaceRequired(psDroid)), JS_PROP_ENUMERABLE);
 	return value;
 }
 
@@ -1588,29 +1627,32 @@ JSValue convDroid(const DROID *psDroid, JSContext *ctx)
 //;;
 JSValue convObj(const BASE_OBJECT *psObj, JSContext *ctx)
 {
+	quickjs_scripting_instance *instance = engineToInstanceMap.at(ctx);
+	PropertyAtoms &atoms = instance->propertyAtoms;
 	JSValue value = JS_NewObject(ctx);
 	ASSERT_OR_RETURN(value, psObj, "No object for conversion");
-	QuickJS_DefinePropertyValue(ctx, value, "id", JS_NewUint32(ctx, psObj->id), 0);
-	QuickJS_DefinePropertyValue(ctx, value, "x", JS_NewInt32(ctx, map_coord(psObj->pos.x)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "y", JS_NewInt32(ctx, map_coord(psObj->pos.y)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "z", JS_NewInt32(ctx, map_coord(psObj->pos.z)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "player", JS_NewUint32(ctx, psObj->player), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "armour", JS_NewInt32(ctx, objArmour(psObj, WC_KINETIC)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "thermal", JS_NewInt32(ctx, objArmour(psObj, WC_HEAT)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "type", JS_NewInt32(ctx, psObj->type), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "selected", JS_NewUint32(ctx, psObj->selected), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "name", JS_NewString(ctx, objInfo(psObj)), JS_PROP_ENUMERABLE);
-	QuickJS_DefinePropertyValue(ctx, value, "born", JS_NewUint32(ctx, psObj->born), JS_PROP_ENUMERABLE);
-	scripting_engine::GROUPMAP *psMap = scripting_engine::instance().getGroupMap(engineToInstanceMap.at(ctx));
-	if (psMap != nullptr && psMap->map().count(psObj) > 0) // FIXME:
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "id"), JS_NewUint32(ctx, psObj->id), 0);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "x"), JS_NewInt32(ctx, map_coord(psObj->pos.x)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "y"), JS_NewInt32(ctx, map_coord(psObj->pos.y)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "z"), JS_NewInt32(ctx, map_coord(psObj->pos.z)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "player"), JS_NewUint32(ctx, psObj->player), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "armour"), JS_NewInt32(ctx, objArmour(psObj, WC_KINETIC)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "thermal"), JS_NewInt32(ctx, objArmour(psObj, WC_HEAT)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "type"), JS_NewInt32(ctx, psObj->type), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "selected"), JS_NewUint32(ctx, psObj->selected), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "name"), JS_NewString(ctx, objInfo(psObj)), JS_PROP_ENUMERABLE);
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "born"), JS_NewUint32(ctx, psObj->born), JS_PROP_ENUMERABLE);
+	scripting_engine::GROUPMAP *psMap = scripting_engine::instance().getGroupMap(instance);
+	JSValue group = JS_NULL;
+	if (psMap != nullptr) // FIXME:
 	{
-		int group = psMap->map().at(psObj); // FIXME:
-		QuickJS_DefinePropertyValue(ctx, value, "group", JS_NewInt32(ctx, group), JS_PROP_ENUMERABLE);
-	}
-	else
-	{
-		QuickJS_DefinePropertyValue(ctx, value, "group", JS_NULL, JS_PROP_ENUMERABLE);
+		auto groupIt = psMap->map().find(psObj);
+		if (groupIt != psMap->map().end())
+		{
+			group = JS_NewInt32(ctx, groupIt->second);
+		}
 	}
+	JS_DefinePropertyValue(ctx, value, atoms.get(ctx, "group"), group, JS_PROP_ENUMERABLE);
 	return value;
 }
 
@@ -2854,6 +2896,62 @@ static std::string QuickJS_DumpError(JSContext *ctx)
 	return result;
 }
 
+/// Bytecode of the scripts compiled so far, shared by all script instances of this process. It is never
+/// written to or read from disk: QuickJS does not check bytecode it loads, so it only loads its own.
+static ScriptBytecodeCache &scriptBytecodeCache()
+{
+	static ScriptBytecodeCache cache;
+	return cache;
+}
+
+/// Names the bytecode of a script by everything it depends on: the script, its path (which ends up
+/// in error messages) and the loaded mods.
+static std::string scriptBytecodeKey(const char *bytes, size_t size, const std::string &path)
+{
+	std::string keyData = path;
+	keyData.push_back('\0');
+	for (const Sha256 &modHash : getModHashList())
+	{
+		keyData.append(reinterpret_cast<const char *>(modHash.bytes), Sha256::Bytes);
+	}
+	Sha256 scriptHash = sha256Sum(bytes, size);
+	keyData.append(reinterpret_cast<const char *>(scriptHash.bytes), Sha256::Bytes);
+	return sha256Sum(keyData.data(), keyData.size()).toString();
+}
+
+/// Compiles a script, without running it, or loads its bytecode from the cache if it was compiled before
+static JSValue compileScript(JSContext *ctx, const char *bytes, size_t size, const std::string &path)
+{
+	ScriptBytecodeCache &cache = scriptBytecodeCache();
+	const std::string key = scriptBytecodeKey(bytes, size, path);
+	if (ScriptBytecodeCache::Bytecode bytecode = cache.find(key))
+	{
+		JSValue compiled = JS_ReadObject(ctx, bytecode->data(), bytecode->size(), JS_READ_OBJ_BYTECODE);
+		if (!JS_IsException(compiled))
+		{
+			return compiled;
+		}
+		// Should not happen, as we wrote it ourselves - compile it again
+		JS_FreeValue(ctx, JS_GetException(ctx));
+		debug(LOG_SCRIPT, "Failed to read cached bytecode for %s", path.c_str());
+		cache.erase(key);
+	}
+
+	JSValue compiled = JS_Eval_BypassLimitedContext(ctx, bytes, size, path.c_str(), JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+	if (JS_IsException(compiled))
+	{
+		return compiled;
+	}
+	size_t bytecodeSize = 0;
+	uint8_t *bytecode = JS_WriteObject(ctx, &bytecodeSize, compiled, JS_WRITE_OBJ_BYTECODE);
+	if (bytecode)
+	{
+		cache.insert(key, std::vector<uint8_t>(bytecode, bytecode + bytecodeSize));
+		js_free(ctx, bytecode);
+	}
+	return compiled;
+}
+
 //-- ## include(filePath)
 //--
 //-- Includes another source code file at this point. You should generally only specify the filename,
@@ -2875,7 +2973,7 @@ static JSValue js_include(JSContext *ctx, JSValueConst this_val, int argc, JSVal
 		JS_ThrowReferenceError(ctx, "Failed to read include file \"%s\"", filePath.c_str());
 		return JS_FALSE;
 	}
-	JSValue compiledFuncObj = JS_Eval_BypassLimitedContext(ctx, bytes, size, loadedFilePath.c_str(), JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+	JSValue compiledFuncObj = compileScript(ctx, bytes, size, loadedFilePath);
 	free(bytes);
 	if (JS_IsException(compiledFuncObj))
 	{
@@ -3252,7 +3350,7 @@ bool quickjs_scripting_instance::loadScript(const WzString& path, int player, in
 		calcDataHash(reinterpret_cast<const uint8_t *>(bytes), size, DATA_SCRIPT);
 	}
 	m_path = path.toUtf8();
-	compiledScriptObj = JS_Eval_BypassLimitedContext(ctx, bytes, size, path.toUtf8().c_str(), JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+	compiledScriptObj = compileScript(ctx, bytes, size, m_path);
 	free(bytes);
 	if (JS_IsException(compiledScriptObj))
 	{
@@ -3696,6 +3794,7 @@ IMPL_JS_FUNC(groupAddArea, scripting_engine::groupAddArea)
 IMPL_JS_FUNC(groupAddDroid, scripting_engine::groupAddDroid)
 IMPL_JS_FUNC(groupAdd, scripting_engine::groupAdd)
 IMPL_JS_FUNC(groupSize, scripting_engine::groupSize)
+IMPL_JS_FUNC(setEventCoalescing, scripting_engine::setEventCoalescing)
 
 IMPL_JS_FUNC(activateStructure, wzapi::activateStructure)
 IMPL_JS_FUNC(findResearch, wzapi::findResearch)
@@ -3754,6 +3853,8 @@ IMPL_JS_FUNC(setPowerModifier, wzapi::setPowerModifier)
 IMPL_JS_FUNC(setPowerStorageMaximum, wzapi::setPowerStorageMaximum)
 IMPL_JS_FUNC(enableStructure, wzapi::enableStructure)
 IMPL_JS_FUNC(setTutorialMode, wzapi::setTutorialMode)
+IMPL_JS_FUNC(setHierarchicalPathfinding, wzapi::setHierarchicalPathfinding)
+IMPL_JS_FUNC(setFlowFieldPathfinding, wzapi::setFlowFieldPathfinding)
 IMPL_JS_FUNC(setMiniMap, wzapi::setMiniMap)
 IMPL_JS_FUNC(setDesign, wzapi::setDesign)
 IMPL_JS_FUNC(enableTemplate, wzapi::enableTemplate)
@@ -4110,6 +4211,7 @@ bool quickjs_scripting_instance::registerFunctions(const std::string& scriptName
 	JS_REGISTER_FUNC(groupAddDroid, 2); // scripting_engine
 	JS_REGISTER_FUNC(groupAdd, 2); // scripting_engine
 	JS_REGISTER_FUNC(groupSize, 1); // scripting_engine
+	JS_REGISTER_FUNC(setEventCoalescing, 2); // scripting_engine
 	JS_REGISTER_FUNC(orderDroidLoc, 4); // WZAPI
 	JS_REGISTER_FUNC(playerPower, 1); // WZAPI
 	JS_REGISTER_FUNC(queuedPower, 1); // WZAPI
@@ -4167,6 +4269,8 @@ bool quickjs_scripting_instance::registerFunctions(const std::string& scriptName
 	JS_REGISTER_FUNC2(setPowerStorageMaximum, 1, 2); // WZAPI
 	JS_REGISTER_FUNC2(extraPowerTime, 1, 2); // WZAPI
 	JS_REGISTER_FUNC(setTutorialMode, 1); // WZAPI
+	JS_REGISTER_FUNC(setHierarchicalPathfinding, 1); // WZAPI
+	JS_REGISTER_FUNC(setFlowFieldPathfinding, 1); // WZAPI
 	JS_REGISTER_FUNC(setDesign, 1); // WZAPI
 	JS_REGISTER_FUNC(enableTemplate, 1); // WZAPI
 	JS_REGISTER_FUNC(removeTemplate, 1); // WZAPI
@@ -405,7 +405,7 @@ static void DrawNorth(const glm::mat4 &modelViewProjectionMatrix)
 	iV_DrawImage(IntImages, RADAR_NORTH, static_cast<int>(-((radarWidth / 2.f) + iV_GetImageWidth(IntImages, RADAR_NORTH) + 1)), static_cast<int>(-(radarHeight / 2.f)), modelViewProjectionMatrix);
 }
 
-static PIELIGHT inline appliedRadarColour(RADAR_DRAW_MODE drawMode, MAPTILE *WTile)
+static PIELIGHT inline appliedRadarColour(RADAR_DRAW_MODE drawMode, MAPTILE *WTile, TileDisplay const *psDisplay)
 {
 	PIELIGHT WScr = WZCOL_BLACK;	// squelch warning
 
@@ -422,9 +422,9 @@ static PIELIGHT inline appliedRadarColour(RADAR_DRAW_MODE drawMode, MAPTILE *WTi
 			// draw radar terrain on/off feature
 			PIELIGHT col = tileColours[TileNumber_tile(WTile->texture)];
 
-			col.byte.r = static_cast<uint8_t>(sqrtf(col.byte.r * WTile->illumination));
-			col.byte.b = static_cast<uint8_t>(sqrtf(col.byte.b * WTile->illumination));
-			col.byte.g = static_cast<uint8_t>(sqrtf(col.byte.g * WTile->illumination));
+			col.byte.r = static_cast<uint8_t>(sqrtf(col.byte.r * psDisplay->illumination));
+			col.byte.b = static_cast<uint8_t>(sqrtf(col.byte.b * psDisplay->illumination));
+			col.byte.g = static_cast<uint8_t>(sqrtf(col.byte.g * psDisplay->illumination));
 			if (terrainType(WTile) == TER_CLIFFFACE)
 			{
 				col.byte.r /= 2;
@@ -451,9 +451,9 @@ static PIELIGHT inline appliedRadarColour(RADAR_DRAW_MODE drawMode, MAPTILE *WTi
 			// draw radar terrain on/off feature
 			PIELIGHT col = tileColours[TileNumber_tile(WTile->texture)];
 
-			col.byte.r = static_cast<uint8_t>(sqrtf(col.byte.r * (WTile->illumination + WTile->height / ELEVATION_SCALE) / 2));
-			col.byte.b = static_cast<uint8_t>(sqrtf(col.byte.b * (WTile->illumination + WTile->height / ELEVATION_SCALE) / 2));
-			col.byte.g = static_cast<uint8_t>(sqrtf(col.byte.g * (WTile->illumination + WTile->height / ELEVATION_SCALE) / 2));
+			col.byte.r = static_cast<uint8_t>(sqrtf(col.byte.r * (psDisplay->illumination + WTile->height / ELEVATION_SCALE) / 2));
+			col.byte.b = static_cast<uint8_t>(sqrtf(col.byte.b * (psDisplay->illumination + WTile->height / ELEVATION_SCALE) / 2));
+			col.byte.g = static_cast<uint8_t>(sqrtf(col.byte.g * (psDisplay->illumination + WTile->height / ELEVATION_SCALE) / 2));
 			if (terrainType(WTile) == TER_CLIFFFACE)
 			{
 				col.byte.r /= 2;
@@ -517,7 +517,7 @@ static void DrawRadarTiles(WorldMapState& mapState)
 				pRaderBuffer[pixelStartPos + 3] = WZCOL_BLACK.byte.a;
 				continue;
 			}
-			auto radarColor = appliedRadarColour(radarDrawMode, psTile);
+			auto radarColor = appliedRadarColour(radarDrawMode, psTile, mapTileDisplay(mapState, x, y));
 			pRaderBuffer[pixelStartPos] = radarColor.byte.r;
 			pRaderBuffer[pixelStartPos + 1] = radarColor.byte.g;
 			pRaderBuffer[pixelStartPos + 2] = radarColor.byte.b;
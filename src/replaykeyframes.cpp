@@ -0,0 +1,166 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  GameState keyframes in replays, see replaykeyframes.h.
+ */
+
+#include "replaykeyframes.h"
+
+#include "lib/framework/frame.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netreplay.h"
+#include "lib/netplay/sync_debug.h"
+
+#include "console.h"
+#include "gamestate_serialize.h"
+#include "loop.h"
+
+#include <vector>
+
+static uint32_t startSeekGameTime = 0;
+static uint32_t requestedSeekGameTime = 0;
+static bool quitAfterReindex = false;
+static bool autoReindex = true;
+static bool keyframesFailed = false;
+
+void replayRequestSeek(uint32_t targetGameTime)
+{
+	requestedSeekGameTime = targetGameTime;
+}
+
+void replaySetStartSeekTime(uint32_t targetGameTime)
+{
+	startSeekGameTime = targetGameTime;
+}
+
+void replaySetQuitAfterReindex(bool quit)
+{
+	quitAfterReindex = quit;
+}
+
+void replaySetAutoReindex(bool enabled)
+{
+	autoReindex = enabled;
+}
+
+void replayKeyframesGameStarted()
+{
+	keyframesFailed = false;
+	requestedSeekGameTime = 0;
+	if (!NETisReplay())
+	{
+		return;
+	}
+
+	requestedSeekGameTime = startSeekGameTime;
+	std::vector<ReplayKeyframeInfo> keyframeIndex;
+	const bool hasKeyframeIndex = NETreplayReadKeyframeIndex(NETreplayFilename(), keyframeIndex);
+	if (!hasKeyframeIndex && requestedSeekGameTime == 0 && autoReindex)
+	{
+		// Recorded before replays had keyframes - write a copy with them while it is played
+		NETreplayReindexStart(NETreplayFilename());
+	}
+	if (quitAfterReindex && !NETreplayReindexActive())
+	{
+		debug(LOG_INFO, "Not adding keyframes to replay file %s", NETreplayFilename().c_str());
+		wzQuit(hasKeyframeIndex ? 0 : 1);
+	}
+}
+
+static bool seekReplay(uint32_t targetGameTime)
+{
+	uint32_t keyframeGameTime = 0;
+	std::string gameState;
+	if (!NETreplayLoadKeyframeBefore(targetGameTime, gameTime, keyframeGameTime, gameState))
+	{
+		return false;
+	}
+
+	// The copy with keyframes needs every message of the replay, so it can't be finished any more
+	NETreplayReindexCancel();
+
+	try
+	{
+		// Like a spectator joining the game: the AI scripts don't run here, their orders are in the replay
+		gamestate::deserializeGameState(gameState, gamestate::ScriptScope::LocalPlayerOnly);
+	}
+	catch (const gamestate::StateError &e)
+	{
+		debug(LOG_ERROR, "Failed to restore the replay keyframe at %" PRIu32 ": %s", keyframeGameTime, e.what());
+		return false;
+	}
+	// As for the other restores (see runGameStateRoundTripTest): drop the syncDebug of the reconstruction,
+	// and don't check the sync CRCs of ticks that were never simulated here.
+	resetSyncDebug();
+	applyResumeSyncDebugCrc();
+	setSyncCheckFloorTime(gameTime);
+
+	NETreplaySkipToKeyframe(keyframeGameTime);
+	countUpdate(true);
+	return true;
+}
+
+void replayKeyframesUpdate()
+{
+	if (requestedSeekGameTime != 0 && NETisReplay())
+	{
+		const uint32_t targetGameTime = requestedSeekGameTime;
+		requestedSeekGameTime = 0;
+		if (seekReplay(targetGameTime))
+		{
+			int hours, minutes, seconds, milliseconds;
+			getTimeComponents(gameTime, &hours, &minutes, &seconds, &milliseconds);
+			CONPRINTF(_("Jumped to %d:%02d:%02d"), hours, minutes, seconds);
+		}
+		else
+		{
+			CONPRINTF("%s", _("There is no keyframe to jump to"));
+		}
+	}
+
+	if (keyframesFailed || !NETreplaySaveWantsKeyframe(gameTime))
+	{
+		return;
+	}
+	try
+	{
+		NETreplaySaveKeyframe(gameTime, gamestate::serializeGameState(gamestate::ScriptScope::LocalPlayerOnly));
+	}
+	catch (const std::exception &e)
+	{
+		// Don't try again every tick
+		debug(LOG_ERROR, "Failed to serialize a replay keyframe, the replay won't have any more: %s", e.what());
+		keyframesFailed = true;
+	}
+}
+
+void replayKeyframesReplayEnded()
+{
+	if (!NETreplayReindexActive())
+	{
+		return;
+	}
+
+	const bool added = NETreplayReindexFinish();
+	if (quitAfterReindex)
+	{
+		wzQuit(added ? 0 : 1);
+	}
+}
@@ -0,0 +1,55 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  GameState keyframes in replays.
+ *
+ *  While a replay is recorded, a GameState snapshot is added to it every minute of game time. Playing a
+ *  replay, these keyframes let us jump ahead: the snapshot is restored, and the replay messages from
+ *  before it are dropped. Replays without keyframes get them added while they are played to the end.
+ */
+
+#ifndef __INCLUDED_SRC_REPLAYKEYFRAMES_H__
+#define __INCLUDED_SRC_REPLAYKEYFRAMES_H__
+
+#include <cstdint>
+
+/// Called when the game loop starts. Starts adding keyframes to a replay being played which has none.
+void replayKeyframesGameStarted();
+
+/// Per-tick hook, at the end of gameStateUpdate: adds a keyframe to the replay being recorded when one
+/// is due, and does a requested seek.
+void replayKeyframesUpdate();
+
+/// Called when the replay being played reaches its end.
+void replayKeyframesReplayEnded();
+
+/// Jump the replay being played ahead to the last keyframe at or before targetGameTime, at the end of
+/// the current tick. Seeking back isn't possible, since the replay messages before the current tick are gone.
+void replayRequestSeek(uint32_t targetGameTime);
+
+/// Set from the command line: seek to this game time once the replay has started (0 = don't).
+void replaySetStartSeekTime(uint32_t targetGameTime);
+
+/// Set from the command line: quit once keyframes have been added to the replay being played.
+void replaySetQuitAfterReindex(bool quit);
+
+/// Whether replays without keyframes get them added while they are played (default: true).
+void replaySetAutoReindex(bool enabled);
+
+#endif // __INCLUDED_SRC_REPLAYKEYFRAMES_H__
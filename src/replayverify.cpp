@@ -0,0 +1,386 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Verifying a directory of replays, see replayverify.h.
+ */
+
+#include <nlohmann/json.hpp> // Must come before WZ includes
+
+#include "replayverify.h"
+
+#include "lib/framework/frame.h"
+#include "lib/framework/physfs_ext.h"
+#include "lib/framework/string_ext.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netplay.h"
+
+#include "gamehistorylogger.h"
+#include "loop.h"
+#include "replaykeyframes.h"
+#include "version.h"
+
+#if defined(HAVE_POSIX_SPAWNP)
+# include <errno.h>
+# include <fcntl.h>
+# include <spawn.h>
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+# if !defined(HAVE_ENVIRON_DECL)
+  extern char **environ;
+# endif
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Where the directory of the replays is mounted in PhysFS
+static const char ReplayVerifyMountPoint[] = "replayverify";
+
+// Game ticks a worker may run per frame. There is nothing to draw, but the main loop still has to
+// handle events now and then.
+static constexpr size_t VerifyMaxFastForwardTicks = 1000;
+
+static std::string workerReportFilename;
+static std::chrono::steady_clock::time_point workerStartTime;
+static bool workerFinished = false;
+
+static bool writeReport(const std::string &filename, const nlohmann::ordered_json &report)
+{
+	FILE *f = fopen(filename.c_str(), "w");
+	if (f == nullptr)
+	{
+		debug(LOG_ERROR, "Failed to open replay verification report for writing: %s", filename.c_str());
+		return false;
+	}
+	const std::string data = report.dump(1, '\t');
+	const bool written = fwrite(data.data(), 1, data.size(), f) == data.size();
+	return fclose(f) == 0 && written;
+}
+
+static std::string fileNameOf(const std::string &path, const std::string &separator)
+{
+	const size_t lastSeparator = path.rfind(separator);
+	return (lastSeparator != std::string::npos) ? path.substr(lastSeparator + separator.size()) : path;
+}
+
+std::string replayVerifyMountReplay(const std::string &path)
+{
+	const std::string separator = PHYSFS_getDirSeparator();
+	const size_t lastSeparator = path.rfind(separator);
+	const std::string directory = (lastSeparator != std::string::npos) ? path.substr(0, lastSeparator) : ".";
+	if (PHYSFS_mount(directory.c_str(), ReplayVerifyMountPoint, PHYSFS_APPEND) == 0)
+	{
+		debug(LOG_ERROR, "Unable to read replays from %s: %s", directory.c_str(), WZ_PHYSFS_getLastError());
+		return std::string();
+	}
+	return std::string(ReplayVerifyMountPoint) + "/" + fileNameOf(path, separator);
+}
+
+void replayVerifySetWorker(const std::string &reportFilename)
+{
+	workerReportFilename = reportFilename;
+	// The worker only reads the replay
+	replaySetAutoReindex(false);
+}
+
+bool replayVerifyWorkerActive()
+{
+	return !workerReportFilename.empty();
+}
+
+void replayVerifyGameStarted()
+{
+	if (!replayVerifyWorkerActive() || !NETisReplay())
+	{
+		return;
+	}
+	setMaxFastForwardTicks(VerifyMaxFastForwardTicks, false);
+	workerStartTime = std::chrono::steady_clock::now();
+}
+
+void replayVerifyFinish(const char *endReason)
+{
+	if (!replayVerifyWorkerActive() || workerFinished)
+	{
+		return;
+	}
+	workerFinished = true;
+
+	const unsigned syncErrors = gameTimeSyncErrorCount();
+	nlohmann::ordered_json report = nlohmann::ordered_json::object();
+	report["replay"] = fileNameOf(NETreplayFilename(), "/");
+	report["version"] = version_getVersionString();
+	report["status"] = (syncErrors == 0) ? "ok" : "desync";
+	report["end"] = endReason;
+	report["gameTime"] = gameTime;
+	report["syncErrors"] = syncErrors;
+	if (syncErrors > 0)
+	{
+		report["firstSyncErrorGameTime"] = gameTimeFirstSyncErrorTime();
+	}
+	report["realTimeMs"] = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - workerStartTime).count();
+	report["stats"] = GameStoryLogger::instance().genCurrentGameReport();
+
+	// The exit code tells the farm the result, see runReplayVerification()
+	if (!writeReport(workerReportFilename, report))
+	{
+		wzQuit(2);
+		return;
+	}
+	wzQuit((syncErrors == 0) ? 0 : 1);
+}
+
+#if defined(HAVE_POSIX_SPAWNP)
+
+namespace
+{
+
+struct VerifyJob
+{
+	std::string replayName;
+	std::string replayFilename;
+	std::string reportFilename;
+	std::string traceFilename;
+	std::string logFilename;
+};
+
+}
+
+static std::vector<std::string> listReplays(const std::string &replayDirectory)
+{
+	std::vector<std::string> replays;
+	if (PHYSFS_mount(replayDirectory.c_str(), ReplayVerifyMountPoint, PHYSFS_APPEND) == 0)
+	{
+		fprintf(stderr, "Unable to read replays from %s: %s\n", replayDirectory.c_str(), WZ_PHYSFS_getLastError());
+		return replays;
+	}
+	WZ_PHYSFS_enumerateFiles(ReplayVerifyMountPoint, [&replays](const char *file) -> bool {
+		if (strEndsWith(file, ".wzrp"))
+		{
+			replays.emplace_back(file);
+		}
+		return true;
+	});
+	PHYSFS_unmount(replayDirectory.c_str());
+	std::sort(replays.begin(), replays.end());
+	return replays;
+}
+
+static VerifyJob makeJob(const std::string &replayDirectory, const std::string &replayName)
+{
+	const std::string basePath = replayDirectory + PHYSFS_getDirSeparator() + replayName.substr(0, replayName.size() - strlen(".wzrp"));
+	VerifyJob job;
+	job.replayName = replayName;
+	job.replayFilename = replayDirectory + PHYSFS_getDirSeparator() + replayName;
+	job.reportFilename = basePath + ".verify.json";
+	job.traceFilename = basePath + ".crctrace.txt";
+	job.logFilename = basePath + ".verify.log";
+	return job;
+}
+
+// The arguments of the farm, without the farm options, are passed on to the workers
+static std::vector<std::string> workerBaseArguments(int argc, const char * const *argv)
+{
+	std::vector<std::string> args;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--replay-verify" || arg == "--replay-verify-jobs")
+		{
+			++i; // and its value
+			continue;
+		}
+		if (arg.rfind("--replay-verify=", 0) == 0 || arg.rfind("--replay-verify-jobs=", 0) == 0)
+		{
+			continue;
+		}
+		args.push_back(arg);
+	}
+	return args;
+}
+
+static pid_t startWorker(const char *executable, const std::vector<std::string> &baseArgs, const VerifyJob &job)
+{
+	std::vector<std::string> args = { executable };
+	args.insert(args.end(), baseArgs.begin(), baseArgs.end());
+	args.insert(args.end(), {
+		"--headless",
+		"--replay-verify-worker", job.replayFilename,
+		"--replay-verify-report", job.reportFilename,
+		"--gamestate-crc-trace", job.traceFilename
+	});
+	std::vector<char *> argv;
+	for (auto &arg : args)
+	{
+		argv.push_back(const_cast<char *>(arg.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	posix_spawn_file_actions_t fileActions;
+	posix_spawn_file_actions_init(&fileActions);
+	posix_spawn_file_actions_addopen(&fileActions, STDOUT_FILENO, job.logFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+	pid_t pid = 0;
+	const int spawnResult = posix_spawnp(&pid, executable, &fileActions, nullptr, argv.data(), environ);
+	posix_spawn_file_actions_destroy(&fileActions);
+	if (spawnResult != 0)
+	{
+		fprintf(stderr, "Failed to start a worker for %s: %s\n", job.replayName.c_str(), strerror(spawnResult));
+		return -1;
+	}
+	return pid;
+}
+
+static void writeFailureReport(const VerifyJob &job, const std::string &error)
+{
+	nlohmann::ordered_json report = nlohmann::ordered_json::object();
+	report["replay"] = job.replayName;
+	report["version"] = version_getVersionString();
+	report["status"] = "failed";
+	report["error"] = error;
+	report["log"] = job.logFilename;
+	writeReport(job.reportFilename, report);
+}
+
+// Worker exit codes: 0 if the replay is in sync, 1 if it isn't, anything else if there is no report
+static const char *finishJob(const VerifyJob &job, int waitStatus)
+{
+	FILE *report = fopen(job.reportFilename.c_str(), "r");
+	const bool haveReport = report != nullptr;
+	if (report != nullptr)
+	{
+		fclose(report);
+	}
+
+	if (WIFEXITED(waitStatus) && haveReport)
+	{
+		if (WEXITSTATUS(waitStatus) == 0)
+		{
+			return "ok";
+		}
+		if (WEXITSTATUS(waitStatus) == 1)
+		{
+			return "desync";
+		}
+	}
+	if (WIFSIGNALED(waitStatus))
+	{
+		writeFailureReport(job, "The worker was killed by signal " + std::to_string(WTERMSIG(waitStatus)));
+	}
+	else
+	{
+		writeFailureReport(job, "The worker exited with code " + std::to_string(WEXITSTATUS(waitStatus)) + " without a report");
+	}
+	return "failed";
+}
+
+bool runReplayVerification(const std::string &replayDirectory, unsigned numJobs, int argc, const char * const *argv)
+{
+	const std::vector<std::string> replays = listReplays(replayDirectory);
+	if (replays.empty())
+	{
+		fprintf(stderr, "No replays to verify in: %s\n", replayDirectory.c_str());
+		return false;
+	}
+	if (numJobs == 0)
+	{
+		numJobs = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	const std::vector<std::string> baseArgs = workerBaseArguments(argc, argv);
+	fprintf(stdout, "Verifying %zu replays in %s, %u at a time\n", replays.size(), replayDirectory.c_str(), numJobs);
+	fflush(stdout);
+
+	const auto startTime = std::chrono::steady_clock::now();
+	std::map<pid_t, VerifyJob> running;
+	size_t nextReplay = 0;
+	size_t numFinished = 0;
+	size_t numInSync = 0;
+	auto reportResult = [&](const VerifyJob &job, const char *result) {
+		++numFinished;
+		numInSync += (strcmp(result, "ok") == 0) ? 1 : 0;
+		fprintf(stdout, "[%zu/%zu] %s: %s\n", numFinished, replays.size(), job.replayName.c_str(), result);
+		fflush(stdout);
+	};
+
+	while (nextReplay < replays.size() || !running.empty())
+	{
+		while (nextReplay < replays.size() && running.size() < numJobs)
+		{
+			VerifyJob job = makeJob(replayDirectory, replays[nextReplay++]);
+			remove(job.reportFilename.c_str()); // from an earlier run
+			const pid_t pid = startWorker(argv[0], baseArgs, job);
+			if (pid < 0)
+			{
+				writeFailureReport(job, "The worker couldn't be started");
+				reportResult(job, "failed");
+				continue;
+			}
+			running.emplace(pid, std::move(job));
+		}
+		if (running.empty())
+		{
+			continue;
+		}
+
+		int waitStatus = 0;
+		const pid_t pid = waitpid(-1, &waitStatus, 0);
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "Lost track of the workers: %s\n", strerror(errno));
+			for (auto const &lost : running)
+			{
+				writeFailureReport(lost.second, "Lost track of the worker");
+				reportResult(lost.second, "failed");
+			}
+			break;
+		}
+		auto it = running.find(pid);
+		if (it == running.end())
+		{
+			continue; // not one of ours
+		}
+		reportResult(it->second, finishJob(it->second, waitStatus));
+		running.erase(it);
+	}
+
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count();
+	fprintf(stdout, "%zu of %zu replays in sync (%lld s)\n", numInSync, replays.size(), static_cast<long long>(seconds));
+	fflush(stdout);
+	return numInSync == replays.size();
+}
+
+#else
+
+bool runReplayVerification(const std::string &, unsigned, int, const char * const *)
+{
+	fprintf(stderr, "Replay verification isn't supported on this platform\n");
+	return false;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Verifying a directory of replays, several at a time.
+ *
+ *  `--replay-verify <dir>` starts a headless worker process per replay, at most `--replay-verify-jobs`
+ *  at once. Each worker plays its replay as fast as it can, checking the sync CRCs recorded in it, and
+ *  writes next to the replay:
+ *  - `<name>.verify.json`: the result, the sync errors and the final game stats,
+ *  - `<name>.crctrace.txt`: the per-tick sync-CRC trace (see setSyncCrcTraceFile()),
+ *  - `<name>.verify.log`: the output of the worker.
+ */
+
+#ifndef __INCLUDED_SRC_REPLAYVERIFY_H__
+#define __INCLUDED_SRC_REPLAYVERIFY_H__
+
+#include <string>
+
+/// Verifies all the replays in replayDirectory, numJobs at a time (0 = one per CPU core), by running
+/// this executable with the arguments in argv, plus the worker options. Returns true if all of them
+/// were played to the end without a sync error.
+bool runReplayVerification(const std::string &replayDirectory, unsigned numJobs, int argc, const char * const *argv);
+
+/// Makes the replay at the given path readable through PhysFS, for a worker. Returns its PhysFS path,
+/// or an empty string if the directory can't be read.
+std::string replayVerifyMountReplay(const std::string &path);
+
+/// Set from the command line: this process is a verification worker, writing its report to reportFilename.
+void replayVerifySetWorker(const std::string &reportFilename);
+bool replayVerifyWorkerActive();
+
+/// Called when the game loop starts. A worker plays the replay as fast as it can.
+void replayVerifyGameStarted();
+
+/// Called when the replay being played ends, or the game is over: a worker writes its report and quits.
+void replayVerifyFinish(const char *endReason);
+
+#endif // __INCLUDED_SRC_REPLAYVERIFY_H__
@@ -47,6 +47,8 @@
 #include "qtscript.h"
 #include "stats.h"
 #include "wzapi.h"
+#include "statids.h"
+#include "researchindex.h"
 
 // The stores for the research stats
 std::vector<RESEARCH> asResearch;
@@ -91,6 +93,12 @@ static void replaceComponent(COMPONENT_STATS *pNewComponent, COMPONENT_STATS *pO
                              UBYTE player);
 static bool checkResearchName(RESEARCH *psRes, UDWORD numStats);
 
+/// Text ids of asResearch, interned in the same order, so that a StatId is an index into asResearch
+static StatIdTable researchIds;
+
+/// Prerequisites of each topic not completed by each player, kept up to date by researchStatusChanged()
+static ResearchPrerequisiteIndex researchPrerequisites;
+
 //flag that indicates whether the player can self repair
 static UBYTE bSelfRepair[MAX_PLAYERS];
 static void replaceDroidComponent(DroidList& pList, UDWORD oldType, UDWORD oldCompInc,
@@ -110,6 +118,8 @@ bool researchInitVars()
 	psCBLastResStructure = nullptr;
 	CBResFacilityOwner = -1;
 	asResearch.clear();
+	researchIds.clear();
+	researchPrerequisites.clear();
 	researchUpgradeCalcMode = nullopt;
 	resCategories.clear();
 	cachedStatsObject = nlohmann::json(nullptr);
@@ -623,6 +633,8 @@ bool loadResearch(WzConfig &ini)
 			}
 		}
 
+		const StatId researchId = researchIds.intern(research.id.toUtf8());
+		ASSERT(researchId == asResearch.size(), "Research ID '%s' interned out of order", getID(&research));
 		asResearch.push_back(research);
 		ini.endGroup();
 	}
@@ -700,6 +712,49 @@ bool loadResearch(WzConfig &ini)
 		researchUpgradeCalcMode = ResearchUpgradeCalculationMode::Compat;
 	}
 
+	rebuildResearchAvailability();
+
+	return true;
+}
+
+void rebuildResearchAvailability()
+{
+	std::vector<std::vector<uint16_t>> prerequisites(asResearch.size());
+	for (size_t inc = 0; inc < asResearch.size(); ++inc)
+	{
+		prerequisites[inc] = asResearch[inc].pPRList;
+	}
+	std::vector<std::vector<bool>> completed(MAX_PLAYERS);
+	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	{
+		for (auto const &playerRes : asPlayerResList[player])
+		{
+			completed[player].push_back(IsResearchCompleted(&playerRes));
+		}
+	}
+	researchPrerequisites.rebuild(prerequisites, completed);
+}
+
+void researchStatusChanged(UDWORD player, UDWORD index)
+{
+	ASSERT_OR_RETURN(, player < MAX_PLAYERS && index < asPlayerResList[player].size(), "Invalid research %u of player %u", index, player);
+	researchPrerequisites.setCompleted(player, index, IsResearchCompleted(&asPlayerResList[player][index]));
+}
+
+static bool researchPrerequisitesCompleted(int inc, UDWORD playerID)
+{
+	if (researchPrerequisites.indexed(playerID, inc))
+	{
+		return researchPrerequisites.prerequisitesCompleted(playerID, inc);
+	}
+	// Only while loading, before the index is built
+	for (UWORD prerequisite : asResearch[inc].pPRList)
+	{
+		if (!IsResearchCompleted(&asPlayerResList[playerID][prerequisite]))
+		{
+			return false;
+		}
+	}
 	return true;
 }
 
@@ -719,8 +774,8 @@ bool researchAvailable(int inc, UDWORD playerID, QUEUE_MODE mode)
 		IsResearchStartedFunc = IsResearchStarted;
 	}
 
-	UDWORD				incPR, incS;
-	bool				bPRFound, bStructFound;
+	UDWORD				incS;
+	bool				bStructFound;
 
 	// if its a cancelled topic - add to list
 	if (IsResearchCancelledFunc(&asPlayerResList[playerID][inc]))
@@ -770,17 +825,7 @@ bool researchAvailable(int inc, UDWORD playerID, QUEUE_MODE mode)
 		}
 
 		// check for pre-requisites
-		bPRFound = true;
-		for (incPR = 0; incPR < asResearch[inc].pPRList.size(); incPR++)
-		{
-			if (IsResearchCompleted(&(asPlayerResList[playerID][asResearch[inc].pPRList[incPR]])) == 0)
-			{
-				// if haven't pre-requisite - quit checking rest
-				bPRFound = false;
-				break;
-			}
-		}
-		if (!bPRFound)
+		if (!researchPrerequisitesCompleted(inc, playerID))
 		{
 			// if haven't pre-requisites, skip the rest of the checks
 			return false;
@@ -1186,6 +1231,7 @@ void researchResult(UDWORD researchIndex, UBYTE player, bool bDisplay, STRUCTURE
 	syncDebug("researchResult(%u, %u, …)", researchIndex, player);
 
 	MakeResearchCompleted(&asPlayerResList[player][researchIndex]);
+	researchStatusChanged(player, researchIndex);
 
 	//check for structures to be made available
 	for (unsigned short pStructureResult : pResearch->pStructureResults)
@@ -1296,6 +1342,8 @@ bool ResearchShutDown()
 void ResearchRelease()
 {
 	asResearch.clear();
+	researchIds.clear();
+	researchPrerequisites.clear();
 	researchUpgradeCalcMode = nullopt;
 	resCategories.clear();
 	for (auto &i : asPlayerResList)
@@ -1427,6 +1475,7 @@ void cancelResearch(STRUCTURE *psBuilding, QUEUE_MODE mode)
 			// Set the researched flag
 			MakeResearchCancelled(pPlayerRes);
 		}
+		researchStatusChanged(psBuilding->player, topicInc);
 
 		// Initialise the research facility's subject
 		psResFac->psSubject = nullptr;
@@ -1626,12 +1675,10 @@ SDWORD	mapIconToRID(UDWORD iconID)
 //return a pointer to a research topic based on the name
 RESEARCH *getResearch(const char *pName)
 {
-	for (auto &inc : asResearch)
+	const StatId researchId = researchIds.find(pName);
+	if (researchId < asResearch.size())
 	{
-		if (inc.id.compare(pName) == 0)
-		{
-			return &inc;
-		}
+		return &asResearch[researchId];
 	}
 	debug(LOG_WARNING, "Unknown research - %s", pName);
 	return nullptr;
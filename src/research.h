@@ -148,6 +148,11 @@ bool researchInitVars();
 
 bool researchAvailable(int inc, UDWORD playerID, QUEUE_MODE mode);
 
+/// Updates the prerequisites researchAvailable() counts as completed, after the status of a topic changed.
+void researchStatusChanged(UDWORD player, UDWORD index);
+/// Counts the completed prerequisites of every topic again, after research status was set directly (such as when loading).
+void rebuildResearchAvailability();
+
 struct AllyResearch
 {
 	unsigned player;
@@ -0,0 +1,86 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Research prerequisite index, see researchindex.h.
+ */
+
+#include "researchindex.h"
+
+void ResearchPrerequisiteIndex::rebuild(std::vector<std::vector<uint16_t>> const &prerequisites, std::vector<std::vector<bool>> const &completed)
+{
+	const size_t topics = prerequisites.size();
+	dependents.assign(topics, {});
+	for (size_t topic = 0; topic < topics; ++topic)
+	{
+		for (uint16_t prerequisite : prerequisites[topic])
+		{
+			if (prerequisite < topics)
+			{
+				dependents[prerequisite].push_back(static_cast<uint16_t>(topic));
+			}
+		}
+	}
+
+	missing.assign(completed.size(), {});
+	counted.assign(completed.size(), {});
+	for (size_t player = 0; player < completed.size(); ++player)
+	{
+		counted[player].assign(topics, false);
+		missing[player].assign(topics, 0);
+		for (size_t topic = 0; topic < topics && topic < completed[player].size(); ++topic)
+		{
+			counted[player][topic] = completed[player][topic];
+		}
+		for (size_t topic = 0; topic < topics; ++topic)
+		{
+			for (uint16_t prerequisite : prerequisites[topic])
+			{
+				// A prerequisite which doesn't exist can never be completed.
+				missing[player][topic] += prerequisite >= topics || !counted[player][prerequisite];
+			}
+		}
+	}
+}
+
+void ResearchPrerequisiteIndex::setCompleted(unsigned player, size_t topic, bool completed)
+{
+	if (!indexed(player, topic) || counted[player][topic] == completed)
+	{
+		return;
+	}
+	counted[player][topic] = completed;
+	for (uint16_t dependent : dependents[topic])
+	{
+		if (completed)
+		{
+			--missing[player][dependent];
+		}
+		else
+		{
+			++missing[player][dependent];
+		}
+	}
+}
+
+void ResearchPrerequisiteIndex::clear()
+{
+	dependents.clear();
+	missing.clear();
+	counted.clear();
+}
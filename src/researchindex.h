@@ -0,0 +1,52 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Per player count of the prerequisites of each research topic which are not completed yet,
+ *  so that researchAvailable() does not walk the prerequisite list of every topic it is asked about.
+ *
+ *  Kept apart from research.cpp, since it depends on nothing but the standard library.
+ */
+
+#ifndef __INCLUDED_SRC_RESEARCHINDEX_H__
+#define __INCLUDED_SRC_RESEARCHINDEX_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ResearchPrerequisiteIndex
+{
+public:
+	/// Counts again from the prerequisites of each topic, and completed[player][topic].
+	void rebuild(std::vector<std::vector<uint16_t>> const &prerequisites, std::vector<std::vector<bool>> const &completed);
+	/// Records whether a topic is completed, updating the topics which depend on it if that changed.
+	void setCompleted(unsigned player, size_t topic, bool completed);
+	void clear();
+
+	bool indexed(unsigned player, size_t topic) const { return player < missing.size() && topic < missing[player].size(); }
+	/// Whether every prerequisite of the topic is completed. True for topics without any.
+	bool prerequisitesCompleted(unsigned player, size_t topic) const { return missing[player][topic] == 0; }
+
+private:
+	std::vector<std::vector<uint16_t>> dependents;  ///< Topics listing each topic as a prerequisite, once per listing.
+	std::vector<std::vector<uint16_t>> missing;     ///< By player and topic.
+	std::vector<std::vector<bool>> counted;         ///< Which topics missing counts as completed, by player.
+};
+
+#endif // __INCLUDED_SRC_RESEARCHINDEX_H__
@@ -37,6 +37,7 @@
 #include "lib/netplay/connection_provider_registry.h"
 #include "lib/netplay/error_categories.h"
 #include "lib/netplay/netlobby.h"
+#include "lib/netplay/wz_compression_provider.h"
 
 #include "../hci.h"
 #include "../activity.h"
@@ -904,6 +905,8 @@ private:
 	char initialAckBuffer[10] = {'\0'};
 	size_t usedInitialAckBuffer = 0;
 	const size_t expectedInitialAckSize = sizeof(uint32_t);
+	// On success, the result is followed by the compression method chosen by the host.
+	const size_t expectedSuccessfulInitialAckSize = expectedInitialAckSize + sizeof(uint32_t);
 
 	std::chrono::steady_clock::time_point timeStarted;
 	const std::chrono::milliseconds minimumTimeBeforeAutoClose = std::chrono::milliseconds(300);
@@ -1731,8 +1734,9 @@ void WzJoiningGameScreen_HandlerRoot::processOpenConnectionResult(size_t connect
 		client_transient_socket->useNagleAlgorithm(false);
 	}
 
-	// Send initial connection data: NETCODE_VERSION_MAJOR and NETCODE_VERSION_MINOR
-	char buffer[sizeof(int32_t) * 2] = { 0 };
+	// Send initial connection data: NETCODE_VERSION_MAJOR and NETCODE_VERSION_MINOR,
+	// followed by the compression methods we support (only read by hosts of the same version)
+	char buffer[sizeof(int32_t) * 3] = { 0 };
 	char *p_buffer = buffer;
 	auto pushu32 = [&](uint32_t value) {
 		uint32_t swapped = wz_htonl(value);
@@ -1741,6 +1745,7 @@ void WzJoiningGameScreen_HandlerRoot::processOpenConnectionResult(size_t connect
 	};
 	pushu32(NETGetMajorVersion());
 	pushu32(NETGetMinorVersion());
+	pushu32(WzCompressionProvider::Instance().supportedMethods());
 
 	const auto writeResult = client_transient_socket->writeAll(buffer, sizeof(buffer), nullptr);
 	if (!writeResult.has_value())
@@ -1967,9 +1972,17 @@ void WzJoiningGameScreen_HandlerRoot::processJoining()
 				return; // wait for next check
 			}
 
+			auto loadu32 = [&](size_t offset) {
+				uint32_t value = 0;
+				memcpy(&value, initialAckBuffer + offset, sizeof(value));
+				return wz_ntohl(value);
+			};
+
+			// Don't read past the result until we know it's a success, to which the compression method is appended.
 			char *p_buffer = initialAckBuffer;
+			const size_t expectedSize = (usedInitialAckBuffer >= expectedInitialAckSize && loadu32(0) == ERROR_NOERROR) ? expectedSuccessfulInitialAckSize : expectedInitialAckSize;
 			const auto readResult = client_transient_socket->readNoInt(p_buffer + usedInitialAckBuffer,
-				expectedInitialAckSize - usedInitialAckBuffer,
+				expectedSize - usedInitialAckBuffer,
 				nullptr);
 			if (readResult.has_value())
 			{
@@ -1978,9 +1991,7 @@ void WzJoiningGameScreen_HandlerRoot::processJoining()
 
 			if (usedInitialAckBuffer >= expectedInitialAckSize)
 			{
-				uint32_t result = ERROR_CONNECTION;
-				memcpy(&result, initialAckBuffer, sizeof(result));
-				result = wz_ntohl(result);
+				uint32_t result = loadu32(0);
 				if (result != ERROR_NOERROR)
 				{
 					debug(LOG_ERROR, "Received error %d", result);
@@ -2001,8 +2012,21 @@ void WzJoiningGameScreen_HandlerRoot::processJoining()
 					return;
 				}
 
+				if (usedInitialAckBuffer < expectedSuccessfulInitialAckSize)
+				{
+					return; // wait for the compression method
+				}
+				const auto compressionMethod = static_cast<WzCompressionMethod>(loadu32(expectedInitialAckSize));
+				if (!WzCompressionProvider::Instance().isSupported(compressionMethod))
+				{
+					debug(LOG_ERROR, "Host chose unsupported compression method %" PRIu32, static_cast<uint32_t>(compressionMethod));
+					closeConnectionAttempt();
+					handleFailure(FailureDetails::makeFromLobbyError(ERROR_CONNECTION));
+					return;
+				}
+
 				// transition to net message mode (enable compression, wait for messages)
-				client_transient_socket->enableCompression();
+				client_transient_socket->enableCompression(compressionMethod);
 				currentJoiningState = JoiningState::ProcessingJoinMessages;
 				// permit fall-through to currentJoiningState == JoiningState::ProcessingJoinMessage case below
 			}
@@ -0,0 +1,70 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Cache of compiled script bytecode, see scriptbytecodecache.h.
+ */
+
+#include "scriptbytecodecache.h"
+
+#include <utility>
+
+ScriptBytecodeCache::Bytecode ScriptBytecodeCache::find(std::string const &key)
+{
+	auto it = entries.find(key);
+	if (it == entries.end())
+	{
+		cacheStats.misses++;
+		return nullptr;
+	}
+	it->second.lastUsed = ++useCounter;
+	cacheStats.hits++;
+	return it->second.bytecode;
+}
+
+ScriptBytecodeCache::Bytecode ScriptBytecodeCache::insert(std::string const &key, std::vector<uint8_t> bytecode)
+{
+	auto shared = std::make_shared<const std::vector<uint8_t>>(std::move(bytecode));
+	erase(key);
+	while (!entries.empty() && memoryBytes + shared->size() > MAX_MEMORY_BYTES)
+	{
+		auto oldest = entries.begin();
+		for (auto i = entries.begin(); i != entries.end(); ++i)
+		{
+			if (i->second.lastUsed < oldest->second.lastUsed)
+			{
+				oldest = i;
+			}
+		}
+		memoryBytes -= oldest->second.bytecode->size();
+		entries.erase(oldest);
+	}
+	entries[key] = Entry{shared, ++useCounter};
+	memoryBytes += shared->size();
+	return shared;
+}
+
+void ScriptBytecodeCache::erase(std::string const &key)
+{
+	auto it = entries.find(key);
+	if (it != entries.end())
+	{
+		memoryBytes -= it->second.bytecode->size();
+		entries.erase(it);
+	}
+}
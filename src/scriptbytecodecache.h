@@ -0,0 +1,72 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Cache of compiled script bytecode, shared by the script instances of a process.
+ *
+ *  The cache knows nothing of the script engine: the caller compiles, serialises and names the bytecode
+ *  (by a hash of everything the bytecode depends on). It is only kept in memory, so the bytecode loaded
+ *  from it is always bytecode this process wrote itself.
+ */
+
+#ifndef __INCLUDED_SRC_SCRIPTBYTECODECACHE_H__
+#define __INCLUDED_SRC_SCRIPTBYTECODECACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ScriptBytecodeCache
+{
+public:
+	using Bytecode = std::shared_ptr<const std::vector<uint8_t>>;
+
+	/// Bytecode kept before the least recently used is dropped, to be compiled again when next needed.
+	static constexpr size_t MAX_MEMORY_BYTES = 32 << 20;
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+
+	/// The bytecode stored for key, or null if there is none.
+	Bytecode find(std::string const &key);
+	/// Stores the bytecode for key.
+	Bytecode insert(std::string const &key, std::vector<uint8_t> bytecode);
+	/// Forgets the bytecode stored for key. Call if it could not be loaded, so that it is compiled and stored again.
+	void erase(std::string const &key);
+
+	Stats const &stats() const { return cacheStats; }
+
+private:
+	struct Entry
+	{
+		Bytecode bytecode;
+		uint64_t lastUsed;
+	};
+	std::unordered_map<std::string, Entry> entries;
+	size_t memoryBytes = 0;
+	uint64_t useCounter = 0;
+	Stats cacheStats;
+};
+
+#endif // __INCLUDED_SRC_SCRIPTBYTECODECACHE_H__
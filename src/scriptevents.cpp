@@ -0,0 +1,103 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Bookkeeping for queued script events, see scriptevents.h.
+ */
+
+#include "scriptevents.h"
+
+#include <algorithm>
+
+static const char *const queuedScriptEventNames[NUM_QUEUED_SCRIPT_EVENTS] = {"eventAttacked", "eventObjectSeen", "eventGroupSeen", "eventDroidIdle"};
+
+const char *queuedScriptEventName(QueuedScriptEvent event)
+{
+	return queuedScriptEventNames[static_cast<size_t>(event)];
+}
+
+bool queuedScriptEventFromName(std::string const &name, QueuedScriptEvent &event)
+{
+	for (size_t i = 0; i < NUM_QUEUED_SCRIPT_EVENTS; ++i)
+	{
+		if (name == queuedScriptEventNames[i])
+		{
+			event = static_cast<QueuedScriptEvent>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void ScriptEventCoalescer::setWindow(uint32_t ms)
+{
+	windowMs = ms;
+	lastDelivered.clear();
+	pruneSize = 64;
+}
+
+bool ScriptEventCoalescer::admit(uint32_t key, uint32_t gameTime)
+{
+	if (windowMs == 0)
+	{
+		return true;
+	}
+	auto it = lastDelivered.find(key);
+	if (it != lastDelivered.end())
+	{
+		if (gameTime - it->second < windowMs)
+		{
+			return false;
+		}
+		it->second = gameTime;
+		return true;
+	}
+
+	if (lastDelivered.size() >= pruneSize)
+	{
+		// Keys delivered before the window can't hold anything back any more.
+		for (auto i = lastDelivered.begin(); i != lastDelivered.end();)
+		{
+			i = gameTime - i->second >= windowMs ? lastDelivered.erase(i) : std::next(i);
+		}
+		pruneSize = std::max<size_t>(64, lastDelivered.size() * 2);
+	}
+	lastDelivered.emplace(key, gameTime);
+	return true;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> ScriptEventCoalescer::recent(uint32_t gameTime) const
+{
+	std::vector<std::pair<uint32_t, uint32_t>> entries;
+	for (auto const &entry : lastDelivered)
+	{
+		if (gameTime - entry.second < windowMs)
+		{
+			entries.push_back(entry);
+		}
+	}
+	std::sort(entries.begin(), entries.end());
+	return entries;
+}
+
+void ScriptEventCoalescer::restore(uint32_t ms, std::vector<std::pair<uint32_t, uint32_t>> const &entries)
+{
+	setWindow(ms);
+	lastDelivered.insert(entries.begin(), entries.end());
+	pruneSize = std::max<size_t>(64, lastDelivered.size() * 2);
+}
@@ -0,0 +1,85 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Bookkeeping for the script events which are queued during a game tick, see flushScriptEvents() in qtscript.h.
+ *
+ *  Kept apart from qtscript.cpp, since it depends on nothing but the standard library.
+ */
+
+#ifndef __INCLUDED_SRC_SCRIPTEVENTS_H__
+#define __INCLUDED_SRC_SCRIPTEVENTS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// The script events which are queued until the end of the game tick, rather than run at once.
+enum class QueuedScriptEvent : uint8_t
+{
+	Attacked,
+	ObjectSeen,
+	GroupSeen,
+	DroidIdle,
+};
+static constexpr size_t NUM_QUEUED_SCRIPT_EVENTS = 4;
+
+/// The name of the event in scripts, such as "eventAttacked".
+const char *queuedScriptEventName(QueuedScriptEvent event);
+
+/// Looks up an event by its name in scripts. Returns false if it isn't one of the queued events.
+bool queuedScriptEventFromName(std::string const &name, QueuedScriptEvent &event);
+
+/// Drops repeats of an event for the same object (or group) within a window of game time, for one script instance.
+class ScriptEventCoalescer
+{
+public:
+	/// Window in milliseconds of game time, 0 to deliver every event. Forgets the events delivered so far.
+	void setWindow(uint32_t ms);
+	uint32_t window() const { return windowMs; }
+
+	/// Whether an event for key should be delivered at gameTime, which must not decrease between calls. If so, remembers it.
+	bool admit(uint32_t key, uint32_t gameTime);
+
+	/// The keys delivered within the window before gameTime, and when, sorted by key. For saving.
+	std::vector<std::pair<uint32_t, uint32_t>> recent(uint32_t gameTime) const;
+	/// Restores what recent() returned, with the window it was saved with.
+	void restore(uint32_t ms, std::vector<std::pair<uint32_t, uint32_t>> const &entries);
+
+private:
+	uint32_t windowMs = 0;
+	std::unordered_map<uint32_t, uint32_t> lastDelivered;  ///< Game time each key was last delivered at.
+	size_t pruneSize = 64;                                  ///< Forget expired keys when there are this many.
+};
+
+/// Counters for one queued event type of one script instance.
+struct ScriptEventStats
+{
+	uint64_t triggered = 0;     ///< Events triggered for the instance, queued or not.
+	uint64_t delivered = 0;     ///< Events run.
+	uint64_t coalesced = 0;     ///< Events dropped, since one for the same object was delivered within the coalescing window.
+	uint64_t stale = 0;         ///< Events dropped, since an object they refer to was freed before the end of the tick.
+	uint64_t time = 0;          ///< Total time taken to run the delivered events, in microseconds.
+	uint32_t worst = 0;         ///< Longest time taken by a single event, in microseconds.
+	uint32_t largestBatch = 0;  ///< Most events queued in one tick.
+};
+
+#endif // __INCLUDED_SRC_SCRIPTEVENTS_H__
@@ -0,0 +1,95 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Interned stat text ids, see statids.h.
+ */
+
+#include "statids.h"
+
+#include <algorithm>
+#include <functional>
+
+StatId StatIdTable::find(std::string_view name) const
+{
+	if (slots.empty())
+	{
+		return STAT_ID_NONE;
+	}
+	const size_t hash = std::hash<std::string_view>{}(name);
+	const size_t mask = slots.size() - 1;
+	for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+	{
+		const StatId id = slots[slot];
+		if (id == STAT_ID_NONE)
+		{
+			return STAT_ID_NONE;
+		}
+		if (hashes[id] == hash && names[id] == name)
+		{
+			return id;
+		}
+	}
+}
+
+StatId StatIdTable::intern(std::string_view name)
+{
+	StatId id = find(name);
+	if (id != STAT_ID_NONE)
+	{
+		return id;
+	}
+	// Keep at most half the slots full, so that unsuccessful lookups stop soon.
+	if ((names.size() + 1) * 2 > slots.size())
+	{
+		rehash(std::max<size_t>(64, slots.size() * 2));
+	}
+	id = static_cast<StatId>(names.size());
+	names.emplace_back(name);
+	hashes.push_back(std::hash<std::string_view>{}(name));
+	const size_t mask = slots.size() - 1;
+	size_t slot = hashes[id] & mask;
+	while (slots[slot] != STAT_ID_NONE)
+	{
+		slot = (slot + 1) & mask;
+	}
+	slots[slot] = id;
+	return id;
+}
+
+void StatIdTable::clear()
+{
+	names.clear();
+	hashes.clear();
+	slots.clear();
+}
+
+void StatIdTable::rehash(size_t slotCount)
+{
+	slots.assign(slotCount, STAT_ID_NONE);
+	const size_t mask = slotCount - 1;
+	for (StatId id = 0; id < names.size(); ++id)
+	{
+		size_t slot = hashes[id] & mask;
+		while (slots[slot] != STAT_ID_NONE)
+		{
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = id;
+	}
+}
@@ -0,0 +1,59 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Interned stat text ids ("MG1Mk1", "R-Wpn-MG1Mk1"), numbered densely in the order they were loaded.
+ *
+ *  Looking a name up takes a string_view, so callers holding a std::string or a char pointer
+ *  do not need to build a WzString (or any other string) first.
+ */
+
+#ifndef __INCLUDED_SRC_STATIDS_H__
+#define __INCLUDED_SRC_STATIDS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+typedef uint32_t StatId;
+static constexpr StatId STAT_ID_NONE = UINT32_MAX;
+
+class StatIdTable
+{
+public:
+	/// The id of name, numbering it after the names interned so far if it is new.
+	StatId intern(std::string_view name);
+	/// The id of name, or STAT_ID_NONE if it was never interned.
+	StatId find(std::string_view name) const;
+	/// The name interned as id.
+	std::string const &name(StatId id) const { return names[id]; }
+	size_t size() const { return names.size(); }
+	/// Forgets all names, so that ids start from 0 again.
+	void clear();
+
+private:
+	void rehash(size_t slotCount);
+
+	std::vector<std::string> names;   ///< By id.
+	std::vector<size_t> hashes;       ///< By id.
+	std::vector<StatId> slots;        ///< Open addressing, power of two size, STAT_ID_NONE if empty.
+};
+
+#endif // __INCLUDED_SRC_STATIDS_H__
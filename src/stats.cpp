@@ -68,8 +68,9 @@ UBYTE		*apCompLists[MAX_PLAYERS][COMP_NUMCOMPONENTS];
 //store for each players Structure states
 UBYTE		*apStructTypeLists[MAX_PLAYERS];
 
-static std::unordered_map<WzString, BASE_STATS *> lookupStatPtr;
-static std::unordered_map<WzString, COMPONENT_STATS *> lookupCompStatPtr;
+static StatIdTable statIds;  ///< Text ids of the component and structure stats
+static std::vector<BASE_STATS *> lookupStatPtr;  ///< By StatId, null if not loaded
+static std::vector<COMPONENT_STATS *> lookupCompStatPtr;  ///< By StatId, null if not a loaded component
 static size_t statModelLoadingFailures = 0;
 
 static bool getMovementModel(const WzString &movementModel, MOVEMENT_MODEL *model);
@@ -105,6 +106,7 @@ static void deallocTerrainTable()
 /*Deallocate all the stats assigned from input data*/
 bool statsShutDown()
 {
+	statIds.clear();
 	lookupStatPtr.clear();
 	lookupCompStatPtr.clear();
 
@@ -271,13 +273,23 @@ static iIMDBaseShape *statsGetIMD(WzConfig &json, BASE_STATS *psStats, const WzS
 	return retval;
 }
 
-static void loadStats(WzConfig &json, BASE_STATS *psStats, size_t index)
+static StatId loadStats(WzConfig &json, BASE_STATS *psStats, size_t index)
 {
 	psStats->id = json.group();
 	psStats->name = json.string("name");
 	psStats->index = index;
-	ASSERT(lookupStatPtr.find(psStats->id) == lookupStatPtr.end(), "Duplicate ID found! (%s)", psStats->id.toUtf8().c_str());
-	lookupStatPtr.insert(std::make_pair(psStats->id, psStats));
+	const StatId statId = statIds.intern(psStats->id.toUtf8());
+	if (statId >= lookupStatPtr.size())
+	{
+		lookupStatPtr.resize(statId + 1, nullptr);
+		lookupCompStatPtr.resize(statId + 1, nullptr);
+	}
+	ASSERT(lookupStatPtr[statId] == nullptr, "Duplicate ID found! (%s)", psStats->id.toUtf8().c_str());
+	if (lookupStatPtr[statId] == nullptr)
+	{
+		lookupStatPtr[statId] = psStats;
+	}
+	return statId;
 }
 
 void loadStructureStats_BaseStats(WzConfig &json, STRUCTURE_STATS *psStats, size_t index)
@@ -287,13 +299,20 @@ void loadStructureStats_BaseStats(WzConfig &json, STRUCTURE_STATS *psStats, size
 
 void unloadStructureStats_BaseStats(const STRUCTURE_STATS &psStats)
 {
-	lookupStatPtr.erase(psStats.id);
+	const StatId statId = statIds.find(psStats.id.toUtf8());
+	if (statId < lookupStatPtr.size())
+	{
+		lookupStatPtr[statId] = nullptr;
+	}
 }
 
 static void loadCompStats(WzConfig &json, COMPONENT_STATS *psStats, size_t index)
 {
-	loadStats(json, psStats, index);
-	lookupCompStatPtr.insert(std::make_pair(psStats->id, psStats));
+	const StatId statId = loadStats(json, psStats, index);
+	if (lookupCompStatPtr[statId] == nullptr)
+	{
+		lookupCompStatPtr[statId] = psStats;
+	}
 	psStats->buildPower = json.value("buildPower", 0).toUInt();
 	psStats->buildPoints = json.value("buildPoints", 0).toUInt();
 	psStats->designable = json.value("designable", false).toBool();
@@ -1350,15 +1369,16 @@ int getCompFromName(COMPONENT_TYPE compType, const WzString &name)
 
 int getCompFromID(COMPONENT_TYPE compType, const WzString &name)
 {
-	COMPONENT_STATS *psComp = nullptr;
-	auto it = lookupCompStatPtr.find(WzString::fromUtf8(name.toUtf8().c_str()));
-	if (it != lookupCompStatPtr.end())
-	{
-		psComp = it->second;
-	}
-	ASSERT_OR_RETURN(-1, psComp, "No such component ID [%s] found", name.toUtf8().c_str());
-	ASSERT_OR_RETURN(-1, compType == psComp->compType, "Wrong component type for ID %s", name.toUtf8().c_str());
-	ASSERT_OR_RETURN(-1, psComp->index <= INT_MAX, "Component index is too large for ID %s", name.toUtf8().c_str());
+	return getCompFromName(compType, std::string_view(name.toUtf8()));
+}
+
+int getCompFromName(COMPONENT_TYPE compType, std::string_view name)
+{
+	COMPONENT_STATS *psComp = getCompStatsFromId(statIds.find(name));
+	const int nameLength = static_cast<int>(name.size());
+	ASSERT_OR_RETURN(-1, psComp, "No such component ID [%.*s] found", nameLength, name.data());
+	ASSERT_OR_RETURN(-1, compType == psComp->compType, "Wrong component type for ID %.*s", nameLength, name.data());
+	ASSERT_OR_RETURN(-1, psComp->index <= INT_MAX, "Component index is too large for ID %.*s", nameLength, name.data());
 	return static_cast<int>(psComp->index);
 }
 
@@ -1366,32 +1386,27 @@ int getCompFromID(COMPONENT_TYPE compType, const WzString &name)
 /// Returns NULL if record not found
 COMPONENT_STATS *getCompStatsFromName(const WzString &name)
 {
-	COMPONENT_STATS *psComp = nullptr;
-	auto it = lookupCompStatPtr.find(name);
-	if (it != lookupCompStatPtr.end())
-	{
-		psComp = it->second;
-	}
-	/*if (!psComp)
-	{
-		debug(LOG_ERROR, "Not found: %s", name.toUtf8().c_str());
-		for (auto& it2 : lookupCompStatPtr)
-		{
-			debug(LOG_ERROR, "    %s", it2.second->id.toUtf8().c_str());
-		}
-	}*/
-	return psComp;
+	return getCompStatsFromId(statIds.find(name.toUtf8()));
 }
 
 BASE_STATS *getBaseStatsFromName(const WzString &name)
 {
-	BASE_STATS *psStat = nullptr;
-	auto it = lookupStatPtr.find(name);
-	if (it != lookupStatPtr.end())
-	{
-		psStat = it->second;
-	}
-	return psStat;
+	return getBaseStatsFromId(statIds.find(name.toUtf8()));
+}
+
+StatId getStatIdFromName(std::string_view name)
+{
+	return statIds.find(name);
+}
+
+BASE_STATS *getBaseStatsFromId(StatId id)
+{
+	return id < lookupStatPtr.size() ? lookupStatPtr[id] : nullptr;
+}
+
+COMPONENT_STATS *getCompStatsFromId(StatId id)
+{
+	return id < lookupCompStatPtr.size() ? lookupCompStatPtr[id] : nullptr;
 }
 
 /*sets the store to the body size based on the name passed in - returns false
@@ -25,10 +25,12 @@
 
 #include "lib/framework/wzconfig.h"
 
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "objectdef.h"
+#include "statids.h"
 
 /**************************************************************************************
  *
@@ -155,6 +157,9 @@ int getCompFromName(COMPONENT_TYPE compType, const WzString &name);
 /// This function only allows you to use the old, deprecated ID name.
 int getCompFromID(COMPONENT_TYPE compType, const WzString &name);
 
+/// As getCompFromName, for names which are not already WzStrings.
+int getCompFromName(COMPONENT_TYPE compType, std::string_view name);
+
 /// Get the component pointer for a component based on the name
 COMPONENT_STATS *getCompStatsFromName(const WzString &name);
 
@@ -164,6 +169,19 @@ STRUCTURE_STATS *getStructStatsFromName(const WzString &name);
 /// Get the base stat pointer for a stat based on the name
 BASE_STATS *getBaseStatsFromName(const WzString &name);
 
+/// Get the interned id of a component or structure stat based on the name, or STAT_ID_NONE.
+/// Takes any string without converting it, so look the id up once and keep it where a name is used repeatedly.
+StatId getStatIdFromName(std::string_view name);
+
+/// Get the base stat pointer for an interned id, or NULL
+BASE_STATS *getBaseStatsFromId(StatId id);
+
+/// Get the component pointer for an interned id, or NULL if it is not a component
+COMPONENT_STATS *getCompStatsFromId(StatId id);
+
+/// Get the structure pointer for an interned id, or NULL if it is not a structure
+STRUCTURE_STATS *getStructStatsFromId(StatId id);
+
 /*returns the weapon sub class based on the string name passed in */
 bool getWeaponSubClass(const char *subClass, WEAPON_SUBCLASS *wclass);
 const char *getWeaponSubClass(WEAPON_SUBCLASS wclass);
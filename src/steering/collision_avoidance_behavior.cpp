@@ -25,6 +25,7 @@
 
 #include "collision_avoidance_behavior.h"
 #include "steering.h"
+#include "neighbour_table.h"
 #include "utils.h" // for PRECISION
 
 #include "lib/framework/trig.h"
@@ -44,12 +45,78 @@
 namespace steering
 {
 
-SteeringForce CollisionAvoidanceBehavior::calculate(const SteeringContext& ctx)
+namespace
+{
+
+// Avoidance directions summed over the obstacles found so far
+struct ObstacleSum
 {
 	int32_t numObstacles = 0;
 	int32_t distTotal = 0;
-	Vector2i totalDir(0, 0);
+	Vector2i totalDir = {0, 0};
+};
+
+} // anonymous namespace
+
+// Neighbour table of the current game tick, see `CollisionAvoidanceBehavior::buildNeighbourTable()`
+static NeighbourTable neighbourTable;
+static bool neighbourTableBuilt = false;
 
+static bool isInRadius(const Vector2i& diff, int32_t radius)
+{
+	// Same test as the grid, cast to int64 to avoid integer overflow
+	return static_cast<int64_t>(diff.x) * diff.x + static_cast<int64_t>(diff.y) * diff.y <= static_cast<int64_t>(radius) * radius;
+}
+
+// Add the avoidance direction of an obstacle, given its radius, propulsion and estimated velocity.
+static void addObstacle(const SteeringContext& ctx, const Vector2i& toTarget, const DROID* obstacle, int32_t obstacleRadius,
+                        PROPULSION_TYPE obstaclePropulsion, const Vector2i& obstacleVel, ObstacleSum& sum)
+{
+	int32_t combinedRadius = ctx.radius + obstacleRadius;
+
+	// Find the guessed obstacle speed and direction, clamped to half our speed.
+	int32_t obstacleSpeedGuess = std::min(iHypot(obstacleVel), ctx.maxSpeed / 2);
+	uint16_t obstDirectionGuess = iAtan2(obstacleVel);
+
+	// Position of obstacle relative to us
+	Vector2i obstaclePos = obstacle->pos.xy();
+	Vector2i diff = obstaclePos - ctx.currentPos;
+
+	// Predict where the obstacle will be when we get close
+	int32_t distToObstacle = iHypot(diff);
+	// Find very approximate position of obstacle relative to us when we get close, based on our guesses.
+	int64_t predictionFactor = std::max(distToObstacle - combinedRadius * 2 / 3, 0) * obstacleSpeedGuess / ctx.maxSpeed;
+	Vector2i deltaDiff = iSinCosR(obstDirectionGuess, predictionFactor);
+
+	// Don't assume obstacle can go through blocking tiles
+	if (!fpathBlockingTile(gameWorld.map, map_coord(obstacle->pos.x + deltaDiff.x),
+	                       map_coord(obstacle->pos.y + deltaDiff.y),
+	                       obstaclePropulsion))
+	{
+		diff += deltaDiff;
+	}
+
+	// Check if obstacle is ahead of us (in direction of movement)
+	if (dot(diff, toTarget) < 0)
+	{
+		// Object is behind us relative to target
+		return;
+	}
+
+	// Calculate distance metrics
+	int32_t centreDist = std::max(iHypot(diff), 1);
+	int32_t effectiveDist = std::max(centreDist - combinedRadius, 1);
+
+	// Accumulate avoidance direction
+	// The formula: diff * PRECISION / (centreDist * effectiveDist)
+	// This gives more weight to closer obstacles
+	sum.totalDir += diff * PRECISION / (centreDist * effectiveDist);
+	sum.distTotal += PRECISION / effectiveDist;
+	++sum.numObstacles;
+}
+
+SteeringForce CollisionAvoidanceBehavior::calculate(const SteeringContext& ctx)
+{
 	// Can't avoid anything if we can't move
 	if (ctx.maxSpeed == 0)
 	{
@@ -59,82 +126,65 @@ SteeringForce CollisionAvoidanceBehavior::calculate(const SteeringContext& ctx)
 	// Vector to target (for blending)
 	Vector2i toTarget = ctx.targetPos - ctx.currentPos;
 
-	// Scan nearby objects for obstacles
-	static GridList gridList;  // static to avoid allocations
-	gridList = gridStartIterate(ctx.currentPos.x, ctx.currentPos.y, OBSTACLE_SCAN_RADIUS);
-	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
+	ObstacleSum sum;
+	if (neighbourTableBuilt)
 	{
-		BASE_OBJECT* obj = *gi;
-
-		// Skip invalid obstacles
-		if (!isValidObstacle(obj, ctx.droid))
-		{
-			continue;
-		}
-
-		DROID* obstacle = castDroid(obj);
-		if (!obstacle)
-		{
-			continue;
-		}
-
-		// Get obstacle properties
-		PROPULSION_STATS* obstaclePropStats = obstacle->getPropulsionStats();
-		int32_t obstacleRadius = moveObjRadius(obstacle);
-		int32_t combinedRadius = ctx.radius + obstacleRadius;
-
-		// Estimate obstacle velocity
-		Vector2i obstacleVel = estimateObstacleVelocity(obstacle);
-		// Find the guessed obstacle speed and direction, clamped to half our speed.
-		int32_t obstacleSpeedGuess = std::min(iHypot(obstacleVel), ctx.maxSpeed / 2);
-		uint16_t obstDirectionGuess = iAtan2(obstacleVel);
-
-		// Position of obstacle relative to us
-		Vector2i obstaclePos = obstacle->pos.xy();
-		Vector2i diff = obstaclePos - ctx.currentPos;
-
-		// Predict where the obstacle will be when we get close
-		int32_t distToObstacle = iHypot(diff);
-		// Find very approximate position of obstacle relative to us when we get close, based on our guesses.
-		int64_t predictionFactor = std::max(distToObstacle - combinedRadius * 2 / 3, 0) * obstacleSpeedGuess / ctx.maxSpeed;
-		Vector2i deltaDiff = iSinCosR(obstDirectionGuess, predictionFactor);
-
-		// Don't assume obstacle can go through blocking tiles
-		if (!fpathBlockingTile(gameWorld.map, map_coord(obstacle->pos.x + deltaDiff.x),
-		                       map_coord(obstacle->pos.y + deltaDiff.y),
-		                       obstaclePropStats->propulsionType))
+		// Scan the neighbour table for obstacles. Finds the same obstacles as the grid, in the same order.
+		static std::vector<uint32_t> neighbours;  // static to avoid allocations
+		neighbourTable.query(ctx.currentPos.x, ctx.currentPos.y, OBSTACLE_SCAN_RADIUS, neighbours);
+		const bool isVtol = ctx.droid->isVtol();
+		for (uint32_t index : neighbours)
 		{
-			diff += deltaDiff;
+			Neighbour& neighbour = neighbourTable[index];
+			DROID* obstacle = neighbour.droid;
+
+			// Skip ourselves, and the same obstacles as `isValidObstacle()`. Transporters aren't in the table.
+			if (obstacle == ctx.droid || neighbour.isVtol != isVtol
+			    || (neighbour.isPerson && obstacle->player != ctx.droid->player)
+			    || !isInRadius(obstacle->pos.xy() - ctx.currentPos, OBSTACLE_SCAN_RADIUS))
+			{
+				continue;
+			}
+
+			addObstacle(ctx, toTarget, obstacle, neighbour.radius, static_cast<PROPULSION_TYPE>(neighbour.propulsionType),
+			            estimateObstacleVelocity(neighbour), sum);
 		}
-
-		// Check if obstacle is ahead of us (in direction of movement)
-		if (dot(diff, toTarget) < 0)
+	}
+	else
+	{
+		// Scan nearby objects for obstacles
+		static GridList gridList;  // static to avoid allocations
+		gridList = gridStartIterate(ctx.currentPos.x, ctx.currentPos.y, OBSTACLE_SCAN_RADIUS);
+		for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 		{
-			// Object is behind us relative to target
-			continue;
+			BASE_OBJECT* obj = *gi;
+
+			// Skip invalid obstacles
+			if (!isValidObstacle(obj, ctx.droid))
+			{
+				continue;
+			}
+
+			DROID* obstacle = castDroid(obj);
+			if (!obstacle)
+			{
+				continue;
+			}
+
+			addObstacle(ctx, toTarget, obstacle, moveObjRadius(obstacle), obstacle->getPropulsionStats()->propulsionType,
+			            estimateObstacleVelocity(obstacle), sum);
 		}
-
-		// Calculate distance metrics
-		int32_t centreDist = std::max(iHypot(diff), 1);
-		int32_t effectiveDist = std::max(centreDist - combinedRadius, 1);
-
-		// Accumulate avoidance direction
-		// The formula: diff * PRECISION / (centreDist * effectiveDist)
-		// This gives more weight to closer obstacles
-		totalDir += diff * PRECISION / (centreDist * effectiveDist);
-		distTotal += PRECISION / effectiveDist;
-		++numObstacles;
 	}
 
 	// No obstacles to avoid
-	if ((totalDir.x == 0 && totalDir.y == 0) || numObstacles == 0)
+	if ((sum.totalDir.x == 0 && sum.totalDir.y == 0) || sum.numObstacles == 0)
 	{
 		return SteeringForce(Vector2i(0, 0), 0);
 	}
 
 	// Average the accumulated direction
-	totalDir = Vector2i(totalDir.x / numObstacles, totalDir.y / numObstacles);
-	distTotal /= numObstacles;
+	Vector2i totalDir = Vector2i(sum.totalDir.x / sum.numObstacles, sum.totalDir.y / sum.numObstacles);
+	int32_t distTotal = sum.distTotal / sum.numObstacles;
 
 	// Create perpendicular avoid vector (choose side toward target)
 	Vector2i perp = orthogonalCW(totalDir);
@@ -160,6 +210,41 @@ SteeringForce CollisionAvoidanceBehavior::calculate(const SteeringContext& ctx)
 	return SteeringForce(result, weight);
 }
 
+void CollisionAvoidanceBehavior::buildNeighbourTable()
+{
+	neighbourTable.clear();
+	for (size_t i = 0; i < gridSize(); ++i)
+	{
+		DROID* droid = castDroid(gridObjectAt(i));
+		// Transporters are never obstacles
+		if (!droid || droid->isTransporter())
+		{
+			continue;
+		}
+
+		const PROPULSION_STATS* propStats = droid->getPropulsionStats();
+		const Vector2i pos = gridPositionAt(i);
+		Neighbour neighbour;
+		neighbour.droid = droid;
+		neighbour.x = pos.x;
+		neighbour.y = pos.y;
+		neighbour.radius = moveObjRadius(droid);
+		neighbour.maxSpeed = propStats->maxSpeed;
+		neighbour.propulsionType = static_cast<uint8_t>(propStats->propulsionType);
+		neighbour.isVtol = droid->isVtol();
+		neighbour.isPerson = droid->droidType == DROID_PERSON;
+		neighbourTable.add(neighbour);
+	}
+	neighbourTable.build();
+	neighbourTableBuilt = true;
+}
+
+void CollisionAvoidanceBehavior::clearNeighbourTable()
+{
+	neighbourTable.clear();
+	neighbourTableBuilt = false;
+}
+
 bool CollisionAvoidanceBehavior::isEnabled(const SteeringContext& ctx) const
 {
 	if (!ctx.droid)
@@ -170,22 +255,25 @@ bool CollisionAvoidanceBehavior::isEnabled(const SteeringContext& ctx) const
 	return !ctx.droid->isTransporter();
 }
 
-Vector2i CollisionAvoidanceBehavior::estimateObstacleVelocity(DROID* obstacle)
+void CollisionAvoidanceBehavior::guessObstacleVelocities(const DROID* obstacle, int32_t maxSpeed, Vector2i& moving, Vector2i& intended)
 {
 	// Velocity guess 1: Guess the velocity the droid is actually moving at.
-	Vector2i velocityGuess1 = iSinCosR(obstacle->sMove.moveDir, obstacle->sMove.speed);
+	moving = iSinCosR(obstacle->sMove.moveDir, obstacle->sMove.speed);
 
 	// Velocity guess 2: Guess the velocity the droid wants to move at.
 	Vector2i obstaclePos = obstacle->pos.xy();
 	Vector2i targetDiff = obstacle->sMove.target - obstaclePos;
 	int32_t targetDist = iHypot(targetDiff);
 
-	const PROPULSION_STATS* propStats = obstacle->getPropulsionStats();
-	int32_t maxSpeed = propStats->maxSpeed;
-
 	// Scale intended speed by distance (slower when close to target)
 	int32_t intendedSpeed = maxSpeed * std::min(targetDist, OBSTACLE_SCAN_RADIUS) / OBSTACLE_SCAN_RADIUS;
-	Vector2i velocityGuess2 = iSinCosR(iAtan2(targetDiff), intendedSpeed);
+	intended = iSinCosR(iAtan2(targetDiff), intendedSpeed);
+}
+
+Vector2i CollisionAvoidanceBehavior::estimateObstacleVelocity(DROID* obstacle)
+{
+	Vector2i velocityGuess1, velocityGuess2;
+	guessObstacleVelocities(obstacle, obstacle->getPropulsionStats()->maxSpeed, velocityGuess1, velocityGuess2);
 
 	// If blocked, assume no intended movement
 	if (moveBlocked(obstacle))
@@ -197,6 +285,39 @@ Vector2i CollisionAvoidanceBehavior::estimateObstacleVelocity(DROID* obstacle)
 	return (velocityGuess1 + velocityGuess2) / 2;
 }
 
+Vector2i CollisionAvoidanceBehavior::estimateObstacleVelocity(Neighbour& neighbour)
+{
+	// The guesses only change when the droid moves, or changes its target, direction or speed
+	const DROID* obstacle = neighbour.droid;
+	Neighbour::VelocityGuess& guess = neighbour.velocity;
+	if (!guess.valid || guess.posX != obstacle->pos.x || guess.posY != obstacle->pos.y
+	    || guess.targetX != obstacle->sMove.target.x || guess.targetY != obstacle->sMove.target.y
+	    || guess.moveDir != obstacle->sMove.moveDir || guess.speed != obstacle->sMove.speed)
+	{
+		Vector2i moving, intended;
+		guessObstacleVelocities(obstacle, neighbour.maxSpeed, moving, intended);
+		guess.valid = true;
+		guess.posX = obstacle->pos.x;
+		guess.posY = obstacle->pos.y;
+		guess.targetX = obstacle->sMove.target.x;
+		guess.targetY = obstacle->sMove.target.y;
+		guess.moveDir = obstacle->sMove.moveDir;
+		guess.speed = obstacle->sMove.speed;
+		guess.movingX = moving.x;
+		guess.movingY = moving.y;
+		guess.intendedX = intended.x;
+		guess.intendedY = intended.y;
+	}
+
+	// moveBlocked() may clear the droid's bump, or reroute it, so is still called every time, like above.
+	Vector2i velocityGuess2(guess.intendedX, guess.intendedY);
+	if (moveBlocked(neighbour.droid))
+	{
+		velocityGuess2 = Vector2i(0, 0);
+	}
+	return (Vector2i(guess.movingX, guess.movingY) + velocityGuess2) / 2;
+}
+
 bool CollisionAvoidanceBehavior::isValidObstacle(const BASE_OBJECT* obj, const DROID* ourDroid)
 {
 	// Skip ourselves
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "steering.h"
+#include "neighbour_table.h"
 #include "lib/framework/vector.h"
 #include "lib/wzmaplib/include/wzmaplib/map.h"  // For TILE_UNITS
 
@@ -70,6 +71,18 @@ public:
 	// Disabled for transporters (they have their own movement logic).
 	bool isEnabled(const SteeringContext& ctx) const override;
 
+	/// <summary>
+	/// Build the neighbour table for this game tick, from the droids in the grid.
+	///
+	/// Call after `gridReset()`, before droids move. Until `clearNeighbourTable()`,
+	/// obstacles are then found in the table instead of by a grid query per droid,
+	/// with the same result.
+	/// </summary>
+	static void buildNeighbourTable();
+
+	/// Go back to finding obstacles by grid queries.
+	static void clearNeighbourTable();
+
 private:
 
 	/// <summary>
@@ -77,12 +90,29 @@ private:
 	///
 	/// Uses two guesses:
 	/// 1. Actual velocity (moveDir * speed)
-	/// 2. Intended velocity (toward target)
+	/// 2. Intended velocity (toward target), or none if the obstacle is blocked
 	/// </summary>
 	/// <param name="obstacle">The obstacle droid</param>
 	/// <returns>Estimated velocity vector</returns>
 	static Vector2i estimateObstacleVelocity(DROID* obstacle);
 
+	/// <summary>
+	/// Estimate obstacle velocity, as above, reusing the guesses stored in the
+	/// neighbour table while the obstacle's movement hasn't changed.
+	/// </summary>
+	/// <param name="neighbour">The obstacle's entry in the neighbour table</param>
+	/// <returns>Estimated velocity vector</returns>
+	static Vector2i estimateObstacleVelocity(Neighbour& neighbour);
+
+	/// <summary>
+	/// Make both velocity guesses for an obstacle, without checking whether it is blocked.
+	/// </summary>
+	/// <param name="obstacle">The obstacle droid</param>
+	/// <param name="maxSpeed">Max speed from the obstacle's propulsion stats</param>
+	/// <param name="moving">Receives the velocity the obstacle is moving at</param>
+	/// <param name="intended">Receives the velocity the obstacle wants to move at</param>
+	static void guessObstacleVelocities(const DROID* obstacle, int32_t maxSpeed, Vector2i& moving, Vector2i& intended);
+
 	/// <summary>
 	/// Check if an object is a valid obstacle for collision avoidance.
 	/// </summary>
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/**
+ * @file neighbour_table.cpp
+ * Per-tick neighbour table implementation.
+ */
+
+#include "neighbour_table.h"
+
+#include <algorithm>
+
+namespace steering
+{
+
+void NeighbourTable::clear()
+{
+	_neighbours.clear();
+	_cellNeighbours.clear();
+	_originX = 0;
+	_originY = 0;
+	_cellShift = CELL_SHIFT;
+	_cellsX = 1;
+	_cellsY = 1;
+	_cellStart.assign(2, 0);
+}
+
+uint32_t NeighbourTable::add(const Neighbour& neighbour)
+{
+	_neighbours.push_back(neighbour);
+	return static_cast<uint32_t>(_neighbours.size() - 1);
+}
+
+void NeighbourTable::build()
+{
+	if (_neighbours.empty())
+	{
+		clear();
+		return;
+	}
+
+	int32_t minX = _neighbours[0].x, maxX = minX;
+	int32_t minY = _neighbours[0].y, maxY = minY;
+	for (const auto& n : _neighbours)
+	{
+		minX = std::min(minX, n.x);
+		maxX = std::max(maxX, n.x);
+		minY = std::min(minY, n.y);
+		maxY = std::max(maxY, n.y);
+	}
+	_originX = minX;
+	_originY = minY;
+	const int64_t extent = std::max(static_cast<int64_t>(maxX) - minX, static_cast<int64_t>(maxY) - minY);
+	_cellShift = CELL_SHIFT;
+	while ((extent >> _cellShift) >= MAX_CELLS)
+	{
+		++_cellShift;
+	}
+	_cellsX = static_cast<int>((static_cast<int64_t>(maxX) - minX) >> _cellShift) + 1;
+	_cellsY = static_cast<int>((static_cast<int64_t>(maxY) - minY) >> _cellShift) + 1;
+
+	// Counting sort, so that each cell stays in the order the neighbours were added
+	_cellStart.assign(static_cast<size_t>(_cellsX) * _cellsY + 1, 0);
+	for (const auto& n : _neighbours)
+	{
+		++_cellStart[cellX(n.x) + cellY(n.y) * _cellsX + 1];
+	}
+	for (size_t c = 1; c < _cellStart.size(); ++c)
+	{
+		_cellStart[c] += _cellStart[c - 1];
+	}
+	_cellNeighbours.resize(_neighbours.size());
+	std::vector<uint32_t> next(_cellStart.begin(), _cellStart.end() - 1);
+	for (uint32_t i = 0; i < _neighbours.size(); ++i)
+	{
+		_cellNeighbours[next[cellX(_neighbours[i].x) + cellY(_neighbours[i].y) * _cellsX]++] = i;
+	}
+}
+
+void NeighbourTable::query(int32_t x, int32_t y, int32_t radius, std::vector<uint32_t>& results) const
+{
+	results.clear();
+	const int64_t minX = static_cast<int64_t>(x) - radius, maxX = static_cast<int64_t>(x) + radius;
+	const int64_t minY = static_cast<int64_t>(y) - radius, maxY = static_cast<int64_t>(y) + radius;
+	const int cx0 = cellX(minX), cx1 = cellX(maxX);
+	const int cy0 = cellY(minY), cy1 = cellY(maxY);
+	for (int cy = cy0; cy <= cy1; ++cy)
+	{
+		for (int cx = cx0; cx <= cx1; ++cx)
+		{
+			const int cell = cx + cy * _cellsX;
+			for (uint32_t n = _cellStart[cell]; n != _cellStart[cell + 1]; ++n)
+			{
+				const uint32_t i = _cellNeighbours[n];
+				const Neighbour& neighbour = _neighbours[i];
+				if (neighbour.x >= minX && neighbour.x <= maxX && neighbour.y >= minY && neighbour.y <= maxY)
+				{
+					results.push_back(i);
+				}
+			}
+		}
+	}
+	std::sort(results.begin(), results.end());
+}
+
+int NeighbourTable::cellX(int64_t x) const
+{
+	return static_cast<int>(std::min<int64_t>(std::max<int64_t>((x - _originX) >> _cellShift, 0), _cellsX - 1));
+}
+
+int NeighbourTable::cellY(int64_t y) const
+{
+	return static_cast<int>(std::min<int64_t>(std::max<int64_t>((y - _originY) >> _cellShift, 0), _cellsY - 1));
+}
+
+} // namespace steering
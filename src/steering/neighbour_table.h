@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/**
+ * @file neighbour_table.h
+ * Per-tick table of the droids steering behaviors need to avoid.
+ *
+ * Built once per game tick, it keeps what does not change during the tick
+ * (radius, propulsion) next to each droid, sorted into cells of the map,
+ * so that the neighbours of a droid can be found without a grid query per
+ * droid, and without looking up the stats of each neighbour.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DROID;
+
+namespace steering
+{
+
+/// <summary>
+/// A droid in the `NeighbourTable`.
+/// </summary>
+struct Neighbour
+{
+	DROID* droid = nullptr;
+	// Position when the table was built, which finds the neighbour
+	int32_t x = 0;
+	int32_t y = 0;
+	// Collision radius
+	int32_t radius = 0;
+	// Max speed from the droid's propulsion stats
+	int32_t maxSpeed = 0;
+	uint8_t propulsionType = 0;
+	bool isVtol = false;
+	bool isPerson = false;
+
+	/// <summary>
+	/// Last velocity guesses made for the droid, with the state they were made from.
+	/// Only valid while the droid's position, target, direction and speed are unchanged.
+	/// </summary>
+	struct VelocityGuess
+	{
+		bool valid = false;
+		int32_t posX = 0, posY = 0;
+		int32_t targetX = 0, targetY = 0;
+		uint16_t moveDir = 0;
+		int32_t speed = 0;
+		// Velocity the droid is moving at
+		int32_t movingX = 0, movingY = 0;
+		// Velocity the droid wants to move at, if not blocked
+		int32_t intendedX = 0, intendedY = 0;
+	} velocity;
+};
+
+/// <summary>
+/// Spatial index over the droids of one game tick.
+///
+/// Neighbours are added in any order, then `build()` sorts them into cells
+/// by counting sort. Queries return neighbour indices in the order the
+/// neighbours were added.
+/// </summary>
+class NeighbourTable
+{
+public:
+	/// Cells are 256x256 world units (2x2 tiles), or bigger if there would be more than MAX_CELLS of them across.
+	static constexpr int CELL_SHIFT = 8;
+	static constexpr int MAX_CELLS = 1024;
+
+	/// Remove all neighbours.
+	void clear();
+
+	/// Add a neighbour, returning its index. Call `build()` before querying.
+	uint32_t add(const Neighbour& neighbour);
+
+	/// Sort the neighbours into cells.
+	void build();
+
+	size_t size() const { return _neighbours.size(); }
+	Neighbour& operator [](uint32_t index) { return _neighbours[index]; }
+	const Neighbour& operator [](uint32_t index) const { return _neighbours[index]; }
+
+	/// <summary>
+	/// Find the neighbours whose position is in the square [x - radius, x + radius] x [y - radius, y + radius].
+	/// </summary>
+	/// <param name="results">Receives the neighbour indices, in ascending order</param>
+	void query(int32_t x, int32_t y, int32_t radius, std::vector<uint32_t>& results) const;
+
+private:
+	int cellX(int64_t x) const;
+	int cellY(int64_t y) const;
+
+	std::vector<Neighbour> _neighbours;
+	int32_t _originX = 0;
+	int32_t _originY = 0;
+	int _cellShift = CELL_SHIFT;
+	int _cellsX = 1;
+	int _cellsY = 1;
+	// The neighbours in cell c are _cellNeighbours[_cellStart[c]] to _cellNeighbours[_cellStart[c + 1] - 1]
+	std::vector<uint32_t> _cellStart = std::vector<uint32_t>(2, 0);
+	std::vector<uint32_t> _cellNeighbours;
+};
+
+} // namespace steering
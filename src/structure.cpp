@@ -85,6 +85,7 @@
 #include "keybind.h"
 
 #include "random.h"
+#include "profiling.h"
 #include <functional>
 #include <unordered_map>
 
@@ -106,7 +107,6 @@ UDWORD			researchModuleStat;
 //holder for all StructureStats
 STRUCTURE_STATS		*asStructureStats = nullptr;
 UDWORD				numStructureStats = 0;
-static std::unordered_map<WzString, STRUCTURE_STATS *> lookupStructStatPtr;
 optional<int> structureDamageBaseExperienceLevel;
 
 //used to hold the modifiers cross refd by weapon effect and structureStrength
@@ -314,7 +314,6 @@ void structureInitVars()
 	ASSERT(asStructureStats == nullptr, "Failed to cleanup prior asStructureStats?");
 
 	asStructureStats = nullptr;
-	lookupStructStatPtr.clear();
 	numStructureStats = 0;
 	factoryModuleStat = 0;
 	powerModuleStat = 0;
@@ -744,7 +743,6 @@ bool loadStructureStats(WzConfig &ini)
 
 		ini.endGroup();
 
-		lookupStructStatPtr.insert(std::make_pair(psStats->id, psStats));
 		++statWriteIdx;
 	}
 	numStructureStats = statWriteIdx;
@@ -853,7 +851,6 @@ bool structureStatsShutDown()
 			unloadStructureStats_BaseStats(asStructureStats[i]);
 		}
 	}
-	lookupStructStatPtr.clear();
 	delete[] asStructureStats;
 	asStructureStats = nullptr;
 	numStructureStats = 0;
@@ -3809,6 +3806,7 @@ int gateCurrentOpenHeight(const STRUCTURE *psStructure, uint32_t time, int minim
 /* The main update routine for all Structures */
 void structureUpdate(STRUCTURE *psBuilding, GameWorld& world)
 {
+	WZ_PROFILE_SCOPE(structureUpdate);
 	UDWORD widthScatter, breadthScatter;
 	UDWORD emissionInterval, iPointsToAdd, iPointsRequired;
 	Vector3i dv;
@@ -4865,8 +4863,9 @@ bool destroyStruct(STRUCTURE *psDel, unsigned impactTime, GameWorld& world)
 				MAPTILE *psTile = mapTile(world.map, b.map.x + width, b.map.y + breadth);
 				if (TEST_TILE_VISIBLE_TO_SELECTEDPLAYER(psTile))
 				{
-					psTile->illumination /= 2;
-					psTile->ambientOcclusion /= 2;
+					TileDisplay *psDisplay = mapTileDisplay(world.map, b.map.x + width, b.map.y + breadth);
+					psDisplay->illumination /= 2;
+					psDisplay->ambientOcclusion /= 2;
 				}
 			}
 		}
@@ -4913,13 +4912,13 @@ int32_t getStructStatFromName(const WzString &name)
 
 STRUCTURE_STATS *getStructStatsFromName(const WzString &name)
 {
-	STRUCTURE_STATS *psStat = nullptr;
-	auto it = lookupStructStatPtr.find(name);
-	if (it != lookupStructStatPtr.end())
-	{
-		psStat = it->second;
-	}
-	return psStat;
+	return getStructStatsFromId(getStatIdFromName(name.toUtf8()));
+}
+
+STRUCTURE_STATS *getStructStatsFromId(StatId id)
+{
+	BASE_STATS *psStat = getBaseStatsFromId(id);
+	return psStat != nullptr && psStat->hasType(STAT_STRUCTURE) ? static_cast<STRUCTURE_STATS *>(psStat) : nullptr;
 }
 
 /*check to see if the structure is 'doing' anything  - return true if idle*/
@@ -6162,6 +6161,7 @@ void hqReward(GameWorld& world, UBYTE losingPlayer, UBYTE rewardPlayer)
 			}
 		}
 	}
+	gridInvalidateVisibility();
 
 	//feature
 	for (FEATURE *psFeat : world.objects.features[0])
@@ -7017,6 +7017,7 @@ STRUCTURE *giftSingleStructure(STRUCTURE *psStructure, UBYTE attackPlayer, bool
 			//since the structure isn't being rebuilt, the visibility code needs to be adjusted
 			//make sure this structure is visible to selectedPlayer
 			psStructure->visible[attackPlayer] = UINT8_MAX;
+			gridInvalidateVisibility();
 			triggerEventObjectTransfer(psStructure, originalPlayer);
 		}
 		intNotifyResearchButton(prevState);
@@ -522,7 +522,7 @@ static TileDecalInfo getTileDecalInfo(WorldMapState& mapState, int i, int j)
 	static const int dxdy[4][2] = {{0,0}, {0,1}, {1,1}, {1,0}};
 	for (int k = 0; k < 4; k++)
 	{
-		groundsBytes[k] = mapTile(mapState, i + dxdy[k][0], j + dxdy[k][1])->ground;
+		groundsBytes[k] = mapTileDisplay(mapState, i + dxdy[k][0], j + dxdy[k][1])->ground;
 	}
 	PIELIGHT grounds;
 	grounds.fromRGBA(groundsBytes[0], groundsBytes[1], groundsBytes[2], groundsBytes[3]);
@@ -1785,7 +1785,7 @@ static void updateLightMap(WorldMapState& mapState, const LightMap& lightmap)
 		{
 			MAPTILE *psTile = mapTile(mapState, i, j);
 			PIELIGHT colour = lightmap(i, j);
-			UBYTE level = static_cast<UBYTE>(psTile->level);
+			UBYTE level = static_cast<UBYTE>(mapTileDisplay(mapState, i, j)->level);
 
 			if (psTile->tileInfoBits & BITS_GATEWAY && showGateways)
 			{
@@ -0,0 +1,167 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Built in latency histograms, see tickprofiler.h.
+ */
+
+#include "tickprofiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace profiling {
+
+std::atomic<bool> tickProfilerActive{false};
+
+static std::mutex histogramsMutex;
+static std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+
+size_t LatencyHistogram::bucketIndex(uint64_t ns)
+{
+	if (ns < 8)
+	{
+		return static_cast<size_t>(ns);
+	}
+	const unsigned exponent = 63 - std::countl_zero(ns);  // At least 3
+	const unsigned sub = static_cast<unsigned>(ns >> (exponent - 3)) & 7;
+	return 8 + (exponent - 3) * 8 + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperNs(size_t index)
+{
+	if (index < 8)
+	{
+		return index;
+	}
+	const unsigned shift = static_cast<unsigned>((index - 8) / 8);
+	const uint64_t lower = (8 + (index - 8) % 8) << shift;
+	return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+	counts[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+	total.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(ns, std::memory_order_relaxed);
+	uint64_t seen = max.load(std::memory_order_relaxed);
+	while (ns > seen && !max.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+	seen = min.load(std::memory_order_relaxed);
+	while (ns < seen && !min.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset()
+{
+	for (auto &bucket : counts)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	total.store(0, std::memory_order_relaxed);
+	sum.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+	min.store(UINT64_MAX, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::minNs() const
+{
+	const uint64_t value = min.load(std::memory_order_relaxed);
+	return value == UINT64_MAX ? 0 : value;
+}
+
+uint64_t LatencyHistogram::percentileNs(double fraction) const
+{
+	uint64_t bucketTotal = 0;
+	for (auto const &bucket : counts)
+	{
+		bucketTotal += bucket.load(std::memory_order_relaxed);
+	}
+	if (bucketTotal == 0)
+	{
+		return 0;
+	}
+	const double clamped = std::min(std::max(fraction, 0.0), 1.0);
+	const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped * static_cast<double>(bucketTotal) + 0.999999));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < NUM_BUCKETS; ++i)
+	{
+		seen += counts[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+		{
+			return std::min(bucketUpperNs(i), maxNs());
+		}
+	}
+	return maxNs();
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> LatencyHistogram::buckets() const
+{
+	std::vector<std::pair<uint64_t, uint64_t>> result;
+	for (size_t i = 0; i < NUM_BUCKETS; ++i)
+	{
+		const uint64_t count = counts[i].load(std::memory_order_relaxed);
+		if (count != 0)
+		{
+			result.emplace_back(bucketUpperNs(i), count);
+		}
+	}
+	return result;
+}
+
+void setTickProfilerEnabled(bool enabled)
+{
+	tickProfilerActive.store(enabled, std::memory_order_relaxed);
+}
+
+void resetTickProfiler()
+{
+	std::lock_guard<std::mutex> lock(histogramsMutex);
+	for (auto &entry : histograms)
+	{
+		entry.second->reset();
+	}
+}
+
+LatencyHistogram &tickProfilerHistogram(const char *name)
+{
+	std::lock_guard<std::mutex> lock(histogramsMutex);
+	auto &histogram = histograms[name];
+	if (!histogram)
+	{
+		histogram = std::make_unique<LatencyHistogram>();
+	}
+	return *histogram;
+}
+
+std::vector<TickProfileEntry> tickProfilerEntries()
+{
+	std::lock_guard<std::mutex> lock(histogramsMutex);
+	std::vector<TickProfileEntry> entries;
+	for (auto const &entry : histograms)
+	{
+		if (entry.second->count() != 0)
+		{
+			entries.push_back({entry.first, entry.second.get()});
+		}
+	}
+	return entries;
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/** @file
+ *  Built in latency histograms for the WZ_PROFILE_SCOPE scopes, see profiling.h.
+ *
+ *  Switched off, a scope costs a relaxed load and a branch. Switched on, it reads the clock twice and
+ *  adds to a histogram with atomic increments, so scopes may run on any thread.
+ *  Kept apart from profiling.cpp, since it depends on nothing but the standard library.
+ */
+
+#ifndef __INCLUDED_SRC_TICKPROFILER_H__
+#define __INCLUDED_SRC_TICKPROFILER_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace profiling {
+
+/// Counts of durations in nanoseconds, in 8 buckets per power of two, so within 12.5% of the true value.
+class LatencyHistogram
+{
+public:
+	static constexpr size_t NUM_BUCKETS = 8 + 61 * 8;
+
+	void record(uint64_t ns);
+	void reset();
+
+	uint64_t count() const { return total.load(std::memory_order_relaxed); }
+	uint64_t sumNs() const { return sum.load(std::memory_order_relaxed); }
+	uint64_t maxNs() const { return max.load(std::memory_order_relaxed); }
+	/// Smallest duration recorded, 0 if none.
+	uint64_t minNs() const;
+	/// Upper bound of the bucket holding the given fraction (0 to 1) of the durations, at most maxNs().
+	uint64_t percentileNs(double fraction) const;
+	/// The non-empty buckets, as the largest duration each holds and how many durations it holds.
+	std::vector<std::pair<uint64_t, uint64_t>> buckets() const;
+
+	static size_t bucketIndex(uint64_t ns);
+	static uint64_t bucketUpperNs(size_t index);
+
+private:
+	std::atomic<uint64_t> counts[NUM_BUCKETS] = {};
+	std::atomic<uint64_t> total{0};
+	std::atomic<uint64_t> sum{0};
+	std::atomic<uint64_t> max{0};
+	std::atomic<uint64_t> min{UINT64_MAX};
+};
+
+extern std::atomic<bool> tickProfilerActive;
+
+void setTickProfilerEnabled(bool enabled);
+inline bool tickProfilerEnabled() { return tickProfilerActive.load(std::memory_order_relaxed); }
+/// Empties every histogram.
+void resetTickProfiler();
+
+/// The histogram for a scope name, created on first use. Scopes with the same name share it.
+LatencyHistogram &tickProfilerHistogram(const char *name);
+
+struct TickProfileEntry
+{
+	std::string name;
+	LatencyHistogram const *histogram;
+};
+/// Every histogram recorded into since the last reset, sorted by name.
+std::vector<TickProfileEntry> tickProfilerEntries();
+
+/// One per WZ_PROFILE_SCOPE, so that the histogram is looked up once.
+class TickProfileSite
+{
+public:
+	explicit TickProfileSite(const char *name) : histogram(tickProfilerHistogram(name)) {}
+	LatencyHistogram &histogram;
+};
+
+class TickProfileScope
+{
+public:
+	explicit TickProfileScope(TickProfileSite &site)
+	{
+		if (tickProfilerEnabled())
+		{
+			histogram = &site.histogram;
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	~TickProfileScope()
+	{
+		if (histogram != nullptr)
+		{
+			histogram->record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+	}
+	TickProfileScope(TickProfileScope const &) = delete;
+	TickProfileScope &operator=(TickProfileScope const &) = delete;
+
+private:
+	LatencyHistogram *histogram = nullptr;
+	std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#endif // __INCLUDED_SRC_TICKPROFILER_H__
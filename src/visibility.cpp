@@ -30,7 +30,9 @@
 #include "lib/sound/audio_id.h"
 #include "lib/ivis_opengl/ivisdef.h"
 
+#include <bit>
 #include <limits>
+#include <unordered_map>
 
 #include "visibility.h"
 
@@ -118,10 +120,10 @@ void visUpdateLevel()
 	visLevelDec = gameTimeAdjustedAverage(VIS_LEVEL_DEC);
 }
 
-static inline void updateTileVis(MAPTILE *psTile, int player)
+static inline void updateTileVis(MAPTILE *psTile, TileVision const *psVision, int player)
 {
 	/// The definition of whether a player can see something on a given tile or not
-	if (psTile->watchers[player] > 0 || (psTile->sensors[player] > 0 && !(psTile->jammerBits & ~alliancebits[player])))
+	if (psVision->watchers[player] > 0 || (psVision->sensors[player] > 0 && !(psTile->jammerBits & ~alliancebits[player])))
 	{
 		psTile->sensorBits |= (1 << player);         // mark it as being seen
 	}
@@ -147,13 +149,14 @@ static void spotterWatchAndRegister(SPOTTER *psSpot, WorldMapState& mapState, in
 			continue;
 		}
 		MAPTILE *psTile = mapTile(mapState, mapX, mapY);
+		TileVision *psVision = mapTileVision(mapState, mapX, mapY);
 		psTile->tileExploredBits |= alliancebits[player];
-		uint16_t *visionType = (!radar) ? psTile->watchers : psTile->sensors;
+		uint16_t *visionType = (!radar) ? psVision->watchers : psVision->sensors;
 		if (visionType[player] < UINT16_MAX)
 		{
 			TILEPOS tilePos = {uint8_t(mapX), uint8_t(mapY), uint8_t(radar)};
 			visionType[player]++;          // we observe this tile
-			updateTileVis(psTile, player);
+			updateTileVis(psTile, psVision, player);
 			psSpot->watchedTiles[psSpot->numWatchedTiles++] = tilePos;    // record having seen it
 		}
 	}
@@ -243,10 +246,11 @@ SPOTTER::~SPOTTER()
 	{
 		const TILEPOS tilePos = watchedTiles[i];
 		MAPTILE *psTile = mapTile(mapState, tilePos.x, tilePos.y);
-		uint16_t *visionType = (tilePos.type == 0) ? psTile->watchers : psTile->sensors;
+		TileVision *psVision = mapTileVision(mapState, tilePos.x, tilePos.y);
+		uint16_t *visionType = (tilePos.type == 0) ? psVision->watchers : psVision->sensors;
 		ASSERT(visionType[player] > 0, "Not watching watched tile (%d, %d)", (int)tilePos.x, (int)tilePos.y);
 		visionType[player]--;
-		updateTileVis(psTile, player);
+		updateTileVis(psTile, psVision, player);
 	}
 	free(watchedTiles);
 }
@@ -254,14 +258,14 @@ SPOTTER::~SPOTTER()
 /* Record all tiles that some object confers visibility to. Only record each tile
  * once. Note that there is both a limit to how many objects can watch any given
  * tile. Strange but non fatal things will happen if these limits are exceeded. */
-static inline void visMarkTile(const BASE_OBJECT *psObj, int mapX, int mapY, MAPTILE *psTile, std::vector<TILEPOS> &watchedTiles)
+static inline void visMarkTile(const BASE_OBJECT *psObj, int mapX, int mapY, MAPTILE *psTile, TileVision *psVision, std::vector<TILEPOS> &watchedTiles)
 {
 	const int rayPlayer = psObj->player;
 	const int xdiff = map_coord(psObj->pos.x) - mapX;
 	const int ydiff = map_coord(psObj->pos.y) - mapY;
 	const int distSq = xdiff * xdiff + ydiff * ydiff;
 	const bool inRange = (distSq < 16);
-	uint16_t *visionType = inRange ? psTile->watchers : psTile->sensors;
+	uint16_t *visionType = inRange ? psVision->watchers : psVision->sensors;
 
 	if (visionType[rayPlayer] < UINT16_MAX)
 	{
@@ -270,29 +274,19 @@ static inline void visMarkTile(const BASE_OBJECT *psObj, int mapX, int mapY, MAP
 		visionType[rayPlayer]++;                        // we observe this tile
 		if (psObj->flags.test(OBJECT_FLAG_JAMMED_TILES))   // we are a jammer object
 		{
-			psTile->jammers[rayPlayer]++;
+			psVision->jammers[rayPlayer]++;
 			psTile->jammerBits |= (1 << rayPlayer); // mark it as being jammed
 		}
-		updateTileVis(psTile, rayPlayer);
+		updateTileVis(psTile, psVision, rayPlayer);
 		watchedTiles.push_back(tilePos);  // record having seen it
 	}
 }
 
-/* The terrain revealing ray callback */
-static void doWaveTerrain(BASE_OBJECT *psObj, WorldMapState& mapState)
+/// Scans the wavecast table of a viewer at tile (tileX, tileY) with eye height sz, calling onSeen(i, mapX, mapY, psTile)
+/// for each tile i of the table which can be seen over the terrain, in table order.
+template <typename OnSeen>
+static void waveTerrainScan(WorldMapState& mapState, int tileX, int tileY, int sz, const WavecastTile *tiles, size_t size, OnSeen &&onSeen)
 {
-	if (psObj == nullptr)
-	{
-		return;
-	}
-
-	const int sx = psObj->pos.x;
-	const int sy = psObj->pos.y;
-	const int sz = psObj->pos.z + ((psObj->sDisplay.imd != nullptr) ? MAX(MIN_VIS_HEIGHT, psObj->sDisplay.imd->max.y) : MIN_VIS_HEIGHT);
-	const unsigned radius = objSensorRange(psObj);
-	const int rayPlayer = psObj->player;
-	size_t size;
-	const WavecastTile *tiles = getWavecastTable(radius, &size);
 #define MAX_WAVECAST_LIST_SIZE 1360  // Trivial upper bound to what a fully upgraded WSS can use (its number of angles). Should probably be some factor times the maximum possible radius. Is probably a lot more than needed. Tested to need at least 180.
 	int heights[2][MAX_WAVECAST_LIST_SIZE];
 	size_t angles[2][MAX_WAVECAST_LIST_SIZE + 1];
@@ -306,11 +300,10 @@ static void doWaveTerrain(BASE_OBJECT *psObj, WorldMapState& mapState)
 	angles[!readList][writeListPos] = 0;               // Smallest angle.
 	++writeListPos;
 
-	psObj->watchedTiles.clear();
 	for (size_t i = 0; i < size; ++i)
 	{
-		const int mapX = map_coord(sx) + tiles[i].dx;
-		const int mapY = map_coord(sy) + tiles[i].dy;
+		const int mapX = tileX + tiles[i].dx;
+		const int mapY = tileY + tiles[i].dy;
 		if (mapX < 0 || mapX >= mapState.width || mapY < 0 || mapY >= mapState.height)
 		{
 			continue;
@@ -360,9 +353,132 @@ static void doWaveTerrain(BASE_OBJECT *psObj, WorldMapState& mapState)
 
 		if (seen)
 		{
-			// Can see this tile.
-			psTile->tileExploredBits |= alliancebits[rayPlayer];                        // Share exploration with allies too
-			visMarkTile(psObj, mapX, mapY, psTile, psObj->watchedTiles);   // Mark this tile as seen by our sensor
+			onSeen(i, mapX, mapY, psTile);
+		}
+	}
+}
+
+/// Terrain line of sight of a structure, as found by waveTerrainScan(), reused until a tile height in range changes.
+struct WavecastLosKey
+{
+	uint32_t epoch;  ///< WorldMapState::epoch
+	int tileX, tileY, sz;
+	unsigned radius;
+
+	bool operator ==(WavecastLosKey const &other) const
+	{
+		return epoch == other.epoch && tileX == other.tileX && tileY == other.tileY && sz == other.sz && radius == other.radius;
+	}
+};
+struct WavecastLosKeyHash
+{
+	size_t operator ()(WavecastLosKey const &key) const
+	{
+		uint64_t h = key.epoch;
+		h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.tileX);
+		h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.tileY);
+		h = h * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.sz);
+		h = h * 0x9E3779B97F4A7C15ull + key.radius;
+		return static_cast<size_t>(h ^ (h >> 32));
+	}
+};
+struct WavecastLos
+{
+	uint64_t heightChanges = 0;  ///< WorldMapState::heightChanges when scanned.
+	int rowMin = 0, rowMax = -1; ///< Rows of the map which the scan looked at.
+	std::vector<uint64_t> seen;  ///< Bit i set if tile i of the wavecast table is seen.
+};
+static std::unordered_map<WavecastLosKey, WavecastLos, WavecastLosKeyHash> wavecastLosCache;
+#define MAX_WAVECAST_LOS_CACHE_SIZE 8192  // A few times the number of structures in a big game.
+
+/// Returns the tiles seen from (tileX, tileY), rescanning only if a tile height in range changed since the last scan.
+static WavecastLos const &getStructureLos(WorldMapState& mapState, int tileX, int tileY, int sz, unsigned radius, const WavecastTile *tiles, size_t size)
+{
+	const WavecastLosKey key {mapState.epoch, tileX, tileY, sz, radius};
+	auto it = wavecastLosCache.find(key);
+	if (it != wavecastLosCache.end())
+	{
+		WavecastLos &los = it->second;
+		bool valid = true;
+		if (los.heightChanges != mapState.heightChanges)
+		{
+			for (int y = los.rowMin; y <= los.rowMax && valid; ++y)
+			{
+				valid = mapState.heightRowChanges[y] <= los.heightChanges;
+			}
+		}
+		if (valid)
+		{
+			los.heightChanges = mapState.heightChanges;  // No height in range changed since the scan.
+			return los;
+		}
+	}
+	else
+	{
+		if (wavecastLosCache.size() >= MAX_WAVECAST_LOS_CACHE_SIZE)
+		{
+			wavecastLosCache.clear();  // Mostly structures which are long gone.
+		}
+		it = wavecastLosCache.emplace(key, WavecastLos()).first;
+	}
+
+	WavecastLos &los = it->second;
+	los.heightChanges = mapState.heightChanges;
+	los.rowMin = mapState.height;
+	los.rowMax = -1;
+	for (size_t i = 0; i < size; ++i)
+	{
+		los.rowMin = std::min(los.rowMin, tileY + tiles[i].dy);
+		los.rowMax = std::max(los.rowMax, tileY + tiles[i].dy);
+	}
+	los.rowMin = std::max(los.rowMin, 0);
+	los.rowMax = std::min(los.rowMax, mapState.height - 1);
+	los.seen.assign((size + 63) / 64, 0);
+	waveTerrainScan(mapState, tileX, tileY, sz, tiles, size, [&](size_t i, int, int, MAPTILE *) {
+		los.seen[i / 64] |= uint64_t(1) << (i % 64);
+	});
+	return los;
+}
+
+/* The terrain revealing ray callback */
+static void doWaveTerrain(BASE_OBJECT *psObj, WorldMapState& mapState)
+{
+	if (psObj == nullptr)
+	{
+		return;
+	}
+
+	const int sx = psObj->pos.x;
+	const int sy = psObj->pos.y;
+	const int sz = psObj->pos.z + ((psObj->sDisplay.imd != nullptr) ? MAX(MIN_VIS_HEIGHT, psObj->sDisplay.imd->max.y) : MIN_VIS_HEIGHT);
+	const unsigned radius = objSensorRange(psObj);
+	const int rayPlayer = psObj->player;
+	size_t size;
+	const WavecastTile *tiles = getWavecastTable(radius, &size);
+
+	psObj->watchedTiles.clear();
+	auto markSeen = [&](size_t, int mapX, int mapY, MAPTILE *psTile) {
+		// Can see this tile.
+		psTile->tileExploredBits |= alliancebits[rayPlayer];                        // Share exploration with allies too
+		visMarkTile(psObj, mapX, mapY, psTile, mapTileVision(mapState, mapX, mapY), psObj->watchedTiles);   // Mark this tile as seen by our sensor
+	};
+
+	if (psObj->type != OBJ_STRUCTURE || mapState.heightRowChanges.size() != static_cast<size_t>(mapState.height))
+	{
+		waveTerrainScan(mapState, map_coord(sx), map_coord(sy), sz, tiles, size, markSeen);
+		return;
+	}
+
+	// Structures do not move, so their view of the terrain only changes with the terrain (see buildFlatten()).
+	WavecastLos const &los = getStructureLos(mapState, map_coord(sx), map_coord(sy), sz, radius, tiles, size);
+	for (size_t word = 0; word < los.seen.size(); ++word)
+	{
+		for (uint64_t bits = los.seen[word]; bits != 0; bits &= bits - 1)
+		{
+			const size_t i = word * 64 + std::countr_zero(bits);
+			const int mapX = map_coord(sx) + tiles[i].dx;
+			const int mapY = map_coord(sy) + tiles[i].dy;
+			markSeen(i, mapX, mapY, mapTile(mapState, mapX, mapY));
 		}
 	}
 }
@@ -416,6 +532,15 @@ static bool rayLOSCallback(WorldMapState& mapState, Vector2i pos, int32_t dist,
 }
 
 
+/// Unbuilt structures and walls do not confer visibility, and cannot see anything.
+static bool visStructureIsBlind(const STRUCTURE *psStruct)
+{
+	return psStruct->status != SS_BUILT
+	       || psStruct->pStructureType->type == REF_WALL
+	       || psStruct->pStructureType->type == REF_WALLCORNER
+	       || psStruct->pStructureType->type == REF_GATE;
+}
+
 /* Remove tile visibility from object */
 void visRemoveVisibility(BASE_OBJECT *psObj, WorldMapState& mapState)
 {
@@ -424,9 +549,10 @@ void visRemoveVisibility(BASE_OBJECT *psObj, WorldMapState& mapState)
 		for (TILEPOS pos : psObj->watchedTiles)
 		{
 			MAPTILE *psTile = mapTile(mapState, pos.x, pos.y);
+			TileVision *psVision = mapTileVision(mapState, pos.x, pos.y);
 
 			ASSERT(pos.type < 2, "Invalid visibility type %d", (int)pos.type);
-			uint16_t *visionType = (pos.type == 0) ? psTile->sensors : psTile->watchers;
+			uint16_t *visionType = (pos.type == 0) ? psVision->sensors : psVision->watchers;
 			if (visionType[psObj->player] == 0 && game.type == LEVEL_TYPE::CAMPAIGN)	// hack
 			{
 				continue;
@@ -436,14 +562,14 @@ void visRemoveVisibility(BASE_OBJECT *psObj, WorldMapState& mapState)
 			if (psObj->flags.test(OBJECT_FLAG_JAMMED_TILES))  // we are a jammer object — we cannot check objJammerPower(psObj) > 0 directly here, we may be in the BASE_OBJECT destructor).
 			{
 				// No jammers in campaign, no need for special hack
-				ASSERT(psTile->jammers[psObj->player] > 0, "Not jamming watched tile (%d, %d)", (int)pos.x, (int)pos.y);
-				psTile->jammers[psObj->player]--;
-				if (psTile->jammers[psObj->player] == 0)
+				ASSERT(psVision->jammers[psObj->player] > 0, "Not jamming watched tile (%d, %d)", (int)pos.x, (int)pos.y);
+				psVision->jammers[psObj->player]--;
+				if (psVision->jammers[psObj->player] == 0)
 				{
 					psTile->jammerBits &= ~(1 << psObj->player);
 				}
 			}
-			updateTileVis(psTile, psObj->player);
+			updateTileVis(psTile, psVision, psObj->player);
 		}
 	}
 	psObj->watchedTiles.clear();
@@ -463,15 +589,10 @@ void visTilesUpdate(BASE_OBJECT *psObj, WorldMapState& mapState)
 	// Remove previous map visibility provided by object
 	visRemoveVisibility(psObj, mapState);
 
-	if (psObj->type == OBJ_STRUCTURE)
+	if (psObj->type == OBJ_STRUCTURE && visStructureIsBlind((STRUCTURE *)psObj))
 	{
-		STRUCTURE *psStruct = (STRUCTURE *)psObj;
-		if (psStruct->status != SS_BUILT ||
-		    psStruct->pStructureType->type == REF_WALL || psStruct->pStructureType->type == REF_WALLCORNER || psStruct->pStructureType->type == REF_GATE)
-		{
-			// unbuilt structures and walls do not confer visibility.
-			return;
-		}
+		// unbuilt structures and walls do not confer visibility.
+		return;
 	}
 
 	// Do the whole circle in ∞ steps. No more pretty moiré patterns.
@@ -541,15 +662,8 @@ int visibleObject(const BASE_OBJECT *psViewer, const BASE_OBJECT *psTarget, bool
 		{
 			const STRUCTURE *psStruct = (const STRUCTURE *)psViewer;
 
-			// a structure that is being built cannot see anything
-			if (psStruct->status != SS_BUILT)
-			{
-				return 0;
-			}
-
-			if (psStruct->pStructureType->type == REF_WALL
-			    || psStruct->pStructureType->type == REF_GATE
-			    || psStruct->pStructureType->type == REF_WALLCORNER)
+			// a structure that is being built cannot see anything, and neither can walls
+			if (visStructureIsBlind(psStruct))
 			{
 				return 0;
 			}
@@ -592,30 +706,33 @@ int visibleObject(const BASE_OBJECT *psViewer, const BASE_OBJECT *psTarget, bool
 		return UBYTE_MAX;
 	}
 
-	// initialise the callback variables
-	VisibleObjectHelp_t help = {
-		true,
-		wallsBlock,
-		psViewer->pos.z + map_Height(gameWorld.map, psViewer->pos.x, psViewer->pos.y),
-		map_coord(psTarget->pos.xy()),
-		0,
-		0,
-		-UBYTE_MAX * GRAD_MUL * ELEVATION_SCALE,
-		0,
-		Vector2i(0, 0)
-	};
-
-	// Cast a ray from the viewer to the target
-	rayCast(gameWorld.map, psViewer->pos.xy(), psTarget->pos.xy(), rayLOSCallback, &help);
-
+	// Line of sight over the terrain is given by the tile watchers below, which doWaveTerrain() only updates when the viewer
+	// moves to another tile or its sensor changes. So the ray is only cast when the caller wants the wall in the way.
 	if (gWall != nullptr && gNumWalls != nullptr) // Out globals are set
 	{
+		// initialise the callback variables
+		VisibleObjectHelp_t help = {
+			true,
+			wallsBlock,
+			psViewer->pos.z + map_Height(gameWorld.map, psViewer->pos.x, psViewer->pos.y),
+			map_coord(psTarget->pos.xy()),
+			0,
+			0,
+			-UBYTE_MAX * GRAD_MUL * ELEVATION_SCALE,
+			0,
+			Vector2i(0, 0)
+		};
+
+		// Cast a ray from the viewer to the target
+		rayCast(gameWorld.map, psViewer->pos.xy(), psTarget->pos.xy(), rayLOSCallback, &help);
+
 		*gWall = help.wall;
 		*gNumWalls = help.numWalls;
 	}
 
-	bool tileWatched = psTile->watchers[psViewer->player] > 0;
-	bool tileWatchedSensor = psTile->sensors[psViewer->player] > 0;
+	const TileVision *psVision = mapTileVision(gameWorld.map, map_coord(psTarget->pos.x), map_coord(psTarget->pos.y));
+	bool tileWatched = psVision->watchers[psViewer->player] > 0;
+	bool tileWatchedSensor = psVision->sensors[psViewer->player] > 0;
 
 	// Show objects hidden by ECM jamming with radar blips
 	if (jammed)
@@ -757,6 +874,10 @@ static void processVisibilityVision(BASE_OBJECT *psViewer)
 	{
 		return;
 	}
+	if (psViewer->type == OBJ_STRUCTURE && visStructureIsBlind((STRUCTURE *)psViewer))
+	{
+		return;  // visibleObject() would not see anything, so do not look for candidates.
+	}
 
 	// get all the objects from the grid the droid is in
 	// Will give inconsistent results if hasSharedVision is not an equivalence relation.
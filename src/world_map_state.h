@@ -28,6 +28,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include <stdint.h>
 
@@ -40,25 +41,41 @@ struct BASE_OBJECT;
 
 /// <summary>
 /// Information stored with each tile on a given map.
+/// Only what path finding, movement, visibility and height lookups need, to keep the map small (40 bytes a tile
+/// rather than about 120). This is for memory size; the lookups measure about as fast either way.
+/// The rest is in the TileVision and TileDisplay planes of WorldMapState.
 /// </summary>
 struct MAPTILE
 {
-	uint8_t         tileInfoBits;
-	PlayerMask      tileExploredBits;
-	PlayerMask      sensorBits;             ///< bit per player, who can see tile with sensor
-	uint16_t        watchers[MAX_PLAYERS];  // player sees through fog of war here with this many objects
-	uint16_t        texture;                // Which graphics texture is on this tile
-	int32_t         height;                 ///< The height at the top left of the tile
 	BASE_OBJECT *   psObject;               // Any object sitting on the location (e.g. building)
+	int32_t         height;                 ///< The height at the top left of the tile
+	int32_t         waterLevel;             ///< At what height is the water for this tile
+	uint16_t        texture;                // Which graphics texture is on this tile
 	uint16_t        limitedContinent;       ///< For land or sea limited propulsion types
 	uint16_t        hoverContinent;         ///< For hover type propulsions
 	uint16_t        fireEndTime;            ///< The (uint16_t)(gameTime / GAME_TICKS_PER_UPDATE) that BITS_ON_FIRE should be cleared.
-	int32_t         waterLevel;             ///< At what height is the water for this tile
+	PlayerMask      tileExploredBits;
+	PlayerMask      sensorBits;             ///< bit per player, who can see tile with sensor
 	PlayerMask      jammerBits;             ///< bit per player, who is jamming tile
+	uint8_t         tileInfoBits;
+};
+
+/// <summary>
+/// How many objects of each player see or jam a tile, see visibility.cpp. Which players can see the tile as a result is
+/// in MAPTILE::sensorBits.
+/// </summary>
+struct TileVision
+{
+	uint16_t        watchers[MAX_PLAYERS];  // player sees through fog of war here with this many objects
 	uint16_t        sensors[MAX_PLAYERS];   ///< player sees this tile with this many radar sensors
 	uint16_t        jammers[MAX_PLAYERS];   ///< player jams the tile with this many objects
+};
 
-	// DISPLAY ONLY (NOT for use in game calculations)
+/// <summary>
+/// DISPLAY ONLY (NOT for use in game calculations)
+/// </summary>
+struct TileDisplay
+{
 	uint8_t         ground;                 ///< The ground type used for the terrain renderer
 	uint8_t         illumination;           // How bright is this tile? = diffuseSunLight * ambientOcclusion
 	uint8_t         ambientOcclusion;       // ambient occlusion. from 1 (max occlusion) to 254 (no occlusion), similar to illumination.
@@ -81,7 +98,11 @@ struct WorldScrollLimits
 /// </summary>
 struct WorldMapState
 {
+	/// Per-tile data, as planes of width * height entries each, indexed by x + y * width. Use mapTile(), mapTileVision()
+	/// and mapTileDisplay() to look them up. Allocate them with mapAllocateTiles().
 	std::unique_ptr<MAPTILE[]> tiles;
+	std::unique_ptr<TileVision[]> vision;
+	std::unique_ptr<TileDisplay[]> display;
 	int32_t width = 0;
 	int32_t height = 0;
 	std::array<std::unique_ptr<uint8_t[]>, AUX_MAX> blockMap;
@@ -89,4 +110,14 @@ struct WorldMapState
 	WorldScrollLimits scroll;
 	/// the list of gateways on the current map
 	GATEWAY_LIST gateways;
+
+	uint32_t epoch = 0;  ///< Changes whenever the map is loaded or restored, which resets the change counts below.
+
+	/// Changes to the path blocking bits of blockMap and auxMap, so that path finding blocking maps can be updated rather than rebuilt (see fpathSetBlockingMap()).
+	uint64_t blockingChanges = 0;              ///< Number of changes so far.
+	std::vector<uint64_t> blockingRowChanges;  ///< Value of blockingChanges after the last change to each row.
+
+	/// Changes to tile heights, so that the terrain line of sight of structures can be reused (see doWaveTerrain()).
+	uint64_t heightChanges = 0;                ///< Number of changes so far.
+	std::vector<uint64_t> heightRowChanges;    ///< Value of heightChanges after the last change to each row.
 };
@@ -83,6 +83,8 @@
 #include "gamehistorylogger.h"
 #include "hci/quickchat.h"
 #include "screens/guidescreen.h"
+#include "profiling.h"
+#include "replayverify.h"
 
 #include <list>
 #include <cmath>
@@ -1027,7 +1029,7 @@ bool wzapi::structureIdle(WZAPI_PARAMS(const STRUCTURE *psStruct))
 std::vector<const STRUCTURE *> _enumStruct_fromList(WZAPI_PARAMS(optional<int> _player, optional<wzapi::STRUCTURE_TYPE_or_statsName_string> _structureType, optional<int> _playerFilter), const PerPlayerStructureLists& psStructLists)
 {
 	std::vector<const STRUCTURE *> matches;
-	WzString statsName;
+	std::string_view statsName;
 	STRUCTURE_TYPE type = NUM_DIFF_BUILDINGS;
 
 	int player = _player.value_or(context.player());
@@ -1036,17 +1038,27 @@ std::vector<const STRUCTURE *> _enumStruct_fromList(WZAPI_PARAMS(optional<int> _
 	if (_structureType.has_value())
 	{
 		type = _structureType.value().type;
-		statsName = WzString::fromUtf8(_structureType.value().statsName);
+		statsName = _structureType.value().statsName;
 	}
 
 	SCRIPT_ASSERT_PLAYER({}, context, player);
 	SCRIPT_ASSERT({}, context, (playerFilter >= 0 && playerFilter < MAX_PLAYERS) || playerFilter == ALL_PLAYERS, "Player filter index out of range: %d", playerFilter);
+	// Stats names are unique, so compare stats rather than names
+	const STRUCTURE_STATS *psStats = nullptr;
+	if (!statsName.empty())
+	{
+		psStats = getStructStatsFromId(getStatIdFromName(statsName));
+		if (psStats == nullptr)
+		{
+			return matches;
+		}
+	}
 	for (STRUCTURE *psStruct : psStructLists[player])
 	{
 		if ((playerFilter == ALL_PLAYERS || psStruct->visible[playerFilter])
 		    && !psStruct->died
 		    && (type == NUM_DIFF_BUILDINGS || type == psStruct->pStructureType->type)
-		    && (statsName.isEmpty() || statsName.compare(psStruct->pStructureType->id) == 0))
+		    && (psStats == nullptr || psStats == psStruct->pStructureType))
 		{
 			matches.push_back(psStruct);
 		}
@@ -1137,18 +1149,23 @@ std::vector<const DROID *> wzapi::enumDroid(WZAPI_PARAMS(optional<int> _player,
 std::vector<const FEATURE *> wzapi::enumFeature(WZAPI_PARAMS(int playerFilter, optional<std::string> _featureName))
 {
 	SCRIPT_ASSERT({}, context, (playerFilter >= 0 && playerFilter < MAX_PLAYERS) || playerFilter == ALL_PLAYERS, "Player filter index out of range: %d", playerFilter);
-	WzString featureName;
-	if (_featureName.has_value())
+	std::vector<const FEATURE *> matches;
+	// Stats names are unique, so compare stats rather than names
+	const FEATURE_STATS *psStats = nullptr;
+	if (_featureName.has_value() && !_featureName.value().empty())
 	{
-		featureName = WzString::fromUtf8(_featureName.value());
+		int index = getFeatureStatFromName(_featureName.value());
+		if (index < 0)
+		{
+			return matches;
+		}
+		psStats = &asFeatureStats[index];
 	}
-
-	std::vector<const FEATURE *> matches;
 	for (const FEATURE *psFeat : gameWorld.objects.features[0])
 	{
 		if ((playerFilter == ALL_PLAYERS || psFeat->visible[playerFilter])
 		    && !psFeat->died
-		    && (featureName.isEmpty() || featureName.compare(psFeat->psStats->id) == 0))
+		    && (psStats == nullptr || psStats == psFeat->psStats))
 		{
 			matches.push_back(psFeat);
 		}
@@ -1273,8 +1290,8 @@ std::vector<const BASE_OBJECT *> wzapi::enumRange(WZAPI_PARAMS(int _x, int _y, i
 
 	SCRIPT_ASSERT({}, context, (playerFilter >= 0 && playerFilter < MAX_PLAYERS) || playerFilter == ALL_PLAYERS || playerFilter == ALLIES || playerFilter == ENEMIES, "Filter player index out of range: %d", playerFilter);
 
-	static GridList gridList;  // static to avoid allocations. // WARNING: THREAD-SAFETY
-	gridList = gridStartIterate(x, y, range);
+	// Scripts often repeat the same queries within a tick
+	GridList const &gridList = gridStartIterateMemoised(x, y, range);
 	std::vector<const BASE_OBJECT *> list;
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -1714,7 +1731,7 @@ bool wzapi::droidCanReach(WZAPI_PARAMS(const DROID *psDroid, int x, int y))
 //--
 bool wzapi::propulsionCanReach(WZAPI_PARAMS(std::string propulsionName, int x1, int y1, int x2, int y2))
 {
-	int propulsionIndex = getCompFromName(COMP_PROPULSION, WzString::fromUtf8(propulsionName));
+	int propulsionIndex = getCompFromName(COMP_PROPULSION, propulsionName);
 	SCRIPT_ASSERT(false, context, propulsionIndex > 0, "No such propulsion: %s", propulsionName.c_str());
 	const PROPULSION_STATS *psPropStats = &asPropulsionStats[propulsionIndex];
 	return fpathCheck(gameWorld.map, Vector3i(world_coord(x1), world_coord(y1), 0), Vector3i(world_coord(x2), world_coord(y2), 0), psPropStats->propulsionType);
@@ -1764,7 +1781,7 @@ static int get_first_available_component(int player, int capacity, const wzapi::
 {
 	for (const auto& componentName : list.strings)
 	{
-		int componentIndex = getCompFromName(componentType, WzString::fromUtf8(componentName));
+		int componentIndex = getCompFromName(componentType, componentName);
 		if (componentIndex >= 0)
 		{
 			int status = apCompLists[player][componentType][componentIndex];
@@ -1820,7 +1837,7 @@ static std::unique_ptr<DROID_TEMPLATE> makeTemplate(int player, const std::strin
 		return nullptr;
 	}
 	std::string componentName = _turrets.va_list[0].strings[0];
-	COMPONENT_STATS *psComp = getCompStatsFromName(WzString::fromUtf8(componentName.c_str()));
+	COMPONENT_STATS *psComp = getCompStatsFromId(getStatIdFromName(componentName));
 	if (psComp == nullptr)
 	{
 		debug(LOG_ERROR, "Wanted to build %s but %s does not exist", templateName.c_str(), componentName.c_str());
@@ -2015,7 +2032,7 @@ bool wzapi::addDroidToTransporter(WZAPI_PARAMS(game_object_identifier transporte
 //--
 wzapi::returned_nullable_ptr<const FEATURE> wzapi::addFeature(WZAPI_PARAMS(std::string featureName, int x, int y)) MUTLIPLAY_UNSAFE
 {
-	int feature = getFeatureStatFromName(WzString::fromUtf8(featureName));
+	int feature = getFeatureStatFromName(featureName);
 	SCRIPT_ASSERT(nullptr, context, feature >= 0 && feature < asFeatureStats.size(), "Unknown feature name: %s", featureName.c_str());
 	FEATURE_STATS *psStats = &asFeatureStats[feature];
 	for (const FEATURE *psFeat : gameWorld.objects.features[0])
@@ -2037,7 +2054,7 @@ bool wzapi::componentAvailable(WZAPI_PARAMS(std::string componentType, optional<
 	int player = context.player();
 	SCRIPT_ASSERT_PLAYER(false, context, player);
 	std::string &componentName = _componentName.has_value() ? _componentName.value() : componentType;
-	COMPONENT_STATS *psComp = getCompStatsFromName(WzString::fromUtf8(componentName.c_str()));
+	COMPONENT_STATS *psComp = getCompStatsFromId(getStatIdFromName(componentName));
 	SCRIPT_ASSERT(false, context, psComp, "No such component: %s", componentName.c_str());
 	int status = apCompLists[player][psComp->compType][psComp->index];
 	return status == AVAILABLE || status == REDUNDANT;
@@ -2399,7 +2416,7 @@ bool wzapi::isSpectator(WZAPI_PARAMS(int player))
 //--
 nlohmann::json wzapi::getWeaponInfo(WZAPI_PARAMS(std::string weaponName)) WZAPI_DEPRECATED
 {
-	int weaponIndex = getCompFromName(COMP_WEAPON, WzString::fromUtf8(weaponName));
+	int weaponIndex = getCompFromName(COMP_WEAPON, weaponName);
 	SCRIPT_ASSERT(nlohmann::json(), context, weaponIndex >= 0 && weaponIndex < asWeaponStats.size(), "No such weapon: %s", weaponName.c_str());
 	WEAPON_STATS *psStats = &asWeaponStats[weaponIndex];
 	nlohmann::json result = nlohmann::json::object();
@@ -2570,12 +2587,18 @@ bool wzapi::gameOverMessage(WZAPI_PARAMS(bool gameWon, optional<bool> _showBackD
 		updateChallenge(gameWon);
 	}
 	GameStoryLogger::instance().logGameOver();
-	if (autogame_enabled())
+	if (replayVerifyWorkerActive())
+	{
+		// Spectators only get here once the game is fully over, and the sync CRCs aren't checked after that
+		replayVerifyFinish("gameOver");
+	}
+	else if (autogame_enabled())
 	{
 		debug(LOG_WARNING, "Autogame completed successfully!");
 		if (headlessGameMode())
 		{
 			stdOutGameSummary(0);
+			saveTickProfile();
 		}
 		wzQuit(0); // Trigger a *graceful* shutdown
 	}
@@ -2827,6 +2850,28 @@ wzapi::no_return_value wzapi::setTutorialMode(WZAPI_PARAMS(bool enableTutorialMo
 	return {};
 }
 
+//-- ## setHierarchicalPathfinding(enable)
+//--
+//-- Whether to plan long routes over a graph of map regions instead of tile by tile. Faster on big maps,
+//-- but the routes are slightly longer. Off by default. (Do not use this in an AI script.) (4.7+ only)
+//--
+wzapi::no_return_value wzapi::setHierarchicalPathfinding(WZAPI_PARAMS(bool enable)) WZAPI_AI_UNSAFE
+{
+	fpathSetHierarchical(enable);
+	return {};
+}
+
+//-- ## setFlowFieldPathfinding(enable)
+//--
+//-- Whether the droids of a large selection given the same order share one search, instead of each
+//-- searching on its own. Faster for large group orders. Off by default. (Do not use this in an AI script.) (4.7+ only)
+//--
+wzapi::no_return_value wzapi::setFlowFieldPathfinding(WZAPI_PARAMS(bool enable)) WZAPI_AI_UNSAFE
+{
+	fpathSetFlowField(enable);
+	return {};
+}
+
 //-- ## setDesign(allowDesignValue)
 //--
 //-- Whether to allow player to design stuff.
@@ -3017,7 +3062,7 @@ wzapi::no_return_value wzapi::enableStructure(WZAPI_PARAMS(std::string structure
 
 static void setComponent(const std::string& componentName, int player, int availability)
 {
-	COMPONENT_STATS *psComp = getCompStatsFromName(WzString::fromUtf8(componentName));
+	COMPONENT_STATS *psComp = getCompStatsFromId(getStatIdFromName(componentName));
 	ASSERT_OR_RETURN(, psComp, "Bad component %s", componentName.c_str());
 	apCompLists[player][psComp->compType][psComp->index] = availability;
 }
@@ -3412,7 +3457,7 @@ wzapi::no_return_value wzapi::setObjectFlag(WZAPI_PARAMS(BASE_OBJECT *psObj, int
 //--
 wzapi::no_return_value wzapi::fireWeaponAtLoc(WZAPI_PARAMS(std::string weaponName, int x, int y, optional<int> _player, optional<bool> center))
 {
-	int weaponIndex = getCompFromName(COMP_WEAPON, WzString::fromUtf8(weaponName));
+	int weaponIndex = getCompFromName(COMP_WEAPON, weaponName);
 	SCRIPT_ASSERT({}, context, weaponIndex > 0, "No such weapon: %s", weaponName.c_str());
 
 	int player = _player.value_or(context.player());
@@ -3441,7 +3486,7 @@ wzapi::no_return_value wzapi::fireWeaponAtLoc(WZAPI_PARAMS(std::string weaponNam
 //--
 wzapi::no_return_value wzapi::fireWeaponAtObj(WZAPI_PARAMS(std::string weaponName, BASE_OBJECT *psObj, optional<int> _player))
 {
-	int weaponIndex = getCompFromName(COMP_WEAPON, WzString::fromUtf8(weaponName));
+	int weaponIndex = getCompFromName(COMP_WEAPON, weaponName);
 	SCRIPT_ASSERT({}, context, weaponIndex > 0, "No such weapon: %s", weaponName.c_str());
 	SCRIPT_ASSERT({}, context, psObj, "No valid object provided");
 
@@ -1102,6 +1102,8 @@ namespace wzapi
 	no_return_value setPowerStorageMaximum(WZAPI_PARAMS(int powerMaximum, optional<int> _player)); WZAPI_AI_UNSAFE
 	no_return_value extraPowerTime(WZAPI_PARAMS(int time, optional<int> _player));
 	no_return_value setTutorialMode(WZAPI_PARAMS(bool enableTutorialMode));
+	no_return_value setHierarchicalPathfinding(WZAPI_PARAMS(bool enable)); WZAPI_AI_UNSAFE
+	no_return_value setFlowFieldPathfinding(WZAPI_PARAMS(bool enable)); WZAPI_AI_UNSAFE
 	no_return_value setDesign(WZAPI_PARAMS(bool allowDesignValue));
 	bool enableTemplate(WZAPI_PARAMS(std::string _templateName));
 	bool removeTemplate(WZAPI_PARAMS(std::string _templateName));
@@ -0,0 +1,419 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Test and benchmark for the network compression adapters (lib/netplay/*_compression_adapter.cpp).
+//
+// Replays game traffic through each adapter the way a connection uses it: the messages of a tick
+// are compressed and flushed, and the receiving adapter gets the flushed bytes in the pieces
+// IClientConnection::readNoInt() would read them. Checks that every adapter gives back exactly
+// what was sent, that the compression method negotiation falls back to zlib, and that the zstd
+// adapter rejects corrupt data and streams needing more than its window. Then prints the ratio
+// and the compression and decompression throughput of each adapter.
+// The traffic is read from a replay (.wzrp), if one is given, or else generated to look like a
+// four player game: game time messages every tick, and droid orders and structure updates.
+// Needs the framework library (for debug() / ASSERT), so it's only built via CMake:
+//   -DWZ_BUILD_BENCHMARKS=ON (target: compression_benchmark)
+// Run:
+//   ./compression_benchmark [--checks-only] [replay.wzrp]
+// --checks-only leaves out the throughput report (ctest runs it that way). Exits nonzero on failure.
+
+#include "lib/netplay/wz_compression_provider.h"
+#include "lib/netplay/zlib_compression_adapter.h"
+#if defined(WZ_ZSTD_ENABLED)
+# include "lib/netplay/zstd_compression_adapter.h"
+#endif
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Message types, from lib/netplay/netplay.h.
+static constexpr uint8_t GAME_DROIDINFO = 112;
+static constexpr uint8_t GAME_STRUCTUREINFO = 113;
+static constexpr uint8_t GAME_GAME_TIME = 120;
+static constexpr uint8_t GAME_SYNC_REQUEST = 123;
+
+// The messages of one tick, as sent in one flush.
+using Tick = std::vector<uint8_t>;
+
+// Encoded like NETuint32_t().
+static void pushVarint(std::vector<uint8_t>& out, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+// Appends a message the way it goes out on the wire: type, big endian payload size, payload.
+static void pushMessage(Tick& tick, uint8_t type, const std::vector<uint8_t>& payload)
+{
+	tick.push_back(type);
+	tick.push_back(static_cast<uint8_t>(payload.size() >> 8));
+	tick.push_back(static_cast<uint8_t>(payload.size()));
+	tick.insert(tick.end(), payload.begin(), payload.end());
+}
+
+static std::vector<Tick> generateTraffic(size_t tickCount)
+{
+	constexpr int PLAYERS = 4;
+	std::mt19937 rng(23);
+	std::vector<std::vector<uint32_t>> droids(PLAYERS);
+	for (int player = 0; player < PLAYERS; ++player)
+	{
+		for (int i = 0; i < 150; ++i)
+		{
+			droids[player].push_back(10000 + player * 5000 + i * 3);
+		}
+	}
+
+	std::vector<Tick> ticks(tickCount);
+	std::vector<uint8_t> payload;
+	for (size_t t = 0; t < tickCount; ++t)
+	{
+		Tick& tick = ticks[t];
+		for (int player = 0; player < PLAYERS; ++player)
+		{
+			if (rng() % 4 == 0)
+			{
+				// A group of droids ordered to a spot near where the player's droids are.
+				payload.clear();
+				payload.push_back(static_cast<uint8_t>(player));
+				payload.push_back(static_cast<uint8_t>(rng() % 3));        // subtype
+				pushVarint(payload, 2 + rng() % 4);                          // order
+				pushVarint(payload, (2000 + player * 3000 + rng() % 1500) * 2);
+				pushVarint(payload, (2000 + player * 2000 + rng() % 1500) * 2);
+				const uint32_t count = 1 + rng() % 12;
+				pushVarint(payload, count);
+				uint32_t droid = droids[player][rng() % (droids[player].size() - count)];
+				pushVarint(payload, droid);
+				for (uint32_t i = 1; i < count; ++i)
+				{
+					pushVarint(payload, 3);
+				}
+				pushMessage(tick, GAME_DROIDINFO, payload);
+			}
+			if (rng() % 30 == 0)
+			{
+				payload.clear();
+				payload.push_back(static_cast<uint8_t>(player));
+				pushVarint(payload, 50000 + player * 1000 + rng() % 40);   // structure
+				payload.push_back(static_cast<uint8_t>(rng() % 4));        // info
+				pushVarint(payload, 400 + rng() % 300);                      // template / research
+				pushMessage(tick, GAME_STRUCTUREINFO, payload);
+			}
+			if (rng() % 200 == 0)
+			{
+				payload.clear();
+				payload.push_back(static_cast<uint8_t>(player));
+				pushVarint(payload, rng() % 8);
+				const char* event = "syncRequest";
+				payload.insert(payload.end(), event, event + std::strlen(event));
+				pushVarint(payload, rng());
+				pushMessage(tick, GAME_SYNC_REQUEST, payload);
+			}
+			// Every tick ends with the player's game time and sync check.
+			payload.clear();
+			payload.push_back(static_cast<uint8_t>(player));
+			pushVarint(payload, static_cast<uint32_t>(t) * 100);
+			pushVarint(payload, 200);
+			for (int i = 0; i < 4; ++i)
+			{
+				payload.push_back(static_cast<uint8_t>(rng()));
+			}
+			pushMessage(tick, GAME_GAME_TIME, payload);
+		}
+	}
+	return ticks;
+}
+
+static uint32_t loadBE32(const uint8_t* p)
+{
+	return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+// Reads the messages of a replay (see lib/netplay/netreplay.cpp). A tick ends before a player's
+// second game time message, so that it holds what the host relays to a client in one flush.
+static std::vector<Tick> loadReplay(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::vector<Tick> ticks;
+	size_t pos = 0;
+	auto skip = [&](size_t size) { pos = std::min(data.size(), pos + size); };
+	if (data.size() < 8 || loadBE32(data.data()) != 0x575A7270)
+	{
+		return ticks;
+	}
+	pos = 4;
+	skip(4 + loadBE32(&data[pos]));            // settings JSON
+	if (pos + 8 > data.size())
+	{
+		return ticks;
+	}
+	skip(8 + loadBE32(&data[pos + 4]));        // embedded map data
+	Tick tick;
+	std::bitset<256> playersDone;
+	while (pos + 4 <= data.size())
+	{
+		const uint8_t player = data[pos];
+		const uint8_t type = data[pos + 1];
+		const size_t size = (size_t(data[pos + 2]) << 8) | data[pos + 3];
+		if (pos + 4 + size > data.size())
+		{
+			break;
+		}
+		if (type == GAME_GAME_TIME && playersDone.test(player))
+		{
+			ticks.push_back(std::move(tick));
+			tick.clear();
+			playersDone.reset();
+		}
+		tick.insert(tick.end(), data.begin() + pos + 1, data.begin() + pos + 4 + size);
+		pos += 4 + size;
+		playersDone.set(player, playersDone.test(player) || type == GAME_GAME_TIME);
+	}
+	if (!tick.empty())
+	{
+		ticks.push_back(std::move(tick));
+	}
+	return ticks;
+}
+
+// Feeds arrived bytes to a decompressing adapter, exactly like IClientConnection::readNoInt().
+struct Receiver
+{
+	ICompressionAdapter& adapter;
+	const std::vector<uint8_t>* arrived = nullptr;
+	size_t arrivedPos = 0;
+	bool failed = false;
+
+	size_t read(uint8_t* buf, size_t maxSize)
+	{
+		if (adapter.decompressionNeedInput())
+		{
+			if (arrivedPos == arrived->size())
+			{
+				return 0;  // recv() would block.
+			}
+			auto& in = adapter.decompressionInBuffer();
+			in.resize(maxSize + 1000);
+			const size_t received = std::min(in.size(), arrived->size() - arrivedPos);
+			std::memcpy(in.data(), arrived->data() + arrivedPos, received);
+			arrivedPos += received;
+			adapter.resetDecompressionStreamInputSize(received);
+			adapter.setDecompressionNeedInput(false);
+		}
+		if (!adapter.decompress(buf, maxSize).has_value())
+		{
+			failed = true;
+			return 0;
+		}
+		if (adapter.availableSpaceToDecompress() != 0)
+		{
+			adapter.setDecompressionNeedInput(true);
+			failed |= !adapter.decompressionStreamConsumedAllInput();
+		}
+		return maxSize - adapter.availableSpaceToDecompress();
+	}
+};
+
+struct RunResult
+{
+	bool roundTrip = true;
+	size_t rawBytes = 0;
+	size_t compressedBytes = 0;
+	double compressSeconds = 0;
+	double decompressSeconds = 0;
+};
+
+// Sends `ticks` from one adapter to the other, one flush per tick.
+static RunResult replay(ICompressionAdapter& sender, ICompressionAdapter& receiver, const std::vector<Tick>& ticks, size_t readSize)
+{
+	RunResult result;
+	Receiver rx{ receiver };
+	std::vector<uint8_t> flushed, got(readSize);
+	Tick decoded;
+	for (const Tick& tick : ticks)
+	{
+		auto start = std::chrono::steady_clock::now();
+		// Messages are written one by one, as NETsend() does.
+		for (size_t pos = 0; pos + 3 <= tick.size();)
+		{
+			const size_t size = 3 + ((size_t(tick[pos + 1]) << 8) | tick[pos + 2]);
+			result.roundTrip &= sender.compress(tick.data() + pos, size).has_value();
+			pos += size;
+		}
+		result.roundTrip &= sender.flushCompressionStream().has_value();
+		flushed.swap(sender.compressionOutBuffer());
+		sender.compressionOutBuffer().clear();
+		auto middle = std::chrono::steady_clock::now();
+
+		rx.arrived = &flushed;
+		rx.arrivedPos = 0;
+		decoded.clear();
+		while (decoded.size() < tick.size() && !rx.failed)
+		{
+			const size_t n = rx.read(got.data(), std::min(readSize, tick.size() - decoded.size()));
+			if (n == 0 && rx.arrivedPos == flushed.size() && receiver.decompressionNeedInput())
+			{
+				break;
+			}
+			decoded.insert(decoded.end(), got.begin(), got.begin() + n);
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		result.roundTrip &= !rx.failed && decoded == tick && rx.arrivedPos == flushed.size();
+		result.rawBytes += tick.size();
+		result.compressedBytes += flushed.size();
+		result.compressSeconds += std::chrono::duration<double>(middle - start).count();
+		result.decompressSeconds += std::chrono::duration<double>(end - middle).count();
+	}
+	return result;
+}
+
+static void checkNegotiation()
+{
+	auto& provider = WzCompressionProvider::Instance();
+	const uint32_t zlibBit = 1u << static_cast<uint32_t>(WzCompressionMethod::Zlib);
+	const uint32_t zstdBit = 1u << static_cast<uint32_t>(WzCompressionMethod::Zstd);
+	CHECK_TRUE((provider.supportedMethods() & zlibBit) && provider.isSupported(WzCompressionMethod::Zlib), "zlib not supported");
+	CHECK_TRUE(provider.negotiateMethod(0) == WzCompressionMethod::Zlib && provider.negotiateMethod(zlibBit) == WzCompressionMethod::Zlib
+	           && provider.negotiateMethod(1u << 31) == WzCompressionMethod::Zlib, "no fallback to zlib");
+	CHECK_TRUE(!provider.isSupported(static_cast<WzCompressionMethod>(31)) && !provider.isSupported(static_cast<WzCompressionMethod>(1000))
+	           && !provider.newCompressionAdapter(static_cast<WzCompressionMethod>(7)), "unknown method accepted");
+#if defined(WZ_ZSTD_ENABLED)
+	CHECK_TRUE(provider.negotiateMethod(zlibBit | zstdBit) == WzCompressionMethod::Zstd && provider.negotiateMethod(zstdBit) == WzCompressionMethod::Zstd,
+	           "zstd not preferred");
+#else
+	CHECK_TRUE(provider.negotiateMethod(zlibBit | zstdBit) == WzCompressionMethod::Zlib && !provider.newCompressionAdapter(WzCompressionMethod::Zstd),
+	           "zstd chosen without support");
+#endif
+}
+
+#if defined(WZ_ZSTD_ENABLED)
+static void checkZstdRejects(const std::vector<Tick>& ticks)
+{
+	// Corrupt data.
+	ZstdCompressionAdapter sender, receiver;
+	CHECK_TRUE(sender.initialize().has_value() && receiver.initialize().has_value(), "zstd initialize failed");
+	std::vector<uint8_t> garbage(300, 0x5A);
+	Receiver rx{ receiver, &garbage };
+	uint8_t buf[512];
+	rx.read(buf, sizeof(buf));
+	CHECK_TRUE(rx.failed, "corrupt zstd data accepted");
+
+	// A stream from a peer using a bigger window than ours.
+	ZSTD_CCtx* cctx = ZSTD_createCCtx();
+	ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, 24);
+	std::vector<uint8_t> big;
+	for (const auto& tick : ticks)
+	{
+		big.insert(big.end(), tick.begin(), tick.end());
+	}
+	std::vector<uint8_t> compressed(ZSTD_compressBound(big.size()));
+	ZSTD_outBuffer out = { compressed.data(), compressed.size(), 0 };
+	ZSTD_inBuffer in = { big.data(), big.size(), 0 };
+	ZSTD_compressStream2(cctx, &out, &in, ZSTD_e_flush);
+	ZSTD_freeCCtx(cctx);
+	compressed.resize(out.pos);
+	ZstdCompressionAdapter bounded;
+	CHECK_TRUE(bounded.initialize().has_value(), "zstd initialize failed");
+	Receiver rx2{ bounded, &compressed };
+	rx2.read(buf, sizeof(buf));
+	CHECK_TRUE(rx2.failed, "zstd stream with a 16 MiB window accepted");
+}
+#endif
+
+template<typename Adapter>
+static RunResult runAdapter(const char* name, const std::vector<Tick>& ticks, size_t readSize)
+{
+	Adapter sender, receiver;
+	CHECK_TRUE(sender.initialize().has_value() && receiver.initialize().has_value(), "%s: initialize failed", name);
+	const RunResult result = replay(sender, receiver, ticks, readSize);
+	CHECK_TRUE(result.roundTrip, "%s: data changed on the way, reading %zu bytes at a time", name, readSize);
+	return result;
+}
+
+static void report(const char* name, const RunResult& r)
+{
+	std::printf("%-5s %8.2f MiB -> %8.2f MiB (%5.1f%%), compress %8.1f MiB/s, decompress %8.1f MiB/s\n",
+	            name, r.rawBytes / 1048576.0, r.compressedBytes / 1048576.0, 100.0 * r.compressedBytes / std::max<size_t>(r.rawBytes, 1),
+	            r.rawBytes / 1048576.0 / std::max(r.compressSeconds, 1e-9), r.rawBytes / 1048576.0 / std::max(r.decompressSeconds, 1e-9));
+}
+
+int main(int argc, char** argv)
+{
+	const bool timings = !checksOnly(argc, argv);
+	const char* replayPath = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--checks-only") != 0)
+		{
+			replayPath = argv[i];
+		}
+	}
+	const std::vector<Tick> ticks = replayPath ? loadReplay(replayPath) : generateTraffic(50000);
+	CHECK_TRUE(!ticks.empty(), "no traffic to replay");
+	if (replayPath)
+	{
+		std::printf("Replaying %zu ticks from %s\n", ticks.size(), replayPath);
+	}
+
+	checkNegotiation();
+
+	// Small reads make every piece of the decompression path run.
+	const std::vector<Tick> head(ticks.begin(), ticks.begin() + std::min<size_t>(ticks.size(), 500));
+	runAdapter<ZlibCompressionAdapter>("zlib", head, 7);
+	const RunResult zlib = runAdapter<ZlibCompressionAdapter>("zlib", ticks, 8192);
+	if (timings)
+	{
+		report("zlib", zlib);
+	}
+#if defined(WZ_ZSTD_ENABLED)
+	runAdapter<ZstdCompressionAdapter>("zstd", head, 7);
+	const RunResult zstd = runAdapter<ZstdCompressionAdapter>("zstd", ticks, 8192);
+	if (timings)
+	{
+		report("zstd", zstd);
+	}
+	if (!replayPath)
+	{
+		CHECK_TRUE(zstd.compressedBytes < zlib.compressedBytes * 5 / 4, "zstd output %zu bytes, zlib %zu bytes", zstd.compressedBytes, zlib.compressedBytes);
+	}
+	checkZstdRejects(head);
+#else
+	std::printf("zstd: not available in this build\n");
+#endif
+
+	return checkSummary();
+}
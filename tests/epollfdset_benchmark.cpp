@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for lib/netplay/tcp/epoll_fd_set.cpp (Linux only).
+//
+// Opens loopback TCP connections and checks that only the sockets with unread data are reported,
+// that they are reported again until drained, that removed, cleared and closed sockets aren't,
+// and that removing a connection whose socket number was reused leaves the new owner alone.
+// Then, with hundreds of mostly idle connections and a few sending each round, compares polling
+// with a persistent epoll set to rebuilding a pollfd list every round and searching it for each
+// connection, as PollDescriptorSet did for TCPConnectionPollGroup.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/epollfdset_benchmark.cpp lib/netplay/tcp/epoll_fd_set.cpp -o epollfdset_benchmark && ./epollfdset_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: epollfdset_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "lib/netplay/tcp/epoll_fd_set.h"
+#include "tests/testcheck.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct Connection
+{
+	int client = -1;
+	int server = -1;
+};
+
+static int listener = -1;
+
+static bool openListener()
+{
+	listener = ::socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	return listener >= 0
+		&& ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0
+		&& ::listen(listener, 1024) == 0;
+}
+
+static Connection openConnection()
+{
+	sockaddr_in addr = {};
+	socklen_t len = sizeof(addr);
+	::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+	Connection conn;
+	conn.client = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (::connect(conn.client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+	{
+		conn.server = ::accept(listener, nullptr, nullptr);
+	}
+	const int one = 1;
+	::setsockopt(conn.client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	return conn;
+}
+
+static void closeConnection(Connection& conn)
+{
+	::close(conn.client);
+	::close(conn.server);
+	conn = Connection();
+}
+
+static void send(const Connection& conn)
+{
+	const char byte = 'x';
+	(void)!::write(conn.client, &byte, 1);
+}
+
+static void drain(const Connection& conn)
+{
+	char buffer[64];
+	(void)!::recv(conn.server, buffer, sizeof(buffer), MSG_DONTWAIT);
+}
+
+static void checkSet()
+{
+	tcp::EpollFdSet set(EPOLLIN);
+	CHECK_TRUE(set.valid(), "epoll instance not created");
+
+	std::vector<Connection> conns(4);
+	for (auto& conn : conns)
+	{
+		conn = openConnection();
+		CHECK_TRUE(conn.server >= 0, "loopback connection failed");
+		CHECK_TRUE(set.add(&conn, conn.server), "add failed");
+	}
+	CHECK_TRUE(!set.add(&conns[0], conns[0].server) && set.size() == 4, "same connection added twice");
+	CHECK_TRUE(set.poll(0) == 0 && set.readyEvents(&conns[0]) == 0, "idle connections reported");
+
+	send(conns[1]);
+	send(conns[3]);
+	CHECK_TRUE(set.poll(1000) == 2, "two sending connections not reported");
+	CHECK_TRUE(!set.readyEvents(&conns[0]) && (set.readyEvents(&conns[1]) & EPOLLIN) && !set.readyEvents(&conns[2]) && (set.readyEvents(&conns[3]) & EPOLLIN),
+	           "wrong connections reported");
+	drain(conns[1]);
+	CHECK_TRUE(set.poll(0) == 1 && !set.readyEvents(&conns[1]) && set.readyEvents(&conns[3]), "undrained connection not reported again");
+
+	set.remove(&conns[3], conns[3].server);
+	CHECK_TRUE(set.poll(0) == 0 && !set.readyEvents(&conns[3]) && set.size() == 3, "removed connection reported");
+
+	// A connection closed by the other end is readable, and recv() then returns 0.
+	::close(conns[2].client);
+	conns[2].client = -1;
+	CHECK_TRUE(set.poll(1000) == 1 && (set.readyEvents(&conns[2]) & EPOLLIN), "closed connection not reported");
+
+	// Close a socket without removing it, and let a new connection get the same number.
+	Connection reused = openConnection();
+	const int oldFd = conns[0].server;
+	::close(conns[0].server);
+	::dup2(reused.server, oldFd);
+	::close(reused.server);
+	reused.server = oldFd;
+	CHECK_TRUE(set.add(&reused, reused.server), "add of new connection failed");
+	set.remove(&conns[0], -1);
+	send(reused);
+	CHECK_TRUE(set.poll(1000) >= 1 && (set.readyEvents(&reused) & EPOLLIN), "new connection lost when removing the old owner of fd %d", oldFd);
+	CHECK_TRUE(!set.add(&conns[1], conns[1].server) && !set.add(&conns[1], -1) && set.size() == 3, "bad adds accepted");
+
+	set.clear();
+	CHECK_TRUE(set.size() == 0 && set.poll(0) == 0 && !set.readyEvents(&reused), "cleared set not empty");
+
+	conns[0].server = -1;
+	for (auto& conn : conns)
+	{
+		closeConnection(conn);
+	}
+	closeConnection(reused);
+}
+
+// Polling the way PollDescriptorSet did for a poll group: rebuild, poll, then search for every connection.
+static int pollRebuilt(std::vector<Connection> const& conns, std::vector<pollfd>& fds, std::vector<char>& ready)
+{
+	fds.clear();
+	for (const auto& conn : conns)
+	{
+		fds.push_back(pollfd{ conn.server, POLLIN, 0 });
+	}
+	const int ret = ::poll(fds.data(), fds.size(), 1000);
+	for (size_t i = 0; i < conns.size(); ++i)
+	{
+		const auto it = std::find_if(fds.begin(), fds.end(), [fd = conns[i].server](const pollfd& pfd) { return pfd.fd == fd; });
+		ready[i] = it != fds.end() && (it->revents & POLLIN);
+	}
+	return ret;
+}
+
+static int pollEpoll(std::vector<Connection> const& conns, tcp::EpollFdSet& set, std::vector<char>& ready)
+{
+	const int ret = set.poll(1000);
+	for (size_t i = 0; i < conns.size(); ++i)
+	{
+		ready[i] = (set.readyEvents(&conns[i]) & EPOLLIN) != 0;
+	}
+	return ret;
+}
+
+static void benchmark(size_t count)
+{
+	constexpr int ROUNDS = 2000;
+	constexpr int SENDERS = 4;
+	std::vector<Connection> conns(count);
+	tcp::EpollFdSet set(EPOLLIN);
+	for (auto& conn : conns)
+	{
+		conn = openConnection();
+		set.add(&conn, conn.server);
+	}
+
+	std::vector<pollfd> fds;
+	std::vector<char> ready(count);
+	int wrong = 0;
+	double seconds[2] = {};
+	for (int method = 0; method < 2; ++method)
+	{
+		std::mt19937 rng(5);
+		for (int round = 0; round < ROUNDS; ++round)
+		{
+			std::vector<size_t> senders;
+			for (int i = 0; i < SENDERS; ++i)
+			{
+				senders.push_back(rng() % count);
+				send(conns[senders.back()]);
+			}
+			// Let all the bytes arrive, so that both ways see the same ready sockets.
+			pollfd last{ conns[senders.back()].server, POLLIN, 0 };
+			::poll(&last, 1, 1000);
+
+			auto start = std::chrono::steady_clock::now();
+			method == 0 ? pollRebuilt(conns, fds, ready) : pollEpoll(conns, set, ready);
+			seconds[method] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				wrong += ready[i] != (std::find(senders.begin(), senders.end(), i) != senders.end());
+			}
+			for (size_t sender : senders)
+			{
+				drain(conns[sender]);
+			}
+		}
+	}
+	CHECK_TRUE(wrong == 0, "%zu connections: %d wrong readiness reports", count, wrong);
+	std::printf("%4zu connections: poll() rebuilt %8.2f us per poll, epoll %8.2f us per poll\n", count, seconds[0] * 1e6 / ROUNDS, seconds[1] * 1e6 / ROUNDS);
+
+	for (auto& conn : conns)
+	{
+		closeConnection(conn);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	CHECK_TRUE(openListener(), "can't listen on the loopback interface");
+	if (failures == 0)
+	{
+		checkSet();
+		if (!checksOnly(argc, argv))
+		{
+			benchmark(16);
+			benchmark(128);
+			benchmark(512);
+		}
+	}
+	::close(listener);
+
+	return checkSummary();
+}
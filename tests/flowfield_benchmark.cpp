@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/flowfield.cpp, on a generated 256x256
+// map with cliffs, structures and dangerous (cost factor 5) areas.
+//
+// Checks that every flow field distance equals the cost of the optimal tile
+// path, that every path found is a valid tile path (adjacent steps, no
+// blocking tiles, no cut corners) of exactly that cost, that unreachable
+// starts and goals give no path, and that paths do not depend on the order in
+// which the field was queried. Prints the time for a group of droids to find
+// their paths to a shared destination with one tile level A* search each (the
+// same cost model as fpathAStarRoute()), and with one flow field.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/flowfield_benchmark.cpp src/flowfield.cpp src/pathbitmap.cpp -o flowfield_benchmark && ./flowfield_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: flowfield_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/flowfield.h"
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr int MAP_SIZE = 256;
+static constexpr unsigned GROUP_SIZE = 100;
+
+struct TestMap
+{
+	std::vector<uint8_t> tiles;
+
+	unsigned cost(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= MAP_SIZE || y >= MAP_SIZE)
+		{
+			return 0;
+		}
+		return tiles[x + y * MAP_SIZE] & HpaGraph::TILE_COST_MASK;
+	}
+	void set(int x, int y, uint8_t value)
+	{
+		if (x > 0 && y > 0 && x < MAP_SIZE - 1 && y < MAP_SIZE - 1)
+		{
+			tiles[x + y * MAP_SIZE] = value;
+		}
+	}
+
+	/// The blocking and danger maps the game would give the flow field for these costs.
+	void makeBitmaps(std::shared_ptr<const PathBitmap> &blocking, std::shared_ptr<const PathBitmap> &danger) const
+	{
+		auto blockingMap = std::make_shared<PathBitmap>(MAP_SIZE, MAP_SIZE);
+		auto dangerMap = std::make_shared<PathBitmap>(MAP_SIZE, MAP_SIZE);
+		for (int y = 0; y < MAP_SIZE; ++y)
+			for (int x = 0; x < MAP_SIZE; ++x)
+			{
+				blockingMap->set(x, y, cost(x, y) == 0);
+				dangerMap->set(x, y, cost(x, y) == 5);
+			}
+		blocking = std::move(blockingMap);
+		danger = std::move(dangerMap);
+	}
+
+	FlowField field(HpaCoord goal) const
+	{
+		std::shared_ptr<const PathBitmap> blocking, danger;
+		makeBitmaps(blocking, danger);
+		return FlowField(blocking, danger, goal);
+	}
+};
+
+static TestMap makeMap(uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	TestMap map;
+	map.tiles.assign(MAP_SIZE * MAP_SIZE, 1);
+	for (int i = 0; i < MAP_SIZE; ++i)
+	{
+		map.tiles[i] = map.tiles[i + (MAP_SIZE - 1) * MAP_SIZE] = 0;
+		map.tiles[i * MAP_SIZE] = map.tiles[MAP_SIZE - 1 + i * MAP_SIZE] = 0;
+	}
+	std::uniform_int_distribution<int> coord(0, MAP_SIZE - 1);
+	// Cliff walls, some with a gap.
+	for (int i = 0; i < 120; ++i)
+	{
+		int x = coord(rng), y = coord(rng), length = 8 + coord(rng) % 40;
+		bool horizontal = rng() % 2;
+		int gap = rng() % 3 == 0 ? -1 : int(rng() % length);
+		for (int j = 0; j < length; ++j)
+		{
+			if (std::abs(j - gap) > 1)
+			{
+				map.set(horizontal ? x + j : x, horizontal ? y : y + j, 0);
+			}
+		}
+	}
+	// Blobs of blocking tiles (water, features).
+	for (int i = 0; i < 400; ++i)
+	{
+		int x = coord(rng), y = coord(rng), r = 1 + rng() % 4;
+		for (int dy = -r; dy <= r; ++dy)
+			for (int dx = -r; dx <= r; ++dx)
+				if (dx * dx + dy * dy <= r * r)
+				{
+					map.set(x + dx, y + dy, 0);
+				}
+	}
+	// Threatened areas.
+	for (int i = 0; i < 30; ++i)
+	{
+		int x = coord(rng), y = coord(rng), r = 3 + rng() % 6;
+		for (int dy = -r; dy <= r; ++dy)
+			for (int dx = -r; dx <= r; ++dx)
+				if (map.cost(x + dx, y + dy) != 0)
+				{
+					map.set(x + dx, y + dy, 5);
+				}
+	}
+	return map;
+}
+
+// Tile level A*, with the costs of fpathAStarRoute(). Returns the cost of the best path, or NO_PATH.
+struct TileAStar
+{
+	std::vector<uint32_t> dist;
+	std::vector<bool> closed;
+	std::vector<uint64_t> open;
+
+	uint32_t run(TestMap const &map, HpaCoord start, HpaCoord goal)
+	{
+		dist.assign(MAP_SIZE * MAP_SIZE, FlowField::NO_PATH);
+		closed.assign(MAP_SIZE * MAP_SIZE, false);
+		open.clear();
+		auto estimate = [&](int x, int y) {
+			uint32_t dx = std::abs(x - goal.x), dy = std::abs(y - goal.y);
+			return std::min(dx, dy) * 58 + std::max(dx, dy) * 140;
+		};
+		if (map.cost(start.x, start.y) == 0 || map.cost(goal.x, goal.y) == 0)
+		{
+			return FlowField::NO_PATH;
+		}
+		dist[start.x + start.y * MAP_SIZE] = 0;
+		open.push_back(uint64_t(estimate(start.x, start.y)) << 32 | (start.x + start.y * MAP_SIZE));
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+			uint32_t index = open.back() & 0xFFFFFFFF;
+			open.pop_back();
+			if (closed[index])
+			{
+				continue;
+			}
+			closed[index] = true;
+			int x = index % MAP_SIZE, y = index / MAP_SIZE;
+			if (x == goal.x && y == goal.y)
+			{
+				return dist[index];
+			}
+			for (int dy = -1; dy <= 1; ++dy)
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					int nx = x + dx, ny = y + dy;
+					unsigned c = map.cost(nx, ny);
+					if ((dx == 0 && dy == 0) || c == 0 || (dx && dy && (map.cost(nx, y) == 0 || map.cost(x, ny) == 0)))
+					{
+						continue;
+					}
+					uint32_t d = dist[index] + (dx && dy ? 198 : 140) * c;
+					uint32_t ni = nx + ny * MAP_SIZE;
+					if (d < dist[ni])
+					{
+						dist[ni] = d;
+						open.push_back(uint64_t(d + estimate(nx, ny)) << 32 | ni);
+						std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+					}
+				}
+		}
+		return FlowField::NO_PATH;
+	}
+};
+
+// Returns the cost of path, or NO_PATH if it is not a valid path from start to goal.
+static uint32_t pathCost(TestMap const &map, std::vector<HpaCoord> const &path, HpaCoord start, HpaCoord goal)
+{
+	if (path.empty() || path.front() != start || path.back() != goal || map.cost(start.x, start.y) == 0)
+	{
+		return FlowField::NO_PATH;
+	}
+	uint32_t cost = 0;
+	for (size_t i = 1; i < path.size(); ++i)
+	{
+		int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+		unsigned c = map.cost(path[i].x, path[i].y);
+		if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0) || c == 0
+		    || (dx && dy && (map.cost(path[i - 1].x + dx, path[i - 1].y) == 0 || map.cost(path[i - 1].x, path[i - 1].y + dy) == 0)))
+		{
+			return FlowField::NO_PATH;
+		}
+		cost += (dx && dy ? 198 : 140) * c;
+	}
+	return cost;
+}
+
+static HpaCoord randomPassable(TestMap const &map, std::mt19937 &rng, HpaCoord centre, int radius)
+{
+	std::uniform_int_distribution<int> offset(-radius, radius);
+	while (true)
+	{
+		HpaCoord tile(std::clamp(centre.x + offset(rng), 1, MAP_SIZE - 2), std::clamp(centre.y + offset(rng), 1, MAP_SIZE - 2));
+		if (map.cost(tile.x, tile.y) != 0)
+		{
+			return tile;
+		}
+	}
+}
+
+/// A group of droids near one point, ordered to a shared, far away destination.
+struct GroupOrder
+{
+	std::vector<HpaCoord> starts;
+	HpaCoord goal;
+};
+
+static GroupOrder makeGroupOrder(TestMap const &map, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	GroupOrder order;
+	HpaCoord centre(32 + rng() % 64, 32 + rng() % 64);
+	order.goal = randomPassable(map, rng, HpaCoord(MAP_SIZE - 1 - centre.x, MAP_SIZE - 1 - centre.y), 8);
+	while (order.starts.size() < GROUP_SIZE)
+	{
+		order.starts.push_back(randomPassable(map, rng, centre, 10));
+	}
+	return order;
+}
+
+static uint64_t hashPath(uint64_t h, std::vector<HpaCoord> const &path)
+{
+	for (HpaCoord p : path)
+	{
+		h = (h ^ (uint16_t(p.x) | uint32_t(uint16_t(p.y)) << 16)) * 1099511628211ull;
+	}
+	return (h ^ path.size()) * 1099511628211ull;
+}
+
+static void testPaths(TestMap const &map, GroupOrder const &order)
+{
+	TileAStar astar;
+	FlowField field = map.field(order.goal);
+	std::vector<HpaCoord> path;
+	unsigned found = 0, reachable = 0;
+	for (HpaCoord start : order.starts)
+	{
+		uint32_t best = astar.run(map, start, order.goal);
+		uint32_t distance = field.distance(start);
+		CHECK_TRUE(distance == best, "distance (%d, %d) -> (%d, %d) is %u, optimal is %u", start.x, start.y, order.goal.x, order.goal.y, distance, best);
+		bool ok = field.findPath(start, path);
+		CHECK_TRUE(ok == (best != FlowField::NO_PATH), "path (%d, %d) -> (%d, %d) %s", start.x, start.y, order.goal.x, order.goal.y, ok ? "found to unreachable goal" : "not found");
+		reachable += best != FlowField::NO_PATH;
+		if (ok)
+		{
+			++found;
+			uint32_t cost = pathCost(map, path, start, order.goal);
+			CHECK_TRUE(cost == best, "path (%d, %d) -> (%d, %d) costs %u, optimal is %u", start.x, start.y, order.goal.x, order.goal.y, cost, best);
+		}
+	}
+	std::printf("found %u of %u reachable goals, explored %zu tiles\n", found, reachable, field.numExplored());
+}
+
+static void testUnreachable(TestMap map)
+{
+	// Wall off a room, with a goal inside it.
+	for (int i = 100; i <= 110; ++i)
+	{
+		map.set(i, 100, 0);
+		map.set(i, 110, 0);
+		map.set(100, i, 0);
+		map.set(110, i, 0);
+	}
+	map.set(105, 105, 1);
+	std::vector<HpaCoord> path;
+	FlowField field = map.field(HpaCoord(105, 105));
+	CHECK_TRUE(!field.findPath(HpaCoord(20, 20), path) && path.empty(), "found a path into a closed room");
+	CHECK_TRUE(field.findPath(HpaCoord(105, 105), path) && path.size() == 1, "no trivial path");
+	CHECK_TRUE(!field.findPath(HpaCoord(100, 100), path), "found a path from a blocking tile");
+
+	FlowField blockedGoal = map.field(HpaCoord(100, 105));
+	CHECK_TRUE(!blockedGoal.findPath(HpaCoord(20, 20), path), "found a path to a blocking tile");
+}
+
+static void testQueryOrder(TestMap const &map, GroupOrder const &order)
+{
+	std::vector<HpaCoord> path;
+	FlowField forward = map.field(order.goal);
+	uint64_t forwardHash = 14695981039346656037ull;
+	for (HpaCoord start : order.starts)
+	{
+		forward.findPath(start, path);
+		forwardHash = hashPath(forwardHash, path);
+	}
+
+	// Query in reverse, each path from a field which was explored further first.
+	std::vector<uint64_t> hashes(order.starts.size());
+	FlowField backward = map.field(order.goal);
+	backward.distance(HpaCoord(1, 1));
+	for (size_t i = order.starts.size(); i-- > 0;)
+	{
+		backward.findPath(order.starts[i], path);
+		hashes[i] = hashPath(0, path);
+	}
+	uint64_t backwardHash = 14695981039346656037ull;
+	for (size_t i = 0; i < order.starts.size(); ++i)
+	{
+		FlowField single = map.field(order.goal);
+		single.findPath(order.starts[i], path);
+		CHECK_TRUE(hashPath(0, path) == hashes[i], "path %zu depends on earlier queries", i);
+		backwardHash = hashPath(backwardHash, path);
+	}
+	CHECK_TRUE(forwardHash == backwardHash, "paths depend on the query order");
+}
+
+static void benchmark(TestMap const &map, std::vector<GroupOrder> const &orders)
+{
+	TileAStar astar;
+	uint64_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (auto const &order : orders)
+	{
+		for (HpaCoord tile : order.starts)
+		{
+			sink += astar.run(map, tile, order.goal);
+		}
+	}
+	// The game already has the bitmaps, shared by all the path finding of the tick.
+	std::shared_ptr<const PathBitmap> blocking, danger;
+	map.makeBitmaps(blocking, danger);
+	auto middle = std::chrono::steady_clock::now();
+	std::vector<HpaCoord> path;
+	for (auto const &order : orders)
+	{
+		FlowField field(blocking, danger, order.goal);
+		for (HpaCoord tile : order.starts)
+		{
+			sink += field.findPath(tile, path) + path.size();
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	double astarMs = std::chrono::duration<double, std::milli>(middle - start).count() / orders.size();
+	double fieldMs = std::chrono::duration<double, std::milli>(end - middle).count() / orders.size();
+	std::printf("group of %u, tile A* each %8.2f ms/order\n", GROUP_SIZE, astarMs);
+	std::printf("group of %u, flow field   %8.2f ms/order (speedup %.1fx) [%llu]\n", GROUP_SIZE, fieldMs, astarMs / fieldMs, (unsigned long long)(sink & 1));
+}
+
+int main(int argc, char **argv)
+{
+	TestMap map = makeMap(42);
+	std::vector<GroupOrder> orders;
+	for (uint32_t seed = 1; seed <= 10; ++seed)
+	{
+		orders.push_back(makeGroupOrder(map, seed));
+	}
+
+	for (auto const &order : orders)
+	{
+		testPaths(map, order);
+	}
+	testUnreachable(map);
+	testQueryOrder(map, orders[0]);
+	if (!checksOnly(argc, argv))
+	{
+		benchmark(map, orders);
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,390 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/hpastar.cpp, on a generated 256x256
+// map with cliffs, structures, gateways and dangerous (cost factor 5) areas.
+//
+// Checks that every hierarchical path is a valid tile path (adjacent steps,
+// no blocking tiles, no cut corners), is never shorter than the optimal tile
+// path, and is only found if the goal is reachable. Checks that a graph
+// rebuilt incrementally after structures are built and destroyed gives the
+// same paths as one built from scratch, and that the same query gives the
+// same path from several threads at once. Prints the average time of a tile
+// level A* search (the same cost model as fpathAStarRoute()) and of a
+// hierarchical search, and the time to build the graph.
+// Build and run:
+//   c++ -std=c++20 -O2 -pthread -I. tests/hpastar_benchmark.cpp src/hpastar.cpp -o hpastar_benchmark && ./hpastar_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: hpastar_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/hpastar.h"
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr int MAP_SIZE = 256;
+static constexpr unsigned NUM_QUERIES = 400;
+
+struct TestMap
+{
+	std::vector<uint8_t> tiles;
+
+	unsigned cost(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= MAP_SIZE || y >= MAP_SIZE)
+		{
+			return 0;
+		}
+		return tiles[x + y * MAP_SIZE] & HpaGraph::TILE_COST_MASK;
+	}
+	void set(int x, int y, uint8_t value)
+	{
+		if (x > 0 && y > 0 && x < MAP_SIZE - 1 && y < MAP_SIZE - 1)
+		{
+			tiles[x + y * MAP_SIZE] = (tiles[x + y * MAP_SIZE] & HpaGraph::TILE_GATEWAY) | value;
+		}
+	}
+};
+
+static TestMap makeMap(uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	TestMap map;
+	map.tiles.assign(MAP_SIZE * MAP_SIZE, 1);
+	for (int i = 0; i < MAP_SIZE; ++i)
+	{
+		map.tiles[i] = map.tiles[i + (MAP_SIZE - 1) * MAP_SIZE] = 0;
+		map.tiles[i * MAP_SIZE] = map.tiles[MAP_SIZE - 1 + i * MAP_SIZE] = 0;
+	}
+	std::uniform_int_distribution<int> coord(0, MAP_SIZE - 1);
+	// Cliff walls, with a gap (marked as a gateway) in some of them.
+	for (int i = 0; i < 120; ++i)
+	{
+		int x = coord(rng), y = coord(rng), length = 8 + coord(rng) % 40;
+		bool horizontal = rng() % 2;
+		int gap = rng() % 3 == 0 ? -1 : int(rng() % length);
+		for (int j = 0; j < length; ++j)
+		{
+			int tx = horizontal ? x + j : x, ty = horizontal ? y : y + j;
+			if (std::abs(j - gap) <= 1)
+			{
+				if (tx > 0 && ty > 0 && tx < MAP_SIZE - 1 && ty < MAP_SIZE - 1)
+				{
+					map.tiles[tx + ty * MAP_SIZE] |= HpaGraph::TILE_GATEWAY;
+				}
+				continue;
+			}
+			map.set(tx, ty, 0);
+		}
+	}
+	// Blobs of blocking tiles (water, features).
+	for (int i = 0; i < 400; ++i)
+	{
+		int x = coord(rng), y = coord(rng), r = 1 + rng() % 4;
+		for (int dy = -r; dy <= r; ++dy)
+			for (int dx = -r; dx <= r; ++dx)
+				if (dx * dx + dy * dy <= r * r)
+				{
+					map.set(x + dx, y + dy, 0);
+				}
+	}
+	// Threatened areas.
+	for (int i = 0; i < 30; ++i)
+	{
+		int x = coord(rng), y = coord(rng), r = 3 + rng() % 6;
+		for (int dy = -r; dy <= r; ++dy)
+			for (int dx = -r; dx <= r; ++dx)
+				if (map.cost(x + dx, y + dy) != 0)
+				{
+					map.set(x + dx, y + dy, 5);
+				}
+	}
+	return map;
+}
+
+// Tile level A*, with the costs of fpathAStarRoute(). Returns the cost of the best path, or NO_PATH.
+struct TileAStar
+{
+	std::vector<uint32_t> dist;
+	std::vector<bool> closed;
+	std::vector<uint64_t> open;
+
+	uint32_t run(TestMap const &map, HpaCoord start, HpaCoord goal)
+	{
+		dist.assign(MAP_SIZE * MAP_SIZE, HpaGraph::NO_PATH);
+		closed.assign(MAP_SIZE * MAP_SIZE, false);
+		open.clear();
+		auto estimate = [&](int x, int y) {
+			uint32_t dx = std::abs(x - goal.x), dy = std::abs(y - goal.y);
+			return std::min(dx, dy) * 58 + std::max(dx, dy) * 140;
+		};
+		if (map.cost(start.x, start.y) == 0 || map.cost(goal.x, goal.y) == 0)
+		{
+			return HpaGraph::NO_PATH;
+		}
+		dist[start.x + start.y * MAP_SIZE] = 0;
+		open.push_back(uint64_t(estimate(start.x, start.y)) << 32 | (start.x + start.y * MAP_SIZE));
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+			uint32_t index = open.back() & 0xFFFFFFFF;
+			open.pop_back();
+			if (closed[index])
+			{
+				continue;
+			}
+			closed[index] = true;
+			int x = index % MAP_SIZE, y = index / MAP_SIZE;
+			if (x == goal.x && y == goal.y)
+			{
+				return dist[index];
+			}
+			for (int dy = -1; dy <= 1; ++dy)
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					int nx = x + dx, ny = y + dy;
+					unsigned c = map.cost(nx, ny);
+					if ((dx == 0 && dy == 0) || c == 0 || (dx && dy && (map.cost(nx, y) == 0 || map.cost(x, ny) == 0)))
+					{
+						continue;
+					}
+					uint32_t d = dist[index] + (dx && dy ? 198 : 140) * c;
+					uint32_t ni = nx + ny * MAP_SIZE;
+					if (d < dist[ni])
+					{
+						dist[ni] = d;
+						open.push_back(uint64_t(d + estimate(nx, ny)) << 32 | ni);
+						std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+					}
+				}
+		}
+		return HpaGraph::NO_PATH;
+	}
+};
+
+// Returns the cost of path, or NO_PATH if it is not a valid path from start to goal.
+static uint32_t pathCost(TestMap const &map, std::vector<HpaCoord> const &path, HpaCoord start, HpaCoord goal)
+{
+	if (path.empty() || path.front() != start || path.back() != goal || map.cost(start.x, start.y) == 0)
+	{
+		return HpaGraph::NO_PATH;
+	}
+	uint32_t cost = 0;
+	for (size_t i = 1; i < path.size(); ++i)
+	{
+		int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+		unsigned c = map.cost(path[i].x, path[i].y);
+		if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0) || c == 0
+		    || (dx && dy && (map.cost(path[i - 1].x + dx, path[i - 1].y) == 0 || map.cost(path[i - 1].x, path[i - 1].y + dy) == 0)))
+		{
+			return HpaGraph::NO_PATH;
+		}
+		cost += (dx && dy ? 198 : 140) * c;
+	}
+	return cost;
+}
+
+static std::vector<std::pair<HpaCoord, HpaCoord>> makeQueries(TestMap const &map, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> coord(1, MAP_SIZE - 2);
+	std::vector<std::pair<HpaCoord, HpaCoord>> queries;
+	while (queries.size() < NUM_QUERIES)
+	{
+		HpaCoord a(coord(rng), coord(rng)), b(coord(rng), coord(rng));
+		// Long routes, which is what the hierarchical mode is for.
+		if (map.cost(a.x, a.y) != 0 && map.cost(b.x, b.y) != 0 && std::abs(a.x - b.x) + std::abs(a.y - b.y) > 64)
+		{
+			queries.emplace_back(a, b);
+		}
+	}
+	return queries;
+}
+
+static uint64_t hashPath(uint64_t h, std::vector<HpaCoord> const &path)
+{
+	for (HpaCoord p : path)
+	{
+		h = (h ^ (uint16_t(p.x) | uint32_t(uint16_t(p.y)) << 16)) * 1099511628211ull;
+	}
+	return (h ^ path.size()) * 1099511628211ull;
+}
+
+static uint64_t hashAllPaths(HpaGraph const &graph, std::vector<std::pair<HpaCoord, HpaCoord>> const &queries)
+{
+	HpaSearch search;
+	std::vector<HpaCoord> path;
+	uint64_t h = 14695981039346656037ull;
+	for (auto const &q : queries)
+	{
+		graph.findPath(search, q.first, q.second, path);
+		h = hashPath(h, path);
+	}
+	return h;
+}
+
+static void testPaths(TestMap const &map, HpaGraph const &graph, std::vector<std::pair<HpaCoord, HpaCoord>> const &queries)
+{
+	TileAStar astar;
+	HpaSearch search;
+	std::vector<HpaCoord> path;
+	unsigned found = 0, reachable = 0;
+	double extraCost = 0;
+	for (auto const &q : queries)
+	{
+		uint32_t best = astar.run(map, q.first, q.second);
+		bool ok = graph.findPath(search, q.first, q.second, path);
+		reachable += best != HpaGraph::NO_PATH;
+		if (!ok)
+		{
+			continue;
+		}
+		++found;
+		uint32_t cost = pathCost(map, path, q.first, q.second);
+		CHECK_TRUE(cost != HpaGraph::NO_PATH, "invalid path (%d, %d) -> (%d, %d)", q.first.x, q.first.y, q.second.x, q.second.y);
+		CHECK_TRUE(best != HpaGraph::NO_PATH && cost >= best, "path (%d, %d) -> (%d, %d) shorter than optimal, or to unreachable goal", q.first.x, q.first.y, q.second.x, q.second.y);
+		if (cost != HpaGraph::NO_PATH && best != HpaGraph::NO_PATH && best != 0)
+		{
+			extraCost += double(cost) / best - 1;
+		}
+	}
+	// Entrances are only placed at the ends of long runs, so a few reachable goals may be missed (the caller falls back to fpathAStarRoute()).
+	CHECK_TRUE(found * 100 >= reachable * 95, "only found %u of %u reachable goals", found, reachable);
+	std::printf("found %u of %u reachable goals, %.1f%% longer than optimal on average, %zu nodes\n", found, reachable, found ? 100 * extraCost / found : 0., graph.numNodes());
+}
+
+static void testIncremental(TestMap map, std::vector<std::pair<HpaCoord, HpaCoord>> const &queries)
+{
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> coord(2, MAP_SIZE - 4);
+	auto graph = HpaGraph::build(MAP_SIZE, MAP_SIZE, map.tiles, nullptr);
+	double incrementalUs = 0, repairUs = 0, fullUs = 0;
+	size_t rebuilt = 0;
+	constexpr unsigned NUM_UPDATES = 20;
+	for (unsigned update = 0; update < NUM_UPDATES; ++update)
+	{
+		// Build or destroy a few structures.
+		std::vector<bool> changedRows(MAP_SIZE, false);
+		for (int i = 0; i < 4; ++i)
+		{
+			int x = coord(rng), y = coord(rng);
+			uint8_t value = rng() % 2 ? 0 : 1;
+			for (int dy = 0; dy < 2; ++dy)
+			{
+				for (int dx = 0; dx < 2; ++dx)
+				{
+					map.set(x + dx, y + dy, value);
+				}
+				changedRows[y + dy] = true;
+			}
+		}
+		auto readRow = [&map](int y, uint8_t *row) {
+			std::copy_n(&map.tiles[y * MAP_SIZE], MAP_SIZE, row);
+		};
+		auto start = std::chrono::steady_clock::now();
+		auto incremental = HpaGraph::build(MAP_SIZE, MAP_SIZE, map.tiles, graph.get());
+		auto middle = std::chrono::steady_clock::now();
+		auto repaired = HpaGraph::repair(*graph, changedRows, readRow);
+		auto middle2 = std::chrono::steady_clock::now();
+		auto full = HpaGraph::build(MAP_SIZE, MAP_SIZE, map.tiles, nullptr);
+		auto end = std::chrono::steady_clock::now();
+		incrementalUs += std::chrono::duration<double, std::micro>(middle - start).count();
+		repairUs += std::chrono::duration<double, std::micro>(middle2 - middle).count();
+		fullUs += std::chrono::duration<double, std::micro>(end - middle2).count();
+		rebuilt += incremental->numRebuiltClusters();
+
+		CHECK_TRUE(incremental->numNodes() == full->numNodes(), "incremental graph has %zu nodes, full rebuild %zu", incremental->numNodes(), full->numNodes());
+		CHECK_TRUE(hashAllPaths(*incremental, queries) == hashAllPaths(*full, queries), "incremental graph gives different paths than a full rebuild, update %u", update);
+		CHECK_TRUE(incremental->numRebuiltClusters() < incremental->numClusters() / 4, "rebuilt %zu of %zu clusters", incremental->numRebuiltClusters(), incremental->numClusters());
+		CHECK_TRUE(repaired->numRebuiltClusters() == incremental->numRebuiltClusters(), "repair rebuilt %zu clusters, incremental build %zu", repaired->numRebuiltClusters(), incremental->numRebuiltClusters());
+		CHECK_TRUE(hashAllPaths(*repaired, queries) == hashAllPaths(*full, queries), "repaired graph gives different paths than a full rebuild, update %u", update);
+		graph = repaired;
+	}
+	std::printf("graph build: incremental %8.1f us, from changed rows %8.1f us (%.1f of %zu clusters), full %8.1f us\n", incrementalUs / NUM_UPDATES, repairUs / NUM_UPDATES, double(rebuilt) / NUM_UPDATES, graph->numClusters(), fullUs / NUM_UPDATES);
+}
+
+static void testConcurrent(HpaGraph const &graph, std::vector<std::pair<HpaCoord, HpaCoord>> const &queries)
+{
+	uint64_t expected = hashAllPaths(graph, queries);
+	std::vector<uint64_t> results(4);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < results.size(); ++t)
+	{
+		threads.emplace_back([&, t] { results[t] = hashAllPaths(graph, queries); });
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	for (size_t t = 0; t < results.size(); ++t)
+	{
+		CHECK_TRUE(results[t] == expected, "thread %zu got different paths", t);
+	}
+}
+
+static void benchmark(TestMap const &map, HpaGraph const &graph, std::vector<std::pair<HpaCoord, HpaCoord>> const &queries)
+{
+	TileAStar astar;
+	uint64_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (auto const &q : queries)
+	{
+		sink += astar.run(map, q.first, q.second);
+	}
+	auto middle = std::chrono::steady_clock::now();
+	HpaSearch search;
+	std::vector<HpaCoord> path;
+	for (auto const &q : queries)
+	{
+		sink += graph.findPath(search, q.first, q.second, path) + path.size();
+	}
+	auto end = std::chrono::steady_clock::now();
+	double astarUs = std::chrono::duration<double, std::micro>(middle - start).count() / queries.size();
+	double hpaUs = std::chrono::duration<double, std::micro>(end - middle).count() / queries.size();
+	std::printf("tile A*      %8.1f us/path\n", astarUs);
+	std::printf("hierarchical %8.1f us/path (speedup %.1fx) [%llu]\n", hpaUs, astarUs / hpaUs, (unsigned long long)(sink & 1));
+}
+
+int main(int argc, char **argv)
+{
+	TestMap map = makeMap(42);
+	auto queries = makeQueries(map, 1);
+	auto graph = HpaGraph::build(MAP_SIZE, MAP_SIZE, map.tiles, nullptr);
+
+	testPaths(map, *graph, queries);
+	CHECK_TRUE(hashAllPaths(*graph, queries) == hashAllPaths(*HpaGraph::build(MAP_SIZE, MAP_SIZE, map.tiles, nullptr), queries), "rebuilding the graph changed the paths");
+	testIncremental(map, queries);
+	testConcurrent(*graph, queries);
+	if (!checksOnly(argc, argv))
+	{
+		benchmark(map, *graph, queries);
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/steering/neighbour_table.cpp.
+//
+// Checks, for droids scattered over a map, packed into a dense blob, all in one place, and at
+// extreme coordinates, that queries return exactly the neighbours whose position is in the query
+// square, in ascending order, matching a scan of every neighbour, and that an empty or cleared
+// table finds nothing. Prints the time to look up the neighbours of every droid in a dense blob
+// by scanning all droids, and with the table.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/neighbourtable_benchmark.cpp src/steering/neighbour_table.cpp -o neighbourtable_benchmark && ./neighbourtable_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: neighbourtable_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/steering/neighbour_table.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using steering::Neighbour;
+using steering::NeighbourTable;
+
+static std::vector<Neighbour> makeNeighbours(unsigned count, int32_t minPos, int32_t maxPos, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int32_t> pos(minPos, maxPos);
+	std::vector<Neighbour> neighbours(count);
+	for (auto &n : neighbours)
+	{
+		n.x = pos(rng);
+		n.y = pos(rng);
+		n.radius = rng() % 64;
+	}
+	return neighbours;
+}
+
+static void scan(std::vector<Neighbour> const &neighbours, int32_t x, int32_t y, int32_t radius, std::vector<uint32_t> &results)
+{
+	results.clear();
+	const int64_t minX = int64_t(x) - radius, maxX = int64_t(x) + radius, minY = int64_t(y) - radius, maxY = int64_t(y) + radius;
+	for (uint32_t i = 0; i < neighbours.size(); ++i)
+	{
+		if (neighbours[i].x >= minX && neighbours[i].x <= maxX && neighbours[i].y >= minY && neighbours[i].y <= maxY)
+		{
+			results.push_back(i);
+		}
+	}
+}
+
+static void checkQueries(std::vector<Neighbour> const &neighbours, int32_t minPos, int32_t maxPos, char const *what)
+{
+	NeighbourTable table;
+	for (auto const &n : neighbours)
+	{
+		table.add(n);
+	}
+	table.build();
+	CHECK_TRUE(table.size() == neighbours.size(), "%s: %zu neighbours in table", what, table.size());
+
+	std::mt19937 rng(neighbours.size());
+	std::uniform_int_distribution<int32_t> pos(minPos, maxPos);
+	static const int32_t radii[] = {0, 1, 255, 256, 257, 1000};
+	std::vector<uint32_t> expected, found;
+	int mismatches = 0;
+	for (unsigned q = 0; q < 2000; ++q)
+	{
+		// Centre half the queries on neighbours, to hit the edges of the square.
+		int32_t x = pos(rng), y = pos(rng);
+		if (q % 2 == 0 && !neighbours.empty())
+		{
+			Neighbour const &n = neighbours[rng() % neighbours.size()];
+			x = n.x + int32_t(rng() % 3) - 1;
+			y = n.y;
+		}
+		const int32_t radius = radii[q % 6];
+		scan(neighbours, x, y, radius, expected);
+		table.query(x, y, radius, found);
+		mismatches += found != expected;
+	}
+	CHECK_TRUE(mismatches == 0, "%s: %d queries differ from a scan", what, mismatches);
+}
+
+static void benchmark()
+{
+	constexpr unsigned COUNT = 2000;
+	constexpr int32_t RADIUS = 256;  // CollisionAvoidanceBehavior::OBSTACLE_SCAN_RADIUS
+	constexpr unsigned REPEAT = 5;
+	// A blob of about 45×45 tiles, so each droid has about 30 neighbours.
+	std::vector<Neighbour> neighbours = makeNeighbours(COUNT, 10000, 10000 + 45 * 128, 3);
+	std::vector<uint32_t> results;
+	uint64_t sink = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned r = 0; r < REPEAT; ++r)
+	{
+		for (auto const &n : neighbours)
+		{
+			scan(neighbours, n.x, n.y, RADIUS, results);
+			sink += results.size();
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (unsigned r = 0; r < REPEAT; ++r)
+	{
+		NeighbourTable table;
+		for (auto const &n : neighbours)
+		{
+			table.add(n);
+		}
+		table.build();
+		for (auto const &n : neighbours)
+		{
+			table.query(n.x, n.y, RADIUS, results);
+			sink -= results.size();
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	CHECK_TRUE(sink == 0, "benchmark queries found different neighbours");
+	double scanMs = std::chrono::duration<double, std::milli>(middle - start).count() / REPEAT;
+	double tableMs = std::chrono::duration<double, std::milli>(end - middle).count() / REPEAT;
+	std::printf("%u droid blob: scan all droids    %8.2f ms per tick\n", COUNT, scanMs);
+	std::printf("%u droid blob: neighbour table    %8.2f ms per tick (speedup %.1fx)\n", COUNT, tableMs, scanMs / tableMs);
+}
+
+int main(int argc, char **argv)
+{
+	checkQueries(makeNeighbours(1000, 0, 256 * 128, 1), 0, 256 * 128, "scattered");
+	checkQueries(makeNeighbours(1000, 5000, 7000, 2), 4000, 8000, "blob");
+	checkQueries(std::vector<Neighbour>(50), -300, 300, "one place");
+	const int32_t big = std::numeric_limits<int32_t>::max() / 2;
+	checkQueries(makeNeighbours(300, -big, big, 4), -big, big, "extreme");
+	checkQueries({}, 0, 1000, "empty");
+
+	NeighbourTable table;
+	for (auto const &n : makeNeighbours(100, 0, 1000, 5))
+	{
+		table.add(n);
+	}
+	table.build();
+	table.clear();
+	table.build();
+	std::vector<uint32_t> found(1, 0);
+	table.query(500, 500, 1000, found);
+	CHECK_TRUE(table.size() == 0 && found.empty(), "cleared table found %zu neighbours", found.size());
+
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
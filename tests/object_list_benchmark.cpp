@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone benchmark for lib/framework/object_slot_list.h (no game
+// dependencies), modelled on the per-player object list workload of
+// gameStateUpdate(): 10 players with 1500 units each, every unit visited
+// via mutating_list_iterate() once per tick, with some units dying (erased
+// from within the loop body) and being produced (prepended) every tick.
+//
+// Runs the identical workload over std::list and ObjectSlotList, checks that
+// both visit the units in exactly the same order (determinism), and prints
+// the average tick time of each. Build and run:
+//   c++ -std=c++20 -O2 -I. tests/object_list_benchmark.cpp -o object_list_benchmark && ./object_list_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: object_list_benchmark).
+// --checks-only doesn't print the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include <cassert>
+
+#include "lib/framework/object_list_iteration.h"
+#include "lib/framework/paged_entity_container.h"
+#include "tests/testcheck.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <vector>
+
+static constexpr unsigned NUM_PLAYERS = 10;
+static constexpr unsigned UNITS_PER_PLAYER = 1500;
+static constexpr unsigned NUM_TICKS = 300;
+// Roughly what a big battle looks like: ~0.5% of the units die and get replaced each tick.
+static constexpr unsigned CHURN_PER_MILLE = 5;
+
+// Stand-in for DROID: big enough that a handful of them span several cache lines.
+struct Unit
+{
+	uint32_t id = 0;
+	int32_t pos[3] = {};
+	int32_t vel[3] = {};
+	uint32_t body = 0;
+	uint8_t payload[400] = {};
+};
+
+// Units live in a paged container, like DROIDs do in the game.
+using UnitStorage = PagedEntityContainer<Unit, 256, false>;
+
+// MARK: - Semantics
+
+static void testOrderMatchesStdList()
+{
+	std::list<Unit*> reference;
+	ObjectSlotList<Unit> slots;
+	std::vector<Unit> units(100);
+	for (unsigned i = 0; i < units.size(); ++i)
+	{
+		units[i].id = i;
+		if (i % 3 == 0)
+		{
+			reference.push_back(&units[i]);
+			slots.push_back(&units[i]);
+		}
+		else
+		{
+			reference.push_front(&units[i]);
+			slots.push_front(&units[i]);
+		}
+	}
+	// Erase every 4th element
+	unsigned n = 0;
+	for (auto it = reference.begin(); it != reference.end(); ++n)
+	{
+		it = (n % 4 == 0) ? reference.erase(it) : std::next(it);
+	}
+	n = 0;
+	for (auto it = slots.begin(); it != slots.end(); ++n)
+	{
+		it = (n % 4 == 0) ? slots.erase(it) : std::next(it);
+	}
+	CHECK_TRUE(reference.size() == slots.size(), "size mismatch: %zu != %zu", reference.size(), slots.size());
+	CHECK_TRUE(std::equal(reference.begin(), reference.end(), slots.begin(), slots.end()), "order mismatch after erase");
+	CHECK_TRUE(slots.tombstones() > 0, "erase should be deferred");
+
+	slots.compact();
+	CHECK_TRUE(slots.tombstones() == 0, "compact should remove tombstones");
+	CHECK_TRUE(std::equal(reference.begin(), reference.end(), slots.begin(), slots.end()), "order mismatch after compact");
+
+	reference.reverse();
+	slots.reverse();
+	CHECK_TRUE(std::equal(reference.begin(), reference.end(), slots.begin(), slots.end()), "order mismatch after reverse");
+
+	// Reversing with tombstones left behind (it compacts first).
+	reference.pop_front();
+	slots.pop_front();
+	reference.pop_back();
+	slots.pop_back();
+	CHECK_TRUE(slots.tombstones() == 2, "pop should be deferred");
+	reference.reverse();
+	slots.reverse();
+	CHECK_TRUE(slots.tombstones() == 0, "reverse should compact");
+	CHECK_TRUE(std::equal(reference.begin(), reference.end(), slots.begin(), slots.end()), "order mismatch after reverse with tombstones");
+	CHECK_TRUE(reference.front() == slots.front() && reference.back() == slots.back(), "front/back mismatch");
+
+	ObjectSlotList<Unit> moved = std::move(slots);
+	CHECK_TRUE(slots.empty() && slots.begin() == slots.end(), "moved-from list should be empty");
+	CHECK_TRUE(std::equal(reference.begin(), reference.end(), moved.begin(), moved.end()), "order mismatch after move");
+}
+
+static void testMutatingIterateErasingOthers()
+{
+	std::vector<Unit> units(10);
+	ObjectSlotList<Unit> slots;
+	for (unsigned i = 0; i < units.size(); ++i)
+	{
+		units[i].id = i;
+		slots.push_back(&units[i]);
+	}
+	// Erase the current and the next element from within the loop body.
+	std::vector<uint32_t> visited;
+	mutating_list_iterate(slots, [&slots, &visited](Unit* u)
+	{
+		visited.push_back(u->id);
+		if (u->id % 3 == 0)
+		{
+			auto it = std::find(slots.begin(), slots.end(), u);
+			it = slots.erase(it);
+			if (it != slots.end())
+			{
+				slots.erase(it);
+			}
+		}
+		return IterationResult::CONTINUE_ITERATION;
+	});
+	const std::vector<uint32_t> expected = {0, 2, 3, 5, 6, 8, 9};
+	CHECK_TRUE(visited == expected, "unexpected visiting order when erasing ahead");
+	CHECK_TRUE(slots.size() == 3, "unexpected size %zu", slots.size());
+}
+
+// MARK: - Benchmark
+
+template <typename ListType>
+struct World
+{
+	std::array<ListType, NUM_PLAYERS> droids;
+};
+
+// Runs the tick workload, returns the average tick time in microseconds.
+// `trace` receives the id of every visited unit, in visiting order.
+template <typename ListType>
+static double runTicks(World<ListType>& world, UnitStorage& storage, uint32_t& nextId, std::vector<uint32_t>& trace, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<unsigned> perMille(0, 999);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned tick = 0; tick < NUM_TICKS; ++tick)
+	{
+		for (unsigned player = 0; player < NUM_PLAYERS; ++player)
+		{
+			unsigned deaths = 0;
+			auto& list = world.droids[player];
+			mutating_list_iterate(list, [&](Unit* u)
+			{
+				trace.push_back(u->id);
+				for (int i = 0; i < 3; ++i)
+				{
+					u->pos[i] += u->vel[i];
+				}
+				u->body += u->pos[0] & 1;
+				if (perMille(rng) < CHURN_PER_MILLE)
+				{
+					// Killed: removed from its list in the middle of the update, like destroyObject() does.
+					list.erase(std::find(list.begin(), list.end(), u));
+					storage.erase(storage.find(*u));
+					++deaths;
+				}
+				return IterationResult::CONTINUE_ITERATION;
+			});
+			// Factories replace the losses, prepending like addObjectToList() does.
+			for (unsigned i = 0; i < deaths; ++i)
+			{
+				Unit& u = storage.emplace();
+				u.id = nextId++;
+				u.vel[0] = static_cast<int32_t>(u.id % 7) - 3;
+				list.emplace_front(&u);
+			}
+		}
+		if constexpr (std::is_same<ListType, ObjectSlotList<Unit>>::value)
+		{
+			// Per-tick safe point, see objmemUpdate().
+			for (auto& list : world.droids)
+			{
+				list.compact();
+			}
+		}
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::micro>(elapsed).count() / NUM_TICKS;
+}
+
+template <typename ListType>
+static double benchmark(const char* name, std::vector<uint32_t>& trace)
+{
+	UnitStorage storage;
+	World<ListType> world;
+	uint32_t nextId = 0;
+
+	// Interleave the players' allocations, like a real game start does,
+	// so that consecutive units of one player are not adjacent in memory.
+	for (unsigned i = 0; i < UNITS_PER_PLAYER; ++i)
+	{
+		for (unsigned player = 0; player < NUM_PLAYERS; ++player)
+		{
+			Unit& u = storage.emplace();
+			u.id = nextId++;
+			u.vel[0] = static_cast<int32_t>(u.id % 7) - 3;
+			world.droids[player].emplace_front(&u);
+		}
+	}
+
+	const double usPerTick = runTicks(world, storage, nextId, trace, 42);
+	std::printf("%-16s %8.1f us/tick (%u players x %u units, %u ticks)\n", name, usPerTick, NUM_PLAYERS, UNITS_PER_PLAYER, NUM_TICKS);
+	return usPerTick;
+}
+
+int main(int argc, char **argv)
+{
+	testOrderMatchesStdList();
+	testMutatingIterateErasingOthers();
+
+	std::vector<uint32_t> listTrace, slotTrace;
+	const double listTime = benchmark<std::list<Unit*>>("std::list", listTrace);
+	const double slotTime = benchmark<ObjectSlotList<Unit>>("ObjectSlotList", slotTrace);
+	CHECK_TRUE(listTrace == slotTrace, "visiting order differs between std::list and ObjectSlotList");
+	if (!checksOnly(argc, argv))
+	{
+		std::printf("speedup: %.2fx\n", listTime / slotTime);
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/pathbitmap.cpp.
+//
+// Checks, for map widths around the 64 bit word boundaries, that rows packed
+// from aux/block style byte maps, tiles set one at a time, the tiles set
+// outside a scroll limited area, and every 3x3 neighbourhood match a plain
+// std::vector<bool> reference, that tiles off the map test as set, and that
+// equal bitmaps compare and checksum equal. Prints the time to build a
+// 256x256 blocking map tile by tile into a std::vector<bool> (as
+// fpathSetBlockingMap() used to) and with packRow().
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/pathbitmap_benchmark.cpp src/pathbitmap.cpp -o pathbitmap_benchmark && ./pathbitmap_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: pathbitmap_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/pathbitmap.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct ByteMaps
+{
+	int width, height;
+	std::vector<uint8_t> aux, block;
+};
+
+static ByteMaps makeByteMaps(int width, int height, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	ByteMaps maps{width, height, std::vector<uint8_t>(width * height), std::vector<uint8_t>(width * height)};
+	for (auto &v : maps.aux)
+	{
+		v = rng() % 4 == 0 ? uint8_t(1 << (rng() % 8)) : 0;
+	}
+	for (auto &v : maps.block)
+	{
+		v = uint8_t(rng() & rng());
+	}
+	return maps;
+}
+
+static std::vector<bool> referenceMap(ByteMaps const &maps, uint8_t maskA, uint8_t maskB)
+{
+	std::vector<bool> ref(maps.width * maps.height);
+	for (int i = 0; i < maps.width * maps.height; ++i)
+	{
+		ref[i] = (maps.aux[i] & maskA) != 0 || (maps.block[i] & maskB) != 0;
+	}
+	return ref;
+}
+
+static bool refTest(std::vector<bool> const &ref, int width, int height, int x, int y)
+{
+	return x < 0 || y < 0 || x >= width || y >= height || ref[x + y * width];
+}
+
+static void checkMatches(PathBitmap const &bitmap, std::vector<bool> const &ref, char const *what)
+{
+	const int width = bitmap.width(), height = bitmap.height();
+	int mismatches = 0, badNeighbourhoods = 0;
+	for (int y = -2; y < height + 2; ++y)
+		for (int x = -2; x < width + 2; ++x)
+		{
+			mismatches += bitmap.test(x, y) != refTest(ref, width, height, x, y);
+			if (x >= 0 && y >= 0 && x < width && y < height)
+			{
+				uint32_t expected = 0;
+				for (int dy = -1; dy <= 1; ++dy)
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						expected |= uint32_t(refTest(ref, width, height, x + dx, y + dy)) << ((dx + 1) + 3 * (dy + 1));
+					}
+				badNeighbourhoods += bitmap.neighbourhood(x, y) != expected;
+			}
+		}
+	bool refAny = false;
+	for (bool b : ref)
+	{
+		refAny |= b;
+	}
+	CHECK_TRUE(mismatches == 0, "%s %dx%d: %d tiles differ", what, width, height, mismatches);
+	CHECK_TRUE(badNeighbourhoods == 0, "%s %dx%d: %d neighbourhoods differ", what, width, height, badNeighbourhoods);
+	CHECK_TRUE(bitmap.any() == refAny, "%s %dx%d: any() is %d", what, width, height, bitmap.any());
+}
+
+static void testSize(int width, int height)
+{
+	ByteMaps maps = makeByteMaps(width, height, width * 1000 + height);
+	static const uint8_t masks[][2] = {{0x01, 0x02}, {0x00, 0x0C}, {0x04, 0x00}, {0x00, 0x00}, {0xFF, 0xFF}};
+	for (auto const &mask : masks)
+	{
+		PathBitmap bitmap(width, height);
+		for (int y = 0; y < height; ++y)
+		{
+			bitmap.packRow(y, maps.aux.data() + y * width, mask[0], maps.block.data() + y * width, mask[1]);
+		}
+		std::vector<bool> ref = referenceMap(maps, mask[0], mask[1]);
+		checkMatches(bitmap, ref, "packRow");
+
+		// The same, one tile at a time.
+		PathBitmap single(width, height);
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x)
+			{
+				single.set(x, y, ref[x + y * width]);
+			}
+		CHECK_TRUE(single == bitmap, "set() %dx%d differs from packRow()", width, height);
+		CHECK_TRUE(single.checksum() == bitmap.checksum(), "equal bitmaps %dx%d have different checksums", width, height);
+
+		// Scroll limits, and copying rows.
+		PathBitmap limited(width, height);
+		const int x0 = width / 5, x1 = width - 1 - width / 7, y0 = height / 3;
+		for (int y = 0; y < height; ++y)
+		{
+			limited.copyRow(bitmap, y);
+			if (y < y0)
+			{
+				limited.setRow(y);
+			}
+			else
+			{
+				limited.setOutside(y, x0, x1);
+			}
+		}
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x)
+			{
+				ref[x + y * width] = ref[x + y * width] || y < y0 || x < x0 || x > x1;
+			}
+		checkMatches(limited, ref, "setOutside");
+		if (width > 2 && height > 2)
+		{
+			CHECK_TRUE(limited != bitmap || limited.checksum() == bitmap.checksum(), "inconsistent comparison");
+		}
+
+		// Reading rows back, and comparing them.
+		int badRows = 0, badComparisons = 0;
+		std::vector<uint8_t> row(width);
+		for (int y = 0; y < height; ++y)
+		{
+			std::fill(row.begin(), row.end(), 7);
+			limited.unpackRow(y, row.data(), 3);
+			for (int x = 0; x < width; ++x)
+			{
+				badRows += row[x] != (ref[x + y * width] ? 3 : 7);
+			}
+			bool same = true;
+			for (int x = 0; x < width; ++x)
+			{
+				same = same && limited.test(x, y) == bitmap.test(x, y);
+			}
+			badComparisons += limited.rowEquals(bitmap, y) != same;
+		}
+		CHECK_TRUE(badRows == 0, "unpackRow %dx%d: %d tiles differ", width, height, badRows);
+		CHECK_TRUE(badComparisons == 0, "rowEquals %dx%d: %d rows wrong", width, height, badComparisons);
+	}
+
+	PathBitmap empty(width, height);
+	CHECK_TRUE(!empty.any(), "new %dx%d bitmap is not empty", width, height);
+	empty.set(width - 1, height - 1, true);
+	CHECK_TRUE(empty.any() && empty.test(width - 1, height - 1), "set() %dx%d failed", width, height);
+}
+
+static void benchmark()
+{
+	constexpr int SIZE = 256;
+	constexpr unsigned REPEAT = 200;
+	ByteMaps maps = makeByteMaps(SIZE, SIZE, 5);
+	uint64_t sink = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned i = 0; i < REPEAT; ++i)
+	{
+		std::vector<bool> map(SIZE * SIZE);
+		for (int y = 0; y < SIZE; ++y)
+			for (int x = 0; x < SIZE; ++x)
+			{
+				// Like fpathBaseBlockingTile(), with an aux and a block map lookup per tile.
+				map[x + y * SIZE] = x < 1 || y < 1 || (maps.aux[x + y * SIZE] & 0x01) != 0 || (maps.block[x + y * SIZE] & 0x06) != 0;
+			}
+		sink += map[i % (SIZE * SIZE)];
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (unsigned i = 0; i < REPEAT; ++i)
+	{
+		PathBitmap map(SIZE, SIZE);
+		for (int y = 0; y < SIZE; ++y)
+		{
+			map.packRow(y, maps.aux.data() + y * SIZE, 0x01, maps.block.data() + y * SIZE, 0x06);
+			map.setOutside(y, 1, SIZE);
+		}
+		map.setRow(0);
+		sink += map.test(i % SIZE, 7);
+	}
+	auto end = std::chrono::steady_clock::now();
+	double perTileUs = std::chrono::duration<double, std::micro>(middle - start).count() / REPEAT;
+	double packedUs = std::chrono::duration<double, std::micro>(end - middle).count() / REPEAT;
+	std::printf("blocking map %dx%d: per tile std::vector<bool> %8.1f us\n", SIZE, SIZE, perTileUs);
+	std::printf("blocking map %dx%d: packRow()                 %8.1f us (speedup %.1fx) [%llu]\n", SIZE, SIZE, packedUs, perTileUs / packedUs, (unsigned long long)(sink & 1));
+}
+
+int main(int argc, char **argv)
+{
+	static const int sizes[] = {1, 2, 3, 61, 62, 63, 64, 65, 66, 127, 128, 129, 190, 250};
+	for (int width : sizes)
+	{
+		testSize(width, width % 7 + 3);
+		testSize(width, 1);
+	}
+	testSize(256, 256);
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,509 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone microbenchmark for src/pointtree.cpp, modelled on the map grid
+// workload: 15000 objects on a 256x256 tile map, queried with the radii the
+// movement code and the target search use.
+//
+// Compares the point tree (structure of arrays, thread safe queries into a
+// caller-provided buffer or visitor) against the previous implementation
+// (array of (key, pointer) pairs, results in the shared lastQueryResults),
+// which is kept below as LegacyPointTree. Checks that all of them return the
+// same points in the same order, also when querying from several threads at
+// once, and prints the average time per query. Also checks the incremental
+// build (as used by gridReset()) against a full rebuild, and times both.
+// Build and run:
+//   c++ -std=c++20 -O2 -pthread -DHAVE_INTTYPES_H -I. -I<build dir> tests/pointtree_benchmark.cpp src/pointtree.cpp -o pointtree_benchmark && ./pointtree_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: pointtree_benchmark).
+// --checks-only doesn't print the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/pointtree.h"
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static constexpr int32_t TILE_UNITS = 128;
+static constexpr int32_t MAP_SIZE = 256 * TILE_UNITS;
+static constexpr unsigned NUM_OBJECTS = 15000;
+static constexpr unsigned NUM_QUERIES = 200000;
+static constexpr unsigned NUM_THREADS = 4;
+
+// MARK: - Previous implementation
+
+// The point tree as it was before the structure of arrays layout, minus the filter support.
+class LegacyPointTree
+{
+public:
+	typedef std::vector<void *> ResultVector;
+
+	void insert(void *pointData, int32_t x, int32_t y)
+	{
+		points.push_back(Point(interleave(x, y), pointData));
+	}
+
+	void sort()
+	{
+		std::stable_sort(points.begin(), points.end(), sortFunction);
+	}
+
+	ResultVector &query(int32_t x, int32_t y, uint32_t radius)
+	{
+		int32_t minXo = x - radius;
+		int32_t maxXo = x + radius;
+		int32_t minYo = y - radius;
+		int32_t maxYo = y + radius;
+
+		uint64_t minX = expandX(minXo);
+		uint64_t maxX = expandX(maxXo);
+		uint64_t minY = expandY(minYo);
+		uint64_t maxY = expandY(maxYo);
+
+		uint32_t splitXo = maxXo & findSplit(minXo ^ maxXo);
+		uint32_t splitYo = maxYo & findSplit(minYo ^ maxYo);
+
+		uint64_t splitX1 = expandX(splitXo - 1);
+		uint64_t splitX2 = expandX(splitXo);
+		uint64_t splitY1 = expandY(splitYo - 1);
+		uint64_t splitY2 = expandY(splitYo);
+
+		Range ranges[4] = {{minX    | minY,    splitX1 | splitY1},
+			{splitX2 | minY,    maxX    | splitY1},
+			{minX    | splitY2, splitX1 | maxY},
+			{splitX2 | splitY2, maxX    | maxY}
+		};
+		int numRanges = 4;
+
+		if (ranges[1].a > ranges[2].a)
+		{
+			std::swap(ranges[1], ranges[2]);
+		}
+		if (ranges[2].z + 1 >= ranges[3].a)
+		{
+			ranges[2].z = ranges[3].z;
+			--numRanges;
+		}
+		if (ranges[1].z + 1 >= ranges[2].a)
+		{
+			ranges[1].z = ranges[2].z;
+			ranges[2] = ranges[3];
+			--numRanges;
+		}
+		if (ranges[0].z + 1 >= ranges[1].a)
+		{
+			ranges[0].z = ranges[1].z;
+			ranges[1] = ranges[2];
+			ranges[2] = ranges[3];
+			--numRanges;
+		}
+
+		lastQueryResults.clear();
+		for (int r = 0; r != numRanges; ++r)
+		{
+			unsigned i1 = std::lower_bound(points.begin(),      points.end(), Point(ranges[r].a, (void *)nullptr), sortFunction) - points.begin();
+			unsigned i2 = std::upper_bound(points.begin() + i1, points.end(), Point(ranges[r].z, (void *)nullptr), sortFunction) - points.begin();
+
+			for (unsigned i = i1; i < i2; ++i)
+			{
+				uint64_t px = points[i].first & 0xAAAAAAAAAAAAAAAAULL;
+				uint64_t py = points[i].first & 0x5555555555555555ULL;
+				if (px >= minX && px <= maxX && py >= minY && py <= maxY)
+				{
+					lastQueryResults.push_back(points[i].second);
+				}
+			}
+		}
+		return lastQueryResults;
+	}
+
+	ResultVector lastQueryResults;
+
+private:
+	typedef std::pair<uint64_t, void *> Point;
+	struct Range
+	{
+		uint64_t a, z;
+	};
+
+	static bool sortFunction(Point const &a, Point const &b)
+	{
+		return a.first < b.first;
+	}
+	static uint64_t expand(uint32_t x)
+	{
+		uint64_t r = x;
+		r = (r | r << 16) & 0x0000FFFF0000FFFFULL;
+		r = (r | r << 8)  & 0x00FF00FF00FF00FFULL;
+		r = (r | r << 4)  & 0x0F0F0F0F0F0F0F0FULL;
+		r = (r | r << 2)  & 0x3333333333333333ULL;
+		r = (r | r << 1)  & 0x5555555555555555ULL;
+		return r;
+	}
+	static uint32_t findSplit(uint32_t v)
+	{
+		v |= v >> 1;
+		v |= v >> 2;
+		v |= v >> 4;
+		v |= v >> 8;
+		v |= v >> 16;
+		return ~(v >> 1);
+	}
+	static uint64_t expandX(int32_t x)
+	{
+		return expand(x + 0x80000000u) << 1;
+	}
+	static uint64_t expandY(int32_t y)
+	{
+		return expand(y + 0x80000000u);
+	}
+	static uint64_t interleave(int32_t x, int32_t y)
+	{
+		return expandX(x) | expandY(y);
+	}
+
+	std::vector<Point> points;
+};
+
+// MARK: - Workload
+
+struct Object
+{
+	int32_t x, y;
+	uint32_t id;
+};
+
+struct Query
+{
+	int32_t x, y;
+	uint32_t radius;
+};
+
+static std::vector<Object> makeObjects()
+{
+	// Clustered, like bases and armies are, plus some stragglers.
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int32_t> anywhere(0, MAP_SIZE - 1);
+	std::normal_distribution<double> spread(0, 6 * TILE_UNITS);
+	std::vector<std::pair<int32_t, int32_t>> clusters(20);
+	for (auto &c : clusters)
+	{
+		c = {anywhere(rng), anywhere(rng)};
+	}
+	std::vector<Object> objects(NUM_OBJECTS);
+	for (unsigned i = 0; i < NUM_OBJECTS; ++i)
+	{
+		objects[i].id = i;
+		if (i % 10 == 0)
+		{
+			objects[i].x = anywhere(rng);
+			objects[i].y = anywhere(rng);
+			continue;
+		}
+		auto const &c = clusters[i % clusters.size()];
+		objects[i].x = std::clamp<int32_t>(c.first + (int32_t)spread(rng), 0, MAP_SIZE - 1);
+		objects[i].y = std::clamp<int32_t>(c.second + (int32_t)spread(rng), 0, MAP_SIZE - 1);
+	}
+	return objects;
+}
+
+static std::vector<Query> makeQueries(std::vector<Object> const &objects)
+{
+	// Queries are made by objects, mostly with the obstacle search radius, sometimes with a weapon range.
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<size_t> pick(0, objects.size() - 1);
+	std::uniform_int_distribution<uint32_t> weaponRange(6 * TILE_UNITS, 14 * TILE_UNITS);
+	std::vector<Query> queries(NUM_QUERIES);
+	for (unsigned i = 0; i < NUM_QUERIES; ++i)
+	{
+		Object const &o = objects[pick(rng)];
+		queries[i] = {o.x, o.y, i % 4 == 0 ? weaponRange(rng) : 4 * TILE_UNITS};
+	}
+	return queries;
+}
+
+// Returns the average time per query in nanoseconds. `checksum` is a hash of all results, in order.
+template <typename QueryFunction>
+static double timeQueries(std::vector<Query> const &queries, uint64_t &checksum, QueryFunction &&query)
+{
+	checksum = 0;
+	auto const start = std::chrono::steady_clock::now();
+	for (Query const &q : queries)
+	{
+		query(q, checksum);
+	}
+	auto const elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::nano>(elapsed).count() / queries.size();
+}
+
+static void hashResult(uint64_t &checksum, void *pointData)
+{
+	checksum = checksum * 1000003 + static_cast<Object *>(pointData)->id + 1;
+}
+
+// MARK: - Tests
+
+static void testFilteredQuery(PointTree const &tree, std::vector<Query> const &queries)
+{
+	// Erase every object with an odd id through the filter, then check no query returns one.
+	PointTree::Filter filter(tree);
+	PointTree::ResultVector results;
+	PointTree::IndexVector indices;
+	PointTree::ResultVector unfiltered;
+	bool consistent = true;
+	for (unsigned n = 0; n < 2000; ++n)
+	{
+		Query const &q = queries[n];
+		tree.query(filter, q.x, q.y, q.radius, results, indices);
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			if (static_cast<Object *>(results[i])->id % 2 == 1)
+			{
+				filter.erase(indices[i]);
+			}
+		}
+		// Compare with an unfiltered query of the same square, minus the objects erased so far.
+		tree.query(q.x, q.y, q.radius, unfiltered);
+		size_t j = 0;
+		for (void *p : unfiltered)
+		{
+			if (j < results.size() && results[j] == p)
+			{
+				++j;
+			}
+		}
+		consistent = consistent && j == results.size();
+	}
+	CHECK_TRUE(consistent, "filtered results are not a subsequence of the unfiltered results");
+
+	Query const &q = queries[0];
+	tree.query(filter, q.x, q.y, q.radius, results, indices);
+	tree.query(filter, q.x, q.y, q.radius, results, indices);  // Second query sees the erasures of the first.
+	bool anyOdd = false;
+	for (void *p : results)
+	{
+		anyOdd = anyOdd || static_cast<Object *>(p)->id % 2 == 1;
+	}
+	CHECK_TRUE(!anyOdd, "filter did not remove erased points");
+}
+
+static void testConcurrentQueries(PointTree const &tree, std::vector<Query> const &queries, uint64_t expectedChecksum)
+{
+	// Each thread runs all queries, with its own buffer; all must see exactly the serial results.
+	std::vector<uint64_t> checksums(NUM_THREADS, 0);
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < NUM_THREADS; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			PointTree::ResultVector results;
+			uint64_t checksum = 0;
+			for (Query const &q : queries)
+			{
+				tree.query(q.x, q.y, q.radius, results);
+				for (void *p : results)
+				{
+					hashResult(checksum, p);
+				}
+			}
+			checksums[t] = checksum;
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	for (unsigned t = 0; t < NUM_THREADS; ++t)
+	{
+		CHECK_TRUE(checksums[t] == expectedChecksum, "thread %u saw different results", t);
+	}
+}
+
+// Simulates gridReset() over many ticks, with objects moving, dying, being created and changing order (also some
+// in exactly the same place), and checks that the incremental build always matches a full rebuild.
+// Returns the average time per tick of the incremental and the full build, in microseconds.
+static std::pair<double, double> testIncrementalBuild()
+{
+	constexpr unsigned NUM_TICKS = 200;
+	std::vector<Object> storage(NUM_OBJECTS * 2);  // Never reallocated, so pointers stay valid.
+	std::vector<Object *> order;                     // Insertion order, like the object lists.
+	std::vector<unsigned> previousIndex(storage.size(), PointTree::NO_PREVIOUS_INDEX);
+	std::vector<Object> const initial = makeObjects();
+	std::copy(initial.begin(), initial.end(), storage.begin());
+	for (unsigned i = 0; i < NUM_OBJECTS; ++i)
+	{
+		order.push_back(&storage[i]);
+		if (i % 20 == 1)
+		{
+			storage[i].x = storage[i - 1].x;  // Same place as another object.
+			storage[i].y = storage[i - 1].y;
+		}
+	}
+	unsigned nextFree = NUM_OBJECTS;
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<unsigned> perMille(0, 999);
+	std::uniform_int_distribution<int32_t> step(-40, 40);
+	PointTree incremental, full;
+	double incrementalTime = 0, fullTime = 0;
+	bool allMatch = true;
+	for (unsigned tick = 0; tick < NUM_TICKS; ++tick)
+	{
+		// A third of the objects move (units), the rest stand still (structures, features, idle units).
+		for (Object *o : order)
+		{
+			if (o->id % 3 == 0)
+			{
+				o->x = std::clamp(o->x + step(rng), 0, MAP_SIZE - 1);
+				o->y = std::clamp(o->y + step(rng), 0, MAP_SIZE - 1);
+			}
+		}
+		// Some die, some are born (at the front, like addObjectToList()), and occasionally two swap places in the order.
+		std::vector<Object *> nextOrder;
+		for (Object *o : order)
+		{
+			if (perMille(rng) >= 5)
+			{
+				nextOrder.push_back(o);
+			}
+			else if (nextFree < storage.size())
+			{
+				Object &born = storage[nextFree++];
+				born = *o;  // Born where the other one died, and with the same id, to stress ties.
+				nextOrder.insert(nextOrder.begin(), &born);
+			}
+		}
+		if (tick % 10 == 0 && nextOrder.size() > 2)
+		{
+			std::swap(nextOrder[1], nextOrder[nextOrder.size() / 2]);
+			// Also swap two objects in the same place, which keep their place in the tree, but not their relative order.
+			for (size_t i = 1; i < nextOrder.size(); ++i)
+			{
+				if (nextOrder[i]->x == nextOrder[i - 1]->x && nextOrder[i]->y == nextOrder[i - 1]->y && nextOrder[i]->id % 3 != 0 && nextOrder[i - 1]->id % 3 != 0)
+				{
+					std::swap(nextOrder[i], nextOrder[i - 1]);
+					break;
+				}
+			}
+		}
+		order = std::move(nextOrder);
+
+		auto const incrementalStart = std::chrono::steady_clock::now();
+		incremental.beginIncrementalBuild();
+		for (Object *o : order)
+		{
+			incremental.insertIncremental(o, o->x, o->y, previousIndex[o - storage.data()]);
+		}
+		incremental.endIncrementalBuild();
+		for (unsigned i = 0; i < incremental.size(); ++i)
+		{
+			previousIndex[static_cast<Object *>(incremental.pointAt(i)) - storage.data()] = i;
+		}
+		auto const fullStart = std::chrono::steady_clock::now();
+		full.clear();
+		for (Object *o : order)
+		{
+			full.insert(o, o->x, o->y);
+		}
+		full.sort();
+		auto const fullEnd = std::chrono::steady_clock::now();
+		incrementalTime += std::chrono::duration<double, std::micro>(fullStart - incrementalStart).count();
+		fullTime += std::chrono::duration<double, std::micro>(fullEnd - fullStart).count();
+
+		bool match = incremental.size() == full.size();
+		for (unsigned i = 0; match && i < full.size(); ++i)
+		{
+			match = incremental.pointAt(i) == full.pointAt(i);
+		}
+		allMatch = allMatch && match;
+	}
+	CHECK_TRUE(allMatch, "incremental build differs from full rebuild");
+	return {incrementalTime / NUM_TICKS, fullTime / NUM_TICKS};
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<Object> objects = makeObjects();
+	std::vector<Query> const queries = makeQueries(objects);
+
+	LegacyPointTree legacy;
+	PointTree tree;
+	for (Object &o : objects)
+	{
+		legacy.insert(&o, o.x, o.y);
+		tree.insert(&o, o.x, o.y);
+	}
+	legacy.sort();
+	tree.sort();
+
+	uint64_t legacySum = 0, querySum = 0, bufferSum = 0, visitSum = 0;
+	double legacyTime = timeQueries(queries, legacySum, [&](Query const &q, uint64_t &checksum) {
+		for (void *p : legacy.query(q.x, q.y, q.radius))
+		{
+			hashResult(checksum, p);
+		}
+	});
+	double queryTime = timeQueries(queries, querySum, [&](Query const &q, uint64_t &checksum) {
+		for (void *p : tree.query(q.x, q.y, q.radius))
+		{
+			hashResult(checksum, p);
+		}
+	});
+	PointTree::ResultVector buffer;
+	PointTree const &constTree = tree;
+	double bufferTime = timeQueries(queries, bufferSum, [&](Query const &q, uint64_t &checksum) {
+		constTree.query(q.x, q.y, q.radius, buffer);
+		for (void *p : buffer)
+		{
+			hashResult(checksum, p);
+		}
+	});
+	double visitTime = timeQueries(queries, visitSum, [&](Query const &q, uint64_t &checksum) {
+		constTree.visit(q.x, q.y, q.radius, [&checksum](void *p) {
+			hashResult(checksum, p);
+		});
+	});
+
+	CHECK_TRUE(querySum == legacySum, "query() results differ from the previous implementation");
+	CHECK_TRUE(bufferSum == legacySum, "query() into a buffer results differ from the previous implementation");
+	CHECK_TRUE(visitSum == legacySum, "visit() results differ from the previous implementation");
+
+	testConcurrentQueries(constTree, queries, legacySum);
+	testFilteredQuery(constTree, queries);
+	auto const buildTimes = testIncrementalBuild();
+
+	if (!checksOnly(argc, argv))
+	{
+		std::printf("%-24s %8.1f ns/query\n", "legacy query()", legacyTime);
+		std::printf("%-24s %8.1f ns/query\n", "query()", queryTime);
+		std::printf("%-24s %8.1f ns/query\n", "query() into buffer", bufferTime);
+		std::printf("%-24s %8.1f ns/query\n", "visit()", visitTime);
+		std::printf("(%u objects, %u queries)\n", NUM_OBJECTS, NUM_QUERIES);
+		std::printf("%-24s %8.1f us/tick\n", "incremental build", buildTimes.first);
+		std::printf("%-24s %8.1f us/tick\n", "full build", buildTimes.second);
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/projectilebroadphase.cpp.
+//
+// Checks that the ceiling of a square is at least the top of every object in
+// it, that it is exactly the highest top in the cells it covers, and that a
+// projectile segment above the ceiling misses every object in the square
+// under the z test of collisionXYZ() in src/projectile.cpp (copied below),
+// for negative object heights too. Prints the time for a tick of artillery
+// shells to look for objects to hit one square at a time, and with the
+// ceiling skipping the shells which are above everything around them.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/projectilebroadphase_benchmark.cpp src/projectilebroadphase.cpp -o projectilebroadphase_benchmark && ./projectilebroadphase_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: projectilebroadphase_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/projectilebroadphase.h"
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Same as collisionZ() in src/projectile.cpp.
+struct INTERVAL
+{
+	int begin, end;
+};
+
+static INTERVAL collisionZ(int32_t z1, int32_t z2, int32_t height)
+{
+	INTERVAL ret = { -1, -1};
+	if (z1 > z2)
+	{
+		z1 *= -1;
+		z2 *= -1;
+	}
+
+	if (z1 > height || z2 < -height)
+	{
+		return ret;    // No collision between time 1 and time 2.
+	}
+
+	if (z1 == z2)
+	{
+		if (z1 >= -height && z1 <= height)
+		{
+			ret.begin = 0;
+			ret.end = 1024;
+		}
+		return ret;
+	}
+
+	ret.begin = 1024 * (-height - z1) / (z2 - z1);
+	ret.end   = 1024 * (height - z1) / (z2 - z1);
+	return ret;
+}
+
+struct Object
+{
+	int32_t x, y;
+	int32_t z, prevZ;
+	int32_t height;
+
+	int32_t top() const
+	{
+		return std::max(z, prevZ) + std::abs(height);  // As proj_BuildBroadphase() adds them.
+	}
+};
+
+static std::vector<Object> makeObjects(std::mt19937 &rng, int32_t worldWidth, int32_t worldHeight, unsigned count)
+{
+	std::vector<Object> objects(count);
+	for (Object &o : objects)
+	{
+		o.x = rng() % worldWidth;
+		o.y = rng() % worldHeight;
+		o.z = rng() % 1024;
+		o.prevZ = o.z + int32_t(rng() % 64) - 32;
+		o.height = int32_t(rng() % 300) - 20;
+	}
+	return objects;
+}
+
+static bool inSquare(Object const &o, int32_t x, int32_t y, int32_t radius)
+{
+	return std::abs(o.x - x) <= radius && std::abs(o.y - y) <= radius;
+}
+
+static void testMap(int32_t worldWidth, int32_t worldHeight, unsigned count, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<Object> objects = makeObjects(rng, worldWidth, worldHeight, count);
+	ProjectileBroadphase broadphase;
+	broadphase.reset(worldWidth, worldHeight);
+	for (Object const &o : objects)
+	{
+		broadphase.add(o.x, o.y, o.top());
+	}
+
+	int badBounds = 0, badCells = 0, badMisses = 0;
+	for (unsigned q = 0; q < 2000; ++q)
+	{
+		// Including queries near and beyond the edges of the map.
+		const int32_t x = int32_t(rng() % (worldWidth + 2048)) - 1024;
+		const int32_t y = int32_t(rng() % (worldHeight + 2048)) - 1024;
+		const int32_t radius = 1 + rng() % 1500;
+		const int32_t ceiling = broadphase.ceiling(x, y, radius);
+
+		const int32_t cx0 = std::clamp((x - radius) >> ProjectileBroadphase::CELL_SHIFT, 0, (worldWidth - 1) >> ProjectileBroadphase::CELL_SHIFT);
+		const int32_t cx1 = std::clamp((x + radius) >> ProjectileBroadphase::CELL_SHIFT, 0, (worldWidth - 1) >> ProjectileBroadphase::CELL_SHIFT);
+		const int32_t cy0 = std::clamp((y - radius) >> ProjectileBroadphase::CELL_SHIFT, 0, (worldHeight - 1) >> ProjectileBroadphase::CELL_SHIFT);
+		const int32_t cy1 = std::clamp((y + radius) >> ProjectileBroadphase::CELL_SHIFT, 0, (worldHeight - 1) >> ProjectileBroadphase::CELL_SHIFT);
+		int32_t cellMax = ProjectileBroadphase::NO_OBJECTS;
+		for (Object const &o : objects)
+		{
+			if (inSquare(o, x, y, radius) && o.top() > ceiling)
+			{
+				++badBounds;
+			}
+			const int32_t cx = o.x >> ProjectileBroadphase::CELL_SHIFT, cy = o.y >> ProjectileBroadphase::CELL_SHIFT;
+			if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1)
+			{
+				cellMax = std::max(cellMax, o.top());
+			}
+		}
+		badCells += cellMax != ceiling;
+
+		// A segment just above the ceiling hits nothing in the square.
+		if (ceiling != ProjectileBroadphase::NO_OBJECTS)
+		{
+			const int32_t z1 = ceiling + 1 + int32_t(rng() % 3), z2 = ceiling + 1 + int32_t(rng() % 500);
+			for (Object const &o : objects)
+			{
+				if (inSquare(o, x, y, radius))
+				{
+					const INTERVAL i = collisionZ(z1 - o.prevZ, z2 - o.z, o.height);
+					badMisses += i.begin < i.end;
+				}
+			}
+		}
+	}
+	CHECK_TRUE(badBounds == 0, "%dx%d, %u objects: %d objects above the ceiling of their square", worldWidth, worldHeight, count, badBounds);
+	CHECK_TRUE(badCells == 0, "%dx%d, %u objects: %d ceilings differ from the highest top in their cells", worldWidth, worldHeight, count, badCells);
+	CHECK_TRUE(badMisses == 0, "%dx%d, %u objects: %d collisions above the ceiling", worldWidth, worldHeight, count, badMisses);
+
+	ProjectileBroadphase empty;
+	empty.reset(worldWidth, worldHeight);
+	CHECK_TRUE(empty.ceiling(worldWidth / 2, worldHeight / 2, 512) == ProjectileBroadphase::NO_OBJECTS, "%dx%d: empty broadphase has a ceiling", worldWidth, worldHeight);
+}
+
+static void benchmark()
+{
+	constexpr int32_t SIZE = 256 * 128;  // 256×256 tiles.
+	constexpr unsigned OBJECTS = 3000, SHELLS = 5000, REPEAT = 20;
+	constexpr int32_t RANGE = 512;  // PROJ_NEIGHBOUR_RANGE
+	std::mt19937 rng(7);
+	std::vector<Object> objects = makeObjects(rng, SIZE, SIZE, OBJECTS);
+	std::sort(objects.begin(), objects.end(), [](Object const &a, Object const &b) { return a.x < b.x; });
+	struct Shell { int32_t x, y, z1, z2; };
+	std::vector<Shell> shells(SHELLS);
+	for (Shell &s : shells)
+	{
+		s.x = rng() % SIZE;
+		s.y = rng() % SIZE;
+		// Mostly high in their arc, some coming down.
+		s.z1 = rng() % 8 == 0 ? int32_t(rng() % 1500) : 2000 + int32_t(rng() % 4000);
+		s.z2 = s.z1 - int32_t(rng() % 100);
+	}
+
+	// Candidates sorted by x, standing in for the point tree query of each shell.
+	auto findHits = [&](Shell const &s) {
+		unsigned hits = 0;
+		auto it = std::lower_bound(objects.begin(), objects.end(), s.x - RANGE, [](Object const &o, int32_t x) { return o.x < x; });
+		for (; it != objects.end() && it->x <= s.x + RANGE; ++it)
+		{
+			if (std::abs(it->y - s.y) <= RANGE)
+			{
+				const INTERVAL i = collisionZ(s.z1 - it->prevZ, s.z2 - it->z, it->height);
+				hits += i.begin < i.end;
+			}
+		}
+		return hits;
+	};
+
+	unsigned hitsSearch = 0, hitsBroadphase = 0, skipped = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned r = 0; r < REPEAT; ++r)
+	{
+		for (Shell const &s : shells)
+		{
+			hitsSearch += findHits(s);
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (unsigned r = 0; r < REPEAT; ++r)
+	{
+		ProjectileBroadphase broadphase;
+		broadphase.reset(SIZE, SIZE);
+		for (Object const &o : objects)
+		{
+			broadphase.add(o.x, o.y, o.top());
+		}
+		for (Shell const &s : shells)
+		{
+			if (std::min(s.z1, s.z2) > broadphase.ceiling(s.x, s.y, RANGE))
+			{
+				++skipped;
+				continue;
+			}
+			hitsBroadphase += findHits(s);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	CHECK_TRUE(hitsSearch == hitsBroadphase, "broadphase changed the hits: %u vs %u", hitsSearch, hitsBroadphase);
+
+	double searchUs = std::chrono::duration<double, std::micro>(middle - start).count() / REPEAT;
+	double broadphaseUs = std::chrono::duration<double, std::micro>(end - middle).count() / REPEAT;
+	std::printf("%u shells, %u objects: search each    %8.1f us per tick\n", SHELLS, OBJECTS, searchUs);
+	std::printf("%u shells, %u objects: with broadphase %8.1f us per tick (speedup %.1fx, %u%% of shells skipped)\n", SHELLS, OBJECTS, broadphaseUs, searchUs / broadphaseUs, skipped * 100 / (SHELLS * REPEAT));
+}
+
+int main(int argc, char **argv)
+{
+	testMap(1, 1, 0, 1);
+	testMap(1000, 3000, 50, 2);
+	testMap(1024, 1024, 200, 3);
+	testMap(64 * 128, 40 * 128, 500, 4);
+	testMap(250 * 128, 250 * 128, 2000, 5);
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,417 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Headless round trip test for the replay file format v4 (lib/netplay/netreplay.cpp).
+//
+// Records a small replay with GameState keyframes, where the "game" is a few per-player counters
+// driven by the replayed messages, and its keyframes are those counters. Checks the keyframe index
+// at the end of the file, and that seeking (restoring the last keyframe before a game time, then
+// playing the messages after it, as NETreplaySkipToKeyframe() does) gives the same state as
+// playing the replay from the start. Then writes a v3 replay, without keyframes, and checks that it
+// still loads, that an abandoned re-index leaves it alone, and that re-indexing it (as when it is
+// played, see replaykeyframes.cpp) adds keyframes that can be seeked to.
+// Needs the framework library (for PhysFS and debug()), so it's only built via CMake:
+//   -DWZ_BUILD_BENCHMARKS=ON (target: replay_keyframes_test)
+// ctest runs it too. Writes its replays to a temporary directory. Exits nonzero on failure.
+
+#include <nlohmann/json.hpp> // Must come before WZ includes
+
+#include "lib/framework/frame.h"
+#include "lib/framework/physfs_ext.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netplay.h"
+#include "lib/netplay/netreplay.h"
+#include "tests/testcheck.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What netreplay.cpp needs from the rest of the game and from the SDL backend.
+UDWORD gameTime = 0;
+NETPLAY NetPlay;
+NETPLAY::NETPLAY() {}
+ReplayOptionsHandler::~ReplayOptionsHandler() {}
+uint32_t NETGetMajorVersion() { return 4; }
+uint32_t NETGetMinorVersion() { return 6; }
+bool NETisCorrectVersion(uint32_t, uint32_t) { return true; }
+bool NETisReplay() { return false; }
+void wzDisplayDialog(DialogType, const char *, const char *) {}
+struct WZ_THREAD { std::thread thread; };
+WZ_THREAD *wzThreadCreate(int (*threadFunc)(void *), void *data, const char *) { return new WZ_THREAD{std::thread(threadFunc, data)}; }
+void wzThreadStart(WZ_THREAD *) {}
+int wzThreadJoin(WZ_THREAD *thread) { thread->thread.join(); delete thread; return 0; }
+
+struct TestOptions : ReplayOptionsHandler
+{
+	bool saveOptions(nlohmann::json &options) const override { options["scavengers"] = 1; return true; }
+	bool saveMap(EmbeddedMapData &mapData) const override { mapData.dataVersion = 7; mapData.mapBinaryData = {1, 2, 3}; return true; }
+	bool optionsUpdatePlayerInfo(nlohmann::json &) const override { return true; }
+	bool restoreOptions(const nlohmann::json &options, EmbeddedMapData &&mapData, uint32_t, uint32_t) override
+	{
+		return options.at("scavengers") == 1 && mapData.dataVersion == 7 && mapData.mapBinaryData.size() == 3;
+	}
+	size_t desiredBufferSize() const override { return 100; }
+	size_t maximumEmbeddedMapBufferSize() const override { return 1000; }
+};
+
+static constexpr unsigned PLAYERS = 3;
+static constexpr uint32_t TICK = 100;
+static constexpr uint32_t GAME_LENGTH = 200000;
+
+struct Message
+{
+	uint8_t player;
+	uint8_t type;
+	uint32_t payload;  ///< The game time of the tick it was sent for, times PLAYERS, plus the player.
+
+	uint32_t gameTime() const { return payload / PLAYERS; }
+};
+
+/// The game simulated by the replay: a hash of the messages of each player, and a count of its orders.
+struct GameState
+{
+	std::array<uint32_t, PLAYERS> hash {};
+	std::array<uint32_t, PLAYERS> orders {};
+
+	void apply(Message const &message)
+	{
+		hash[message.player] = hash[message.player] * 31 + message.payload;
+		orders[message.player] += message.type == GAME_DROIDINFO;
+	}
+	std::string serialize() const
+	{
+		return nlohmann::json{{"hash", hash}, {"orders", orders}}.dump() + std::string(20000, ' ');
+	}
+	static GameState deserialize(std::string const &data)
+	{
+		GameState state;
+		nlohmann::json json = nlohmann::json::parse(data);
+		json.at("hash").get_to(state.hash);
+		json.at("orders").get_to(state.orders);
+		return state;
+	}
+	bool operator ==(GameState const &) const = default;
+};
+
+static NetMessage netMessage(Message const &message)
+{
+	NetMessageBuilder builder(message.type);
+	uint8_t payload[4];
+	std::memcpy(payload, &message.payload, 4);
+	builder.append(payload, 4);
+	return builder.build();
+}
+
+/// The messages of the whole game, GAME_LENGTH ms long.
+static std::vector<Message> makeMessages()
+{
+	std::vector<Message> messages;
+	for (uint32_t time = TICK; time <= GAME_LENGTH; time += TICK)
+	{
+		for (uint8_t player = 0; player < PLAYERS; ++player)
+		{
+			const uint8_t type = time % 1000 == 0 ? GAME_DROIDINFO : GAME_GAME_TIME;
+			messages.push_back(Message{player, type, time * PLAYERS + player});
+		}
+	}
+	return messages;
+}
+
+/// Plays the messages tick by tick into the replay being written, adding keyframes when it wants them,
+/// as the game loop does (see replayKeyframesUpdate()). Returns the keyframes added.
+static std::vector<std::string> writeMessages(std::vector<Message> const &messages, bool withViewerMessages)
+{
+	std::vector<std::string> keyframes;
+	GameState state;
+	size_t next = 0;
+	for (gameTime = TICK; gameTime <= GAME_LENGTH; gameTime += TICK)
+	{
+		for (; next < messages.size() && messages[next].gameTime() <= gameTime; ++next)
+		{
+			auto message = netMessage(messages[next]);
+			NETreplaySaveNetMessage(&message, messages[next].player);
+			state.apply(messages[next]);
+		}
+		if (withViewerMessages)
+		{
+			// The chat of whoever is watching the replay being re-indexed, which doesn't belong in it
+			auto message = netMessage(Message{MAX_CONNECTED_PLAYERS, GAME_DROIDINFO, 1});
+			NETreplaySaveNetMessage(&message, MAX_CONNECTED_PLAYERS);
+		}
+		if (NETreplaySaveWantsKeyframe(gameTime))
+		{
+			keyframes.push_back(state.serialize());
+			NETreplaySaveKeyframe(gameTime, state.serialize());
+		}
+	}
+	return keyframes;
+}
+
+/// Where a keyframe is in the replay: like ReplaySeekPoint in nettypes.cpp, but with one queue.
+struct SeekPoint
+{
+	ReplayKeyframeInfo keyframe;
+	size_t messagesBefore;
+};
+
+struct LoadedReplay
+{
+	uint32_t formatVersion = 0;
+	bool ended = false;
+	std::vector<Message> messages;
+	std::vector<SeekPoint> seekPoints;
+};
+
+/// Reads all the messages of a replay, as NETloadReplay() does.
+static LoadedReplay loadReplay(std::string const &filename)
+{
+	LoadedReplay replay;
+	TestOptions options;
+	if (!NETreplayLoadStart(filename, options, replay.formatVersion))
+	{
+		return replay;
+	}
+	std::unique_ptr<NetMessage> message;
+	uint8_t player;
+	std::vector<ReplayKeyframeInfo> keyframesPassed;
+	while (NETreplayLoadNetMessage(message, player, &keyframesPassed))
+	{
+		for (auto const &keyframe : keyframesPassed)
+		{
+			replay.seekPoints.push_back(SeekPoint{keyframe, replay.messages.size()});
+		}
+		keyframesPassed.clear();
+		if (message->type() == REPLAY_ENDED)
+		{
+			replay.ended = true;
+			break;
+		}
+		uint32_t payload = 0;
+		if (message->payloadSize() == 4)
+		{
+			std::memcpy(&payload, message->payload(), 4);
+		}
+		replay.messages.push_back(Message{player, message->type(), payload});
+	}
+	NETreplayLoadStop();
+	return replay;
+}
+
+/// The state after the messages up to targetTime, played from the start.
+static GameState playLinear(LoadedReplay const &replay, uint32_t targetTime)
+{
+	GameState state;
+	for (auto const &message : replay.messages)
+	{
+		if (message.gameTime() > targetTime)
+		{
+			break;
+		}
+		state.apply(message);
+	}
+	return state;
+}
+
+/// The state after the messages up to targetTime, played from the last keyframe before it.
+static bool playFromKeyframe(std::string const &filename, LoadedReplay const &replay, uint32_t targetTime, GameState &state, uint32_t &keyframeTime)
+{
+	auto point = std::find_if(replay.seekPoints.rbegin(), replay.seekPoints.rend(), [targetTime](SeekPoint const &point) {
+		return point.keyframe.gameTime <= targetTime;
+	});
+	std::string data;
+	if (point == replay.seekPoints.rend() || !NETreplayLoadKeyframe(filename, point->keyframe, data))
+	{
+		return false;
+	}
+	keyframeTime = point->keyframe.gameTime;
+	state = GameState::deserialize(data);
+	for (size_t i = point->messagesBefore; i < replay.messages.size() && replay.messages[i].gameTime() <= targetTime; ++i)
+	{
+		state.apply(replay.messages[i]);
+	}
+	return true;
+}
+
+static std::vector<uint8_t> readFile(std::filesystem::path const &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static uint32_t readBE32(std::vector<uint8_t> const &data, size_t offset)
+{
+	return (uint32_t)data[offset] << 24 | (uint32_t)data[offset + 1] << 16 | (uint32_t)data[offset + 2] << 8 | data[offset + 3];
+}
+
+/// Checks the index at the end of the replay against the keyframes in its message stream, and seeking against linear play.
+static void checkKeyframes(std::filesystem::path const &writeDir, std::string const &filename, std::vector<Message> const &messages, std::vector<std::string> const &keyframes)
+{
+	LoadedReplay replay = loadReplay(filename);
+	CHECK_TRUE(replay.formatVersion == 4, "%s: format version %u", filename.c_str(), replay.formatVersion);
+	CHECK_TRUE(replay.ended, "%s: no REPLAY_ENDED", filename.c_str());
+	CHECK_TRUE(replay.messages.size() == messages.size(), "%s: %zu messages, %zu written", filename.c_str(), replay.messages.size(), messages.size());
+	bool sameMessages = replay.messages.size() == messages.size();
+	for (size_t i = 0; sameMessages && i < messages.size(); ++i)
+	{
+		sameMessages = replay.messages[i].player == messages[i].player && replay.messages[i].type == messages[i].type && replay.messages[i].payload == messages[i].payload;
+	}
+	CHECK_TRUE(sameMessages, "%s: messages differ from the ones written", filename.c_str());
+
+	// The "end of game info" JSON is preceded and followed by its size
+	std::vector<uint8_t> data = readFile(writeDir / filename);
+	const uint32_t trailerSize = data.size() >= 8 ? readBE32(data, data.size() - 4) : 0;
+	CHECK_TRUE(trailerSize + 8 <= data.size() && readBE32(data, data.size() - 8 - trailerSize) == trailerSize, "%s: bad end of game info size", filename.c_str());
+
+	std::vector<ReplayKeyframeInfo> index;
+	CHECK_TRUE(NETreplayReadKeyframeIndex(filename, index), "%s: no keyframe index", filename.c_str());
+	CHECK_TRUE(index.size() == 3 && keyframes.size() == 3 && replay.seekPoints.size() == 3, "%s: %zu keyframes in the index, %zu in the stream, %zu written", filename.c_str(), index.size(), replay.seekPoints.size(), keyframes.size());
+	for (size_t i = 0; i < index.size() && i < replay.seekPoints.size() && i < keyframes.size(); ++i)
+	{
+		const uint32_t expectedTime = (i + 1) * 60 * GAME_TICKS_PER_SEC;
+		CHECK_TRUE(index[i].gameTime == expectedTime && replay.seekPoints[i].keyframe.gameTime == expectedTime, "%s: keyframe %zu at %u", filename.c_str(), i, index[i].gameTime);
+		CHECK_TRUE(index[i].fileOffset == replay.seekPoints[i].keyframe.fileOffset, "%s: keyframe %zu indexed at %llu, in the stream at %llu", filename.c_str(), i, (unsigned long long)index[i].fileOffset, (unsigned long long)replay.seekPoints[i].keyframe.fileOffset);
+		CHECK_TRUE(index[i].fileOffset < data.size() && data[index[i].fileOffset] == 0xFF, "%s: keyframe %zu offset isn't a keyframe record", filename.c_str(), i);
+		std::string state;
+		CHECK_TRUE(NETreplayLoadKeyframe(filename, index[i], state) && state == keyframes[i], "%s: keyframe %zu differs from the one written", filename.c_str(), i);
+		CHECK_TRUE(GameState::deserialize(keyframes[i]) == playLinear(replay, expectedTime), "%s: keyframe %zu isn't the state at its game time", filename.c_str(), i);
+	}
+	std::string state;
+	CHECK_TRUE(index.empty() || !NETreplayLoadKeyframe(filename, ReplayKeyframeInfo{index[0].gameTime, index[0].fileOffset + 1}, state), "%s: loaded a keyframe at a bad offset", filename.c_str());
+	CHECK_TRUE(index.empty() || !NETreplayLoadKeyframe(filename, ReplayKeyframeInfo{index[0].gameTime + 1, index[0].fileOffset}, state), "%s: loaded a keyframe with the wrong game time", filename.c_str());
+
+	static const uint32_t targets[] = {59900, 60000, 90000, 150000, 180000, GAME_LENGTH};
+	for (uint32_t target : targets)
+	{
+		GameState seeked;
+		uint32_t keyframeTime = 0;
+		const bool found = playFromKeyframe(filename, replay, target, seeked, keyframeTime);
+		if (target < 60000)
+		{
+			CHECK_TRUE(!found, "%s: seeking to %u found a keyframe", filename.c_str(), target);
+			continue;
+		}
+		CHECK_TRUE(found && keyframeTime == target / 60000 * 60000, "%s: seeking to %u used the keyframe at %u", filename.c_str(), target, keyframeTime);
+		CHECK_TRUE(seeked == playLinear(replay, target), "%s: seeking to %u differs from playing to it", filename.c_str(), target);
+	}
+}
+
+/// Writes a replay the way versions from before keyframes did: format version 3, no keyframes and no index.
+static bool writeV3Replay(std::string const &filename, std::vector<Message> const &messages)
+{
+	PHYSFS_file *handle = PHYSFS_openWrite(filename.c_str());
+	if (handle == nullptr)
+	{
+		return false;
+	}
+	PHYSFS_writeSBE32(handle, 0x575A7270);  // "WZrp"
+	const std::string settings = nlohmann::json{{"replayFormatVer", 3}, {"major", NETGetMajorVersion()}, {"minor", NETGetMinorVersion()}, {"gameOptions", {{"scavengers", 1}}}}.dump();
+	PHYSFS_writeUBE32(handle, settings.size());
+	WZ_PHYSFS_writeBytes(handle, settings.data(), settings.size());
+	const uint8_t mapData[] = {1, 2, 3};
+	PHYSFS_writeUBE32(handle, 7);
+	PHYSFS_writeUBE32(handle, sizeof(mapData));
+	WZ_PHYSFS_writeBytes(handle, mapData, sizeof(mapData));
+
+	std::vector<uint8_t> stream;
+	for (auto const &message : messages)
+	{
+		stream.push_back(message.player);
+		netMessage(message).rawDataAppendToVector(stream);
+	}
+	stream.push_back(NetPlay.hostPlayer);
+	NetMessageBuilder(REPLAY_ENDED, 0).build().rawDataAppendToVector(stream);
+	WZ_PHYSFS_writeBytes(handle, stream.data(), stream.size());
+
+	const std::string endOfGameInfo = nlohmann::json{{"gameTimeElapsed", GAME_LENGTH}}.dump();
+	PHYSFS_writeUBE32(handle, endOfGameInfo.size());
+	WZ_PHYSFS_writeBytes(handle, endOfGameInfo.data(), endOfGameInfo.size());
+	PHYSFS_writeUBE32(handle, endOfGameInfo.size());
+	return PHYSFS_close(handle) != 0;
+}
+
+int main(int argc, char **argv)
+{
+	(void)argc;
+	const std::filesystem::path writeDir = std::filesystem::temp_directory_path() / "wz_replay_keyframes_test";
+	std::filesystem::remove_all(writeDir);
+	std::filesystem::create_directories(writeDir);
+	if (!PHYSFS_init(argv[0]) || !PHYSFS_setWriteDir(writeDir.string().c_str()) || !PHYSFS_mount(writeDir.string().c_str(), nullptr, PHYSFS_PREPEND) || !PHYSFS_mkdir("replay/skirmish"))
+	{
+		std::printf("FAIL: can't set up PhysFS in %s\n", writeDir.string().c_str());
+		return 1;
+	}
+	NetPlay.hostPlayer = 0;
+	TestOptions options;
+	const std::vector<Message> messages = makeMessages();
+
+	// A replay recorded with keyframes
+	const std::string recorded = NETreplaySaveStart("skirmish", options, 0);
+	CHECK_TRUE(!recorded.empty(), "can't start recording a replay");
+	std::vector<std::string> keyframes = writeMessages(messages, false);
+	CHECK_TRUE(NETreplaySaveStop(options), "can't finish recording %s", recorded.c_str());
+	checkKeyframes(writeDir, recorded, messages, keyframes);
+
+	// A replay from before keyframes still loads
+	const std::string old = "replay/skirmish/old.wzrp";
+	CHECK_TRUE(writeV3Replay(old, messages), "can't write %s", old.c_str());
+	std::vector<ReplayKeyframeInfo> index;
+	CHECK_TRUE(!NETreplayReadKeyframeIndex(old, index) && index.empty(), "%s: has a keyframe index", old.c_str());
+	LoadedReplay replay = loadReplay(old);
+	CHECK_TRUE(replay.formatVersion == 3 && replay.ended && replay.messages.size() == messages.size() && replay.seekPoints.empty(), "%s: version %u, %zu messages, %zu keyframes", old.c_str(), replay.formatVersion, replay.messages.size(), replay.seekPoints.size());
+	GameState finalState;
+	for (auto const &message : messages)
+	{
+		finalState.apply(message);
+	}
+	CHECK_TRUE(playLinear(replay, GAME_LENGTH) == finalState, "%s: doesn't play to the end state of the game", old.c_str());
+
+	// Re-indexing it, abandoned half way, leaves it as it was
+	const std::vector<uint8_t> original = readFile(writeDir / old);
+	CHECK_TRUE(NETreplayReindexStart(old) && NETreplayReindexActive(), "can't start re-indexing %s", old.c_str());
+	for (size_t i = 0; i < 100; ++i)
+	{
+		auto message = netMessage(messages[i]);
+		NETreplaySaveNetMessage(&message, messages[i].player);
+	}
+	CHECK_TRUE(!NETreplaySaveStop(options) && !NETreplayReindexActive(), "%s: abandoned re-index was finished", old.c_str());
+	CHECK_TRUE(!std::filesystem::exists(writeDir / (old + ".reindex")), "%s: abandoned re-index left its copy", old.c_str());
+	CHECK_TRUE(readFile(writeDir / old) == original, "%s: changed by an abandoned re-index", old.c_str());
+
+	// Re-indexing it to the end adds the keyframes and the index
+	CHECK_TRUE(NETreplayReindexStart(old), "can't start re-indexing %s", old.c_str());
+	keyframes = writeMessages(messages, true);
+	CHECK_TRUE(NETreplayReindexFinish(), "can't finish re-indexing %s", old.c_str());
+	CHECK_TRUE(!std::filesystem::exists(writeDir / (old + ".reindex")), "%s: re-index left its copy", old.c_str());
+	checkKeyframes(writeDir, old, messages, keyframes);
+
+	PHYSFS_deinit();
+	std::filesystem::remove_all(writeDir);
+
+	return checkSummary();
+}
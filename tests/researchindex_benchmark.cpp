@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/researchindex.cpp.
+//
+// Builds random research trees (including topics without prerequisites, prerequisites listed twice
+// and prerequisites which don't exist), completes and un-completes random topics for several
+// players, and checks after every change that the index agrees with walking the prerequisite
+// lists, as researchAvailable() used to, also after rebuilding half way through. Prints the time
+// for ten AIs to ask about every topic of a large modded tree both ways.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/researchindex_benchmark.cpp src/researchindex.cpp -o researchindex_benchmark && ./researchindex_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: researchindex_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/researchindex.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Prerequisites = std::vector<std::vector<uint16_t>>;
+using Completed = std::vector<std::vector<bool>>;
+
+// Each topic depends on up to four earlier topics, like the base game's tree but wider.
+static Prerequisites makeTree(size_t topics, uint32_t seed, bool oddities)
+{
+	std::mt19937 rng(seed);
+	Prerequisites prerequisites(topics);
+	for (size_t topic = 1; topic < topics; ++topic)
+	{
+		const unsigned count = rng() % 5;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			prerequisites[topic].push_back(static_cast<uint16_t>(rng() % topic));
+		}
+		if (oddities && rng() % 50 == 0 && !prerequisites[topic].empty())
+		{
+			prerequisites[topic].push_back(prerequisites[topic][0]);
+		}
+		if (oddities && rng() % 200 == 0)
+		{
+			prerequisites[topic].push_back(static_cast<uint16_t>(topics + 3));
+		}
+	}
+	return prerequisites;
+}
+
+static bool walk(Prerequisites const &prerequisites, std::vector<bool> const &completed, size_t topic)
+{
+	for (uint16_t prerequisite : prerequisites[topic])
+	{
+		if (prerequisite >= completed.size() || !completed[prerequisite])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static int mismatches(ResearchPrerequisiteIndex const &index, Prerequisites const &prerequisites, Completed const &completed)
+{
+	int count = 0;
+	for (unsigned player = 0; player < completed.size(); ++player)
+	{
+		for (size_t topic = 0; topic < prerequisites.size(); ++topic)
+		{
+			count += !index.indexed(player, topic) || index.prerequisitesCompleted(player, topic) != walk(prerequisites, completed[player], topic);
+		}
+	}
+	return count;
+}
+
+static void checkIndex(size_t topics, unsigned players, uint32_t seed)
+{
+	const Prerequisites prerequisites = makeTree(topics, seed, true);
+	Completed completed(players, std::vector<bool>(topics, false));
+	std::mt19937 rng(seed + 1);
+
+	ResearchPrerequisiteIndex index;
+	index.rebuild(prerequisites, completed);
+	CHECK_TRUE(mismatches(index, prerequisites, completed) == 0, "%zu topics: fresh index disagrees", topics);
+
+	int changeMismatches = 0;
+	for (int change = 0; change < 4000; ++change)
+	{
+		const unsigned player = rng() % players;
+		const size_t topic = rng() % topics;
+		// Mostly completing research, sometimes undoing it, sometimes reporting no change.
+		const bool value = rng() % 8 != 0;
+		completed[player][topic] = value;
+		index.setCompleted(player, topic, value);
+		if (change % 97 == 0)
+		{
+			changeMismatches += mismatches(index, prerequisites, completed);
+		}
+		if (change == 2000)
+		{
+			index.rebuild(prerequisites, completed);
+		}
+	}
+	CHECK_TRUE(changeMismatches == 0, "%zu topics: %d disagreements while changing", topics, changeMismatches);
+	CHECK_TRUE(mismatches(index, prerequisites, completed) == 0, "%zu topics: index disagrees at the end", topics);
+
+	index.setCompleted(players, 0, true);
+	index.setCompleted(0, topics, true);
+	CHECK_TRUE(!index.indexed(players, 0) && !index.indexed(0, topics), "%zu topics: out of range topics indexed", topics);
+	index.clear();
+	CHECK_TRUE(!index.indexed(0, 0), "cleared index has topics");
+}
+
+static void benchmark()
+{
+	constexpr size_t TOPICS = 3000;
+	constexpr unsigned PLAYERS = 10;
+	constexpr int POLLS = 20;
+	const Prerequisites prerequisites = makeTree(TOPICS, 9, false);
+	Completed completed(PLAYERS, std::vector<bool>(TOPICS, false));
+	std::mt19937 rng(10);
+	for (auto &player : completed)
+	{
+		for (size_t topic = 0; topic < TOPICS; ++topic)
+		{
+			player[topic] = rng() % 3 == 0;
+		}
+	}
+	ResearchPrerequisiteIndex index;
+	index.rebuild(prerequisites, completed);
+
+	uint64_t walked = 0, indexed = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int poll = 0; poll < POLLS; ++poll)
+	{
+		for (unsigned player = 0; player < PLAYERS; ++player)
+		{
+			for (size_t topic = 0; topic < TOPICS; ++topic)
+			{
+				walked += walk(prerequisites, completed[player], topic);
+			}
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (int poll = 0; poll < POLLS; ++poll)
+	{
+		for (unsigned player = 0; player < PLAYERS; ++player)
+		{
+			for (size_t topic = 0; topic < TOPICS; ++topic)
+			{
+				indexed += index.prerequisitesCompleted(player, topic);
+			}
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	CHECK_TRUE(walked == indexed, "benchmark found %llu topics by walking, %llu indexed", static_cast<unsigned long long>(walked), static_cast<unsigned long long>(indexed));
+	const double polls = POLLS * PLAYERS;
+	std::printf("%zu topics: prerequisites walked  %8.2f us per AI poll\n", TOPICS, std::chrono::duration<double, std::micro>(middle - start).count() / polls);
+	std::printf("%zu topics: prerequisites indexed %8.2f us per AI poll\n", TOPICS, std::chrono::duration<double, std::micro>(end - middle).count() / polls);
+}
+
+int main(int argc, char **argv)
+{
+	checkIndex(1, 2, 1);
+	checkIndex(50, 4, 2);
+	checkIndex(1500, 10, 3);
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/scriptbytecodecache.cpp.
+//
+// Checks that bytecode is shared between lookups, compiled again once erased, and dropped least
+// recently used first past the memory limit. Prints the time to look up bytecode the size of a
+// large AI script, against copying it.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/scriptbytecodecache_benchmark.cpp src/scriptbytecodecache.cpp -o scriptbytecodecache_benchmark && ./scriptbytecodecache_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: scriptbytecodecache_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/scriptbytecodecache.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> makeBytecode(size_t size, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<uint8_t> bytecode(size);
+	for (auto &b : bytecode)
+	{
+		b = static_cast<uint8_t>(rng());
+	}
+	return bytecode;
+}
+
+static void checkCache()
+{
+	const std::vector<uint8_t> rules = makeBytecode(5000, 2), bot = makeBytecode(8000, 3);
+
+	// Nothing cached yet, so compile and store.
+	ScriptBytecodeCache cache;
+	CHECK_TRUE(!cache.find("rules") && !cache.find("bot") && cache.stats().misses == 2, "empty cache found bytecode");
+	cache.insert("rules", rules);
+	ScriptBytecodeCache::Bytecode stored = cache.insert("bot", bot);
+	CHECK_TRUE(stored && *stored == bot, "stored bytecode differs");
+
+	// Ten bots share the bytecode.
+	bool shared = true;
+	for (int i = 0; i < 10; ++i)
+	{
+		shared = shared && cache.find("bot") == stored;
+	}
+	CHECK_TRUE(shared && cache.stats().hits == 10, "bot bytecode not shared, %llu hits", static_cast<unsigned long long>(cache.stats().hits));
+
+	// Storing again replaces the bytecode.
+	cache.insert("rules", bot);
+	ScriptBytecodeCache::Bytecode found = cache.find("rules");
+	CHECK_TRUE(found && *found == bot, "bytecode not replaced");
+
+	// Bytecode which cannot be loaded is forgotten, so that it is compiled again. Lookups still hold it.
+	cache.erase("rules");
+	CHECK_TRUE(!cache.find("rules") && found && *found == bot, "erased bytecode found");
+	cache.erase("rules");
+	CHECK_TRUE(cache.find("bot") == stored, "erasing twice dropped other bytecode");
+
+	// Past the memory limit, the least recently used bytecode is dropped.
+	const size_t big = ScriptBytecodeCache::MAX_MEMORY_BYTES / 3 + 1;
+	ScriptBytecodeCache limited;
+	limited.insert("a", makeBytecode(big, 4));
+	limited.insert("b", makeBytecode(big, 5));
+	limited.find("a");
+	limited.insert("c", makeBytecode(big, 6));  // drops b
+	CHECK_TRUE(limited.find("a") && limited.find("c"), "recently used bytecode dropped");
+	CHECK_TRUE(!limited.find("b"), "least recently used bytecode kept");
+	limited.insert("b", makeBytecode(big, 5));  // drops a
+	CHECK_TRUE(!limited.find("a") && limited.find("b") && limited.find("c"), "wrong bytecode dropped after storing again");
+
+	// Bytecode larger than the limit is still stored, alone.
+	limited.insert("huge", makeBytecode(ScriptBytecodeCache::MAX_MEMORY_BYTES + 1, 7));
+	CHECK_TRUE(limited.find("huge") && !limited.find("b") && !limited.find("c"), "bytecode over the limit not stored alone");
+}
+
+static void benchmark()
+{
+	// About the size of the bytecode of a large AI, with its includes.
+	const std::vector<uint8_t> bytecode = makeBytecode(2 << 20, 7);
+	constexpr int REPEAT = 20;
+	ScriptBytecodeCache cache;
+	cache.insert("big", bytecode);
+	uint64_t sink = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < REPEAT; ++i)
+	{
+		sink += cache.find("big")->size();
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (int i = 0; i < REPEAT; ++i)
+	{
+		std::vector<uint8_t> copy = *cache.find("big");
+		sink -= copy.size();
+	}
+	auto end = std::chrono::steady_clock::now();
+	CHECK_TRUE(sink == 0, "benchmark lookups found different bytecode");
+	std::printf("2 MiB bytecode: shared  %8.4f ms per lookup\n", std::chrono::duration<double, std::milli>(middle - start).count() / REPEAT);
+	std::printf("2 MiB bytecode: copied  %8.4f ms per lookup\n", std::chrono::duration<double, std::milli>(end - middle).count() / REPEAT);
+}
+
+int main(int argc, char **argv)
+{
+	checkCache();
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
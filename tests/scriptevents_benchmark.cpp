@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/scriptevents.cpp.
+//
+// Checks that event names map to events and back, that a coalescer with no window admits every
+// event, and that with a window it admits exactly the events a simple model of "at most once per
+// key per window" admits, across many keys (so that expired keys are pruned) and across a
+// save and restore half way through. Prints how many events a battle of a few hundred units
+// delivers to a script with and without coalescing eventAttacked, and the time taken to coalesce.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/scriptevents_benchmark.cpp src/scriptevents.cpp -o scriptevents_benchmark && ./scriptevents_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: scriptevents_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/scriptevents.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Event
+{
+	uint32_t key;
+	uint32_t gameTime;
+};
+
+// Events for keys out of [0, keys), at increasing game times, in ticks of 100 ms.
+static std::vector<Event> makeEvents(unsigned count, uint32_t keys, unsigned perTick, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<Event> events(count);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		events[i] = {static_cast<uint32_t>(rng() % keys), 1000 + (i / perTick) * 100};
+	}
+	return events;
+}
+
+// What should be admitted: an event, unless the same key was admitted less than window ms before.
+static std::vector<bool> model(std::vector<Event> const &events, uint32_t window)
+{
+	std::map<uint32_t, uint32_t> last;
+	std::vector<bool> admitted;
+	for (auto const &e : events)
+	{
+		auto it = last.find(e.key);
+		bool admit = window == 0 || it == last.end() || e.gameTime - it->second >= window;
+		if (admit)
+		{
+			last[e.key] = e.gameTime;
+		}
+		admitted.push_back(admit);
+	}
+	return admitted;
+}
+
+static void checkCoalescing(std::vector<Event> const &events, uint32_t window, char const *what)
+{
+	std::vector<bool> expected = model(events, window);
+
+	ScriptEventCoalescer coalescer;
+	coalescer.setWindow(window);
+	int mismatches = 0;
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		mismatches += coalescer.admit(events[i].key, events[i].gameTime) != expected[i];
+	}
+	CHECK_TRUE(mismatches == 0, "%s, window %u: %d events admitted differently from the model", what, window, mismatches);
+
+	// Save half way through, and carry on in a restored coalescer.
+	ScriptEventCoalescer first, restored;
+	first.setWindow(window);
+	const size_t half = events.size() / 2;
+	for (size_t i = 0; i < half; ++i)
+	{
+		first.admit(events[i].key, events[i].gameTime);
+	}
+	restored.restore(first.window(), first.recent(events[half].gameTime));
+	mismatches = 0;
+	for (size_t i = half; i < events.size(); ++i)
+	{
+		mismatches += restored.admit(events[i].key, events[i].gameTime) != expected[i];
+	}
+	CHECK_TRUE(restored.window() == window && mismatches == 0, "%s, window %u: %d events admitted differently after restoring", what, window, mismatches);
+}
+
+static void benchmark()
+{
+	// 300 units, each hit a few times per second, for ten minutes of game time.
+	constexpr uint32_t UNITS = 300;
+	constexpr unsigned HITS_PER_TICK = 120;
+	constexpr unsigned TICKS = 10 * 60 * 10;
+	std::vector<Event> events = makeEvents(HITS_PER_TICK * TICKS, UNITS, HITS_PER_TICK, 7);
+
+	for (uint32_t window : {0u, 1000u, 3000u})
+	{
+		ScriptEventCoalescer coalescer;
+		coalescer.setWindow(window);
+		uint64_t delivered = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (auto const &e : events)
+		{
+			delivered += coalescer.admit(e.key, e.gameTime);
+		}
+		auto end = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(end - start).count() / events.size();
+		std::printf("eventAttacked, window %4u ms: %8llu of %zu events delivered (%5.1f%%), %5.1f ns per event\n", window,
+		            static_cast<unsigned long long>(delivered), events.size(), 100.0 * delivered / events.size(), ns);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	for (size_t i = 0; i < NUM_QUEUED_SCRIPT_EVENTS; ++i)
+	{
+		QueuedScriptEvent event = QueuedScriptEvent::DroidIdle;
+		bool found = queuedScriptEventFromName(queuedScriptEventName(static_cast<QueuedScriptEvent>(i)), event);
+		CHECK_TRUE(found && static_cast<size_t>(event) == i, "%s does not map back to itself", queuedScriptEventName(static_cast<QueuedScriptEvent>(i)));
+	}
+	QueuedScriptEvent event;
+	CHECK_TRUE(!queuedScriptEventFromName("eventDestroyed", event) && !queuedScriptEventFromName("", event), "unqueued events have names");
+
+	ScriptEventCoalescer none;
+	bool all = true;
+	for (auto const &e : makeEvents(1000, 3, 50, 1))
+	{
+		all = all && none.admit(e.key, e.gameTime);
+	}
+	CHECK_TRUE(all && none.recent(100000).empty(), "coalescer without a window dropped or kept events");
+
+	for (uint32_t window : {0u, 1u, 100u, 1000u, 5000u})
+	{
+		checkCoalescing(makeEvents(20000, 10, 20, 2), window, "few keys");
+		checkCoalescing(makeEvents(20000, 5000, 20, 3), window, "many keys");
+	}
+
+	// Changing the window forgets what was delivered.
+	ScriptEventCoalescer coalescer;
+	coalescer.setWindow(1000);
+	coalescer.admit(1, 1000);
+	bool heldBack = !coalescer.admit(1, 1500);
+	coalescer.setWindow(1000);
+	CHECK_TRUE(heldBack && coalescer.admit(1, 1500), "setWindow kept the events delivered");
+
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/statids.cpp.
+//
+// Checks that names are numbered densely in the order they are first interned, that interning a
+// name again or looking it up returns the same id (also from a view into a longer string), that
+// names never interned are not found, and that clearing starts the numbering again. Prints the
+// time to look up a stat name the way scripts did (building a string for a hash map, or comparing
+// against every research topic) and with the interned table.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/statids_benchmark.cpp src/statids.cpp -o statids_benchmark && ./statids_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: statids_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/statids.h"
+#include "tests/testcheck.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Names like the research and component ids of the base game, long enough not to fit in a small string.
+static std::vector<std::string> makeNames(size_t count, char const *prefix)
+{
+	std::vector<std::string> names;
+	for (size_t i = 0; i < count; ++i)
+	{
+		names.push_back(std::string(prefix) + "-Wpn-Cannon" + std::to_string(i % 7) + "Mk" + std::to_string(i));
+	}
+	return names;
+}
+
+static void checkTable()
+{
+	StatIdTable table;
+	CHECK_TRUE(table.find("MG1Mk1") == STAT_ID_NONE && table.size() == 0, "empty table found a name");
+
+	const std::vector<std::string> names = makeNames(5000, "R");
+	bool dense = true;
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		dense = dense && table.intern(names[i]) == i;
+	}
+	CHECK_TRUE(dense && table.size() == names.size(), "ids not numbered in the order interned");
+
+	bool found = true;
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		found = found && table.find(names[i]) == i && table.intern(names[i]) == i && table.name(i) == names[i];
+	}
+	CHECK_TRUE(found && table.size() == names.size(), "interned names not found, or interned twice");
+
+	int missing = 0;
+	for (auto const &name : makeNames(5000, "S"))
+	{
+		missing += table.find(name) == STAT_ID_NONE;
+	}
+	CHECK_TRUE(missing == 5000, "%d of 5000 names never interned were not found", missing);
+	CHECK_TRUE(table.find("") == STAT_ID_NONE && table.find(names[0] + "x") == STAT_ID_NONE, "prefix or empty name found");
+
+	const std::string longer = "(" + names[42] + ")";
+	CHECK_TRUE(table.find(std::string_view(longer).substr(1, names[42].size())) == 42, "name not found from a view into a longer string");
+
+	table.clear();
+	CHECK_TRUE(table.size() == 0 && table.find(names[0]) == STAT_ID_NONE, "cleared table found a name");
+	CHECK_TRUE(table.intern(names[7]) == 0 && table.intern(names[0]) == 1, "numbering not restarted after clearing");
+}
+
+static void benchmark()
+{
+	// About as many research topics as the base game, looked up by scripts choosing what to research.
+	const std::vector<std::string> names = makeNames(500, "R");
+	constexpr int LOOKUPS = 200000;
+	std::mt19937 rng(1);
+	std::vector<char const *> queries;
+	for (int i = 0; i < LOOKUPS; ++i)
+	{
+		queries.push_back(names[rng() % names.size()].c_str());
+	}
+
+	std::unordered_map<std::string, size_t> map;
+	StatIdTable table;
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		map.emplace(names[i], i);
+		table.intern(names[i]);
+	}
+
+	uint64_t sumMap = 0, sumScan = 0, sumTable = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (char const *query : queries)
+	{
+		sumMap += map.find(std::string(query))->second;
+	}
+	auto afterMap = std::chrono::steady_clock::now();
+	for (char const *query : queries)
+	{
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			if (names[i].compare(query) == 0)
+			{
+				sumScan += i;
+				break;
+			}
+		}
+	}
+	auto afterScan = std::chrono::steady_clock::now();
+	for (char const *query : queries)
+	{
+		sumTable += table.find(query);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	CHECK_TRUE(sumMap == sumTable && sumScan == sumTable, "benchmark lookups found different ids");
+	auto ns = [](auto from, auto to) { return std::chrono::duration<double, std::nano>(to - from).count() / LOOKUPS; };
+	std::printf("%zu names: string built, hash map   %7.1f ns per lookup\n", names.size(), ns(start, afterMap));
+	std::printf("%zu names: compared one by one     %7.1f ns per lookup\n", names.size(), ns(afterMap, afterScan));
+	std::printf("%zu names: interned table          %7.1f ns per lookup\n", names.size(), ns(afterScan, end));
+}
+
+int main(int argc, char **argv)
+{
+	checkTable();
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
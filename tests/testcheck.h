@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Checks shared by the standalone tests and benchmarks in tests/.
+//
+// Each of them counts its checks with CHECK_TRUE() and returns checkSummary() from main(). The
+// benchmarks skip their timings when run with --checks-only, which is how ctest runs them.
+
+#ifndef __INCLUDED_TESTS_TESTCHECK_H__
+#define __INCLUDED_TESTS_TESTCHECK_H__
+
+#include <cstdio>
+#include <cstring>
+
+inline int failures = 0;
+inline int checks = 0;
+
+#define CHECK_TRUE(cond, ...) \
+	do { \
+		checks++; \
+		if (!(cond)) { \
+			failures++; \
+			std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+			std::printf(__VA_ARGS__); \
+			std::printf("\n"); \
+		} \
+	} while (0)
+
+/// True if the command line asks for the checks only, without the timings.
+inline bool checksOnly(int argc, char **argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--checks-only") == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Prints the number of checks and failures, and returns the exit code: nonzero if any check failed.
+inline int checkSummary()
+{
+	std::printf("%s: %d checks, %d failures\n", failures == 0 ? "PASS" : "FAIL", checks, failures);
+	return failures == 0 ? 0 : 1;
+}
+
+#endif // __INCLUDED_TESTS_TESTCHECK_H__
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for src/tickprofiler.cpp.
+//
+// Checks that every duration falls in a bucket whose bounds hold it to within 12.5%, that
+// percentiles agree with sorting the durations to within a bucket, that scopes record only while
+// switched on, that several threads can record into one histogram without losing counts, and that
+// resetting empties the histograms. Prints the cost of a scope switched off and switched on.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/tickprofiler_benchmark.cpp src/tickprofiler.cpp -o tickprofiler_benchmark -pthread && ./tickprofiler_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: tickprofiler_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "src/tickprofiler.h"
+#include "tests/testcheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using profiling::LatencyHistogram;
+
+static void checkBuckets()
+{
+	std::mt19937_64 rng(1);
+	int misplaced = 0, imprecise = 0;
+	for (int i = 0; i < 200000; ++i)
+	{
+		const uint64_t ns = i < 1000 ? static_cast<uint64_t>(i) : rng() >> (rng() % 64);
+		const size_t index = LatencyHistogram::bucketIndex(ns);
+		const uint64_t upper = LatencyHistogram::bucketUpperNs(index);
+		const uint64_t lower = index == 0 ? 0 : LatencyHistogram::bucketUpperNs(index - 1) + 1;
+		misplaced += index >= LatencyHistogram::NUM_BUCKETS || ns < lower || ns > upper;
+		imprecise += static_cast<double>(upper - lower) > 0.125 * static_cast<double>(lower) + 1;
+	}
+	CHECK_TRUE(misplaced == 0, "%d durations outside their bucket", misplaced);
+	CHECK_TRUE(imprecise == 0, "%d buckets wider than 12.5%%", imprecise);
+	CHECK_TRUE(LatencyHistogram::bucketIndex(UINT64_MAX) == LatencyHistogram::NUM_BUCKETS - 1
+	           && LatencyHistogram::bucketUpperNs(LatencyHistogram::NUM_BUCKETS - 1) == UINT64_MAX, "largest duration not in the last bucket");
+}
+
+static void checkPercentiles()
+{
+	// Tick times: mostly a few hundred microseconds, with the odd slow tick.
+	std::mt19937 rng(2);
+	std::lognormal_distribution<double> tick(12.5, 0.6);
+	std::vector<uint64_t> durations;
+	LatencyHistogram histogram;
+	CHECK_TRUE(histogram.percentileNs(0.5) == 0 && histogram.minNs() == 0 && histogram.buckets().empty(), "empty histogram not empty");
+	for (int i = 0; i < 50000; ++i)
+	{
+		durations.push_back(static_cast<uint64_t>(tick(rng)));
+		histogram.record(durations.back());
+	}
+	std::sort(durations.begin(), durations.end());
+	uint64_t sum = 0;
+	for (uint64_t d : durations)
+	{
+		sum += d;
+	}
+	CHECK_TRUE(histogram.count() == durations.size() && histogram.sumNs() == sum, "count or sum wrong");
+	CHECK_TRUE(histogram.minNs() == durations.front() && histogram.maxNs() == durations.back(), "min or max wrong");
+
+	for (double fraction : {0.0, 0.5, 0.9, 0.99, 1.0})
+	{
+		const size_t rank = std::max<size_t>(1, static_cast<size_t>(fraction * durations.size() + 0.999999));
+		const uint64_t exact = durations[rank - 1];
+		const uint64_t estimate = histogram.percentileNs(fraction);
+		CHECK_TRUE(estimate >= exact && static_cast<double>(estimate) <= static_cast<double>(exact) * 1.125 + 1,
+		           "p%.0f: %llu estimated, %llu exact", fraction * 100, static_cast<unsigned long long>(estimate), static_cast<unsigned long long>(exact));
+	}
+
+	uint64_t bucketed = 0;
+	for (auto const &bucket : histogram.buckets())
+	{
+		bucketed += bucket.second;
+	}
+	CHECK_TRUE(bucketed == durations.size(), "buckets hold %llu durations", static_cast<unsigned long long>(bucketed));
+	histogram.reset();
+	CHECK_TRUE(histogram.count() == 0 && histogram.buckets().empty() && histogram.maxNs() == 0, "reset histogram not empty");
+}
+
+static void checkScopes()
+{
+	static profiling::TickProfileSite site("checkScopes");
+	profiling::setTickProfilerEnabled(false);
+	for (int i = 0; i < 10; ++i)
+	{
+		profiling::TickProfileScope scope(site);
+	}
+	CHECK_TRUE(site.histogram.count() == 0, "scope recorded while switched off");
+	CHECK_TRUE(profiling::tickProfilerEntries().empty(), "entries listed before anything was recorded");
+
+	profiling::setTickProfilerEnabled(true);
+	for (int i = 0; i < 10; ++i)
+	{
+		profiling::TickProfileScope scope(site);
+	}
+	CHECK_TRUE(site.histogram.count() == 10, "%llu of 10 scopes recorded", static_cast<unsigned long long>(site.histogram.count()));
+	CHECK_TRUE(&profiling::tickProfilerHistogram("checkScopes") == &site.histogram, "same name, different histogram");
+
+	// The path finding jobs record from worker threads.
+	constexpr int THREADS = 4;
+	constexpr int PER_THREAD = 100000;
+	LatencyHistogram &shared = profiling::tickProfilerHistogram("checkThreads");
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back([&shared, t]() {
+			for (int i = 0; i < PER_THREAD; ++i)
+			{
+				shared.record(static_cast<uint64_t>(t * PER_THREAD + i));
+			}
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	CHECK_TRUE(shared.count() == THREADS * PER_THREAD && shared.maxNs() == THREADS * PER_THREAD - 1 && shared.minNs() == 0,
+	           "threads recorded %llu of %d", static_cast<unsigned long long>(shared.count()), THREADS * PER_THREAD);
+
+	auto entries = profiling::tickProfilerEntries();
+	CHECK_TRUE(entries.size() == 2 && entries[0].name == "checkScopes" && entries[1].name == "checkThreads", "entries not listed by name");
+	profiling::resetTickProfiler();
+	CHECK_TRUE(profiling::tickProfilerEntries().empty() && site.histogram.count() == 0, "reset left durations");
+	profiling::setTickProfilerEnabled(false);
+}
+
+static void benchmark()
+{
+	static profiling::TickProfileSite site("benchmark");
+	constexpr int CALLS = 2000000;
+	volatile uint64_t sink = 0;
+	double ns[2];
+	for (bool enabled : {false, true})
+	{
+		profiling::setTickProfilerEnabled(enabled);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < CALLS; ++i)
+		{
+			profiling::TickProfileScope scope(site);
+			sink = sink + i;
+		}
+		ns[enabled] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+	}
+	profiling::setTickProfilerEnabled(false);
+	CHECK_TRUE(site.histogram.count() == CALLS, "benchmark recorded %llu scopes", static_cast<unsigned long long>(site.histogram.count()));
+	std::printf("scope switched off: %6.2f ns per scope\n", ns[0]);
+	std::printf("scope switched on:  %6.2f ns per scope\n", ns[1]);
+}
+
+int main(int argc, char **argv)
+{
+	checkBuckets();
+	checkPercentiles();
+	checkScopes();
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}
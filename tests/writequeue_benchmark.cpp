@@ -0,0 +1,305 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2026  Warzone 2100 Project (https://github.com/Warzone2100)
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+// Standalone test and benchmark for lib/netplay/write_queue.cpp.
+//
+// Queues random mixes of copied, moved and shared buffers, sends them in random partial amounts,
+// and checks that the bytes come out in order and that moved and shared buffers are sent from
+// where they are, without being copied. On Unix, also sends a queue through a socket pair with
+// sendmsg(), as TCPClientConnection::sendImpl does. Then compares the host relaying compressed
+// batches to ten clients, whose sockets fall behind for a while, with a flat vector per
+// connection (copied into, erased from the front) and with the write queue.
+// Build and run:
+//   c++ -std=c++20 -O2 -I. tests/writequeue_benchmark.cpp lib/netplay/write_queue.cpp -o writequeue_benchmark && ./writequeue_benchmark
+// or via CMake with -DWZ_BUILD_BENCHMARKS=ON (target: writequeue_benchmark).
+// --checks-only leaves out the timings (ctest runs it that way). Exits nonzero on failure.
+
+#include "lib/netplay/write_queue.h"
+#include "tests/testcheck.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <sys/socket.h>
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static std::vector<uint8_t> randomBytes(std::mt19937& rng, size_t size)
+{
+	std::vector<uint8_t> bytes(size);
+	for (auto& b : bytes)
+	{
+		b = static_cast<uint8_t>(rng());
+	}
+	return bytes;
+}
+
+// Sends at most `limit` bytes of the queue, the way a socket with a full buffer would.
+static size_t sendSome(WriteQueue& queue, std::vector<uint8_t>& out, size_t limit)
+{
+	WriteSpan spans[16];
+	const size_t count = queue.spans(spans, 16);
+	size_t sent = 0;
+	for (size_t i = 0; i < count && sent < limit; ++i)
+	{
+		const size_t size = std::min(spans[i].size, limit - sent);
+		out.insert(out.end(), spans[i].data, spans[i].data + size);
+		sent += size;
+	}
+	queue.consume(sent);
+	return sent;
+}
+
+static void checkOrder(uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	WriteQueue queue;
+	std::vector<uint8_t> expected, sent;
+	int sizeMismatches = 0;
+	for (int step = 0; step < 5000; ++step)
+	{
+		switch (rng() % 4)
+		{
+		case 0:
+		{
+			const auto bytes = randomBytes(rng, rng() % 40);
+			expected.insert(expected.end(), bytes.begin(), bytes.end());
+			queue.append(bytes.data(), bytes.size());
+			break;
+		}
+		case 1:
+		{
+			auto bytes = randomBytes(rng, rng() % 2000);
+			expected.insert(expected.end(), bytes.begin(), bytes.end());
+			queue.append(std::move(bytes));
+			break;
+		}
+		case 2:
+		{
+			auto bytes = std::make_shared<const std::vector<uint8_t>>(randomBytes(rng, rng() % 300));
+			expected.insert(expected.end(), bytes->begin(), bytes->end());
+			queue.append(bytes);
+			break;
+		}
+		default:
+			sendSome(queue, sent, rng() % 3000);
+			break;
+		}
+		sizeMismatches += queue.size() != expected.size() - sent.size() || queue.empty() != (queue.size() == 0);
+	}
+	while (!queue.empty())
+	{
+		sendSome(queue, sent, 1 + rng() % 3000);
+	}
+	CHECK_TRUE(sizeMismatches == 0, "seed %u: size wrong %d times", seed, sizeMismatches);
+	CHECK_TRUE(sent == expected, "seed %u: %zu bytes sent, %zu expected, or in the wrong order", seed, sent.size(), expected.size());
+}
+
+static void checkNoCopies()
+{
+	WriteQueue queue;
+	std::vector<uint8_t> batch(1000, 7);
+	const uint8_t* batchData = batch.data();
+	queue.append(std::move(batch));
+	WriteSpan span;
+	CHECK_TRUE(queue.spans(&span, 1) == 1 && span.data == batchData && span.size == 1000, "moved buffer was copied");
+	queue.consume(400);
+	CHECK_TRUE(queue.spans(&span, 1) == 1 && span.data == batchData + 400 && span.size == 600, "partial send not tracked");
+
+	auto message = std::make_shared<const std::vector<uint8_t>>(64, 3);
+	std::vector<WriteQueue> recipients(10);
+	int copied = 0;
+	for (auto& recipient : recipients)
+	{
+		recipient.append(message);
+		copied += recipient.spans(&span, 1) != 1 || span.data != message->data();
+	}
+	CHECK_TRUE(copied == 0 && message.use_count() == 11, "shared buffer was copied (use count %ld)", message.use_count());
+	for (auto& recipient : recipients)
+	{
+		recipient.consume(64);
+	}
+	CHECK_TRUE(message.use_count() == 1, "sent buffer still held (use count %ld)", message.use_count());
+
+	// Small copies are gathered into one buffer, but never into a shared one.
+	WriteQueue small;
+	small.append(message);
+	const uint8_t header[4] = {1, 2, 3, 4};
+	small.append(header, 4);
+	small.append(header, 4);
+	WriteSpan spans[4];
+	CHECK_TRUE(small.spans(spans, 4) == 2 && spans[0].size == 64 && spans[1].size == 8 && *message == std::vector<uint8_t>(64, 3), "small copies not gathered");
+	small.append(std::vector<uint8_t>());
+	small.append(WriteBuffer());
+	small.append(header, 0);
+	CHECK_TRUE(small.spans(spans, 4) == 2 && small.size() == 72, "empty appends queued");
+	small.clear();
+	CHECK_TRUE(small.empty() && small.spans(spans, 4) == 0, "cleared queue not empty");
+}
+
+static void checkSocket()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	int fds[2];
+	CHECK_TRUE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "socketpair failed");
+	std::mt19937 rng(8);
+	WriteQueue queue;
+	std::vector<uint8_t> expected;
+	for (int i = 0; i < 40; ++i)
+	{
+		auto bytes = randomBytes(rng, 1 + rng() % 500);
+		expected.insert(expected.end(), bytes.begin(), bytes.end());
+		if (i % 2)
+		{
+			queue.append(bytes.data(), bytes.size());
+		}
+		else
+		{
+			queue.append(std::move(bytes));
+		}
+	}
+	std::vector<uint8_t> received;
+	while (!queue.empty())
+	{
+		WriteSpan spans[16];
+		struct iovec buffers[16];
+		const size_t count = queue.spans(spans, 16);
+		for (size_t i = 0; i < count; ++i)
+		{
+			buffers[i].iov_base = const_cast<uint8_t*>(spans[i].data);
+			buffers[i].iov_len = spans[i].size;
+		}
+		struct msghdr msg = {};
+		msg.msg_iov = buffers;
+		msg.msg_iovlen = count;
+		const ssize_t sent = ::sendmsg(fds[0], &msg, 0);
+		if (sent <= 0)
+		{
+			break;
+		}
+		queue.consume(static_cast<size_t>(sent));
+		uint8_t buffer[65536];
+		for (ssize_t got = 0; got < sent;)
+		{
+			const ssize_t r = ::read(fds[1], buffer, sizeof(buffer));
+			if (r <= 0)
+			{
+				break;
+			}
+			received.insert(received.end(), buffer, buffer + r);
+			got += r;
+		}
+	}
+	CHECK_TRUE(received == expected, "sendmsg: %zu bytes received, %zu expected", received.size(), expected.size());
+	::close(fds[0]);
+	::close(fds[1]);
+#endif
+}
+
+static void benchmark()
+{
+	constexpr int CLIENTS = 10;
+	constexpr int TICKS = 20000;
+	constexpr size_t BATCH = 1500;        // One compressed flush per client per tick
+	// A congested socket, which alternately takes less and more than a batch per send.
+	constexpr size_t SLOW_SEND = 1000, FAST_SEND = 2000;
+	std::mt19937 rng(9);
+	const auto batchTemplate = randomBytes(rng, BATCH);
+	std::vector<uint8_t> sink(FAST_SEND);
+	uint64_t sentFlat = 0, sentQueue = 0;
+
+	// Before: the flush copies the batch into the connection's vector, a send erases what went out.
+	std::vector<std::vector<uint8_t>> flat(CLIENTS);
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < TICKS; ++tick)
+	{
+		for (int client = 0; client < CLIENTS; ++client)
+		{
+			std::vector<uint8_t> compressionBuf(batchTemplate);
+			auto& queue = flat[client];
+			queue.reserve(queue.size() + compressionBuf.size());
+			queue.insert(queue.end(), compressionBuf.begin(), compressionBuf.end());
+			const size_t sent = std::min(queue.size(), tick % 200 < 100 ? SLOW_SEND : FAST_SEND);
+			std::memcpy(sink.data(), queue.data(), sent);
+			queue.erase(queue.begin(), queue.begin() + sent);
+			sentFlat += sent;
+		}
+	}
+	auto middle = std::chrono::steady_clock::now();
+
+	// After: the batch is moved in, sends gather from the buffers and drop them once sent.
+	std::vector<WriteQueue> queues(CLIENTS);
+	for (int tick = 0; tick < TICKS; ++tick)
+	{
+		for (int client = 0; client < CLIENTS; ++client)
+		{
+			std::vector<uint8_t> compressionBuf(batchTemplate);
+			auto& queue = queues[client];
+			queue.append(std::move(compressionBuf));
+			const size_t limit = tick % 200 < 100 ? SLOW_SEND : FAST_SEND;
+			WriteSpan spans[16];
+			const size_t count = queue.spans(spans, 16);
+			size_t sent = 0;
+			for (size_t i = 0; i < count && sent < limit; ++i)
+			{
+				const size_t size = std::min(spans[i].size, limit - sent);
+				std::memcpy(sink.data() + sent, spans[i].data, size);
+				sent += size;
+			}
+			queue.consume(sent);
+			sentQueue += sent;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	size_t leftFlat = 0, leftQueue = 0;
+	for (int client = 0; client < CLIENTS; ++client)
+	{
+		leftFlat += flat[client].size();
+		leftQueue += queues[client].size();
+	}
+	CHECK_TRUE(sentFlat == sentQueue && leftFlat == leftQueue, "benchmark sent %llu and %llu bytes", static_cast<unsigned long long>(sentFlat), static_cast<unsigned long long>(sentQueue));
+	std::printf("%d clients, up to %zu KiB backlog each: flat vector %8.2f us per tick, write queue %8.2f us per tick\n",
+	            CLIENTS, 100 * (BATCH - SLOW_SEND) / 1024,
+	            std::chrono::duration<double, std::micro>(middle - start).count() / TICKS,
+	            std::chrono::duration<double, std::micro>(end - middle).count() / TICKS);
+}
+
+int main(int argc, char **argv)
+{
+	checkOrder(1);
+	checkOrder(2);
+	checkNoCopies();
+	checkSocket();
+	if (!checksOnly(argc, argv))
+	{
+		benchmark();
+	}
+
+	return checkSummary();
+}